@@ -19,8 +19,16 @@ if(ENABLE_COVERAGE)
 endif()
 
 # Optimization settings
+# -march=native ties the binaries to the build machine's CPU: off by default so that release builds run
+# anywhere. Vector code does not need it: aknet_kernels builds each instruction set separately and picks one
+# at run time.
+option(AKNET_MARCH_NATIVE "Optimize for the build machine's CPU (binaries may not run on other CPUs)" OFF)
+
 if(CMAKE_BUILD_TYPE STREQUAL "Release")
-    add_compile_options(-O3 -march=native)
+    add_compile_options(-O3)
+    if(AKNET_MARCH_NATIVE)
+        add_compile_options(-march=native)
+    endif()
     # Optional: Link-time optimization (LTO)
     # add_compile_options(-flto)
     # add_link_options(-flto)
@@ -19,11 +19,14 @@ include(${CMAKE_CURRENT_BINARY_DIR}/cmake/CPM.cmake)
 # Saucer
 # --------------------------------------------------------------------------------------------------------
 
-CPMAddPackage(
-        NAME           saucer
-        VERSION        7.0.2
-        GIT_REPOSITORY "https://github.com/saucer/saucer"
-)
+# Only the webview front end uses it
+if(AKNET_BUILD_GUI)
+    CPMAddPackage(
+            NAME           saucer
+            VERSION        7.0.2
+            GIT_REPOSITORY "https://github.com/saucer/saucer"
+    )
+endif()
 
 # --------------------------------------------------------------------------------------------------------
 # spdlog
@@ -0,0 +1,567 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+// aknet_core_bench: throughput and round-trip latency of commands through the message bus, the cost and
+// latency of meter telemetry, and the cost of the meters and the routing matrix.
+//
+//   aknet_core_bench [--format text|csv|json] [--seconds <n>] [--producers <n>] [--channels <n>]
+//
+// Five measurements, the first three over `seconds` each:
+//   - throughput: 1, 2, 4... up to `producers` threads post commands flat out, one at a time or in batches
+//     of 16, to a consumer that drains them as fast as it can; commands applied per second, and the share of
+//     posts that found the queue full (they are retried)
+//   - round trip: one thread posts a Ping and polls the events until its Pong comes back, over and over.
+//     Through a consumer spinning on the queue (the cost of the bus alone), and through a running engine
+//     that applies commands at the start of its blocks of 64 frames at 48 kHz (what the UI sees: up to a
+//     block period of wait on top). Pings to the engine leave at random times within a block, as UI
+//     actions would: the wait for the next block averages half a period
+//   - telemetry: a running engine meters 64, 128... up to `channels` channels (default 512) and publishes
+//     120 snapshots per second; a UI thread pulls a frame from the bridge at 60 Hz. The bridge's CPU time
+//     per frame and its share of the UI thread, the frame size in base64, the latency from the audio
+//     thread's publication to the frame being ready, and the slowest block of the audio thread
+//   - metering: the meters alone on blocks of 64 frames of noise, 64, 128... up to `channels` channels, with
+//     each kernel implementation this CPU runs; time per channel per block, the share of the block period
+//     it takes for all channels, and the speedup over the scalar kernels
+//   - routing: a 256 x 256 routing matrix with 1%, 10% and 100% of its crosspoints active, on blocks of 64
+//     frames of noise, with each kernel implementation; time per block once the ramps are over, its share of
+//     the block period, the speedup over a dense matrix (a gain-add per crosspoint, zero or not), and the
+//     time commit() takes to compile the table on the control thread
+
+#include <message_bus.h>
+#include <routing.h>
+#include <telemetry.h>
+#include <engine.h>
+#include <kernels.h>
+#include <logger.h>
+#include <bench_support.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <ctime>
+
+using namespace aknet;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct ThroughputResult {
+        std::uint32_t producers = 0;
+        std::uint32_t batch = 0;
+        double commands_per_second = 0;
+        double full_percent = 0;  // posts that found the queue full
+    };
+
+    struct LatencyResult {
+        std::string path;
+        std::uint64_t round_trips = 0;
+        double p50_us = 0;
+        double p99_us = 0;
+        double max_us = 0;
+    };
+
+    struct TelemetryResult {
+        std::uint32_t channels = 0;
+        std::uint64_t frames = 0;
+        std::size_t frame_bytes = 0;      // base64
+        double bridge_us = 0;             // CPU time per frame, on the UI thread
+        double bridge_max_us = 0;
+        double ui_cpu_percent = 0;        // of the UI thread's time
+        double latency_p50_ms = 0;        // publication to frame ready
+        double latency_p99_ms = 0;
+        double latency_max_ms = 0;
+        double worst_block_percent = 0;   // slowest audio block, in percent of the block period
+    };
+
+    struct MeteringResult {
+        std::string isa;
+        std::uint32_t channels = 0;
+        double ns_per_channel = 0;        // per block of 64 frames
+        double block_percent = 0;         // all channels, in percent of the block period at 48 kHz
+        double speedup = 0;               // over the scalar kernels
+    };
+
+    struct RoutingResult {
+        std::string isa;
+        double density_percent = 0;
+        std::size_t crosspoints = 0;
+        double ns_per_block = 0;          // 64 frames
+        double block_percent = 0;         // of the block period at 48 kHz
+        double dense_speedup = 0;         // over a gain-add per crosspoint of the whole matrix
+        double commit_us = 0;             // compiling the table, control thread
+    };
+
+    struct Options {
+        bench::Format format = bench::Format::text;
+        std::uint32_t seconds = 2;
+        std::uint32_t producers = 4;
+        std::uint32_t channels = 512;
+    };
+
+    std::int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    // CPU time of the calling thread
+    std::int64_t thread_cpu_ns() {
+        timespec ts{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return std::int64_t{ts.tv_sec} * 1'000'000'000 + ts.tv_nsec;
+    }
+
+    // Time of one call, best of 10 rounds of about 25 ms each
+    double time_per_call(const std::function<void()>& call) {
+        double best_ns = 0;
+        std::uint64_t calls = 1;
+        for (int round = 0; round < 10; round++) {
+            const auto start = Clock::now();
+            for (std::uint64_t n = 0; n < calls; n++) call();
+            const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                              static_cast<double>(calls);
+            best_ns = round == 0 ? ns : std::min(best_ns, ns);
+            calls = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(0.025e9 / ns));
+        }
+        return best_ns;
+    }
+
+    double percentile(std::vector<double>& values, double p) {
+        if (values.empty()) return 0;
+        std::ranges::sort(values);
+        return values[std::min(values.size() - 1, static_cast<std::size_t>(p * static_cast<double>(values.size())))];
+    }
+
+    // Answer every Ping with a Pong (what the core does on the audio thread)
+    void answer(bus::MessageBus& bus, std::uint64_t sample_time) {
+        bus.drain([&](const bus::Command& command) {
+            if (const auto* ping = std::get_if<bus::command::Ping>(&command)) {
+                bus.emit(bus::event::Pong{.id = ping->id, .sent_ns = ping->sent_ns, .sample_time = sample_time});
+            }
+        });
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Throughput
+    // ---------------------------------------------------------------------------------------------
+
+    ThroughputResult measure_throughput(const Options& options, std::uint32_t producers, std::uint32_t batch) {
+        bus::MessageBus bus;
+        std::atomic<bool> stop{false};
+        std::atomic<std::uint64_t> full{0};
+        std::atomic<std::uint64_t> posts{0};
+
+        std::vector<std::jthread> threads;
+        for (std::uint32_t p = 0; p < producers; p++) {
+            threads.emplace_back([&] {
+                std::vector<bus::Command> commands(batch);
+                std::uint64_t id = 0;
+                std::uint64_t my_full = 0;
+                std::uint64_t my_posts = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    for (auto& command : commands) command = bus::command::Ping{.id = id++};
+                    if (bus.post(commands)) {
+                        my_posts++;
+                    } else {
+                        my_full++;
+                        std::this_thread::yield();
+                    }
+                }
+                full.fetch_add(my_full, std::memory_order_relaxed);
+                posts.fetch_add(my_posts, std::memory_order_relaxed);
+            });
+        }
+
+        // The consumer counts the commands without answering them
+        const auto start = Clock::now();
+        const auto end = start + std::chrono::seconds(options.seconds);
+        while (Clock::now() < end) {
+            if (bus.drain([](const bus::Command&) {}) == 0) std::this_thread::yield();
+        }
+        const auto applied = bus.stats().commands_applied;
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        stop = true;
+        threads.clear();
+
+        const double attempts = static_cast<double>(posts.load() + full.load());
+        return {
+            .producers = producers,
+            .batch = batch,
+            .commands_per_second = static_cast<double>(applied) / elapsed,
+            .full_percent = attempts > 0 ? 100.0 * static_cast<double>(full.load()) / attempts : 0,
+        };
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Round trip
+    // ---------------------------------------------------------------------------------------------
+
+    // Round trips for `seconds`, each after a random pause of up to max_pause
+    LatencyResult round_trips(const Options& options, bus::MessageBus& bus, std::string path,
+                              std::chrono::nanoseconds max_pause = {}) {
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<std::int64_t> pause(0, max_pause.count());
+        std::vector<double> times;
+        const auto end = Clock::now() + std::chrono::seconds(options.seconds);
+        for (std::uint64_t id = 0; Clock::now() < end; id++) {
+            if (max_pause.count() > 0) std::this_thread::sleep_for(std::chrono::nanoseconds(pause(rng)));
+            bus.post(bus::command::Ping{.id = id, .sent_ns = now_ns()});
+            bool answered = false;
+            while (!answered) {
+                bus.poll([&](const bus::Event& event) {
+                    if (const auto* pong = std::get_if<bus::event::Pong>(&event); pong && pong->id == id) {
+                        times.push_back(static_cast<double>(now_ns() - pong->sent_ns) * 1e-3);
+                        answered = true;
+                    }
+                });
+                if (!answered) std::this_thread::yield();
+            }
+        }
+
+        return {
+            .path = std::move(path),
+            .round_trips = times.size(),
+            .p50_us = percentile(times, 0.50),
+            .p99_us = percentile(times, 0.99),
+            .max_us = percentile(times, 1.0),
+        };
+    }
+
+    LatencyResult measure_spin(const Options& options) {
+        bus::MessageBus bus;
+        std::atomic<bool> stop{false};
+        std::jthread consumer([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                answer(bus, 0);
+                std::this_thread::yield();
+            }
+        });
+        auto result = round_trips(options, bus, "spin");
+        stop = true;
+        return result;
+    }
+
+    LatencyResult measure_engine(const Options& options) {
+        bus::MessageBus bus;
+        engine::Engine engine({.sample_rate = 48000, .block_size = 64, .priority = 0});
+        engine.set_block_hook([&](std::uint64_t sample_time) { answer(bus, sample_time); });
+        engine.start();
+        auto result = round_trips(options, bus, "engine", engine.stats().period);
+        engine.stop();
+        return result;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Telemetry
+    // ---------------------------------------------------------------------------------------------
+
+    // Every output a different level, changing with every block
+    class Levels : public engine::Node {
+    public:
+        explicit Levels(std::uint32_t channels) : channels_(channels) {}
+        std::size_t input_count() const override { return 0; }
+        std::size_t output_count() const override { return channels_; }
+        void process(const engine::ProcessBlock& block) noexcept override {
+            const float step = static_cast<float>(block.sample_time % 4096) / 4096.0f;
+            for (std::uint32_t c = 0; c < channels_; c++) {
+                std::fill_n(block.outputs[c], block.frames, step * static_cast<float>(c + 1) / static_cast<float>(channels_));
+            }
+        }
+
+    private:
+        std::uint32_t channels_;
+    };
+
+    TelemetryResult measure_telemetry(const Options& options, std::uint32_t channels) {
+        engine::Engine engine({.sample_rate = 48000, .block_size = 64, .priority = 0});
+        auto meters = std::make_shared<telemetry::Meters>(telemetry::MeterConfig{.channels = channels, .publish_rate = 120});
+        engine::GraphBuilder builder;
+        const auto source = builder.add(std::make_shared<Levels>(channels));
+        const auto sink = builder.add(meters);
+        for (std::uint32_t c = 0; c < channels; c++) builder.connect(source, c, sink, c);
+        engine.publish(builder.build(engine.spec()));
+        engine.start();
+
+        // The UI thread, at 60 frames per second
+        telemetry::TelemetryBridge bridge(meters);
+        std::vector<double> latencies;
+        std::int64_t cpu_total = 0;
+        std::int64_t cpu_max = 0;
+        std::size_t frame_bytes = 0;
+        const auto tick = std::chrono::nanoseconds(1'000'000'000 / 60);
+        const auto start = Clock::now();
+        for (auto next = start + tick; next < start + std::chrono::seconds(options.seconds); next += tick) {
+            std::this_thread::sleep_until(next);
+            const auto cpu_before = thread_cpu_ns();
+            const std::string_view frame = bridge.frame();
+            const auto ready = now_ns();
+            const auto cpu = thread_cpu_ns() - cpu_before;
+            if (frame.empty()) continue;
+            cpu_total += cpu;
+            cpu_max = std::max(cpu_max, cpu);
+            frame_bytes = frame.size();
+            latencies.push_back(static_cast<double>(ready - meters->snapshot().published_ns) * 1e-6);
+        }
+        const double elapsed_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        engine.stop();
+
+        const auto stats = engine.stats();
+        const auto frames = bridge.stats().frames;
+        return {
+            .channels = channels,
+            .frames = frames,
+            .frame_bytes = frame_bytes,
+            .bridge_us = frames > 0 ? static_cast<double>(cpu_total) * 1e-3 / static_cast<double>(frames) : 0,
+            .bridge_max_us = static_cast<double>(cpu_max) * 1e-3,
+            .ui_cpu_percent = 100.0 * static_cast<double>(cpu_total) / elapsed_ns,
+            .latency_p50_ms = percentile(latencies, 0.50),
+            .latency_p99_ms = percentile(latencies, 0.99),
+            .latency_max_ms = percentile(latencies, 1.0),
+            .worst_block_percent = 100.0 * static_cast<double>(stats.max_process_time.count()) /
+                                   static_cast<double>(stats.period.count()),
+        };
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Metering
+    // ---------------------------------------------------------------------------------------------
+
+    std::vector<MeteringResult> measure_metering(const Options& options) {
+        constexpr std::uint32_t frames = 64;
+        constexpr double period_ns = 1e9 * frames / 48000;
+        const auto initial = kernels::active_isa();
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+        std::vector<MeteringResult> results;
+        for (std::uint32_t channels = 64; channels <= options.channels; channels *= 2) {
+            std::vector<float> samples(std::size_t{channels} * frames);
+            for (auto& s : samples) s = uniform(rng);
+            std::vector<const float*> inputs;
+            for (std::uint32_t c = 0; c < channels; c++) inputs.push_back(samples.data() + std::size_t{c} * frames);
+
+            double scalar_ns = 0;
+            for (const auto isa : {kernels::Isa::scalar, kernels::Isa::sse2, kernels::Isa::avx2, kernels::Isa::avx512,
+                                   kernels::Isa::neon}) {
+                if (!kernels::use_isa(isa)) continue;
+                telemetry::Meters meters({.channels = channels, .publish_rate = 120});
+                meters.prepare({.sample_rate = 48000, .block_size = frames});
+
+                std::uint64_t sample_time = 0;
+                const double best_ns = time_per_call([&] {
+                    meters.process({.inputs = inputs, .outputs = {}, .frames = frames, .sample_time = sample_time});
+                    sample_time += frames;
+                });
+                if (isa == kernels::Isa::scalar) scalar_ns = best_ns;
+                results.push_back({
+                    .isa = std::string(kernels::isa_name(isa)),
+                    .channels = channels,
+                    .ns_per_channel = best_ns / channels,
+                    .block_percent = 100.0 * best_ns / period_ns,
+                    .speedup = scalar_ns / best_ns,
+                });
+            }
+        }
+        kernels::use_isa(initial);
+        return results;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Routing
+    // ---------------------------------------------------------------------------------------------
+
+    std::vector<RoutingResult> measure_routing() {
+        constexpr std::uint32_t size = 256;
+        constexpr std::uint32_t frames = 64;
+        constexpr double period_ns = 1e9 * frames / 48000;
+        const auto initial = kernels::active_isa();
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+        std::vector<float> samples(std::size_t{size} * frames), mixed(std::size_t{size} * frames);
+        for (auto& s : samples) s = uniform(rng);
+        std::vector<const float*> inputs;
+        std::vector<float*> outputs;
+        for (std::uint32_t c = 0; c < size; c++) {
+            inputs.push_back(samples.data() + std::size_t{c} * frames);
+            outputs.push_back(mixed.data() + std::size_t{c} * frames);
+        }
+
+        std::vector<RoutingResult> results;
+        for (const double density : {0.01, 0.10, 1.0}) {
+            // The same random crosspoints for every implementation
+            std::vector<float> gains(std::size_t{size} * size);
+            std::vector<std::uint32_t> order(gains.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::ranges::shuffle(order, rng);
+            const auto active = static_cast<std::size_t>(std::lround(density * static_cast<double>(gains.size())));
+            for (std::size_t n = 0; n < active; n++) gains[order[n]] = uniform(rng);
+
+            for (const auto isa : {kernels::Isa::scalar, kernels::Isa::sse2, kernels::Isa::avx2, kernels::Isa::avx512,
+                                   kernels::Isa::neon}) {
+                if (!kernels::use_isa(isa)) continue;
+
+                routing::RoutingMatrix matrix({.inputs = size, .outputs = size});
+                matrix.prepare({.sample_rate = 48000, .block_size = frames});
+                for (std::uint32_t o = 0; o < size; o++) {
+                    for (std::uint32_t i = 0; i < size; i++) matrix.set(i, o, gains[std::size_t{o} * size + i]);
+                }
+                const auto commit_start = Clock::now();
+                matrix.commit();
+                const double commit_ns = std::chrono::duration<double, std::nano>(Clock::now() - commit_start).count();
+
+                std::uint64_t sample_time = 0;
+                const auto block = [&] {
+                    matrix.process({.inputs = inputs, .outputs = outputs, .frames = frames, .sample_time = sample_time});
+                    sample_time += frames;
+                };
+                for (int b = 0; b < 100; b++) block(); // past the ramps
+                const double sparse_ns = time_per_call(block);
+                const double dense_ns = time_per_call([&] {
+                    for (std::uint32_t o = 0; o < size; o++) {
+                        std::fill_n(outputs[o], frames, 0.0f);
+                        for (std::uint32_t i = 0; i < size; i++) {
+                            kernels::mix_add(outputs[o], inputs[i], frames, gains[std::size_t{o} * size + i]);
+                        }
+                    }
+                });
+
+                results.push_back({
+                    .isa = std::string(kernels::isa_name(isa)),
+                    .density_percent = 100.0 * density,
+                    .crosspoints = active,
+                    .ns_per_block = sparse_ns,
+                    .block_percent = 100.0 * sparse_ns / period_ns,
+                    .dense_speedup = dense_ns / sparse_ns,
+                    .commit_us = commit_ns * 1e-3,
+                });
+            }
+        }
+        kernels::use_isa(initial);
+        return results;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Output
+    // ---------------------------------------------------------------------------------------------
+
+    void print(const Options& options, const std::vector<ThroughputResult>& throughput,
+               const std::vector<LatencyResult>& latency, const std::vector<TelemetryResult>& telemetry,
+               const std::vector<MeteringResult>& metering, const std::vector<RoutingResult>& routing) {
+        bench::Table throughput_table{"throughput", {
+            {.key = "producers", .header = "producers", .width = 10},
+            {.key = "batch", .header = "batch", .width = 6},
+            {.key = "commands_per_second", .header = "commands/s", .width = 16},
+            {.key = "full_percent", .header = "full", .width = 8, .precision = 2, .unit = "%"},
+        }};
+        for (const auto& r : throughput) throughput_table.add({r.producers, r.batch, r.commands_per_second, r.full_percent});
+
+        bench::Table latency_table{"round_trip", {
+            {.key = "path", .header = "path", .width = 10},
+            {.key = "round_trips", .header = "round trips", .width = 12},
+            {.key = "p50_us", .header = "p50", .width = 12, .precision = 2, .unit = "us"},
+            {.key = "p99_us", .header = "p99", .width = 12, .precision = 2, .unit = "us"},
+            {.key = "max_us", .header = "max", .width = 12, .precision = 2, .unit = "us"},
+        }};
+        for (const auto& r : latency) latency_table.add({r.path, r.round_trips, r.p50_us, r.p99_us, r.max_us});
+
+        bench::Table telemetry_table{"telemetry", {
+            {.key = "channels", .header = "channels", .width = 10},
+            {.key = "frames", .header = "frames", .width = 8},
+            {.key = "frame_bytes", .header = "bytes", .width = 8},
+            {.key = "bridge_us", .header = "bridge", .width = 12, .precision = 2, .unit = "us"},
+            {.key = "bridge_max_us", .header = "bridge max", .width = 12, .precision = 2, .unit = "us"},
+            {.key = "ui_cpu_percent", .header = "ui cpu", .width = 8, .precision = 4, .unit = "%"},
+            {.key = "latency_p50_ms", .header = "lat p50", .width = 10, .precision = 3, .unit = "ms"},
+            {.key = "latency_p99_ms", .header = "lat p99", .width = 10, .precision = 3, .unit = "ms"},
+            {.key = "latency_max_ms", .header = "lat max", .width = 10, .precision = 3, .unit = "ms"},
+            {.key = "worst_block_percent", .header = "worst block", .width = 12, .precision = 2, .unit = "%"},
+        }};
+        for (const auto& r : telemetry) {
+            telemetry_table.add({r.channels, r.frames, r.frame_bytes, r.bridge_us, r.bridge_max_us, r.ui_cpu_percent,
+                                 r.latency_p50_ms, r.latency_p99_ms, r.latency_max_ms, r.worst_block_percent});
+        }
+
+        bench::Table metering_table{"metering", {
+            {.key = "isa", .header = "isa", .width = 10},
+            {.key = "channels", .header = "channels", .width = 8},
+            {.key = "ns_per_channel", .header = "per channel", .width = 14, .precision = 1, .unit = "ns"},
+            {.key = "block_percent", .header = "block", .width = 10, .precision = 3, .unit = "%"},
+            {.key = "speedup", .header = "speedup", .width = 8, .precision = 2, .unit = "x"},
+        }};
+        for (const auto& r : metering) {
+            metering_table.add({r.isa, r.channels, r.ns_per_channel, r.block_percent, r.speedup});
+        }
+
+        bench::Table routing_table{"routing", {
+            {.key = "isa", .header = "isa", .width = 10},
+            {.key = "density_percent", .header = "density", .width = 8, .unit = "%"},
+            {.key = "crosspoints", .header = "crosspoints", .width = 12},
+            {.key = "ns_per_block", .header = "per block", .width = 12, .unit = "ns"},
+            {.key = "block_percent", .header = "block", .width = 10, .precision = 3, .unit = "%"},
+            {.key = "dense_speedup", .header = "vs dense", .width = 12, .precision = 2, .unit = "x"},
+            {.key = "commit_us", .header = "commit", .width = 12, .precision = 1, .unit = "us"},
+        }};
+        for (const auto& r : routing) {
+            routing_table.add({r.isa, r.density_percent, r.crosspoints, r.ns_per_block, r.block_percent, r.dense_speedup,
+                               r.commit_us});
+        }
+
+        bench::print(options.format, {throughput_table, latency_table, telemetry_table, metering_table, routing_table});
+    }
+
+    std::optional<Options> parse_options(int argc, char** argv) {
+        return bench::parse_options<Options>(argc, argv, [](Options& options, std::string_view name, std::string_view value) {
+            if (name == "--seconds") return bench::parse_count(value, options.seconds);
+            if (name == "--producers") return bench::parse_count(value, options.producers);
+            if (name == "--channels") return bench::parse_count(value, options.channels);
+            return false;
+        });
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_options(argc, argv);
+    if (!options) {
+        std::cerr << "Usage: " << argv[0] << " [--format text|csv|json] [--seconds <n>] [--producers <n>] [--channels <n>]" << std::endl;
+        return 1;
+    }
+
+    std::vector<ThroughputResult> throughput;
+    for (std::uint32_t producers = 1; producers <= options->producers; producers *= 2) {
+        for (const std::uint32_t batch : {1u, 16u}) throughput.push_back(measure_throughput(*options, producers, batch));
+    }
+
+    // The engine logs its start and stop; keep that off the output
+    const auto log_dir = std::filesystem::temp_directory_path() / "aknet_core_bench_logs";
+    log::init(log_dir, {.console = false});
+    const std::vector<LatencyResult> latency = {measure_spin(*options), measure_engine(*options)};
+    std::vector<TelemetryResult> telemetry;
+    for (std::uint32_t channels = 64; channels <= options->channels; channels *= 2) {
+        telemetry.push_back(measure_telemetry(*options, channels));
+    }
+    log::shutdown();
+    std::filesystem::remove_all(log_dir);
+
+    const auto metering = measure_metering(*options);
+    const auto routing = measure_routing();
+
+    print(*options, throughput, latency, telemetry, metering, routing);
+    return 0;
+}
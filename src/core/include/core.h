@@ -10,12 +10,23 @@
 #include <memory>
 #include <filesystem>
 #include <logger.h>
+#include <engine.h>
+#include <buffer_pool.h>
+
+#include "message_bus.h"
+#include "routing.h"
+#include "telemetry.h"
 
 namespace aknet {
 
     struct core_config {
         std::filesystem::path log_dir = {};
         log::LogLevel log_level = log::LogLevel::info;
+        engine::EngineConfig engine = {};
+        pool::BufferPoolConfig buffers = {};   // packets and audio blocks shared between threads
+        bus::MessageBusConfig bus = {};        // commands from the UI, events back to it
+        telemetry::MeterConfig meters = {};    // levels published for the UI
+        routing::RoutingConfig routing = {};   // crosspoints from network inputs to outputs
     };
 
     class core {
@@ -28,18 +39,36 @@ namespace aknet {
         core(const core&) = delete;
         core& operator=(const core&) = delete;
 
-        void test_function();
+        // Owned modules
+        engine::Engine& engine() { return *engine_; }
+        pool::BufferPool& buffers() { return *buffers_; }
+
+        // The UI's way in: post commands from any thread, poll the events from one. The engine applies the
+        // commands at the start of its blocks.
+        bus::MessageBus& bus() { return *bus_; }
 
-        // Future: accessors for owned modules
-        // ModuleA& module_a();
+        // The meters and the routing matrix sit in the core's first graph; graphs published later add these
+        // same nodes to keep them. The UI pulls the meters' snapshots through the telemetry bridge, from one
+        // thread; crosspoints are set and committed from one control thread.
+        const std::shared_ptr<telemetry::Meters>& meters() { return meters_; }
+        const std::shared_ptr<routing::RoutingMatrix>& routing() { return routing_; }
+        telemetry::TelemetryBridge& telemetry() { return *telemetry_; }
 
     private:
         std::shared_ptr<log::Logger> logger_;
 
         void log_aknet_start_message();
 
-        // Future: owned modules
-        // std::unique_ptr<ModuleA> module_a_;
+        // Audio thread: apply the commands posted since the last block
+        void apply_commands(std::uint64_t sample_time) noexcept;
+
+        // Owned modules (the buffer pool and the bus outlive the modules using them)
+        std::unique_ptr<pool::BufferPool> buffers_;
+        std::unique_ptr<bus::MessageBus> bus_;
+        std::shared_ptr<telemetry::Meters> meters_;
+        std::shared_ptr<routing::RoutingMatrix> routing_;
+        std::unique_ptr<telemetry::TelemetryBridge> telemetry_;
+        std::unique_ptr<engine::Engine> engine_;
     };
 
 } // namespace aknet
@@ -0,0 +1,138 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_MESSAGE_BUS_H
+#define AKNET_MESSAGE_BUS_H
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <variant>
+
+#include "queues.h"
+
+namespace aknet::bus {
+
+    // Commands: from the UI (or any thread) to the core, applied by the audio thread between two blocks
+    namespace command {
+        struct Ping {
+            std::uint64_t id = 0;
+            std::int64_t sent_ns = 0;      // steady clock, for the round trip
+        };
+        struct TestMessage {};
+    }
+
+    using Command = std::variant<command::Ping, command::TestMessage>;
+
+    // Events: from the audio thread to the UI
+    namespace event {
+        struct Pong {
+            std::uint64_t id = 0;
+            std::int64_t sent_ns = 0;      // copied from the Ping
+            std::uint64_t sample_time = 0; // the block the Ping was applied before
+        };
+        struct TestMessage {
+            std::uint64_t sample_time = 0;
+        };
+    }
+
+    using Event = std::variant<event::Pong, event::TestMessage>;
+
+    struct MessageBusConfig {
+        std::size_t command_capacity = 1024;  // rounded up to a power of two
+        std::size_t event_capacity = 1024;    // rounded up to a power of two
+        std::size_t max_batch = 256;          // commands applied at one block boundary at most
+    };
+
+    // Counters since construction, read with relaxed loads
+    struct MessageBusStats {
+        std::uint64_t commands_posted = 0;
+        std::uint64_t commands_dropped = 0;   // posted to a full queue
+        std::uint64_t commands_applied = 0;
+        std::uint64_t batches = 0;            // block boundaries that applied commands
+        std::uint64_t largest_batch = 0;
+        std::uint64_t events_emitted = 0;
+        std::uint64_t events_dropped = 0;     // emitted to a full queue: the UI is not polling
+    };
+
+    // -------------------------------------------------------------------------
+    // MessageBus: typed messages between the UI bridge and the core, without locks on either side.
+    // Commands go through a bounded MPSC queue: any thread posts, and the audio thread applies them in a
+    // batch at the start of a block, so the graph sees every change at a block boundary and the cost of a
+    // block stays bounded (max_batch). Events come back through a bounded SPSC queue that one UI thread
+    // polls. Neither side waits: posting to a full queue fails and is counted.
+    // -------------------------------------------------------------------------
+    class MessageBus {
+    public:
+        // Throws std::invalid_argument on a zero capacity or batch
+        explicit MessageBus(const MessageBusConfig& config = {});
+
+        MessageBus(const MessageBus&) = delete;
+        MessageBus& operator=(const MessageBus&) = delete;
+
+        const MessageBusConfig& config() const noexcept { return config_; }
+
+        // Any thread. False if the command queue is full.
+        bool post(const Command& command) noexcept;
+
+        // Any thread: all the commands, applied in order with no other thread's in between, or none of them
+        // if the queue cannot take them all
+        bool post(std::span<const Command> commands) noexcept;
+
+        // Audio thread, at a block boundary: apply(command) for the commands posted so far, max_batch at most.
+        // Returns how many were applied.
+        template <typename Apply>
+        std::size_t drain(Apply&& apply) noexcept {
+            std::size_t count = 0;
+            while (count < config_.max_batch) {
+                const auto command = commands_.try_pop();
+                if (!command) break;
+                apply(*command);
+                count++;
+            }
+            if (count > 0) record_batch(count);
+            return count;
+        }
+
+        // Audio thread (the side that drains). False if the event queue is full.
+        bool emit(const Event& event) noexcept;
+
+        // UI thread: handle(event) for every event emitted so far. Returns how many were handled.
+        template <typename Handle>
+        std::size_t poll(Handle&& handle) {
+            std::size_t count = 0;
+            while (const auto event = events_.try_pop()) {
+                handle(*event);
+                count++;
+            }
+            return count;
+        }
+
+        MessageBusStats stats() const noexcept;
+
+    private:
+        void record_batch(std::size_t count) noexcept;
+
+        const MessageBusConfig config_;
+        MpscQueue<Command> commands_;
+        SpscQueue<Event> events_;
+
+        // Any thread
+        std::atomic<std::uint64_t> commands_posted_{0};
+        std::atomic<std::uint64_t> commands_dropped_{0};
+
+        // Written by the audio thread only
+        std::atomic<std::uint64_t> commands_applied_{0};
+        std::atomic<std::uint64_t> batches_{0};
+        std::atomic<std::uint64_t> largest_batch_{0};
+        std::atomic<std::uint64_t> events_emitted_{0};
+        std::atomic<std::uint64_t> events_dropped_{0};
+    };
+
+} // namespace aknet::bus
+
+#endif // AKNET_MESSAGE_BUS_H
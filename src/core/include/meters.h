@@ -0,0 +1,93 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_METERS_H
+#define AKNET_METERS_H
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <graph.h>
+
+#include "triple_buffer.h"
+
+namespace aknet::telemetry {
+
+    struct MeterConfig {
+        std::uint32_t channels = 64;
+        double publish_rate = 120.0;   // snapshots per second at most, rounded to whole blocks
+        double peak_fall = 20.0;       // dB per second a peak falls back once the signal is below it (0 holds it)
+        double rms_time = 0.3;         // seconds: time constant of the RMS average
+    };
+
+    // Levels of every channel when the snapshot was published, all linear
+    struct MeterSnapshot {
+        std::uint64_t sequence = 0;       // snapshots published before this one
+        std::uint64_t sample_time = 0;    // first frame measured since the previous snapshot
+        std::uint64_t frames = 0;         // frames measured since the previous snapshot
+        std::int64_t published_ns = 0;    // steady clock, when the audio thread published it
+        std::vector<float> peak;          // per channel: largest sample magnitude, falling at peak_fall
+        std::vector<float> true_peak;     // per channel: same, between samples too (BS.1770 4x oversampling)
+        std::vector<float> rms;           // per channel: exponential average of the energy, over rms_time
+    };
+
+    // -------------------------------------------------------------------------
+    // Meters: a sink node measuring the sample peak, true peak and RMS level of each of its inputs, and
+    // publishing them for the UI through a triple buffer, publish_rate times per second.
+    // Every block runs the SIMD kernels over each channel, then the ballistics: peaks rise at once and fall
+    // at peak_fall, the RMS level follows the energy with a time constant of rms_time. Snapshots only copy
+    // the levels out every few blocks, so the UI rate costs nothing per block. The audio thread never waits
+    // for the UI: a snapshot the UI has not taken yet is replaced by the next one, and as peaks fall slowly
+    // no peak goes unseen however late the UI reads (a 50 ms late UI sees it 1 dB lower at 20 dB/s).
+    // -------------------------------------------------------------------------
+    class Meters : public engine::Node {
+    public:
+        // Throws std::invalid_argument on zero channels, a publish rate or RMS time that is not positive, or a
+        // negative peak fall
+        explicit Meters(const MeterConfig& config = {});
+
+        const MeterConfig& config() const noexcept { return config_; }
+
+        std::size_t input_count() const override { return config_.channels; }
+        std::size_t output_count() const override { return 0; }
+
+        void prepare(const engine::ProcessSpec& spec) override;
+        void process(const engine::ProcessBlock& block) noexcept override;
+
+        // One reader (the telemetry bridge): take the latest snapshot if there is a new one
+        bool update() noexcept { return snapshots_.update(); }
+        const MeterSnapshot& snapshot() const noexcept { return snapshots_.read_buffer(); }
+
+    private:
+        void publish() noexcept;
+
+        const MeterConfig config_;
+
+        // Per block, from the spec
+        std::uint32_t blocks_per_snapshot_ = 1;
+        float peak_fall_ = 1.0f;      // gain applied to the peaks
+        float rms_weight_ = 1.0f;     // weight of the block's mean square in the average
+
+        // Audio thread: levels per channel...
+        std::vector<float> peak_;
+        std::vector<float> true_peak_;
+        std::vector<float> mean_square_;
+        // ...and the last samples of each channel (true_peak_history of them) followed by room for a block,
+        // sized by prepare(): the oversampling filter runs across blocks
+        std::vector<float> history_;
+        std::size_t history_stride_ = 0;
+
+        std::uint32_t blocks_ = 0;
+        std::uint64_t frames_ = 0;
+        std::uint64_t first_sample_ = 0;
+        std::uint64_t sequence_ = 0;
+
+        bus::TripleBuffer<MeterSnapshot> snapshots_;
+    };
+
+} // namespace aknet::telemetry
+
+#endif // AKNET_METERS_H
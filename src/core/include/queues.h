@@ -0,0 +1,172 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_QUEUES_H
+#define AKNET_QUEUES_H
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace aknet::bus {
+
+    namespace detail {
+        // Queue capacities are powers of two, so a position maps to a slot with a mask
+        inline std::size_t queue_capacity(std::size_t capacity) {
+            if (capacity == 0) throw std::invalid_argument("Queue capacity must not be zero");
+            return std::bit_ceil(capacity);
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // MpscQueue: bounded queue with any number of producers and one consumer, lock-free.
+    // Every slot carries a sequence number telling whose turn it is: a producer claims a position with a
+    // compare-and-swap on the tail, writes the slot, then hands it to the consumer by bumping its sequence;
+    // the consumer reads slots in order and hands them back for the next lap. A full queue fails the push
+    // instead of waiting. Nothing allocates after construction, and values are copied with memcpy-like
+    // semantics (T must be trivially copyable), so both ends are safe on the audio thread.
+    // -------------------------------------------------------------------------
+    template <typename T>
+    class MpscQueue {
+        static_assert(std::is_trivially_copyable_v<T>, "Queued values must be trivially copyable");
+
+    public:
+        // Capacity rounded up to a power of two. Throws std::invalid_argument on zero.
+        explicit MpscQueue(std::size_t capacity)
+            : capacity_(detail::queue_capacity(capacity)),
+              mask_(capacity_ - 1),
+              slots_(std::make_unique<Slot[]>(capacity_)) {
+            for (std::size_t i = 0; i < capacity_; i++) slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        std::size_t capacity() const noexcept { return capacity_; }
+
+        // Any thread. False if the queue is full.
+        bool try_push(const T& value) noexcept { return try_push(std::span(&value, 1)); }
+
+        // Any thread: all the values, one after the other with no other producer's in between, or none of
+        // them if they do not fit (always none for more than capacity() values).
+        bool try_push(std::span<const T> values) noexcept {
+            const std::size_t count = values.size();
+            if (count == 0) return true;
+            if (count > capacity_) return false;
+
+            // The consumer frees slots in order: if the last slot of the range is free, all of them are
+            std::size_t position = tail_.load(std::memory_order_relaxed);
+            for (;;) {
+                const std::size_t last = position + count - 1;
+                const std::size_t sequence = slots_[last & mask_].sequence.load(std::memory_order_acquire);
+                const auto lag = static_cast<std::intptr_t>(sequence - last);
+                if (lag == 0) {
+                    if (tail_.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) break;
+                } else if (lag < 0) {
+                    return false;
+                } else {
+                    position = tail_.load(std::memory_order_relaxed);
+                }
+            }
+
+            for (std::size_t i = 0; i < count; i++) {
+                Slot& slot = slots_[(position + i) & mask_];
+                slot.value = values[i];
+                slot.sequence.store(position + i + 1, std::memory_order_release);
+            }
+            return true;
+        }
+
+        // Consumer thread only. Empty if the queue is, or if the next value's producer is still writing it.
+        std::optional<T> try_pop() noexcept {
+            Slot& slot = slots_[head_ & mask_];
+            if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) return std::nullopt;
+            const T value = slot.value;
+            slot.sequence.store(head_ + capacity_, std::memory_order_release);
+            head_++;
+            return value;
+        }
+
+    private:
+        struct Slot {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        const std::size_t capacity_;
+        const std::size_t mask_;
+        const std::unique_ptr<Slot[]> slots_;
+
+        alignas(64) std::atomic<std::size_t> tail_{0}; // next position to claim, shared by the producers
+        alignas(64) std::size_t head_ = 0;             // next position to read, consumer only
+    };
+
+    // -------------------------------------------------------------------------
+    // SpscQueue: bounded queue with one producer and one consumer, wait-free.
+    // Each end owns its index and keeps a copy of the other's, refreshed only when the queue looks full
+    // (producer) or empty (consumer), so the two threads share a cache line only when they have to.
+    // Same constraints as MpscQueue: no allocation after construction, trivially copyable values.
+    // -------------------------------------------------------------------------
+    template <typename T>
+    class SpscQueue {
+        static_assert(std::is_trivially_copyable_v<T>, "Queued values must be trivially copyable");
+
+    public:
+        // Capacity rounded up to a power of two. Throws std::invalid_argument on zero.
+        explicit SpscQueue(std::size_t capacity)
+            : capacity_(detail::queue_capacity(capacity)),
+              mask_(capacity_ - 1),
+              values_(std::make_unique<T[]>(capacity_)) {}
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        std::size_t capacity() const noexcept { return capacity_; }
+
+        // Producer thread only. False if the queue is full.
+        bool try_push(const T& value) noexcept {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_cache_ == capacity_) {
+                head_cache_ = head_.load(std::memory_order_acquire);
+                if (tail - head_cache_ == capacity_) return false;
+            }
+            values_[tail & mask_] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer thread only
+        std::optional<T> try_pop() noexcept {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_cache_) {
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+                if (head == tail_cache_) return std::nullopt;
+            }
+            const T value = values_[head & mask_];
+            head_.store(head + 1, std::memory_order_release);
+            return value;
+        }
+
+    private:
+        const std::size_t capacity_;
+        const std::size_t mask_;
+        const std::unique_ptr<T[]> values_;
+
+        alignas(64) std::atomic<std::size_t> tail_{0};
+        std::size_t head_cache_ = 0;  // producer's copy of head_
+        alignas(64) std::atomic<std::size_t> head_{0};
+        std::size_t tail_cache_ = 0;  // consumer's copy of tail_
+    };
+
+} // namespace aknet::bus
+
+#endif // AKNET_QUEUES_H
@@ -0,0 +1,129 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_ROUTING_H
+#define AKNET_ROUTING_H
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <graph.h>
+
+#include "queues.h"
+
+namespace aknet::routing {
+
+    struct RoutingConfig {
+        std::uint32_t inputs = 64;
+        std::uint32_t outputs = 64;
+        double ramp_time = 0.01;   // seconds a gain change takes, rounded to whole blocks
+    };
+
+    // Counters of a matrix, read with relaxed loads
+    struct RoutingStats {
+        std::uint64_t commits = 0;        // tables compiled by commit()
+        std::uint64_t swaps = 0;          // tables the audio thread picked up
+        std::uint64_t replaced = 0;       // tables replaced by a later commit before the audio thread saw them
+        std::uint64_t crosspoints = 0;    // in the last table committed, fading ones included
+    };
+
+    // -------------------------------------------------------------------------
+    // RoutingMatrix: a node mixing its inputs into its outputs through a matrix of gains, most of them zero.
+    // The control thread sets crosspoints, then commit() compiles the active ones into a table per output
+    // row (compressed sparse rows: for each output, the inputs feeding it and their gains) and hands it to
+    // the audio thread with an atomic swap. A block costs one SIMD gain-add per active crosspoint, whatever
+    // the size of the matrix.
+    // Gains never jump: the audio thread ramps each crosspoint from the gain it plays to the new one over
+    // ramp_time, and a removed crosspoint stays in the tables, at zero, until the audio thread has played
+    // it out: commit() drops it once a table retired by the audio thread shows it faded. Tables are freed on
+    // the control thread (by the next commit, or the destructor), never on the audio thread.
+    // The methods are for one control thread; process() is the audio thread's.
+    // -------------------------------------------------------------------------
+    class RoutingMatrix : public engine::Node {
+    public:
+        // Throws std::invalid_argument on zero inputs or outputs, or a negative ramp time
+        explicit RoutingMatrix(const RoutingConfig& config = {});
+        ~RoutingMatrix() override;
+
+        const RoutingConfig& config() const noexcept { return config_; }
+
+        std::size_t input_count() const override { return config_.inputs; }
+        std::size_t output_count() const override { return config_.outputs; }
+
+        void prepare(const engine::ProcessSpec& spec) override;
+        void process(const engine::ProcessBlock& block) noexcept override;
+
+        // Set the gain of a crosspoint, linear (0 removes it). Takes effect at the next commit().
+        // Throws std::invalid_argument on a port that does not exist or a gain that is not finite.
+        void set(std::uint32_t input, std::uint32_t output, float gain);
+
+        // Remove every crosspoint (at the next commit())
+        void clear() noexcept;
+
+        // Gain of a crosspoint as last set, committed or not
+        float gain(std::uint32_t input, std::uint32_t output) const noexcept;
+
+        // Crosspoints with a gain, as last set
+        std::size_t active_count() const noexcept;
+
+        // Compile the crosspoints and hand them to the audio thread, which ramps to them from its next block.
+        // Does not wait: a table the audio thread has not picked up yet is replaced.
+        void commit();
+
+        RoutingStats stats() const noexcept;
+
+    private:
+        // A compiled crosspoint, and its ramp (audio thread's, once the table is picked up)
+        struct Entry {
+            std::uint32_t input;
+            float target;
+            float gain = 0.0f;          // playing
+            float step = 0.0f;          // per block
+            std::uint32_t remaining = 0;  // blocks of ramp left
+        };
+
+        // Output o mixes entries[rows[o], rows[o + 1]), sorted by input
+        struct Table {
+            std::uint64_t generation = 0;   // number of the commit that built it, from 1
+            std::vector<std::uint32_t> rows;
+            std::vector<Entry> entries;
+        };
+
+        // Control thread: a crosspoint as set
+        struct Crosspoint {
+            float gain = 0.0f;
+            std::uint64_t live = 0;   // generation of the last table giving it a gain, 0 if none did
+        };
+
+        // Audio thread: start the ramps of a table picked up from the gains the current one plays
+        void take_over(Table& next) const noexcept;
+
+        // Control thread: drop the removed crosspoints a retired table played out
+        void forget_faded(const Table& retired);
+
+        const RoutingConfig config_;
+        std::uint32_t ramp_blocks_ = 1;
+
+        std::map<std::uint64_t, Crosspoint> crosspoints_;   // by output << 32 | input: the rows' order
+
+        Table* current_ = nullptr;       // owned; audio thread
+        std::atomic<Table*> pending_{nullptr};
+        // From the audio thread, freed by the next commit: two tables at most retire between commits
+        bus::SpscQueue<Table*> retired_{8};
+        Table* unretired_ = nullptr;     // audio thread: retired while the queue was full
+
+        std::atomic<std::uint64_t> commits_{0};
+        std::atomic<std::uint64_t> swaps_{0};
+        std::atomic<std::uint64_t> replaced_{0};
+        std::atomic<std::uint64_t> committed_crosspoints_{0};
+    };
+
+} // namespace aknet::routing
+
+#endif // AKNET_ROUTING_H
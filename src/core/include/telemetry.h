@@ -0,0 +1,94 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_TELEMETRY_H
+#define AKNET_TELEMETRY_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "meters.h"
+
+namespace aknet::telemetry {
+
+    // -------------------------------------------------------------------------
+    // Telemetry frames: meter snapshots packed for the webview. Little-endian, as every target we build for.
+    //
+    //   offset  size  field
+    //        0     4  magic "AKTM"
+    //        4     2  version (2)
+    //        6     2  header size in bytes (40): the level codes start there
+    //        8     4  channels (n)
+    //       12     4  snapshots replaced unread since the previous frame
+    //       16     8  snapshot sequence
+    //       24     8  sample time of the first frame measured
+    //       32     4  frames measured
+    //       36     4  age of the snapshot when the frame was encoded, in microseconds
+    //       40     n  peak level codes, one byte per channel
+    //     40+n     n  true peak level codes, one byte per channel
+    //    40+2n     n  RMS level codes, one byte per channel
+    //
+    // A level code is the level in half-dB steps: code c is c / 2 - 120 dBFS, from 1 (-119.5 dBFS) up to
+    // 255 (+7.5 dBFS, the most an inter-sample peak can reach); 0 is anything at or below -120 dBFS.
+    // 512 channels make 1576 bytes, 2104 in base64.
+    // -------------------------------------------------------------------------
+
+    constexpr std::uint32_t frame_magic = 0x4D544B41; // "AKTM" in memory
+    constexpr std::uint16_t frame_version = 2;
+    constexpr std::size_t frame_header_bytes = 40;
+
+    // Linear level to its code, and back in dBFS (-infinity for code 0)
+    std::uint8_t level_code(float level) noexcept;
+    float code_db(std::uint8_t code) noexcept;
+
+    // The frame of a snapshot, into `out` (resized: no allocation once it has grown to a frame)
+    void encode_frame(const MeterSnapshot& snapshot, std::uint32_t replaced, std::int64_t now_ns,
+                      std::vector<std::uint8_t>& out);
+
+    // Standard base64 with padding, into `out` (same reuse as encode_frame)
+    void base64_encode(std::span<const std::uint8_t> bytes, std::string& out);
+
+    // Counters of a bridge, for its thread
+    struct BridgeStats {
+        std::uint64_t frames = 0;
+        std::uint64_t replaced = 0;     // snapshots the UI never saw, superseded by the next one
+        std::uint64_t bytes = 0;        // base64 sent
+    };
+
+    // -------------------------------------------------------------------------
+    // TelemetryBridge: hands the meters' latest snapshot to the webview as one base64 frame per UI tick.
+    // The webview pulls at its own frame rate (one call per animation frame), so frames never pile up in
+    // the webview: snapshots published in between are replaced by the meters, and the UI thread only
+    // encodes what it displays. saucer passes strings, hence base64 rather than an ArrayBuffer.
+    // One thread only, the UI one.
+    // -------------------------------------------------------------------------
+    class TelemetryBridge {
+    public:
+        // Throws std::invalid_argument on null meters
+        explicit TelemetryBridge(std::shared_ptr<Meters> meters);
+
+        // The latest snapshot as a base64 frame, or empty if there is nothing new since the last call.
+        // Valid until the next call.
+        std::string_view frame();
+
+        const BridgeStats& stats() const noexcept { return stats_; }
+
+    private:
+        std::shared_ptr<Meters> meters_;
+        std::vector<std::uint8_t> bytes_;
+        std::string text_;
+        std::uint64_t next_sequence_ = 0;
+        BridgeStats stats_;
+    };
+
+} // namespace aknet::telemetry
+
+#endif // AKNET_TELEMETRY_H
@@ -0,0 +1,66 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_TRIPLE_BUFFER_H
+#define AKNET_TRIPLE_BUFFER_H
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace aknet::bus {
+
+    // -------------------------------------------------------------------------
+    // TripleBuffer: the latest value of a state written by one thread and read by another, wait-free.
+    // The writer fills its back buffer and publishes it by swapping it with the middle one; the reader
+    // swaps the middle buffer with its front one when something new is there. Each side always owns a
+    // buffer, so neither ever waits or copies through the other: the writer simply replaces a value the
+    // reader has not taken yet. Buffers are allocated once (T may hold vectors sized up front).
+    // -------------------------------------------------------------------------
+    template <typename T>
+    class TripleBuffer {
+    public:
+        // The three buffers start as copies of `initial`
+        explicit TripleBuffer(const T& initial = {}) : buffers_{initial, initial, initial} {}
+
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        // Writer: the buffer to fill, then publish(). Holds whatever was in it before, not the last value.
+        T& write_buffer() noexcept { return buffers_[back_]; }
+
+        // Writer: make the write buffer the latest value
+        void publish() noexcept {
+            back_ = middle_.exchange(back_ | fresh, std::memory_order_acq_rel) & index_mask;
+        }
+
+        // Writer: the last value published has not been taken by the reader yet (the reader may take it
+        // right after this returns)
+        bool unread() const noexcept { return middle_.load(std::memory_order_relaxed) & fresh; }
+
+        // Reader: take the latest value if there is a new one. True if read_buffer() changed.
+        bool update() noexcept {
+            if (!(middle_.load(std::memory_order_relaxed) & fresh)) return false;
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & index_mask;
+            return true;
+        }
+
+        // Reader: the value taken by the last update()
+        const T& read_buffer() const noexcept { return buffers_[front_]; }
+
+    private:
+        static constexpr std::uint8_t index_mask = 0x3;
+        static constexpr std::uint8_t fresh = 0x4;  // the middle buffer holds a value the reader has not taken
+
+        std::array<T, 3> buffers_;
+        alignas(64) std::atomic<std::uint8_t> middle_{1};
+        alignas(64) std::uint8_t back_ = 0;   // writer only
+        alignas(64) std::uint8_t front_ = 2;  // reader only
+    };
+
+} // namespace aknet::bus
+
+#endif // AKNET_TRIPLE_BUFFER_H
@@ -5,6 +5,9 @@
 #include "core.h"
 #include <version.h>
 
+#include <type_traits>
+#include <variant>
+
 namespace aknet {
 
     // Constructor
@@ -20,8 +23,21 @@ namespace aknet {
         log_aknet_start_message();
         logger_->info("Initializing Core...");
 
-        // Future: create owned modules here
-        // module_a_ = std::make_unique<ModuleA>();
+        // Create owned modules
+        buffers_ = std::make_unique<pool::BufferPool>(config.buffers);
+        logger_->info("Buffer pool: {} buffers of {} bytes", config.buffers.buffers, buffers_->stats().buffer_bytes);
+        bus_ = std::make_unique<bus::MessageBus>(config.bus);
+        engine_ = std::make_unique<engine::Engine>(config.engine);
+        engine_->set_block_hook([this](std::uint64_t sample_time) { apply_commands(sample_time); });
+
+        meters_ = std::make_shared<telemetry::Meters>(config.meters);
+        telemetry_ = std::make_unique<telemetry::TelemetryBridge>(meters_);
+        routing_ = std::make_shared<routing::RoutingMatrix>(config.routing);
+        engine::GraphBuilder graph;
+        graph.add(routing_);
+        graph.add(meters_);
+        engine_->publish(graph.build(engine_->spec()));
+        engine_->start();
 
         logger_->info("Initializing Core: Done.");
     }
@@ -30,7 +46,13 @@ namespace aknet {
     core::~core() {
         logger_->info("Core shutting down...");
 
-        // 1. Future: modules are destroyed automatically (unique_ptr, reverse order)
+        // 1. Destroy owned modules (reverse order of creation)
+        engine_.reset();
+        routing_.reset();
+        telemetry_.reset();
+        meters_.reset();
+        bus_.reset();
+        buffers_.reset();
 
         // 2. Release our logger before shutting down logging system
         logger_.reset();
@@ -39,8 +61,16 @@ namespace aknet {
         log::shutdown();
     }
 
-    void core::test_function() {
-        logger_->info("Core test function called");
+    void core::apply_commands(std::uint64_t sample_time) noexcept {
+        bus_->drain([&](const bus::Command& command) {
+            std::visit([&]<typename T>(const T& c) {
+                if constexpr (std::is_same_v<T, bus::command::Ping>) {
+                    bus_->emit(bus::event::Pong{.id = c.id, .sent_ns = c.sent_ns, .sample_time = sample_time});
+                } else if constexpr (std::is_same_v<T, bus::command::TestMessage>) {
+                    bus_->emit(bus::event::TestMessage{.sample_time = sample_time});
+                }
+            }, command);
+        });
     }
 
     void core::log_aknet_start_message() {
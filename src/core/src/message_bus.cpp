@@ -0,0 +1,69 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "message_bus.h"
+
+#include <counters.h>
+
+#include <stdexcept>
+
+namespace aknet::bus {
+
+    namespace {
+        MessageBusConfig validated(const MessageBusConfig& config) {
+            if (config.command_capacity == 0 || config.event_capacity == 0 || config.max_batch == 0) {
+                throw std::invalid_argument("Message bus capacities and batch size must not be zero");
+            }
+            return config;
+        }
+    }
+
+    MessageBus::MessageBus(const MessageBusConfig& config)
+        : config_(validated(config)),
+          commands_(config.command_capacity),
+          events_(config.event_capacity) {}
+
+    bool MessageBus::post(const Command& command) noexcept {
+        return post(std::span(&command, 1));
+    }
+
+    bool MessageBus::post(std::span<const Command> commands) noexcept {
+        if (!commands_.try_push(commands)) {
+            commands_dropped_.fetch_add(commands.size(), std::memory_order_relaxed);
+            return false;
+        }
+        commands_posted_.fetch_add(commands.size(), std::memory_order_relaxed);
+        return true;
+    }
+
+    bool MessageBus::emit(const Event& event) noexcept {
+        if (!events_.try_push(event)) {
+            bump(events_dropped_);
+            return false;
+        }
+        bump(events_emitted_);
+        return true;
+    }
+
+    void MessageBus::record_batch(std::size_t count) noexcept {
+        bump(commands_applied_, count);
+        bump(batches_);
+        if (count > largest_batch_.load(std::memory_order_relaxed)) {
+            largest_batch_.store(count, std::memory_order_relaxed);
+        }
+    }
+
+    MessageBusStats MessageBus::stats() const noexcept {
+        return {
+            .commands_posted = commands_posted_.load(std::memory_order_relaxed),
+            .commands_dropped = commands_dropped_.load(std::memory_order_relaxed),
+            .commands_applied = commands_applied_.load(std::memory_order_relaxed),
+            .batches = batches_.load(std::memory_order_relaxed),
+            .largest_batch = largest_batch_.load(std::memory_order_relaxed),
+            .events_emitted = events_emitted_.load(std::memory_order_relaxed),
+            .events_dropped = events_dropped_.load(std::memory_order_relaxed),
+        };
+    }
+
+} // namespace aknet::bus
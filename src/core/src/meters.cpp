@@ -0,0 +1,102 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "meters.h"
+
+#include <kernels.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace aknet::telemetry {
+
+    namespace {
+        constexpr std::size_t history = kernels::true_peak_history;
+
+        // Levels below -140 dBFS, under the lowest one the UI shows, are flushed to zero rather than left to
+        // fall into denormals
+        constexpr float silence = 1e-7f;
+
+        MeterConfig validated(const MeterConfig& config) {
+            if (config.channels == 0) throw std::invalid_argument("Meters need at least one channel");
+            if (!(config.publish_rate > 0)) throw std::invalid_argument("Meter publish rate must be positive");
+            if (!(config.peak_fall >= 0)) throw std::invalid_argument("Meter peak fall must not be negative");
+            if (!(config.rms_time > 0)) throw std::invalid_argument("Meter RMS time must be positive");
+            return config;
+        }
+
+        MeterSnapshot empty_snapshot(std::uint32_t channels) {
+            return {.peak = std::vector<float>(channels), .true_peak = std::vector<float>(channels),
+                    .rms = std::vector<float>(channels)};
+        }
+    }
+
+    Meters::Meters(const MeterConfig& config)
+        : config_(validated(config)),
+          peak_(config_.channels),
+          true_peak_(config_.channels),
+          mean_square_(config_.channels),
+          snapshots_(empty_snapshot(config_.channels)) {}
+
+    void Meters::prepare(const engine::ProcessSpec& spec) {
+        const double blocks = spec.sample_rate / (config_.publish_rate * spec.block_size);
+        blocks_per_snapshot_ = std::max<std::uint32_t>(1, static_cast<std::uint32_t>(std::lround(blocks)));
+
+        const double block_seconds = static_cast<double>(spec.block_size) / spec.sample_rate;
+        peak_fall_ = static_cast<float>(std::pow(10.0, -config_.peak_fall * block_seconds / 20.0));
+        rms_weight_ = static_cast<float>(-std::expm1(-block_seconds / config_.rms_time));
+
+        history_stride_ = history + spec.block_size;
+        history_.assign(history_stride_ * config_.channels, 0.0f);
+    }
+
+    void Meters::process(const engine::ProcessBlock& block) noexcept {
+        if (frames_ == 0) first_sample_ = block.sample_time;
+        const std::size_t frames = block.frames;
+
+        for (std::size_t c = 0; c < config_.channels; c++) {
+            const float* in = block.inputs[c];
+
+            // The filter reads the previous block's last samples: the block is filtered behind them, then
+            // its own last ones are kept for the next
+            float* h = history_.data() + history_stride_ * c;
+            std::copy_n(in, frames, h + history);
+            const float true_peak = kernels::true_peak(h + history, frames);
+            if (frames > 0) std::copy(h + frames, h + frames + history, h);
+
+            const float peak = kernels::peak(in, frames);
+            const float mean_square = frames > 0 ? kernels::dot(in, in, frames) / static_cast<float>(frames) : 0.0f;
+
+            peak_[c] = std::max(peak_[c] * peak_fall_, peak);
+            if (peak_[c] < silence) peak_[c] = 0.0f;
+            // Sample peaks are inter-sample ones too: the filter's ripple must not show a true peak below them
+            true_peak_[c] = std::max(true_peak_[c] * peak_fall_, std::max(true_peak, peak));
+            if (true_peak_[c] < silence) true_peak_[c] = 0.0f;
+            mean_square_[c] += rms_weight_ * (mean_square - mean_square_[c]);
+            if (mean_square_[c] < silence * silence) mean_square_[c] = 0.0f;
+        }
+        frames_ += frames;
+
+        if (++blocks_ >= blocks_per_snapshot_) publish();
+    }
+
+    void Meters::publish() noexcept {
+        MeterSnapshot& snapshot = snapshots_.write_buffer();
+        std::ranges::copy(peak_, snapshot.peak.begin());
+        std::ranges::copy(true_peak_, snapshot.true_peak.begin());
+        std::ranges::transform(mean_square_, snapshot.rms.begin(), [](float m) { return std::sqrt(m); });
+        snapshot.sequence = sequence_++;
+        snapshot.sample_time = first_sample_;
+        snapshot.frames = frames_;
+        snapshot.published_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch()).count();
+        snapshots_.publish();
+
+        frames_ = 0;
+        blocks_ = 0;
+    }
+
+} // namespace aknet::telemetry
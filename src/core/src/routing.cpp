@@ -0,0 +1,189 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "routing.h"
+
+#include <counters.h>
+#include <kernels.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace aknet::routing {
+
+    namespace {
+        std::uint64_t key(std::uint32_t input, std::uint32_t output) noexcept {
+            return std::uint64_t{output} << 32 | input;
+        }
+
+        RoutingConfig validated(const RoutingConfig& config) {
+            if (config.inputs == 0 || config.outputs == 0) {
+                throw std::invalid_argument("Routing matrix needs at least one input and one output");
+            }
+            if (!(config.ramp_time >= 0)) throw std::invalid_argument("Routing ramp time must not be negative");
+            return config;
+        }
+    }
+
+    RoutingMatrix::RoutingMatrix(const RoutingConfig& config)
+        : config_(validated(config)) {}
+
+    RoutingMatrix::~RoutingMatrix() {
+        delete current_;
+        delete pending_.exchange(nullptr);
+        delete unretired_;
+        while (const auto table = retired_.try_pop()) delete *table;
+    }
+
+    void RoutingMatrix::prepare(const engine::ProcessSpec& spec) {
+        const double blocks = config_.ramp_time * spec.sample_rate / spec.block_size;
+        ramp_blocks_ = std::max<std::uint32_t>(1, static_cast<std::uint32_t>(std::lround(blocks)));
+    }
+
+    void RoutingMatrix::set(std::uint32_t input, std::uint32_t output, float gain) {
+        if (input >= config_.inputs || output >= config_.outputs) {
+            throw std::invalid_argument("Crosspoint out of the routing matrix");
+        }
+        if (!std::isfinite(gain)) throw std::invalid_argument("Crosspoint gain must be finite");
+
+        const auto it = crosspoints_.find(key(input, output));
+        if (it == crosspoints_.end()) {
+            if (gain != 0.0f) crosspoints_.emplace(key(input, output), Crosspoint{.gain = gain});
+            return;
+        }
+        // Never committed with a gain: nothing to fade
+        if (gain == 0.0f && it->second.live == 0) {
+            crosspoints_.erase(it);
+            return;
+        }
+        it->second.gain = gain;
+    }
+
+    void RoutingMatrix::clear() noexcept {
+        for (auto& [key, crosspoint] : crosspoints_) crosspoint.gain = 0.0f;
+        std::erase_if(crosspoints_, [](const auto& entry) { return entry.second.live == 0; });
+    }
+
+    float RoutingMatrix::gain(std::uint32_t input, std::uint32_t output) const noexcept {
+        const auto it = crosspoints_.find(key(input, output));
+        return it == crosspoints_.end() ? 0.0f : it->second.gain;
+    }
+
+    std::size_t RoutingMatrix::active_count() const noexcept {
+        return static_cast<std::size_t>(std::ranges::count_if(crosspoints_, [](const auto& entry) {
+            return entry.second.gain != 0.0f;
+        }));
+    }
+
+    void RoutingMatrix::commit() {
+        // Free the tables the audio thread is done with, dropping what they faded out
+        while (const auto retired = retired_.try_pop()) {
+            const std::unique_ptr<Table> table(*retired);
+            forget_faded(*table);
+        }
+
+        // The crosspoints in row order; removed ones at zero until the audio thread has faded them out
+        auto table = std::make_unique<Table>();
+        table->generation = commits_.load(std::memory_order_relaxed) + 1;
+        table->rows.assign(config_.outputs + 1, 0);
+        table->entries.reserve(crosspoints_.size());
+        for (auto& [key, crosspoint] : crosspoints_) {
+            if (crosspoint.gain != 0.0f) crosspoint.live = table->generation;
+            table->rows[(key >> 32) + 1]++;
+            table->entries.push_back({.input = static_cast<std::uint32_t>(key), .target = crosspoint.gain});
+        }
+        std::partial_sum(table->rows.begin(), table->rows.end(), table->rows.begin());
+
+        committed_crosspoints_.store(table->entries.size(), std::memory_order_relaxed);
+        bump(commits_);
+        if (Table* unseen = pending_.exchange(table.release(), std::memory_order_acq_rel)) {
+            delete unseen;
+            bump(replaced_);
+        }
+    }
+
+    RoutingStats RoutingMatrix::stats() const noexcept {
+        return {
+            .commits = commits_.load(std::memory_order_relaxed),
+            .swaps = swaps_.load(std::memory_order_relaxed),
+            .replaced = replaced_.load(std::memory_order_relaxed),
+            .crosspoints = committed_crosspoints_.load(std::memory_order_relaxed),
+        };
+    }
+
+    void RoutingMatrix::forget_faded(const Table& retired) {
+        // An entry at rest at zero has been played out. The crosspoint goes if it is still removed and no
+        // later table gave it a gain back: those all took over its zero, and play it at zero.
+        for (std::uint32_t o = 0; o < config_.outputs; o++) {
+            for (auto e = retired.rows[o]; e < retired.rows[o + 1]; e++) {
+                const Entry& entry = retired.entries[e];
+                if (entry.target != 0.0f || entry.remaining != 0) continue;
+                const auto it = crosspoints_.find(key(entry.input, o));
+                if (it != crosspoints_.end() && it->second.gain == 0.0f && it->second.live <= retired.generation) {
+                    crosspoints_.erase(it);
+                }
+            }
+        }
+    }
+
+    void RoutingMatrix::take_over(Table& next) const noexcept {
+        const auto start = [&](Entry& entry, float gain) {
+            entry.gain = gain;
+            entry.remaining = gain == entry.target ? 0 : ramp_blocks_;
+            entry.step = (entry.target - gain) / static_cast<float>(ramp_blocks_);
+        };
+
+        if (!current_) {
+            for (auto& entry : next.entries) start(entry, 0.0f);
+            return;
+        }
+
+        // Both rows are sorted by input: one pass over each
+        for (std::uint32_t o = 0; o < config_.outputs; o++) {
+            auto old = current_->entries.begin() + current_->rows[o];
+            const auto old_end = current_->entries.begin() + current_->rows[o + 1];
+            for (auto e = next.rows[o]; e < next.rows[o + 1]; e++) {
+                Entry& entry = next.entries[e];
+                while (old != old_end && old->input < entry.input) ++old;
+                start(entry, old != old_end && old->input == entry.input ? old->gain : 0.0f);
+            }
+        }
+    }
+
+    void RoutingMatrix::process(const engine::ProcessBlock& block) noexcept {
+        // A table retired while the queue was full goes back first: no swap until it has
+        if (unretired_ && retired_.try_push(unretired_)) unretired_ = nullptr;
+
+        // Pick up a committed table; only commit() replaces it, so once seen it stays until taken
+        if (!unretired_ && pending_.load(std::memory_order_relaxed)) {
+            Table* next = pending_.exchange(nullptr, std::memory_order_acquire);
+            take_over(*next);
+            if (current_ && !retired_.try_push(current_)) unretired_ = current_;
+            current_ = next;
+            bump(swaps_);
+        }
+
+        const std::size_t frames = block.frames;
+        for (std::uint32_t o = 0; o < config_.outputs; o++) {
+            float* out = block.outputs[o];
+            std::fill_n(out, frames, 0.0f);
+            if (!current_) continue;
+
+            for (auto e = current_->rows[o]; e < current_->rows[o + 1]; e++) {
+                Entry& entry = current_->entries[e];
+                const float* in = block.inputs[entry.input];
+                if (entry.remaining > 0) {
+                    const float to = --entry.remaining == 0 ? entry.target : entry.gain + entry.step;
+                    kernels::mix_add_ramp(out, in, frames, entry.gain, to);
+                    entry.gain = to;
+                } else if (entry.gain != 0.0f) {
+                    kernels::mix_add(out, in, frames, entry.gain);
+                }
+            }
+        }
+    }
+
+} // namespace aknet::routing
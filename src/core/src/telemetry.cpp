@@ -0,0 +1,108 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace aknet::telemetry {
+
+    namespace {
+        constexpr float floor_db = -120.0f;
+
+        template <typename T>
+        void put(std::uint8_t* out, std::size_t offset, T value) noexcept {
+            std::memcpy(out + offset, &value, sizeof(T));
+        }
+    }
+
+    std::uint8_t level_code(float level) noexcept {
+        const float db = 20.0f * std::log10(level);
+        if (!(db > floor_db)) return 0;
+        return static_cast<std::uint8_t>(std::clamp(std::lround(2.0f * (db - floor_db)), 1l, 255l));
+    }
+
+    float code_db(std::uint8_t code) noexcept {
+        return code == 0 ? -std::numeric_limits<float>::infinity() : code / 2.0f + floor_db;
+    }
+
+    void encode_frame(const MeterSnapshot& snapshot, std::uint32_t replaced, std::int64_t now_ns,
+                      std::vector<std::uint8_t>& out) {
+        const auto channels = static_cast<std::uint32_t>(snapshot.peak.size());
+        out.resize(frame_header_bytes + 3 * std::size_t{channels});
+
+        const auto age_us = std::clamp<std::int64_t>((now_ns - snapshot.published_ns) / 1000, 0,
+                                                     std::numeric_limits<std::uint32_t>::max());
+        std::uint8_t* p = out.data();
+        put(p, 0, frame_magic);
+        put(p, 4, frame_version);
+        put(p, 6, static_cast<std::uint16_t>(frame_header_bytes));
+        put(p, 8, channels);
+        put(p, 12, replaced);
+        put(p, 16, snapshot.sequence);
+        put(p, 24, snapshot.sample_time);
+        put(p, 32, static_cast<std::uint32_t>(std::min<std::uint64_t>(snapshot.frames, std::numeric_limits<std::uint32_t>::max())));
+        put(p, 36, static_cast<std::uint32_t>(age_us));
+
+        std::uint8_t* peak = p + frame_header_bytes;
+        std::uint8_t* true_peak = peak + channels;
+        std::uint8_t* rms = true_peak + channels;
+        for (std::uint32_t c = 0; c < channels; c++) {
+            peak[c] = level_code(snapshot.peak[c]);
+            true_peak[c] = level_code(snapshot.true_peak[c]);
+            rms[c] = level_code(snapshot.rms[c]);
+        }
+    }
+
+    void base64_encode(std::span<const std::uint8_t> bytes, std::string& out) {
+        static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        out.resize((bytes.size() + 2) / 3 * 4);
+
+        char* o = out.data();
+        std::size_t i = 0;
+        for (; i + 3 <= bytes.size(); i += 3) {
+            const std::uint32_t v = std::uint32_t{bytes[i]} << 16 | std::uint32_t{bytes[i + 1]} << 8 | bytes[i + 2];
+            *o++ = alphabet[v >> 18 & 0x3f];
+            *o++ = alphabet[v >> 12 & 0x3f];
+            *o++ = alphabet[v >> 6 & 0x3f];
+            *o++ = alphabet[v & 0x3f];
+        }
+        if (const std::size_t rest = bytes.size() - i; rest > 0) {
+            const std::uint32_t v = std::uint32_t{bytes[i]} << 16 | (rest == 2 ? std::uint32_t{bytes[i + 1]} << 8 : 0);
+            *o++ = alphabet[v >> 18 & 0x3f];
+            *o++ = alphabet[v >> 12 & 0x3f];
+            *o++ = rest == 2 ? alphabet[v >> 6 & 0x3f] : '=';
+            *o++ = '=';
+        }
+    }
+
+    TelemetryBridge::TelemetryBridge(std::shared_ptr<Meters> meters) : meters_(std::move(meters)) {
+        if (!meters_) throw std::invalid_argument("Telemetry bridge needs meters");
+    }
+
+    std::string_view TelemetryBridge::frame() {
+        if (!meters_->update()) return {};
+
+        const MeterSnapshot& snapshot = meters_->snapshot();
+        const auto replaced = static_cast<std::uint32_t>(snapshot.sequence - next_sequence_);
+        next_sequence_ = snapshot.sequence + 1;
+
+        const auto now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch()).count();
+        encode_frame(snapshot, replaced, now_ns, bytes_);
+        base64_encode(bytes_, text_);
+
+        stats_.frames++;
+        stats_.replaced += replaced;
+        stats_.bytes += text_.size();
+        return text_;
+    }
+
+} // namespace aknet::telemetry
@@ -5,5 +5,732 @@
 #include <catch2/catch_test_macros.hpp>
 #include <core.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
 using namespace aknet;
+namespace fs = std::filesystem;
+
+namespace {
+
+    template <typename Predicate>
+    bool eventually(Predicate predicate) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    // A value tagged with its producer, to check the order per producer
+    struct Tagged {
+        std::uint32_t producer = 0;
+        std::uint32_t sequence = 0;
+    };
+
+} // namespace
+
+TEST_CASE("Core | Queues", "[core]") {
+
+    SECTION("the MPSC queue keeps the order, fails when full and rounds its capacity up") {
+        bus::MpscQueue<int> queue(5);
+        REQUIRE(queue.capacity() == 8);
+        for (int i = 0; i < 8; i++) REQUIRE(queue.try_push(i));
+        REQUIRE_FALSE(queue.try_push(8));
+
+        for (int i = 0; i < 8; i++) REQUIRE(queue.try_pop() == i);
+        REQUIRE_FALSE(queue.try_pop());
+
+        // Several laps
+        for (int i = 0; i < 100; i++) {
+            REQUIRE(queue.try_push(i));
+            REQUIRE(queue.try_pop() == i);
+        }
+
+        REQUIRE_THROWS_AS(bus::MpscQueue<int>(0), std::invalid_argument);
+    }
+
+    SECTION("batches go in whole or not at all") {
+        bus::MpscQueue<int> queue(8);
+        const std::array batch = {1, 2, 3, 4, 5};
+        REQUIRE(queue.try_push(std::span<const int>(batch)));
+        REQUIRE_FALSE(queue.try_push(std::span<const int>(batch)));
+        REQUIRE(queue.try_push(std::span<const int>(batch).first(3)));
+
+        const std::vector<int> too_many(9, 0);
+        REQUIRE(queue.try_pop() == 1);
+        REQUIRE_FALSE(queue.try_push(std::span<const int>(too_many)));
+
+        for (int expected : {2, 3, 4, 5, 1, 2, 3}) REQUIRE(queue.try_pop() == expected);
+        REQUIRE_FALSE(queue.try_pop());
+    }
+
+    SECTION("the MPSC queue takes every value from concurrent producers, in order per producer") {
+        constexpr std::uint32_t producers = 4;
+        constexpr std::uint32_t per_producer = 50000;
+        bus::MpscQueue<Tagged> queue(256);
+
+        std::vector<std::jthread> threads;
+        for (std::uint32_t p = 0; p < producers; p++) {
+            threads.emplace_back([&queue, p] {
+                std::uint32_t i = 0;
+                while (i < per_producer) {
+                    // Every other push is a batch of two
+                    const std::array batch = {Tagged{p, i}, Tagged{p, i + 1}};
+                    if (i % 4 == 0 && i + 1 < per_producer) {
+                        if (queue.try_push(std::span<const Tagged>(batch))) i += 2;
+                    } else if (queue.try_push(Tagged{p, i})) {
+                        i++;
+                    }
+                }
+            });
+        }
+
+        std::array<std::uint32_t, producers> next{};
+        std::uint64_t received = 0;
+        bool ordered = true;
+        while (received < std::uint64_t{producers} * per_producer) {
+            if (const auto value = queue.try_pop()) {
+                ordered &= value->sequence == next[value->producer];
+                next[value->producer] = value->sequence + 1;
+                received++;
+            }
+        }
+        threads.clear();
+
+        REQUIRE(ordered);
+        REQUIRE_FALSE(queue.try_pop());
+    }
+
+    SECTION("the SPSC queue keeps the order and fails when full") {
+        bus::SpscQueue<int> queue(4);
+        for (int i = 0; i < 4; i++) REQUIRE(queue.try_push(i));
+        REQUIRE_FALSE(queue.try_push(4));
+        REQUIRE(queue.try_pop() == 0);
+        REQUIRE(queue.try_push(4));
+        for (int i = 1; i <= 4; i++) REQUIRE(queue.try_pop() == i);
+        REQUIRE_FALSE(queue.try_pop());
+
+        constexpr int count = 200000;
+        std::jthread producer([&queue] {
+            for (int i = 0; i < count;) {
+                if (queue.try_push(i)) i++;
+            }
+        });
+        bool ordered = true;
+        for (int i = 0; i < count;) {
+            if (const auto value = queue.try_pop()) ordered &= *value == i++;
+        }
+        REQUIRE(ordered);
+    }
+}
+
+TEST_CASE("Core | Message bus", "[core]") {
+
+    SECTION("commands are applied in batches of at most max_batch") {
+        bus::MessageBus bus({.command_capacity = 16, .event_capacity = 4, .max_batch = 3});
+        for (std::uint64_t i = 0; i < 5; i++) REQUIRE(bus.post(bus::command::Ping{.id = i}));
+
+        std::vector<std::uint64_t> applied;
+        const auto apply = [&](const bus::Command& command) {
+            applied.push_back(std::get<bus::command::Ping>(command).id);
+        };
+        REQUIRE(bus.drain(apply) == 3);
+        REQUIRE(bus.drain(apply) == 2);
+        REQUIRE(bus.drain(apply) == 0);
+        REQUIRE(applied == std::vector<std::uint64_t>{0, 1, 2, 3, 4});
+
+        const auto stats = bus.stats();
+        REQUIRE(stats.commands_posted == 5);
+        REQUIRE(stats.commands_applied == 5);
+        REQUIRE(stats.batches == 2);
+        REQUIRE(stats.largest_batch == 3);
+    }
+
+    SECTION("full queues drop and count, on both sides") {
+        bus::MessageBus bus({.command_capacity = 2, .event_capacity = 2});
+        const std::array<bus::Command, 3> commands = {bus::command::TestMessage{}, bus::command::TestMessage{},
+                                                     bus::command::TestMessage{}};
+        REQUIRE_FALSE(bus.post(commands));
+        REQUIRE(bus.post(std::span(commands).first(2)));
+        REQUIRE_FALSE(bus.post(bus::command::TestMessage{}));
+
+        for (std::uint64_t t : {0, 64, 128}) bus.emit(bus::event::TestMessage{.sample_time = t});
+        std::vector<std::uint64_t> times;
+        REQUIRE(bus.poll([&](const bus::Event& event) {
+            times.push_back(std::get<bus::event::TestMessage>(event).sample_time);
+        }) == 2);
+        REQUIRE(times == std::vector<std::uint64_t>{0, 64});
+
+        const auto stats = bus.stats();
+        REQUIRE(stats.commands_posted == 2);
+        REQUIRE(stats.commands_dropped == 4);
+        REQUIRE(stats.events_emitted == 2);
+        REQUIRE(stats.events_dropped == 1);
+    }
+
+    SECTION("invalid configurations throw") {
+        REQUIRE_THROWS_AS(bus::MessageBus({.command_capacity = 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(bus::MessageBus({.event_capacity = 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(bus::MessageBus({.max_batch = 0}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Core | Telemetry", "[core]") {
+
+    // Runs meters on blocks of 64 frames at 48 kHz, each channel a constant
+    struct MeterRun {
+        std::shared_ptr<telemetry::Meters> meters;
+        std::uint64_t sample_time = 0;
+
+        void blocks(std::size_t count, const std::vector<float>& levels) {
+            std::vector<std::vector<float>> buffers;
+            std::vector<const float*> inputs;
+            for (const float level : levels) buffers.emplace_back(64, level);
+            for (const auto& buffer : buffers) inputs.push_back(buffer.data());
+            for (std::size_t b = 0; b < count; b++) {
+                meters->process({.inputs = inputs, .outputs = {}, .frames = 64, .sample_time = sample_time});
+                sample_time += 64;
+            }
+        }
+    };
+
+    SECTION("the triple buffer hands over the latest value and never a torn one") {
+        bus::TripleBuffer<int> buffer(0);
+        REQUIRE_FALSE(buffer.update());
+        buffer.write_buffer() = 1;
+        buffer.publish();
+        REQUIRE(buffer.unread());
+        buffer.write_buffer() = 2;
+        buffer.publish();
+        REQUIRE(buffer.update());
+        REQUIRE(buffer.read_buffer() == 2);
+        REQUIRE_FALSE(buffer.unread());
+        REQUIRE_FALSE(buffer.update());
+        REQUIRE(buffer.read_buffer() == 2);
+
+        // Every value written holds the same number everywhere: a reader seeing two differ saw a torn one
+        bus::TripleBuffer<std::array<std::uint64_t, 64>> values;
+        std::atomic<bool> done{false};
+        std::jthread writer([&] {
+            for (std::uint64_t n = 1; n <= 200000; n++) {
+                values.write_buffer().fill(n);
+                values.publish();
+            }
+            done = true;
+        });
+        bool whole = true;
+        bool increasing = true;
+        std::uint64_t last = 0;
+        while (!done) {
+            if (!values.update()) continue;
+            const auto& value = values.read_buffer();
+            whole &= std::ranges::all_of(value, [&](std::uint64_t v) { return v == value[0]; });
+            increasing &= value[0] > last;
+            last = value[0];
+        }
+        REQUIRE(whole);
+        REQUIRE(increasing);
+    }
+
+    SECTION("meters publish the levels of each channel at the publish rate") {
+        MeterRun run{std::make_shared<telemetry::Meters>(telemetry::MeterConfig{.channels = 2, .publish_rate = 375})};
+        run.meters->prepare({.sample_rate = 48000, .block_size = 64});
+
+        // 375 per second: one snapshot every 2 blocks
+        run.blocks(1, {0.5f, -0.25f});
+        REQUIRE_FALSE(run.meters->update());
+        run.blocks(1, {0.5f, -0.25f});
+        REQUIRE(run.meters->update());
+
+        const auto& snapshot = run.meters->snapshot();
+        REQUIRE(snapshot.sequence == 0);
+        REQUIRE(snapshot.sample_time == 0);
+        REQUIRE(snapshot.frames == 128);
+        REQUIRE(snapshot.peak == std::vector<float>{0.5f, 0.25f});
+        // The step from silence rings a little between samples
+        REQUIRE(snapshot.true_peak[0] >= 0.5f);
+        REQUIRE(snapshot.true_peak[0] < 0.6f);
+        // Still rising: 128 frames are a few percent of the time constant
+        REQUIRE(snapshot.rms[0] > 0.0f);
+        REQUIRE(snapshot.rms[0] < 0.25f);
+
+        // Each snapshot covers the blocks since the previous one
+        run.blocks(2, {0.1f, 0.0f});
+        REQUIRE(run.meters->update());
+        REQUIRE(run.meters->snapshot().sample_time == 128);
+        REQUIRE(run.meters->snapshot().frames == 128);
+
+        // A few seconds of a constant: the average is there, the peaks have fallen to it
+        run.blocks(3000, {0.1f, 0.0f});
+        REQUIRE(run.meters->update());
+        REQUIRE(std::abs(run.meters->snapshot().rms[0] - 0.1f) < 1e-4f);
+        REQUIRE(run.meters->snapshot().peak[0] == 0.1f);
+    }
+
+    SECTION("peaks fall at the peak fall rate, the RMS level follows its time constant") {
+        MeterRun run{std::make_shared<telemetry::Meters>(
+            telemetry::MeterConfig{.channels = 1, .publish_rate = 750, .peak_fall = 20, .rms_time = 0.3})};
+        run.meters->prepare({.sample_rate = 48000, .block_size = 64});
+
+        // 0.3 s of full scale: 1 - 1/e of the energy
+        run.blocks(225, {1.0f});
+        REQUIRE(run.meters->update());
+        REQUIRE(std::abs(run.meters->snapshot().rms[0] - std::sqrt(1.0f - std::exp(-1.0f))) < 1e-3f);
+
+        // The edge to silence rings between samples, above full scale
+        run.blocks(1, {0.0f});
+        REQUIRE(run.meters->update());
+        const float peak = run.meters->snapshot().peak[0];
+        const float true_peak = run.meters->snapshot().true_peak[0];
+        REQUIRE(true_peak > 1.0f);
+
+        // A second of silence: 20 dB down
+        run.blocks(750, {0.0f});
+        REQUIRE(run.meters->update());
+        REQUIRE(std::abs(run.meters->snapshot().peak[0] - 0.1f * peak) < 1e-5f);
+        REQUIRE(std::abs(run.meters->snapshot().true_peak[0] - 0.1f * true_peak) < 1e-5f);
+
+        // Long after, below anything shown: zero rather than denormals
+        run.blocks(9000, {0.0f});
+        REQUIRE(run.meters->update());
+        REQUIRE(run.meters->snapshot().peak[0] == 0.0f);
+        REQUIRE(run.meters->snapshot().true_peak[0] == 0.0f);
+        REQUIRE(run.meters->snapshot().rms[0] == 0.0f);
+
+        REQUIRE_THROWS_AS(telemetry::Meters({.channels = 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(telemetry::Meters({.publish_rate = 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(telemetry::Meters({.peak_fall = -1}), std::invalid_argument);
+        REQUIRE_THROWS_AS(telemetry::Meters({.rms_time = 0}), std::invalid_argument);
+    }
+
+    SECTION("a snapshot the UI missed still shows in the next one") {
+        MeterRun run{std::make_shared<telemetry::Meters>(telemetry::MeterConfig{.channels = 1, .publish_rate = 750})};
+        run.meters->prepare({.sample_rate = 48000, .block_size = 64});
+
+        run.blocks(1, {1.0f});
+        run.blocks(3, {0.0f});
+        REQUIRE(run.meters->update());
+
+        const auto& snapshot = run.meters->snapshot();
+        REQUIRE(snapshot.sequence == 3);
+        REQUIRE(snapshot.sample_time == 192);
+        REQUIRE(snapshot.frames == 64);
+        // Three blocks of fall: 0.08 dB
+        REQUIRE(snapshot.peak[0] < 1.0f);
+        REQUIRE(snapshot.peak[0] > 0.99f);
+
+        // Held for good without a fall
+        MeterRun held{std::make_shared<telemetry::Meters>(telemetry::MeterConfig{.channels = 1, .peak_fall = 0})};
+        held.meters->prepare({.sample_rate = 48000, .block_size = 64});
+        held.blocks(1, {1.0f});
+        held.blocks(1000, {0.0f});
+        REQUIRE(held.meters->update());
+        REQUIRE(held.meters->snapshot().peak[0] == 1.0f);
+    }
+
+    SECTION("true peaks see between samples, across blocks of any size") {
+        // A quarter of the sample rate, 45 degrees off the samples: they all sit at 0.707 of the wave's peak
+        std::vector<float> sine(1024);
+        for (std::size_t i = 0; i < sine.size(); i++) {
+            sine[i] = static_cast<float>(std::sin(std::numbers::pi / 2 * static_cast<double>(i) + std::numbers::pi / 4));
+        }
+        std::vector<float> noise(1024);
+        std::uint32_t state = 1;
+        for (auto& s : noise) {
+            state = state * 1664525u + 1013904223u;
+            s = static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+        }
+
+        // Held peaks: the largest over everything, whatever the block size
+        const auto true_peaks = [&](std::uint32_t block_size) {
+            telemetry::Meters meters({.channels = 2, .publish_rate = 1e6, .peak_fall = 0});
+            meters.prepare({.sample_rate = 48000, .block_size = block_size});
+            for (std::size_t i = 0; i < sine.size(); i += block_size) {
+                const std::array<const float*, 2> inputs = {sine.data() + i, noise.data() + i};
+                meters.process({.inputs = inputs, .outputs = {}, .frames = block_size, .sample_time = i});
+            }
+            REQUIRE(meters.update());
+            return meters.snapshot();
+        };
+
+        const auto whole = true_peaks(1024);
+        REQUIRE(std::abs(whole.peak[0] - 0.7071f) < 1e-3f);
+        REQUIRE(whole.true_peak[0] > 0.95f);
+        REQUIRE(whole.true_peak[0] < 1.05f);
+        REQUIRE(whole.true_peak[1] >= whole.peak[1]);
+        for (const std::uint32_t block_size : {64u, 16u, 4u, 1u}) {
+            REQUIRE(true_peaks(block_size).true_peak == whole.true_peak);
+        }
+    }
+
+    SECTION("levels are coded in half-dB steps from -120 dBFS") {
+        REQUIRE(telemetry::level_code(1.0f) == 240);
+        REQUIRE(telemetry::level_code(0.5f) == 228); // -6.02 dBFS
+        REQUIRE(telemetry::level_code(2.0f) == 252);
+        REQUIRE(telemetry::level_code(100.0f) == 255);
+        REQUIRE(telemetry::level_code(1e-6f) == 0);
+        REQUIRE(telemetry::level_code(0.0f) == 0);
+        REQUIRE(telemetry::code_db(240) == 0.0f);
+        REQUIRE(telemetry::code_db(1) == -119.5f);
+        REQUIRE(std::isinf(telemetry::code_db(0)));
+    }
+
+    SECTION("base64 matches the standard encoding") {
+        std::string out;
+        for (const auto& [in, expected] : {std::pair<std::string_view, std::string_view>{"", ""}, {"f", "Zg=="},
+                                            {"fo", "Zm8="}, {"foo", "Zm9v"}, {"foob", "Zm9vYg=="},
+                                            {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"}}) {
+            telemetry::base64_encode({reinterpret_cast<const std::uint8_t*>(in.data()), in.size()}, out);
+            REQUIRE(out == expected);
+        }
+        const std::array<std::uint8_t, 3> high = {0xfb, 0xff, 0xbf};
+        telemetry::base64_encode(high, out);
+        REQUIRE(out == "+/+/");
+    }
+
+    SECTION("frames follow the documented layout") {
+        const telemetry::MeterSnapshot snapshot{.sequence = 7, .sample_time = 4096, .frames = 512,
+                                                .published_ns = 1'000'000, .peak = {1.0f, 0.0f, 0.5f},
+                                                .true_peak = {1.0f, 0.0f, 2.0f}, .rms = {0.5f, 0.0f, 0.25f}};
+        std::vector<std::uint8_t> frame;
+        telemetry::encode_frame(snapshot, 2, 1'250'000, frame);
+        REQUIRE(frame.size() == telemetry::frame_header_bytes + 9);
+
+        const auto field = [&]<typename T>(std::size_t offset, T) {
+            T value;
+            std::memcpy(&value, frame.data() + offset, sizeof(T));
+            return value;
+        };
+        REQUIRE(std::memcmp(frame.data(), "AKTM", 4) == 0);
+        REQUIRE(field(4, std::uint16_t{}) == 2);
+        REQUIRE(field(6, std::uint16_t{}) == 40);
+        REQUIRE(field(8, std::uint32_t{}) == 3);
+        REQUIRE(field(12, std::uint32_t{}) == 2);
+        REQUIRE(field(16, std::uint64_t{}) == 7);
+        REQUIRE(field(24, std::uint64_t{}) == 4096);
+        REQUIRE(field(32, std::uint32_t{}) == 512);
+        REQUIRE(field(36, std::uint32_t{}) == 250);
+        REQUIRE(std::vector(frame.begin() + 40, frame.end()) == std::vector<std::uint8_t>{240, 0, 228, 240, 0, 252, 228, 0, 216});
+    }
+
+    SECTION("the bridge sends a frame per new snapshot and counts the ones it missed") {
+        MeterRun run{std::make_shared<telemetry::Meters>(telemetry::MeterConfig{.channels = 512, .publish_rate = 750})};
+        run.meters->prepare({.sample_rate = 48000, .block_size = 64});
+        telemetry::TelemetryBridge bridge(run.meters);
+        REQUIRE(bridge.frame().empty());
+
+        run.blocks(1, std::vector<float>(512, 0.5f));
+        REQUIRE(bridge.frame().size() == 2104);
+        REQUIRE(bridge.frame().empty());
+
+        run.blocks(4, std::vector<float>(512, 0.5f));
+        REQUIRE_FALSE(bridge.frame().empty());
+        REQUIRE(bridge.stats().frames == 2);
+        REQUIRE(bridge.stats().replaced == 3);
+        REQUIRE(bridge.stats().bytes == 2 * 2104);
+
+        REQUIRE_THROWS_AS(telemetry::TelemetryBridge(nullptr), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Core | Routing", "[core]") {
+
+    // Runs a matrix on blocks of 64 frames at 48 kHz, each input a constant
+    struct MatrixRun {
+        std::shared_ptr<routing::RoutingMatrix> matrix;
+        std::vector<std::vector<float>> inputs;
+        std::vector<std::vector<float>> outputs;
+
+        MatrixRun(const routing::RoutingConfig& config, std::vector<float> levels)
+            : matrix(std::make_shared<routing::RoutingMatrix>(config)),
+              outputs(config.outputs, std::vector<float>(64)) {
+            for (const float level : levels) inputs.emplace_back(64, level);
+            matrix->prepare({.sample_rate = 48000, .block_size = 64});
+        }
+
+        // The samples of every block, per output
+        std::vector<std::vector<float>> blocks(std::size_t count) {
+            std::vector<const float*> in;
+            std::vector<float*> out;
+            for (const auto& buffer : inputs) in.push_back(buffer.data());
+            for (auto& buffer : outputs) out.push_back(buffer.data());
+            std::vector<std::vector<float>> played(outputs.size());
+            for (std::size_t b = 0; b < count; b++) {
+                matrix->process({.inputs = in, .outputs = out, .frames = 64, .sample_time = 64 * b});
+                for (std::size_t o = 0; o < outputs.size(); o++) {
+                    played[o].insert(played[o].end(), outputs[o].begin(), outputs[o].end());
+                }
+            }
+            return played;
+        }
+    };
+
+    // 128 frames at 48 kHz: ramps of 2 blocks
+    constexpr double two_blocks = 128.0 / 48000.0;
+
+    SECTION("outputs mix their crosspoints once the ramps are over") {
+        MatrixRun run({.inputs = 4, .outputs = 3, .ramp_time = two_blocks}, {1.0f, 2.0f, 3.0f, 4.0f});
+        REQUIRE(run.blocks(1)[0] == std::vector<float>(64, 0.0f));
+
+        run.matrix->set(0, 0, 0.5f);
+        run.matrix->set(1, 0, 0.25f);
+        run.matrix->set(2, 1, 1.0f);
+        REQUIRE(run.matrix->active_count() == 3);
+        REQUIRE(run.matrix->gain(1, 0) == 0.25f);
+        REQUIRE(run.matrix->gain(0, 1) == 0.0f);
+        REQUIRE(run.blocks(1)[0] == std::vector<float>(64, 0.0f)); // not committed
+
+        run.matrix->commit();
+        run.blocks(2);
+        const auto played = run.blocks(1);
+        REQUIRE(played[0] == std::vector<float>(64, 1.0f));
+        REQUIRE(played[1] == std::vector<float>(64, 3.0f));
+        REQUIRE(played[2] == std::vector<float>(64, 0.0f));
+
+        const auto stats = run.matrix->stats();
+        REQUIRE(stats.commits == 1);
+        REQUIRE(stats.swaps == 1);
+        REQUIRE(stats.crosspoints == 3);
+    }
+
+    SECTION("gain changes ramp without a step, removed crosspoints fade out") {
+        MatrixRun run({.inputs = 1, .outputs = 1, .ramp_time = 4 * 64 / 48000.0}, {1.0f});
+        const auto smooth = [](const std::vector<float>& samples, float from, float to) {
+            float previous = from;
+            for (const float sample : samples) {
+                if (std::abs(sample - previous) > std::abs(to - from) / 256 + 1e-6f) return false;
+                previous = sample;
+            }
+            return std::abs(samples.back() - to) <= std::abs(to - from) / 256 + 1e-6f;
+        };
+
+        run.matrix->set(0, 0, 1.0f);
+        run.matrix->commit();
+        REQUIRE(smooth(run.blocks(4)[0], 0.0f, 1.0f));
+        REQUIRE(run.blocks(1)[0] == std::vector<float>(64, 1.0f));
+
+        run.matrix->set(0, 0, 0.5f);
+        run.matrix->commit();
+        REQUIRE(smooth(run.blocks(4)[0], 1.0f, 0.5f));
+        REQUIRE(run.blocks(1)[0] == std::vector<float>(64, 0.5f));
+
+        // Removed: still in the tables until the audio thread retires one it has faded out in
+        run.matrix->set(0, 0, 0.0f);
+        REQUIRE(run.matrix->active_count() == 0);
+        run.matrix->commit();
+        REQUIRE(run.matrix->stats().crosspoints == 1);
+        REQUIRE(smooth(run.blocks(4)[0], 0.5f, 0.0f));
+        REQUIRE(run.blocks(1)[0] == std::vector<float>(64, 0.0f));
+        run.matrix->commit();
+        REQUIRE(run.matrix->stats().crosspoints == 1);
+        REQUIRE(run.blocks(1)[0] == std::vector<float>(64, 0.0f));
+        run.matrix->commit();
+        REQUIRE(run.matrix->stats().crosspoints == 0);
+        REQUIRE(run.blocks(1)[0] == std::vector<float>(64, 0.0f));
+    }
+
+    SECTION("a removed crosspoint fades out however late the audio thread gets to it") {
+        MatrixRun run({.inputs = 1, .outputs = 1, .ramp_time = 4 * 64 / 48000.0}, {1.0f});
+        run.matrix->set(0, 0, 1.0f);
+        run.matrix->commit();
+        run.blocks(5);
+
+        // Commits with the audio thread stalled for many times the ramp
+        run.matrix->set(0, 0, 0.0f);
+        run.matrix->commit();
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        run.matrix->commit();
+        REQUIRE(run.matrix->stats().crosspoints == 1);
+
+        const auto played = run.blocks(4)[0];
+        REQUIRE(played.front() > 0.99f);
+        for (std::size_t i = 1; i < played.size(); i++) REQUIRE(played[i] <= played[i - 1]);
+        REQUIRE(played.back() < 0.01f);
+        REQUIRE(run.blocks(1)[0] == std::vector<float>(64, 0.0f));
+
+        // Stalled mid-ramp: the table retired then is no proof of a fade
+        run.matrix->set(0, 0, 1.0f);
+        run.matrix->commit();
+        run.blocks(5);
+        run.matrix->set(0, 0, 0.0f);
+        run.matrix->commit();
+        run.blocks(2);
+        run.matrix->commit();
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        run.matrix->commit();
+        REQUIRE(run.matrix->stats().crosspoints == 1);
+        const auto rest = run.blocks(4)[0];
+        REQUIRE(rest.front() > 0.49f);
+        for (std::size_t i = 1; i < rest.size(); i++) REQUIRE(rest[i] <= rest[i - 1]);
+        REQUIRE(rest.back() < 0.01f);
+    }
+
+    SECTION("a sparse matrix mixes as the dense one") {
+        constexpr std::uint32_t size = 16;
+        std::vector<float> levels(size);
+        for (std::uint32_t i = 0; i < size; i++) levels[i] = 0.1f * static_cast<float>(i + 1);
+        MatrixRun run({.inputs = size, .outputs = size, .ramp_time = two_blocks}, levels);
+
+        std::vector<float> gains(size * size);
+        std::uint32_t state = 7;
+        for (auto& gain : gains) {
+            state = state * 1664525u + 1013904223u;
+            if (state >> 24 < 52) gain = static_cast<float>(state >> 8 & 0xffff) / 65536.0f; // a fifth of them
+        }
+        for (std::uint32_t o = 0; o < size; o++) {
+            for (std::uint32_t i = 0; i < size; i++) run.matrix->set(i, o, gains[o * size + i]);
+        }
+        run.matrix->commit();
+        run.blocks(2);
+        const auto played = run.blocks(1);
+
+        for (std::uint32_t o = 0; o < size; o++) {
+            float expected = 0.0f;
+            for (std::uint32_t i = 0; i < size; i++) expected += gains[o * size + i] * levels[i];
+            REQUIRE(std::abs(played[o][0] - expected) < 1e-5f);
+            REQUIRE(std::ranges::all_of(played[o], [&](float s) { return s == played[o][0]; }));
+        }
+    }
+
+    SECTION("commits never wait for the audio thread, and tables are swapped whole") {
+        MatrixRun run({.inputs = 2, .outputs = 1, .ramp_time = 0}, {1.0f, 1.0f});
+
+        // Replaced before the audio thread saw it
+        run.matrix->set(0, 0, 1.0f);
+        run.matrix->commit();
+        run.matrix->set(1, 0, 1.0f);
+        run.matrix->commit();
+        REQUIRE(run.matrix->stats().replaced == 1);
+        run.blocks(1);
+        REQUIRE(run.blocks(1)[0] == std::vector<float>(64, 2.0f));
+        REQUIRE(run.matrix->stats().swaps == 1);
+
+        // Commits racing the audio thread: every table is picked up or replaced, and each block plays
+        // the gains of one table only (the gains always sum to 1, the ramps included)
+        run.matrix->set(0, 0, 0.5f);
+        run.matrix->set(1, 0, 0.5f);
+        run.matrix->commit();
+        run.blocks(2);
+        std::atomic<bool> done{false};
+        bool whole = true;
+        std::jthread audio([&] {
+            while (!done) {
+                const auto played = run.blocks(1);
+                for (const float sample : played[0]) whole &= std::abs(sample - 1.0f) < 1e-5f;
+            }
+        });
+        for (int n = 0; n < 2000; n++) {
+            const float gain = static_cast<float>(n % 10) / 10.0f;
+            run.matrix->set(0, 0, gain + 0.0001f);
+            run.matrix->set(1, 0, 0.9999f - gain);
+            run.matrix->commit();
+        }
+        REQUIRE(eventually([&] {
+            const auto stats = run.matrix->stats();
+            return stats.swaps + stats.replaced == stats.commits;
+        }));
+        done = true;
+        audio.join();
+        REQUIRE(whole);
+    }
+
+    SECTION("settings are checked") {
+        routing::RoutingMatrix matrix({.inputs = 2, .outputs = 2});
+        REQUIRE_THROWS_AS(matrix.set(2, 0, 1.0f), std::invalid_argument);
+        REQUIRE_THROWS_AS(matrix.set(0, 2, 1.0f), std::invalid_argument);
+        REQUIRE_THROWS_AS(matrix.set(0, 0, std::numeric_limits<float>::quiet_NaN()), std::invalid_argument);
+        matrix.set(0, 0, 0.0f);
+        REQUIRE(matrix.active_count() == 0);
+        matrix.set(0, 0, 1.0f);
+        matrix.set(1, 1, 1.0f);
+        matrix.clear();
+        REQUIRE(matrix.active_count() == 0);
+
+        REQUIRE_THROWS_AS(routing::RoutingMatrix({.inputs = 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(routing::RoutingMatrix({.outputs = 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(routing::RoutingMatrix({.ramp_time = -1}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Core | Commands", "[core]") {
+
+    const fs::path log_dir = fs::temp_directory_path() / "aknet_core_test_logs";
+
+    SECTION("the audio thread answers a command at the start of a block") {
+        {
+            core app({
+                .log_dir = log_dir,
+                .log_level = log::LogLevel::off,
+                .engine = {.sample_rate = 48000, .block_size = 64, .priority = 0},
+            });
+
+            const auto sent = std::chrono::steady_clock::now().time_since_epoch();
+            const std::array<bus::Command, 2> commands = {bus::command::Ping{.id = 42, .sent_ns = sent.count()},
+                                                          bus::command::TestMessage{}};
+            REQUIRE(app.bus().post(commands));
+
+            std::vector<bus::Event> events;
+            REQUIRE(eventually([&] {
+                app.bus().poll([&](const bus::Event& event) { events.push_back(event); });
+                return events.size() == 2;
+            }));
+
+            const auto& pong = std::get<bus::event::Pong>(events[0]);
+            REQUIRE(pong.id == 42);
+            REQUIRE(pong.sent_ns == sent.count());
+            REQUIRE(pong.sample_time % 64 == 0);
+            REQUIRE(std::get<bus::event::TestMessage>(events[1]).sample_time >= pong.sample_time);
+            REQUIRE(app.bus().stats().commands_applied == 2);
+        }
+        fs::remove_all(log_dir);
+    }
+
+    SECTION("the core's meters reach the telemetry bridge") {
+        {
+            core app({
+                .log_dir = log_dir,
+                .log_level = log::LogLevel::off,
+                .engine = {.sample_rate = 48000, .block_size = 64, .priority = 0},
+                .meters = {.channels = 8},
+            });
+
+            std::string frame;
+            REQUIRE(eventually([&] {
+                frame = app.telemetry().frame();
+                return !frame.empty();
+            }));
+            // 40 + 3 * 8 bytes
+            REQUIRE(frame.size() == 88);
+            REQUIRE(frame.starts_with("QUtUTQ")); // "AKTM"
+        }
+        fs::remove_all(log_dir);
+    }
+
+    SECTION("the core's routing matrix picks up its tables on the audio thread") {
+        {
+            core app({
+                .log_dir = log_dir,
+                .log_level = log::LogLevel::off,
+                .engine = {.sample_rate = 48000, .block_size = 64, .priority = 0},
+                .routing = {.inputs = 8, .outputs = 8},
+            });
 
+            app.routing()->set(0, 1, 0.5f);
+            app.routing()->commit();
+            REQUIRE(eventually([&] { return app.routing()->stats().swaps == 1; }));
+            REQUIRE(app.routing()->stats().crosspoints == 1);
+        }
+        fs::remove_all(log_dir);
+    }
+}
@@ -2,8 +2,23 @@
 #include <saucer/embedded/all.hpp>
 #include <core.h>
 
+#include <string>
+#include <type_traits>
+#include <variant>
+
 namespace {
     std::unique_ptr<aknet::core> g_core;
+
+    // Handle the core's events on the webview thread (the bus's only event consumer)
+    std::size_t poll_events() {
+        return g_core->bus().poll([](const aknet::bus::Event& event) {
+            std::visit([]<typename T>(const T& e) {
+                if constexpr (std::is_same_v<T, aknet::bus::event::TestMessage>) {
+                    aknet::log::get("ui")->info("Core test message applied at sample {}", e.sample_time);
+                }
+            }, event);
+        });
+    }
 }
 
 coco::stray start(saucer::application* app)
@@ -13,14 +28,20 @@ coco::stray start(saucer::application* app)
 
     window->set_title("aknet");
 
-    webview->expose("log_test_msg", []() { g_core->test_function(); });
+    // UI actions post commands and never call into the core directly: the webview thread must not wait on
+    // the audio thread
+    webview->expose("log_test_msg", []() { return g_core->bus().post(aknet::bus::command::TestMessage{}); });
+    webview->expose("poll_events", []() { return poll_events(); });
+
+    // Meter frames, pulled once per animation frame by the UI (one call in flight at a time)
+    webview->expose("telemetry_frame", []() { return std::string(g_core->telemetry().frame()); });
 
     webview->embed(saucer::embedded::all());
     webview->serve("/index.html");
     window->show();
 
-    // temp Test function
-    g_core->test_function();
+    // temp Test message
+    g_core->bus().post(aknet::bus::command::TestMessage{});
 
     co_await app->finish();
 }
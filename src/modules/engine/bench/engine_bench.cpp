@@ -0,0 +1,186 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+// aknet_engine_bench: quality and cost of the ASRC that plays network streams on the engine's clock.
+//
+//   aknet_engine_bench [--format text|csv|json] [--seconds <n>]
+//
+// Two measurements, for filters of 32 and 64 taps (256 phases), at 48 kHz in blocks of 64 frames:
+//   - quality: THD+N of a sine at several frequencies and ratios (clock offsets of 100 ppm, 0.1% and 1%),
+//     from the residual of a least-squares sine fit over `seconds` of output, after the filter has filled
+//   - cost: CPU time per output frame and channel, with 1 to 64 channels, over `seconds` of audio;
+//     the share of a core one channel takes in real time, and the slowest block against the block period
+//     (a fixed budget: the slowest block stays close to the average one)
+
+#include <asrc.h>
+#include <bench_support.h>
+
+#include "signal_analysis.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <numbers>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace aknet;
+
+namespace {
+
+    constexpr double sample_rate = 48000;
+    constexpr std::uint32_t block_frames = 64;
+
+    struct QualityResult {
+        std::uint32_t taps = 0;
+        double frequency = 0;
+        double ratio = 1;
+        double thd_n_db = 0;
+    };
+
+    struct CostResult {
+        std::uint32_t taps = 0;
+        std::uint32_t channels = 0;
+        double ns_per_frame_channel = 0;
+        double cpu_percent_per_channel = 0; // of one core, in real time
+        double worst_block_percent = 0;     // slowest block, in percent of the block period
+    };
+
+    struct Options {
+        bench::Format format = bench::Format::text;
+        std::uint32_t seconds = 2;
+    };
+
+    // ---------------------------------------------------------------------------------------------
+    // Quality
+    // ---------------------------------------------------------------------------------------------
+
+    QualityResult measure_quality(const Options& options, std::uint32_t taps, double frequency, double ratio) {
+        engine::Asrc asrc({.channels = 1, .max_block = block_frames, .taps = taps});
+        asrc.set_ratio(ratio);
+
+        const auto frames = static_cast<std::size_t>(options.seconds * sample_rate);
+        const std::size_t settle = 4 * taps;
+        std::vector<float> in(asrc.max_input_frames());
+        std::vector<float> played(frames + settle + block_frames);
+        const double w = 2 * std::numbers::pi * frequency / sample_rate;
+        std::int64_t next = 0;
+        for (std::size_t done = 0; done < frames + settle; done += block_frames) {
+            const std::uint32_t count = asrc.input_frames(block_frames);
+            for (std::uint32_t i = 0; i < count; i++) in[i] = static_cast<float>(0.5 * std::sin(w * static_cast<double>(next++)));
+            const float* inputs[] = {in.data()};
+            float* outputs[] = {played.data() + done};
+            asrc.process(inputs, outputs, block_frames);
+        }
+
+        return {
+            .taps = taps,
+            .frequency = frequency,
+            .ratio = ratio,
+            .thd_n_db = test::thd_n(std::span(played).subspan(settle, frames), frequency * asrc.ratio() / sample_rate),
+        };
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Cost
+    // ---------------------------------------------------------------------------------------------
+
+    CostResult measure_cost(const Options& options, std::uint32_t taps, std::uint32_t channels) {
+        engine::Asrc asrc({.channels = channels, .max_block = block_frames, .taps = taps});
+        const std::size_t stride = asrc.max_input_frames();
+        std::vector<float> in(stride * channels);
+        std::vector<float> out(std::size_t{block_frames} * channels);
+        for (std::size_t i = 0; i < in.size(); i++) in[i] = static_cast<float>(std::sin(0.01 * static_cast<double>(i)));
+        std::vector<const float*> inputs;
+        std::vector<float*> outputs;
+        for (std::uint32_t c = 0; c < channels; c++) {
+            inputs.push_back(in.data() + c * stride);
+            outputs.push_back(out.data() + c * block_frames);
+        }
+
+        // The ratio wanders around 1 as a clock recovery would have it
+        const auto blocks = static_cast<std::uint64_t>(options.seconds * sample_rate / block_frames);
+        double total = 0;
+        double worst = 0;
+        for (std::uint64_t b = 0; b < blocks; b++) {
+            asrc.set_ratio(1 + 100e-6 * std::sin(static_cast<double>(b) * 1e-3));
+            const auto t0 = std::chrono::steady_clock::now();
+            asrc.process(inputs, outputs, block_frames);
+            const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+            total += ns;
+            worst = std::max(worst, ns);
+        }
+
+        const double frames = static_cast<double>(blocks) * block_frames;
+        const double ns_per_frame_channel = total / frames / channels;
+        return {
+            .taps = taps,
+            .channels = channels,
+            .ns_per_frame_channel = ns_per_frame_channel,
+            .cpu_percent_per_channel = 100.0 * ns_per_frame_channel * sample_rate * 1e-9,
+            .worst_block_percent = 100.0 * worst / (block_frames / sample_rate * 1e9),
+        };
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Output
+    // ---------------------------------------------------------------------------------------------
+
+    void print(const Options& options, const std::vector<QualityResult>& quality, const std::vector<CostResult>& cost) {
+        bench::Table quality_table{"quality", {
+            {.key = "taps", .header = "taps", .width = 6},
+            {.key = "frequency", .header = "frequency", .width = 10, .unit = "Hz"},
+            {.key = "ratio", .header = "ratio", .width = 8, .precision = 4},
+            {.key = "thd_n_db", .header = "THD+N", .width = 10, .precision = 1, .unit = " dB"},
+        }};
+        for (const auto& r : quality) quality_table.add({r.taps, r.frequency, r.ratio, r.thd_n_db});
+
+        bench::Table cost_table{"cost", {
+            {.key = "taps", .header = "taps", .width = 6},
+            {.key = "channels", .header = "channels", .width = 10},
+            {.key = "ns_per_frame_channel", .header = "ns/frame/ch", .width = 14, .precision = 2},
+            {.key = "cpu_percent_per_channel", .header = "cpu/channel", .width = 12, .precision = 4, .unit = "%"},
+            {.key = "worst_block_percent", .header = "worst block", .width = 12, .precision = 2, .unit = "%"},
+        }};
+        for (const auto& r : cost) {
+            cost_table.add({r.taps, r.channels, r.ns_per_frame_channel, r.cpu_percent_per_channel, r.worst_block_percent});
+        }
+        bench::print(options.format, {quality_table, cost_table});
+    }
+
+    std::optional<Options> parse_options(int argc, char** argv) {
+        return bench::parse_options<Options>(argc, argv, [](Options& options, std::string_view name, std::string_view value) {
+            return name == "--seconds" && bench::parse_count(value, options.seconds);
+        });
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_options(argc, argv);
+    if (!options) {
+        std::cerr << "Usage: " << argv[0] << " [--format text|csv|json] [--seconds <n>]" << std::endl;
+        return 1;
+    }
+
+    std::vector<QualityResult> quality;
+    std::vector<CostResult> cost;
+    for (const std::uint32_t taps : {32u, 64u}) {
+        for (const double ratio : {1.0001, 1.001, 0.99}) {
+            for (const double frequency : {100.0, 1000.0, 10000.0, 18000.0, 20000.0}) {
+                quality.push_back(measure_quality(*options, taps, frequency, ratio));
+            }
+        }
+        for (const std::uint32_t channels : {1u, 2u, 8u, 64u}) cost.push_back(measure_cost(*options, taps, channels));
+    }
+
+    print(*options, quality, cost);
+    return 0;
+}
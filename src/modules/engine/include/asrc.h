@@ -0,0 +1,88 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_ASRC_H
+#define AKNET_ASRC_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace aknet::engine {
+
+    struct AsrcConfig {
+        std::uint32_t channels = 2;
+        std::uint32_t max_block = 1024;   // most output frames per process() call
+        std::uint32_t taps = 64;          // filter length, even: latency is taps / 2 frames
+        std::uint32_t phases = 256;       // filters between two input frames, interpolated linearly
+        double cutoff = 0.45;             // of the sample rate
+        double kaiser_beta = 10.0;        // window shape: stopband attenuation against transition width
+        double max_deviation = 0.01;      // ratios are clamped to 1 ± this
+    };
+
+    // -------------------------------------------------------------------------
+    // Asrc: asynchronous sample-rate converter between two clocks of the same nominal rate (a sender's and
+    // ours), for planar channels. The ratio (input frames consumed per output frame) comes from a clock
+    // recovery loop and may change on every call.
+    //
+    // Each output frame is the dot product of `taps` input frames with a windowed-sinc filter, picked in a
+    // polyphase table by the fractional position of the frame and interpolated between the two nearest
+    // phases. The filter is computed once per frame and shared by the channels; products are summed with
+    // kernels::dot. The cost of a block depends on its frames and channels only: no branch on the ratio
+    // or on the signal, so a block always fits the same real-time budget.
+    //
+    // Pull model, on the audio thread: ask input_frames() how many frames the next output block needs, get
+    // exactly that many from the source, then process().
+    // -------------------------------------------------------------------------
+    class Asrc {
+    public:
+        // Allocates the filter table and the history. Throws std::invalid_argument on zero channels, block,
+        // taps or phases, an odd tap count, or a cutoff or deviation out of (0, 0.5].
+        explicit Asrc(const AsrcConfig& config = {});
+
+        const AsrcConfig& config() const noexcept { return config_; }
+
+        // Input frames per output frame: above 1 when the source's clock runs faster than ours
+        void set_ratio(double ratio) noexcept;
+        double ratio() const noexcept;
+
+        // Input frames the next process() of `output_frames` frames (at most max_block) consumes
+        std::uint32_t input_frames(std::uint32_t output_frames) const noexcept;
+
+        // Most input_frames() can return
+        std::uint32_t max_input_frames() const noexcept { return max_input_; }
+
+        // Convert: `input` has input_frames(output_frames) frames per channel, `output` gets output_frames
+        void process(std::span<const float* const> input, std::span<float* const> output,
+                     std::uint32_t output_frames) noexcept;
+
+        // Delay from input to output, in frames
+        std::uint32_t latency() const noexcept { return config_.taps / 2; }
+
+        // Back to silence, at the start position
+        void reset() noexcept;
+
+    private:
+        static constexpr int fraction_bits = 32;
+
+        const AsrcConfig config_;
+        std::uint32_t max_input_ = 0;
+        std::vector<float> filters_;      // phases + 1 rows of taps coefficients
+        std::vector<float> slopes_;       // row p + 1 minus row p, for the interpolation
+        std::vector<float> filter_;       // the current frame's filter
+        std::vector<float> history_;      // per channel: taps frames of history, then the new input
+        std::size_t history_stride_ = 0;
+
+        // Fixed point with 32 fractional bits: the position of the next output frame, relative to the first
+        // frame of the next input, and its step
+        std::int64_t position_ = 0;
+        std::int64_t step_ = std::int64_t{1} << fraction_bits;
+    };
+
+} // namespace aknet::engine
+
+#endif // AKNET_ASRC_H
@@ -0,0 +1,118 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_ENGINE_H
+#define AKNET_ENGINE_H
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <logger.h>
+
+#include "graph.h"
+
+namespace aknet::engine {
+
+    // Audio thread of the engine. Without an audio device, the thread clocks itself: it sleeps until each
+    // block's start time, spinning for the last `spin` of the wait to start on time.
+    struct EngineConfig {
+        std::uint32_t sample_rate = 48000;
+        std::uint32_t block_size = 64;        // frames per block
+        int priority = 80;                    // SCHED_FIFO priority on Linux (time-constraint policy on macOS), 0: none
+        int cpu = -1;                         // pin the audio thread to this CPU (Linux only), -1: no pinning
+        bool lock_memory = false;             // mlockall() at start(), so the process never page-faults
+        std::chrono::microseconds spin{50};
+    };
+
+    // Counters of the audio thread since start(), read with relaxed loads (cheap, lock-free)
+    struct EngineStats {
+        std::uint64_t blocks = 0;
+        std::uint64_t deadline_misses = 0;  // blocks finished after the start of the next block
+        std::uint64_t skipped_blocks = 0;   // blocks dropped to catch up after falling more than a block behind
+        std::uint64_t graph_swaps = 0;
+        std::chrono::nanoseconds period{};  // duration of a block
+        std::chrono::nanoseconds last_process_time{};
+        std::chrono::nanoseconds max_process_time{};
+        bool realtime = false;              // the audio thread got real-time scheduling
+    };
+
+    // Runs on the audio thread at the start of every block, before the graph: where changes posted by other
+    // threads are applied, so that the graph sees them at a block boundary. Same rules as Node::process().
+    using BlockHook = std::function<void(std::uint64_t sample_time)>;
+
+    // -------------------------------------------------------------------------
+    // Engine: runs a processing graph on a dedicated real-time thread, one block at a time.
+    // The audio thread never locks, allocates or makes syscalls while processing a block: buffers belong
+    // to the graph and are allocated when it is built, and graph edits are published with an atomic swap.
+    // All the methods are for the control thread.
+    // -------------------------------------------------------------------------
+    class Engine {
+    public:
+        // Throws std::invalid_argument on a zero sample rate or block size
+        explicit Engine(const EngineConfig& config = {});
+        ~Engine();
+
+        Engine(const Engine&) = delete;
+        Engine& operator=(const Engine&) = delete;
+
+        const ProcessSpec& spec() const noexcept { return spec_; }
+
+        // Start the audio thread (no-op if it runs). Counters restart from zero.
+        void start();
+
+        // Stop the audio thread after its current block (no-op if it is stopped)
+        void stop();
+
+        bool running() const noexcept { return running_.load(std::memory_order_relaxed); }
+
+        // Replace the running graph. The audio thread picks it up at the start of its next block; this returns
+        // once it has, and the previous graph is destroyed here, never on the audio thread.
+        // Throws std::invalid_argument if the graph is null or was built for another spec.
+        void publish(std::unique_ptr<Graph> graph);
+
+        // Set the hook run before every block (empty: none). Its time counts in the block's process time.
+        // Throws std::logic_error while the audio thread runs.
+        void set_block_hook(BlockHook hook);
+
+        EngineStats stats() const noexcept;
+
+    private:
+        void run();
+
+        const EngineConfig config_;
+        const ProcessSpec spec_;
+        const std::chrono::nanoseconds period_;
+        std::shared_ptr<log::Logger> logger_;
+
+        std::mutex control_mutex_;           // start, stop and publish
+        std::thread thread_;
+        std::atomic<bool> running_{false};
+        std::atomic<bool> stop_requested_{false};
+        std::atomic<bool> started_{false};   // the audio thread finished its setup
+
+        BlockHook hook_;                     // audio thread only while running
+        Graph* current_ = nullptr;           // owned; audio thread only while running
+        std::atomic<Graph*> pending_{nullptr};
+        std::atomic<Graph*> retired_{nullptr};
+
+        // Written by the audio thread only
+        std::atomic<std::uint64_t> blocks_{0};
+        std::atomic<std::uint64_t> deadline_misses_{0};
+        std::atomic<std::uint64_t> skipped_blocks_{0};
+        std::atomic<std::uint64_t> graph_swaps_{0};
+        std::atomic<std::int64_t> last_process_ns_{0};
+        std::atomic<std::int64_t> max_process_ns_{0};
+        std::atomic<bool> realtime_{false};
+    };
+
+} // namespace aknet::engine
+
+#endif // AKNET_ENGINE_H
@@ -0,0 +1,151 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_GRAPH_H
+#define AKNET_GRAPH_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace aknet::engine {
+
+    // Fixed processing format of an engine, known when a graph is built
+    struct ProcessSpec {
+        std::uint32_t sample_rate = 48000;
+        std::uint32_t block_size = 64; // frames per block
+
+        bool operator==(const ProcessSpec&) const = default;
+    };
+
+    // One block handed to a node: a mono buffer of `frames` samples per port
+    struct ProcessBlock {
+        std::span<const float* const> inputs;
+        std::span<float* const> outputs;
+        std::uint32_t frames = 0;
+        std::uint64_t sample_time = 0; // position of the block's first frame since the engine started
+    };
+
+    // -------------------------------------------------------------------------
+    // Node: a processing unit of the graph.
+    // prepare() runs on the control thread when the first graph using the node is built, and may allocate.
+    // process() runs on the audio thread: no locks, allocations, syscalls or exceptions.
+    // A node can be shared by consecutive graphs (it keeps its state across edits, and is not prepared
+    // again for the same spec), but never runs in two graphs at once.
+    // -------------------------------------------------------------------------
+    class Node {
+    public:
+        virtual ~Node() = default;
+
+        virtual std::size_t input_count() const = 0;
+        virtual std::size_t output_count() const = 0;
+
+        virtual void prepare(const ProcessSpec& spec) { (void)spec; }
+        virtual void process(const ProcessBlock& block) noexcept = 0;
+
+    private:
+        friend class GraphBuilder;
+        std::optional<ProcessSpec> prepared_for_;
+    };
+
+    using NodeId = std::uint32_t;
+
+    // -------------------------------------------------------------------------
+    // Graph: an immutable, compiled processing graph, ready to run.
+    // Nodes run in topological order. Every output port owns a buffer of the arena allocated at build time;
+    // an input fed by one connection reads the source's buffer directly, one fed by several reads their sum,
+    // and an unconnected input reads silence.
+    // -------------------------------------------------------------------------
+    class Graph {
+    public:
+        ~Graph();
+
+        Graph(const Graph&) = delete;
+        Graph& operator=(const Graph&) = delete;
+
+        const ProcessSpec& spec() const noexcept { return spec_; }
+        std::size_t node_count() const noexcept { return nodes_.size(); }
+
+        // Run every node once, for the block starting at sample_time (audio thread)
+        void process(std::uint64_t sample_time) noexcept;
+
+        // Last block written to an output port
+        std::span<const float> output(NodeId node, std::size_t port) const;
+
+    private:
+        friend class GraphBuilder;
+
+        Graph() = default;
+
+        struct Step {
+            Node* node;
+            std::uint32_t first_input;  // into inputs_
+            std::uint32_t first_output; // into outputs_
+            std::uint32_t input_count;
+            std::uint32_t output_count;
+            std::uint32_t first_mix;    // into mixes_
+            std::uint32_t mix_count;
+        };
+
+        // An input port fed by several outputs
+        struct Mix {
+            float* destination;
+            std::uint32_t first_source; // into mix_sources_
+            std::uint32_t source_count;
+        };
+
+        struct ArenaDeleter {
+            void operator()(float* p) const noexcept;
+        };
+
+        ProcessSpec spec_;
+        std::vector<std::shared_ptr<Node>> nodes_;   // by NodeId
+        std::vector<std::uint32_t> node_outputs_;    // by NodeId: first output buffer, into outputs_
+        std::vector<Step> steps_;                    // in processing order
+        std::vector<const float*> inputs_;
+        std::vector<float*> outputs_;
+        std::vector<Mix> mixes_;
+        std::vector<const float*> mix_sources_;
+        std::unique_ptr<float[], ArenaDeleter> arena_;
+    };
+
+    // -------------------------------------------------------------------------
+    // GraphBuilder: describes a graph on the control thread and compiles it.
+    //   GraphBuilder builder;
+    //   const auto osc = builder.add(std::make_shared<Oscillator>(440.0f));
+    //   const auto out = builder.add(output_node);
+    //   builder.connect(osc, 0, out, 0);
+    //   engine.publish(builder.build(engine.spec()));
+    // -------------------------------------------------------------------------
+    class GraphBuilder {
+    public:
+        NodeId add(std::shared_ptr<Node> node);
+
+        // Feed an output port of `source` into an input port of `destination`
+        void connect(NodeId source, std::size_t output, NodeId destination, std::size_t input);
+
+        // Allocate the buffers, order the nodes and prepare them.
+        // Throws std::invalid_argument on a cycle or a connection to a port that does not exist.
+        std::unique_ptr<Graph> build(const ProcessSpec& spec) const;
+
+    private:
+        struct Connection {
+            NodeId source;
+            std::uint32_t output;
+            NodeId destination;
+            std::uint32_t input;
+        };
+
+        std::vector<std::shared_ptr<Node>> nodes_;
+        std::vector<Connection> connections_;
+    };
+
+} // namespace aknet::engine
+
+#endif // AKNET_GRAPH_H
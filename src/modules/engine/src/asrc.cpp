@@ -0,0 +1,131 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "asrc.h"
+
+#include <kernels.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+namespace aknet::engine {
+
+    namespace {
+        AsrcConfig validated(const AsrcConfig& config) {
+            if (config.channels == 0 || config.max_block == 0 || config.taps == 0 || config.phases == 0) {
+                throw std::invalid_argument("ASRC channels, block, taps and phases must not be zero");
+            }
+            if (config.taps % 2 != 0) throw std::invalid_argument("ASRC tap count must be even");
+            if (!(config.cutoff > 0 && config.cutoff <= 0.5) ||
+                !(config.max_deviation > 0 && config.max_deviation <= 0.5)) {
+                throw std::invalid_argument("ASRC cutoff and maximum deviation must be in (0, 0.5]");
+            }
+            return config;
+        }
+
+        // Modified Bessel function of the first kind, order 0 (Kaiser window)
+        double bessel_i0(double x) {
+            double sum = 1;
+            double term = 1;
+            for (int k = 1; term > sum * 1e-17; k++) {
+                term *= (x / (2 * k)) * (x / (2 * k));
+                sum += term;
+            }
+            return sum;
+        }
+    }
+
+    Asrc::Asrc(const AsrcConfig& config) : config_(validated(config)) {
+        const std::uint32_t taps = config_.taps;
+        const std::uint32_t half = taps / 2;
+
+        // Row p is the filter for an output frame p / phases of a frame after an input one: tap k weighs the
+        // input frame at distance d = k - (half - 1) - p / phases. Rows are normalised to a gain of 1 at DC.
+        filters_.resize(std::size_t{config_.phases + 1} * taps);
+        for (std::uint32_t p = 0; p <= config_.phases; p++) {
+            float* row = filters_.data() + std::size_t{p} * taps;
+            double sum = 0;
+            for (std::uint32_t k = 0; k < taps; k++) {
+                const double d = static_cast<double>(k) - (half - 1) - static_cast<double>(p) / config_.phases;
+                const double x = 2 * config_.cutoff * d;
+                const double sinc = x == 0 ? 1 : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+                const double edge = d / half;
+                const double window = bessel_i0(config_.kaiser_beta * std::sqrt(std::max(0.0, 1 - edge * edge))) /
+                                      bessel_i0(config_.kaiser_beta);
+                const double h = sinc * window;
+                row[k] = static_cast<float>(h);
+                sum += h;
+            }
+            for (std::uint32_t k = 0; k < taps; k++) row[k] = static_cast<float>(row[k] / sum);
+        }
+        slopes_.resize(std::size_t{config_.phases} * taps);
+        for (std::size_t i = 0; i < slopes_.size(); i++) slopes_[i] = filters_[i + taps] - filters_[i];
+        filter_.resize(taps);
+
+        // The largest input: a full block at the highest ratio, from the furthest start position
+        max_input_ = static_cast<std::uint32_t>(std::ceil(config_.max_block * (1 + config_.max_deviation))) + 2;
+        history_stride_ = taps + max_input_;
+        history_.resize(history_stride_ * config_.channels);
+        reset();
+    }
+
+    void Asrc::set_ratio(double ratio) noexcept {
+        ratio = std::clamp(ratio, 1 - config_.max_deviation, 1 + config_.max_deviation);
+        step_ = std::llround(std::ldexp(ratio, fraction_bits));
+    }
+
+    double Asrc::ratio() const noexcept {
+        return std::ldexp(static_cast<double>(step_), -fraction_bits);
+    }
+
+    // The last output frame reads up to `half` frames after its position
+    std::uint32_t Asrc::input_frames(std::uint32_t output_frames) const noexcept {
+        if (output_frames == 0) return 0;
+        const std::int64_t last = (position_ + (output_frames - 1) * step_) >> fraction_bits;
+        return static_cast<std::uint32_t>(std::max<std::int64_t>(last + config_.taps / 2 + 1, 0));
+    }
+
+    void Asrc::process(std::span<const float* const> input, std::span<float* const> output,
+                       std::uint32_t output_frames) noexcept {
+        const std::uint32_t taps = config_.taps;
+        const std::uint32_t consumed = input_frames(output_frames);
+        for (std::size_t c = 0; c < config_.channels; c++) {
+            std::copy_n(input[c], consumed, history_.data() + c * history_stride_ + taps);
+        }
+
+        constexpr std::uint64_t fraction_mask = (std::uint64_t{1} << fraction_bits) - 1;
+        for (std::uint32_t j = 0; j < output_frames; j++) {
+            const std::int64_t t = position_ + j * step_;
+
+            // Filter between the two nearest phases
+            const std::uint64_t phase = (static_cast<std::uint64_t>(t) & fraction_mask) * config_.phases;
+            const std::size_t row = static_cast<std::size_t>(phase >> fraction_bits) * taps;
+            const auto weight = static_cast<float>(std::ldexp(static_cast<double>(phase & fraction_mask), -fraction_bits));
+            std::copy_n(filters_.data() + row, taps, filter_.data());
+            kernels::mix_add(filter_.data(), slopes_.data() + row, taps, weight);
+
+            // Input frames from t - half + 1 to t + half, history included
+            const std::size_t first = static_cast<std::size_t>((t >> fraction_bits) + taps / 2 + 1);
+            for (std::size_t c = 0; c < config_.channels; c++) {
+                output[c][j] = kernels::dot(history_.data() + c * history_stride_ + first, filter_.data(), taps);
+            }
+        }
+
+        // Keep the last taps frames as the history of the next call
+        position_ += output_frames * step_ - (std::int64_t{consumed} << fraction_bits);
+        for (std::size_t c = 0; c < config_.channels; c++) {
+            float* history = history_.data() + c * history_stride_;
+            std::copy_n(history + consumed, taps, history);
+        }
+    }
+
+    void Asrc::reset() noexcept {
+        std::ranges::fill(history_, 0.0f);
+        // The first output frame sits `latency()` frames before the first input frame
+        position_ = -static_cast<std::int64_t>(config_.taps / 2) << fraction_bits;
+    }
+
+} // namespace aknet::engine
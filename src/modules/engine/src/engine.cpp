@@ -0,0 +1,178 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "engine.h"
+#include "realtime.h"
+
+#include <counters.h>
+
+#include <stdexcept>
+#include <utility>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace aknet::engine {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+            _mm_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+
+        EngineConfig validated(const EngineConfig& config) {
+            if (config.sample_rate == 0 || config.block_size == 0) {
+                throw std::invalid_argument("Engine sample rate and block size must not be zero");
+            }
+            return config;
+        }
+    }
+
+    Engine::Engine(const EngineConfig& config)
+        : config_(validated(config)),
+          spec_{config.sample_rate, config.block_size},
+          period_(std::chrono::nanoseconds(std::int64_t{1'000'000'000} * config.block_size / config.sample_rate)),
+          logger_(log::get("engine")) {}
+
+    Engine::~Engine() {
+        stop();
+        delete current_;
+        delete pending_.exchange(nullptr);
+        delete retired_.exchange(nullptr);
+    }
+
+    void Engine::start() {
+        std::lock_guard lock(control_mutex_);
+        if (running()) return;
+
+        blocks_ = 0;
+        deadline_misses_ = 0;
+        skipped_blocks_ = 0;
+        graph_swaps_ = 0;
+        last_process_ns_ = 0;
+        max_process_ns_ = 0;
+        realtime_ = false;
+
+        if (config_.lock_memory && !detail::lock_memory()) logger_->warn("Cannot lock the process memory");
+
+        stop_requested_ = false;
+        started_ = false;
+        running_ = true;
+        thread_ = std::thread([this] { run(); });
+        started_.wait(false);
+
+        logger_->info("Audio thread running: {} frames at {} Hz ({:.3f} ms per block), real-time scheduling: {}",
+                      spec_.block_size, spec_.sample_rate, std::chrono::duration<double, std::milli>(period_).count(),
+                      realtime_.load() ? "yes" : "no");
+    }
+
+    void Engine::stop() {
+        std::lock_guard lock(control_mutex_);
+        if (!running()) return;
+
+        stop_requested_.store(true, std::memory_order_relaxed);
+        thread_.join();
+        running_ = false;
+
+        // A graph published while the thread was stopping becomes the current one
+        if (Graph* graph = pending_.exchange(nullptr)) {
+            delete std::exchange(current_, graph);
+        }
+        delete retired_.exchange(nullptr);
+
+        const auto s = stats();
+        logger_->info("Audio thread stopped after {} blocks: {} deadline misses, {} skipped, max block {:.3f} ms",
+                      s.blocks, s.deadline_misses, s.skipped_blocks,
+                      std::chrono::duration<double, std::milli>(s.max_process_time).count());
+    }
+
+    void Engine::publish(std::unique_ptr<Graph> graph) {
+        if (!graph) throw std::invalid_argument("Cannot publish a null graph");
+        if (graph->spec() != spec_) throw std::invalid_argument("Graph built for another process spec");
+
+        std::lock_guard lock(control_mutex_);
+        if (!running()) {
+            delete std::exchange(current_, graph.release());
+            return;
+        }
+
+        pending_.store(graph.release(), std::memory_order_release);
+        while (pending_.load(std::memory_order_acquire)) std::this_thread::sleep_for(period_ / 2);
+        delete retired_.exchange(nullptr, std::memory_order_acquire);
+    }
+
+    void Engine::set_block_hook(BlockHook hook) {
+        std::lock_guard lock(control_mutex_);
+        if (running()) throw std::logic_error("Cannot set the block hook while the audio thread runs");
+        hook_ = std::move(hook);
+    }
+
+    EngineStats Engine::stats() const noexcept {
+        return {
+            .blocks = blocks_.load(std::memory_order_relaxed),
+            .deadline_misses = deadline_misses_.load(std::memory_order_relaxed),
+            .skipped_blocks = skipped_blocks_.load(std::memory_order_relaxed),
+            .graph_swaps = graph_swaps_.load(std::memory_order_relaxed),
+            .period = period_,
+            .last_process_time = std::chrono::nanoseconds(last_process_ns_.load(std::memory_order_relaxed)),
+            .max_process_time = std::chrono::nanoseconds(max_process_ns_.load(std::memory_order_relaxed)),
+            .realtime = realtime_.load(std::memory_order_relaxed),
+        };
+    }
+
+    void Engine::run() {
+        bool realtime = config_.priority > 0 && detail::set_realtime_priority(config_.priority, period_);
+        if (config_.cpu >= 0) realtime &= detail::pin_to_cpu(config_.cpu);
+        realtime_.store(realtime, std::memory_order_relaxed);
+        started_.store(true);
+        started_.notify_one();
+
+        std::uint64_t sample_time = 0;
+        auto block_start = Clock::now();
+        while (!stop_requested_.load(std::memory_order_relaxed)) {
+            // Wait for the block's start: sleep, then spin the last stretch
+            if (const auto wake = block_start - config_.spin; Clock::now() < wake) std::this_thread::sleep_until(wake);
+            while (Clock::now() < block_start) cpu_relax();
+
+            // Pick up a published graph; the control thread frees the previous one
+            if (Graph* next = pending_.load(std::memory_order_acquire)) {
+                retired_.store(std::exchange(current_, next), std::memory_order_release);
+                pending_.store(nullptr, std::memory_order_release);
+                bump(graph_swaps_);
+            }
+
+            const auto begin = Clock::now();
+            if (hook_) hook_(sample_time);
+            if (current_) current_->process(sample_time);
+            const auto end = Clock::now();
+
+            const auto process_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+            last_process_ns_.store(process_ns, std::memory_order_relaxed);
+            if (process_ns > max_process_ns_.load(std::memory_order_relaxed)) {
+                max_process_ns_.store(process_ns, std::memory_order_relaxed);
+            }
+            bump(blocks_);
+
+            block_start += period_;
+            sample_time += spec_.block_size;
+            if (end > block_start) {
+                bump(deadline_misses_);
+
+                // More than a block behind: drop the blocks that are already late instead of bursting through them
+                if (const auto behind = (end - block_start) / period_; behind > 0) {
+                    block_start += behind * period_;
+                    sample_time += static_cast<std::uint64_t>(behind) * spec_.block_size;
+                    bump(skipped_blocks_, static_cast<std::uint64_t>(behind));
+                }
+            }
+        }
+    }
+
+} // namespace aknet::engine
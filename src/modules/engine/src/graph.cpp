@@ -0,0 +1,171 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "graph.h"
+
+#include <kernels.h>
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+namespace aknet::engine {
+
+    namespace {
+        constexpr std::size_t buffer_alignment = 64;
+
+        // Buffers start on a cache line, so kernels can use aligned vector loads
+        std::size_t buffer_stride(std::uint32_t block_size) {
+            constexpr std::size_t floats_per_line = buffer_alignment / sizeof(float);
+            return (block_size + floats_per_line - 1) / floats_per_line * floats_per_line;
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Graph
+    // -------------------------------------------------------------------------
+    Graph::~Graph() = default;
+
+    void Graph::ArenaDeleter::operator()(float* p) const noexcept {
+        ::operator delete[](p, std::align_val_t{buffer_alignment});
+    }
+
+    void Graph::process(std::uint64_t sample_time) noexcept {
+        const std::uint32_t frames = spec_.block_size;
+        for (const Step& step : steps_) {
+            for (std::uint32_t m = step.first_mix; m < step.first_mix + step.mix_count; m++) {
+                const Mix& mix = mixes_[m];
+                const float* const* sources = &mix_sources_[mix.first_source];
+                std::copy_n(sources[0], frames, mix.destination);
+                for (std::uint32_t s = 1; s < mix.source_count; s++) kernels::mix_add(mix.destination, sources[s], frames);
+            }
+
+            step.node->process({
+                .inputs = {inputs_.data() + step.first_input, step.input_count},
+                .outputs = {outputs_.data() + step.first_output, step.output_count},
+                .frames = frames,
+                .sample_time = sample_time,
+            });
+        }
+    }
+
+    std::span<const float> Graph::output(NodeId node, std::size_t port) const {
+        if (node >= nodes_.size() || port >= nodes_[node]->output_count()) {
+            throw std::out_of_range("No output port " + std::to_string(port) + " on node " + std::to_string(node));
+        }
+        return {outputs_[node_outputs_[node] + port], spec_.block_size};
+    }
+
+    // -------------------------------------------------------------------------
+    // GraphBuilder
+    // -------------------------------------------------------------------------
+    NodeId GraphBuilder::add(std::shared_ptr<Node> node) {
+        if (!node) throw std::invalid_argument("Cannot add a null node to a graph");
+        nodes_.push_back(std::move(node));
+        return static_cast<NodeId>(nodes_.size() - 1);
+    }
+
+    void GraphBuilder::connect(NodeId source, std::size_t output, NodeId destination, std::size_t input) {
+        if (source >= nodes_.size() || destination >= nodes_.size()) {
+            throw std::invalid_argument("Connection between unknown nodes");
+        }
+        if (output >= nodes_[source]->output_count() || input >= nodes_[destination]->input_count()) {
+            throw std::invalid_argument("Connection to a port that does not exist");
+        }
+        connections_.push_back({source, static_cast<std::uint32_t>(output), destination, static_cast<std::uint32_t>(input)});
+    }
+
+    std::unique_ptr<Graph> GraphBuilder::build(const ProcessSpec& spec) const {
+        if (spec.block_size == 0 || spec.sample_rate == 0) throw std::invalid_argument("Invalid process spec");
+
+        const std::size_t count = nodes_.size();
+
+        // Kahn's algorithm, keeping insertion order among ready nodes
+        std::vector<std::size_t> pending_inputs(count, 0);
+        for (const auto& c : connections_) pending_inputs[c.destination]++;
+
+        std::vector<NodeId> order;
+        order.reserve(count);
+        for (NodeId id = 0; id < count; id++) {
+            if (pending_inputs[id] == 0) order.push_back(id);
+        }
+        for (std::size_t i = 0; i < order.size(); i++) {
+            for (const auto& c : connections_) {
+                if (c.source == order[i] && --pending_inputs[c.destination] == 0) order.push_back(c.destination);
+            }
+        }
+        if (order.size() != count) throw std::invalid_argument("The graph has a cycle");
+
+        std::unique_ptr<Graph> graph(new Graph());
+        graph->spec_ = spec;
+        graph->nodes_ = nodes_;
+
+        // Buffers: silence, then every output port, then every input port fed by several outputs
+        std::size_t output_ports = 0;
+        graph->node_outputs_.resize(count);
+        for (NodeId id = 0; id < count; id++) {
+            graph->node_outputs_[id] = static_cast<std::uint32_t>(output_ports);
+            output_ports += nodes_[id]->output_count();
+        }
+
+        std::vector<std::vector<std::vector<const Connection*>>> feeds(count);
+        std::size_t mixed_ports = 0;
+        for (NodeId id = 0; id < count; id++) feeds[id].resize(nodes_[id]->input_count());
+        for (const auto& c : connections_) {
+            auto& port = feeds[c.destination][c.input];
+            port.push_back(&c);
+            if (port.size() == 2) mixed_ports++;
+        }
+
+        const std::size_t stride = buffer_stride(spec.block_size);
+        const std::size_t buffer_count = 1 + output_ports + mixed_ports;
+        graph->arena_.reset(static_cast<float*>(
+            ::operator new[](buffer_count * stride * sizeof(float), std::align_val_t{buffer_alignment})));
+        std::fill_n(graph->arena_.get(), buffer_count * stride, 0.0f);
+
+        float* const silence = graph->arena_.get();
+        float* next_buffer = silence + stride;
+        graph->outputs_.reserve(output_ports);
+        for (std::size_t i = 0; i < output_ports; i++, next_buffer += stride) graph->outputs_.push_back(next_buffer);
+
+        const auto output_buffer = [&](const Connection& c) -> const float* {
+            return graph->outputs_[graph->node_outputs_[c.source] + c.output];
+        };
+
+        for (const NodeId id : order) {
+            Graph::Step step{};
+            step.node = nodes_[id].get();
+            step.first_input = static_cast<std::uint32_t>(graph->inputs_.size());
+            step.first_output = graph->node_outputs_[id];
+            step.input_count = static_cast<std::uint32_t>(nodes_[id]->input_count());
+            step.output_count = static_cast<std::uint32_t>(nodes_[id]->output_count());
+            step.first_mix = static_cast<std::uint32_t>(graph->mixes_.size());
+
+            for (const auto& port : feeds[id]) {
+                if (port.empty()) {
+                    graph->inputs_.push_back(silence);
+                } else if (port.size() == 1) {
+                    graph->inputs_.push_back(output_buffer(*port[0]));
+                } else {
+                    graph->mixes_.push_back({next_buffer, static_cast<std::uint32_t>(graph->mix_sources_.size()),
+                                             static_cast<std::uint32_t>(port.size())});
+                    for (const Connection* c : port) graph->mix_sources_.push_back(output_buffer(*c));
+                    graph->inputs_.push_back(next_buffer);
+                    next_buffer += stride;
+                }
+            }
+            step.mix_count = static_cast<std::uint32_t>(graph->mixes_.size()) - step.first_mix;
+            graph->steps_.push_back(step);
+        }
+
+        for (const auto& node : nodes_) {
+            if (node->prepared_for_ == spec) continue;
+            node->prepare(spec);
+            node->prepared_for_ = spec;
+        }
+        return graph;
+    }
+
+} // namespace aknet::engine
@@ -0,0 +1,59 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "realtime.h"
+
+#include <pthread.h>
+#include <sys/mman.h>
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#else
+#include <sched.h>
+#endif
+
+namespace aknet::engine::detail {
+
+    bool set_realtime_priority([[maybe_unused]] int priority, [[maybe_unused]] std::chrono::nanoseconds period) noexcept {
+#ifdef __APPLE__
+        mach_timebase_info_data_t timebase{};
+        if (mach_timebase_info(&timebase) != KERN_SUCCESS) return false;
+        const auto to_ticks = [&](std::chrono::nanoseconds ns) {
+            return static_cast<std::uint32_t>(ns.count() * timebase.denom / timebase.numer);
+        };
+
+        // Up to half of every period of computation, to be done within the period
+        thread_time_constraint_policy_data_t policy{};
+        policy.period = to_ticks(period);
+        policy.computation = to_ticks(period / 2);
+        policy.constraint = to_ticks(period);
+        policy.preemptible = 1;
+        return thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+                                 reinterpret_cast<thread_policy_t>(&policy),
+                                 THREAD_TIME_CONSTRAINT_POLICY_COUNT) == KERN_SUCCESS;
+#else
+        sched_param param{};
+        param.sched_priority = priority;
+        return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#endif
+    }
+
+    bool pin_to_cpu([[maybe_unused]] int cpu) noexcept {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof set, &set) == 0;
+#else
+        return false; // macOS has no hard affinity
+#endif
+    }
+
+    bool lock_memory() noexcept {
+        return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+    }
+
+} // namespace aknet::engine::detail
@@ -0,0 +1,29 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_REALTIME_H
+#define AKNET_REALTIME_H
+
+#pragma once
+
+#include <chrono>
+
+namespace aknet::engine::detail {
+
+    // Scheduling of the calling thread for periodic real-time work. Each returns false when the system
+    // refuses (typically missing privileges: CAP_SYS_NICE / rtprio limits on Linux); the thread then keeps
+    // running with its previous settings.
+
+    // Linux: SCHED_FIFO at `priority`. macOS: time-constraint policy for work of `period` (priority unused).
+    bool set_realtime_priority(int priority, std::chrono::nanoseconds period) noexcept;
+
+    // Pin the calling thread to one CPU (Linux only)
+    bool pin_to_cpu(int cpu) noexcept;
+
+    // Lock the process's current and future pages in memory, so the audio thread never page-faults
+    bool lock_memory() noexcept;
+
+} // namespace aknet::engine::detail
+
+#endif // AKNET_REALTIME_H
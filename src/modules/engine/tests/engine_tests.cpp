@@ -0,0 +1,405 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <numbers>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <asrc.h>
+#include <engine.h>
+#include <logger.h>
+
+#include "signal_analysis.h"
+
+using namespace aknet;
+namespace fs = std::filesystem;
+
+// ------------------------------------------------------------------------------------------------
+// Helpers
+// ------------------------------------------------------------------------------------------------
+
+// Logging session in a temporary directory, for the engine's logger
+class LogSession {
+    fs::path path_;
+public:
+    LogSession() : path_(fs::temp_directory_path() / "aknet_engine_test_logs") {
+        fs::create_directories(path_);
+        log::init(path_, {.console = false});
+    }
+    ~LogSession() {
+        log::shutdown();
+        fs::remove_all(path_);
+    }
+};
+
+// Writes a constant to its output
+class Constant : public engine::Node {
+public:
+    explicit Constant(float value) : value_(value) {}
+    std::size_t input_count() const override { return 0; }
+    std::size_t output_count() const override { return 1; }
+    void process(const engine::ProcessBlock& block) noexcept override {
+        std::fill_n(block.outputs[0], block.frames, value_);
+    }
+private:
+    float value_;
+};
+
+// Multiplies its input
+class Gain : public engine::Node {
+public:
+    explicit Gain(float gain) : gain_(gain) {}
+    std::size_t input_count() const override { return 1; }
+    std::size_t output_count() const override { return 1; }
+    void process(const engine::ProcessBlock& block) noexcept override {
+        for (std::uint32_t i = 0; i < block.frames; i++) block.outputs[0][i] = block.inputs[0][i] * gain_;
+    }
+private:
+    float gain_;
+};
+
+// Records what reaches its input
+class Probe : public engine::Node {
+public:
+    std::size_t input_count() const override { return 1; }
+    std::size_t output_count() const override { return 0; }
+    void prepare(const engine::ProcessSpec&) override { prepare_count++; }
+    void process(const engine::ProcessBlock& block) noexcept override {
+        last_value.store(block.inputs[0][block.frames - 1], std::memory_order_relaxed);
+        last_sample_time.store(block.sample_time, std::memory_order_relaxed);
+        blocks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int prepare_count = 0;
+    std::atomic<float> last_value{-1.0f};
+    std::atomic<std::uint64_t> last_sample_time{0};
+    std::atomic<std::uint64_t> blocks{0};
+};
+
+// Takes longer than a block to process
+class Stall : public engine::Node {
+public:
+    explicit Stall(std::chrono::microseconds duration) : duration_(duration) {}
+    std::size_t input_count() const override { return 0; }
+    std::size_t output_count() const override { return 0; }
+    void process(const engine::ProcessBlock&) noexcept override {
+        const auto end = std::chrono::steady_clock::now() + duration_;
+        while (std::chrono::steady_clock::now() < end) {}
+    }
+private:
+    std::chrono::microseconds duration_;
+};
+
+// Wait until a condition holds, for at most two seconds
+template <typename Predicate>
+bool eventually(Predicate predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// Runs `input(frame)` through an ASRC at a fixed ratio, 64 frames per block, for `frames` output frames
+template <typename Input>
+std::vector<float> resample(engine::Asrc& asrc, std::size_t frames, Input input) {
+    std::vector<float> in(asrc.max_input_frames());
+    std::vector<float> out(64);
+    std::vector<float> played;
+    std::int64_t next = 0;
+    while (played.size() < frames) {
+        const std::uint32_t count = asrc.input_frames(64);
+        for (std::uint32_t i = 0; i < count; i++) in[i] = input(next++);
+        const float* inputs[] = {in.data()};
+        float* outputs[] = {out.data()};
+        asrc.process(inputs, outputs, 64);
+        played.insert(played.end(), out.begin(), out.end());
+    }
+    played.resize(frames);
+    return played;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Tests
+// ------------------------------------------------------------------------------------------------
+
+TEST_CASE("Engine | Graph", "[engine]") {
+
+    const engine::ProcessSpec spec{.sample_rate = 48000, .block_size = 64};
+
+    SECTION("nodes run after their sources, whatever the order they were added in") {
+        engine::GraphBuilder builder;
+        auto probe = std::make_shared<Probe>();
+        const auto sink = builder.add(probe);
+        const auto gain = builder.add(std::make_shared<Gain>(0.5f));
+        const auto source = builder.add(std::make_shared<Constant>(3.0f));
+        builder.connect(gain, 0, sink, 0);
+        builder.connect(source, 0, gain, 0);
+
+        const auto graph = builder.build(spec);
+        graph->process(128);
+
+        REQUIRE(probe->last_value == 1.5f);
+        REQUIRE(probe->last_sample_time == 128);
+        REQUIRE(graph->output(gain, 0).size() == 64);
+        REQUIRE(graph->output(gain, 0)[0] == 1.5f);
+    }
+
+    SECTION("an input fed by several outputs reads their sum, an unconnected one reads silence") {
+        engine::GraphBuilder builder;
+        auto mixed = std::make_shared<Probe>();
+        auto silent = std::make_shared<Probe>();
+        const auto a = builder.add(std::make_shared<Constant>(1.0f));
+        const auto b = builder.add(std::make_shared<Constant>(2.0f));
+        const auto c = builder.add(std::make_shared<Constant>(4.0f));
+        const auto sink = builder.add(mixed);
+        builder.add(silent);
+        builder.connect(a, 0, sink, 0);
+        builder.connect(b, 0, sink, 0);
+        builder.connect(c, 0, sink, 0);
+
+        builder.build(spec)->process(0);
+
+        REQUIRE(mixed->last_value == 7.0f);
+        REQUIRE(silent->last_value == 0.0f);
+    }
+
+    SECTION("nodes shared by consecutive graphs are prepared once per spec") {
+        auto probe = std::make_shared<Probe>();
+        for (int i = 0; i < 3; i++) {
+            engine::GraphBuilder builder;
+            builder.add(probe);
+            builder.build(spec);
+        }
+        REQUIRE(probe->prepare_count == 1);
+
+        engine::GraphBuilder builder;
+        builder.add(probe);
+        builder.build({.sample_rate = 96000, .block_size = 64});
+        REQUIRE(probe->prepare_count == 2);
+    }
+
+    SECTION("invalid graphs are rejected") {
+        engine::GraphBuilder builder;
+        const auto a = builder.add(std::make_shared<Gain>(1.0f));
+        const auto b = builder.add(std::make_shared<Gain>(1.0f));
+        const auto source = builder.add(std::make_shared<Constant>(1.0f));
+
+        REQUIRE_THROWS_AS(builder.connect(a, 1, b, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(builder.connect(a, 0, source, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(builder.connect(a, 0, 42, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(builder.add(nullptr), std::invalid_argument);
+
+        builder.connect(a, 0, b, 0);
+        builder.connect(b, 0, a, 0);
+        REQUIRE_THROWS_AS(builder.build(spec), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Engine | Audio thread", "[engine]") {
+
+    const LogSession session;
+
+    SECTION("blocks run on the audio thread at the block rate") {
+        engine::Engine engine({.sample_rate = 48000, .block_size = 64, .priority = 0});
+        engine::GraphBuilder builder;
+        auto probe = std::make_shared<Probe>();
+        builder.connect(builder.add(std::make_shared<Constant>(1.0f)), 0, builder.add(probe), 0);
+        engine.publish(builder.build(engine.spec()));
+
+        const auto start = std::chrono::steady_clock::now();
+        engine.start();
+        REQUIRE(engine.running());
+        REQUIRE(eventually([&] { return probe->blocks >= 150; }));
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        // 150 blocks of 1.333 ms: about 200 ms, never faster
+        REQUIRE(elapsed >= std::chrono::milliseconds(195));
+        REQUIRE(probe->last_value == 1.0f);
+        REQUIRE(probe->last_sample_time % 64 == 0);
+
+        const auto stats = engine.stats();
+        REQUIRE(stats.blocks >= 150);
+        REQUIRE(stats.period == std::chrono::nanoseconds(1'333'333));
+
+        engine.stop();
+        REQUIRE_FALSE(engine.running());
+    }
+
+    SECTION("published graphs replace the running one") {
+        engine::Engine engine({.priority = 0});
+        engine.start();
+
+        auto first = std::make_shared<Probe>();
+        auto second = std::make_shared<Probe>();
+        for (const auto& [probe, value] : {std::pair{first, 1.0f}, std::pair{second, 2.0f}}) {
+            engine::GraphBuilder builder;
+            builder.connect(builder.add(std::make_shared<Constant>(value)), 0, builder.add(probe), 0);
+            engine.publish(builder.build(engine.spec()));
+        }
+
+        REQUIRE(eventually([&] { return second->blocks >= 10; }));
+        const auto first_blocks = first->blocks.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        REQUIRE(first->blocks == first_blocks);
+        REQUIRE(second->last_value == 2.0f);
+        REQUIRE(engine.stats().graph_swaps == 2);
+
+        engine::GraphBuilder builder;
+        REQUIRE_THROWS_AS(engine.publish(builder.build({.sample_rate = 44100, .block_size = 64})), std::invalid_argument);
+        REQUIRE_THROWS_AS(engine.publish(nullptr), std::invalid_argument);
+    }
+
+    SECTION("blocks that overrun their deadline are counted") {
+        engine::Engine engine({.sample_rate = 48000, .block_size = 64, .priority = 0});
+        engine::GraphBuilder builder;
+        builder.add(std::make_shared<Stall>(std::chrono::microseconds(3000)));
+        engine.publish(builder.build(engine.spec()));
+
+        engine.start();
+        REQUIRE(eventually([&] { return engine.stats().blocks >= 10; }));
+        engine.stop();
+
+        const auto stats = engine.stats();
+        REQUIRE(stats.deadline_misses == stats.blocks);
+        REQUIRE(stats.skipped_blocks >= stats.blocks);
+        REQUIRE(stats.max_process_time >= std::chrono::microseconds(3000));
+
+        // Counters restart with the thread
+        engine.publish(engine::GraphBuilder().build(engine.spec()));
+        engine.start();
+        REQUIRE(eventually([&] { return engine.stats().blocks >= 20; }));
+        REQUIRE(engine.stats().deadline_misses < engine.stats().blocks);
+    }
+
+    SECTION("the block hook runs before every block, with its sample time") {
+        engine::Engine engine({.sample_rate = 48000, .block_size = 64, .priority = 0});
+        auto probe = std::make_shared<Probe>();
+        engine::GraphBuilder builder;
+        builder.connect(builder.add(std::make_shared<Constant>(1.0f)), 0, builder.add(probe), 0);
+        engine.publish(builder.build(engine.spec()));
+
+        std::atomic<std::uint64_t> hooks{0};
+        std::atomic<bool> in_step{true};
+        engine.set_block_hook([&](std::uint64_t sample_time) {
+            // The graph has not run this block yet: it ran once per earlier hook
+            if (probe->blocks != hooks || sample_time % 64 != 0) in_step = false;
+            hooks++;
+        });
+        engine.start();
+        REQUIRE(eventually([&] { return hooks >= 50; }));
+        REQUIRE_THROWS_AS(engine.set_block_hook({}), std::logic_error);
+        engine.stop();
+
+        REQUIRE(in_step);
+        REQUIRE(hooks == engine.stats().blocks);
+    }
+
+    SECTION("an idle graph holds 64-sample blocks at 48 kHz") {
+        engine::Engine engine({.sample_rate = 48000, .block_size = 64, .priority = 0, .spin = std::chrono::microseconds(200)});
+        engine::GraphBuilder builder;
+        auto probe = std::make_shared<Probe>();
+        builder.connect(builder.add(std::make_shared<Constant>(1.0f)), 0, builder.add(probe), 0);
+        engine.publish(builder.build(engine.spec()));
+
+        engine.start();
+        REQUIRE(eventually([&] { return engine.stats().blocks >= 300; }));
+        engine.stop();
+
+        // Without real-time scheduling (as in CI) a loaded machine preempts the thread now and then
+        const auto stats = engine.stats();
+        REQUIRE(stats.deadline_misses * 10 <= stats.blocks);
+    }
+}
+
+TEST_CASE("Engine | ASRC", "[engine]") {
+
+    SECTION("at a ratio of 1, the input comes out delayed by the latency") {
+        engine::Asrc asrc({.channels = 1, .max_block = 64});
+        const auto sine = [](std::int64_t i) { return 0.5f * static_cast<float>(std::sin(0.05 * static_cast<double>(i))); };
+        const auto played = resample(asrc, 4800, sine);
+        for (std::size_t i = 1000; i < played.size(); i++) {
+            REQUIRE(std::abs(played[i] - sine(static_cast<std::int64_t>(i) - asrc.latency())) < 1e-4f);
+        }
+
+        const auto dc = resample(asrc, 1000, [](std::int64_t) { return 1.0f; });
+        REQUIRE(std::abs(dc.back() - 1.0f) < 1e-6f);
+    }
+
+    SECTION("input frames follow the ratio") {
+        for (const double ratio : {1.0, 1.0002, 0.9998, 1.01, 0.99}) {
+            engine::Asrc asrc({.channels = 1, .max_block = 64});
+            asrc.set_ratio(ratio);
+            std::uint64_t consumed = 0;
+            std::vector<float> in(asrc.max_input_frames()), out(64);
+            const float* inputs[] = {in.data()};
+            float* outputs[] = {out.data()};
+            for (int block = 0; block < 10000; block++) {
+                const std::uint32_t count = asrc.input_frames(64);
+                REQUIRE(count <= asrc.max_input_frames());
+                consumed += count;
+                asrc.process(inputs, outputs, 64);
+            }
+            REQUIRE(std::abs(static_cast<double>(consumed) - ratio * 640000) <= 1);
+        }
+    }
+
+    SECTION("sines across the band come out with a THD+N below -100 dB") {
+        for (const double ratio : {1.0001, 0.9999, 1.001, 0.99}) {
+            for (const double frequency : {100.0, 1000.0, 10000.0, 18000.0}) {
+                engine::Asrc asrc({.channels = 1, .max_block = 64});
+                asrc.set_ratio(ratio);
+                const double w = 2 * std::numbers::pi * frequency / 48000;
+                const auto played = resample(asrc, 24000, [&](std::int64_t i) {
+                    return static_cast<float>(0.5 * std::sin(w * static_cast<double>(i)));
+                });
+                // Skip the start, where the filter fills up
+                const double thdn = test::thd_n(std::span(played).subspan(1000), frequency * asrc.ratio() / 48000);
+                INFO(frequency << " Hz at a ratio of " << ratio << ": " << thdn << " dB");
+                REQUIRE(thdn < -100.0);
+            }
+        }
+    }
+
+    SECTION("channels are converted alike, and ratios are clamped") {
+        engine::Asrc asrc({.channels = 3, .max_block = 32, .max_deviation = 0.001});
+        asrc.set_ratio(1.5);
+        REQUIRE(std::abs(asrc.ratio() - 1.001) < 1e-9);
+        asrc.set_ratio(0.5);
+        REQUIRE(std::abs(asrc.ratio() - 0.999) < 1e-9);
+
+        std::vector<float> in(3 * asrc.max_input_frames()), out(3 * 32);
+        const float* inputs[] = {in.data(), in.data() + asrc.max_input_frames(), in.data() + 2 * asrc.max_input_frames()};
+        float* outputs[] = {out.data(), out.data() + 32, out.data() + 64};
+        for (int block = 0; block < 10; block++) {
+            const std::uint32_t count = asrc.input_frames(32);
+            for (std::uint32_t i = 0; i < count; i++) {
+                in[i] = static_cast<float>(std::sin(0.1 * (block * 32 + i)));
+                in[asrc.max_input_frames() + i] = 2 * in[i];
+                in[2 * asrc.max_input_frames() + i] = -in[i];
+            }
+            asrc.process(inputs, outputs, 32);
+            for (int i = 0; i < 32; i++) {
+                REQUIRE(out[32 + i] == 2 * out[i]);
+                REQUIRE(out[64 + i] == -out[i]);
+            }
+        }
+    }
+
+    SECTION("invalid configurations are rejected") {
+        REQUIRE_THROWS_AS(engine::Asrc({.channels = 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(engine::Asrc({.taps = 63}), std::invalid_argument);
+        REQUIRE_THROWS_AS(engine::Asrc({.cutoff = 0.6}), std::invalid_argument);
+        REQUIRE_THROWS_AS(engine::Asrc({.max_deviation = 0}), std::invalid_argument);
+    }
+}
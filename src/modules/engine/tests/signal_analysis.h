@@ -0,0 +1,57 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_SIGNAL_ANALYSIS_H
+#define AKNET_SIGNAL_ANALYSIS_H
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <span>
+
+namespace aknet::test {
+
+    // THD+N in dB of `signal` against the least-squares fit of a sine of `frequency` cycles per frame (and DC).
+    // Shared by the engine tests and aknet_engine_bench.
+    inline double thd_n(std::span<const float> signal, double frequency) {
+        const double w = 2 * std::numbers::pi * frequency;
+        // Normal equations of the fit on sin, cos and 1
+        double a[3][3]{};
+        double b[3]{};
+        for (std::size_t i = 0; i < signal.size(); i++) {
+            const double basis[3] = {std::sin(w * i), std::cos(w * i), 1};
+            for (int r = 0; r < 3; r++) {
+                b[r] += basis[r] * signal[i];
+                for (int c = 0; c < 3; c++) a[r][c] += basis[r] * basis[c];
+            }
+        }
+        for (int r = 0; r < 3; r++) {
+            for (int below = r + 1; below < 3; below++) {
+                const double f = a[below][r] / a[r][r];
+                for (int c = 0; c < 3; c++) a[below][c] -= f * a[r][c];
+                b[below] -= f * b[r];
+            }
+        }
+        double x[3];
+        for (int r = 2; r >= 0; r--) {
+            x[r] = b[r];
+            for (int c = r + 1; c < 3; c++) x[r] -= a[r][c] * x[c];
+            x[r] /= a[r][r];
+        }
+
+        double fit_power = 0;
+        double residual_power = 0;
+        for (std::size_t i = 0; i < signal.size(); i++) {
+            const double fit = x[0] * std::sin(w * i) + x[1] * std::cos(w * i) + x[2];
+            fit_power += fit * fit;
+            residual_power += (signal[i] - fit) * (signal[i] - fit);
+        }
+        return 10 * std::log10(residual_power / fit_power);
+    }
+
+} // namespace aknet::test
+
+#endif // AKNET_SIGNAL_ANALYSIS_H
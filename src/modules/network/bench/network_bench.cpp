@@ -0,0 +1,220 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+// aknet_network_bench: cost of moving RTP audio streams through UDP sockets, over the loopback interface.
+//
+//   aknet_network_bench [--format text|csv|json] [--streams <n>] [--seconds <n>]
+//
+// Every simulated millisecond, each of `streams` streams sends one packet (48 stereo L24 frames, 300 bytes
+// with the RTP header) from one socket to another, and the receiving socket reads them all back. This runs
+// as fast as it can, on this thread, with each transport:
+//   - recvfrom: one sendto() and one recvfrom() per packet, the baseline
+//   - mmsg: UdpSocket without offload, sendmmsg() and recvmmsg() in batches of 64
+//   - mmsg_offload: UdpSocket with UDP GSO and GRO, when the kernel supports them
+// It reports packets per second, syscalls per packet, and the CPU time (user and system) one stream costs
+// in real time, as a percentage of a core. Kernel timestamps are off throughout. Loopback has no NIC, so
+// this measures the syscall and stack costs only; on a wire, interrupts and the driver come on top.
+
+#include <rtp.h>
+#include <udp_socket.h>
+#include <bench_support.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+using namespace aknet;
+using namespace std::chrono_literals;
+
+namespace {
+
+    // ---------------------------------------------------------------------------------------------
+    // Measurement
+    // ---------------------------------------------------------------------------------------------
+
+    constexpr std::size_t packet_bytes = network::rtp_header_bytes + 48 * 2 * 3;
+    constexpr std::size_t chunk = 64; // packets in flight at most: the receive buffer never overflows
+
+    struct Result {
+        std::string transport;
+        std::uint32_t streams = 0;
+        std::uint64_t packets = 0;
+        std::uint64_t lost = 0;
+        double packets_per_second = 0;
+        double syscalls_per_packet = 0;
+        double cpu_percent_per_stream = 0; // of one core, at one packet per millisecond
+    };
+
+    struct Options {
+        bench::Format format = bench::Format::text;
+        std::uint32_t streams = 256;
+        std::uint32_t seconds = 2;
+    };
+
+    double cpu_seconds() {
+        timespec t{};
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+        return static_cast<double>(t.tv_sec) + static_cast<double>(t.tv_nsec) * 1e-9;
+    }
+
+    // Header of stream `ssrc`'s packet at `tick`; the payload does not matter
+    void write_header(std::byte* packet, std::uint32_t ssrc, std::uint32_t tick) {
+        network::write_rtp_header({.sequence = static_cast<std::uint16_t>(tick), .timestamp = tick * 48, .ssrc = ssrc},
+                                  packet);
+    }
+
+    // Runs `ticks` milliseconds of `streams` streams; `exchange(first, count)` moves packets of streams
+    // [first, first + count) and returns how many arrived, adding its syscalls to `syscalls`
+    template <typename Exchange>
+    Result measure(std::string transport, const Options& options, Exchange exchange) {
+        const std::uint64_t ticks = std::uint64_t{options.seconds} * 1000;
+        std::uint64_t syscalls = 0;
+        std::uint64_t received = 0;
+
+        const double cpu0 = cpu_seconds();
+        const auto t0 = std::chrono::steady_clock::now();
+        for (std::uint64_t tick = 0; tick < ticks; tick++) {
+            for (std::uint32_t first = 0; first < options.streams; first += chunk) {
+                const auto count = std::min<std::uint32_t>(chunk, options.streams - first);
+                received += exchange(static_cast<std::uint32_t>(tick), first, count, syscalls);
+            }
+        }
+        const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        const double cpu = cpu_seconds() - cpu0;
+
+        const std::uint64_t packets = ticks * options.streams;
+        return {
+            .transport = std::move(transport),
+            .streams = options.streams,
+            .packets = packets,
+            .lost = packets - received,
+            .packets_per_second = static_cast<double>(received) / wall,
+            .syscalls_per_packet = static_cast<double>(syscalls) / static_cast<double>(packets),
+            .cpu_percent_per_stream = 100.0 * cpu / static_cast<double>(options.seconds) / options.streams,
+        };
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Transports
+    // ---------------------------------------------------------------------------------------------
+
+    Result bench_recvfrom(const Options& options) {
+        // The same sockets, one syscall per packet
+        network::UdpSocket receiver({.local = network::Endpoint::parse("127.0.0.1:0"), .batch = 1,
+                                     .timestamps = false, .offload = false});
+        network::UdpSocket sender({.local = network::Endpoint::parse("127.0.0.1:0"), .batch = 1,
+                                   .timestamps = false, .offload = false});
+        sockaddr_in destination{};
+        destination.sin_family = AF_INET;
+        destination.sin_addr.s_addr = htonl(receiver.local_endpoint().address);
+        destination.sin_port = htons(receiver.local_endpoint().port);
+
+        std::vector<std::byte> packet(packet_bytes, std::byte{0x5A});
+        std::vector<std::byte> buffer(1500);
+        return measure("recvfrom", options, [&](std::uint32_t tick, std::uint32_t first, std::uint32_t count,
+                                                std::uint64_t& syscalls) {
+            for (std::uint32_t s = first; s < first + count; s++) {
+                write_header(packet.data(), s, tick);
+                sendto(sender.native_handle(), packet.data(), packet.size(), 0,
+                       reinterpret_cast<const sockaddr*>(&destination), sizeof destination);
+            }
+            std::uint32_t received = 0;
+            for (; received < count; received++) {
+                if (recvfrom(receiver.native_handle(), buffer.data(), buffer.size(), 0, nullptr, nullptr) < 0) break;
+            }
+            syscalls += 2 * count;
+            return received;
+        });
+    }
+
+    Result bench_mmsg(const Options& options, bool offload) {
+        network::UdpSocket receiver({.local = network::Endpoint::parse("127.0.0.1:0"), .timestamps = false, .offload = offload});
+        network::UdpSocket sender({.local = network::Endpoint::parse("127.0.0.1:0"), .offload = offload});
+        const auto destination = receiver.local_endpoint();
+        if (offload && !(sender.segmentation_offload() && receiver.receive_offload())) {
+            std::cerr << "UDP GSO/GRO not supported by this kernel: mmsg_offload runs without them" << std::endl;
+        }
+
+        const std::vector<std::byte> packet(packet_bytes, std::byte{0x5A});
+        return measure(offload ? "mmsg_offload" : "mmsg", options, [&](std::uint32_t tick, std::uint32_t first,
+                                                                      std::uint32_t count, std::uint64_t& syscalls) {
+            const auto calls = sender.stats().send_calls + receiver.stats().receive_calls;
+            for (std::uint32_t s = first; s < first + count; s++) {
+                const auto out = sender.stage(destination, packet.size());
+                std::ranges::copy(packet, out.begin());
+                write_header(out.data(), s, tick);
+            }
+            sender.flush();
+
+            std::uint32_t received = 0;
+            std::uint32_t empty = 0;
+            while (received < count && empty < 2) {
+                const auto packets = receiver.receive(10ms);
+                empty += packets.empty();
+                received += static_cast<std::uint32_t>(packets.size());
+            }
+            syscalls += sender.stats().send_calls + receiver.stats().receive_calls - calls + empty;
+            return received;
+        });
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Output
+    // ---------------------------------------------------------------------------------------------
+
+    void print(const Options& options, const std::vector<Result>& results) {
+        const double baseline = results.front().cpu_percent_per_stream;
+        bench::Table table{"results", {
+            {.key = "transport", .header = "transport", .width = 14, .left = true},
+            {.key = "streams", .header = "streams", .width = 8},
+            {.key = "packets"},
+            {.key = "lost", .header = "lost", .width = 8},
+            {.key = "packets_per_second", .header = "packets/s", .width = 12},
+            {.key = "syscalls_per_packet", .header = "syscalls", .width = 10, .precision = 3},
+            {.key = "cpu_percent_per_stream", .header = "cpu/stream", .width = 12, .precision = 4, .unit = "%"},
+            {.key = "speedup", .header = "speedup", .width = 8, .precision = 2, .unit = "x"},
+        }};
+        for (const auto& r : results) {
+            table.add({r.transport, r.streams, r.packets, r.lost, r.packets_per_second, r.syscalls_per_packet,
+                       r.cpu_percent_per_stream, baseline / r.cpu_percent_per_stream});
+        }
+        bench::print(options.format, {table});
+    }
+
+    std::optional<Options> parse_options(int argc, char** argv) {
+        return bench::parse_options<Options>(argc, argv, [](Options& options, std::string_view name, std::string_view value) {
+            if (name == "--streams") return bench::parse_count(value, options.streams);
+            if (name == "--seconds") return bench::parse_count(value, options.seconds);
+            return false;
+        });
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_options(argc, argv);
+    if (!options) {
+        std::cerr << "Usage: " << argv[0] << " [--format text|csv|json] [--streams <n>] [--seconds <n>]" << std::endl;
+        return 1;
+    }
+
+    std::vector<Result> results;
+    results.push_back(bench_recvfrom(*options));
+    results.push_back(bench_mmsg(*options, false));
+    results.push_back(bench_mmsg(*options, true));
+
+    print(*options, results);
+    return 0;
+}
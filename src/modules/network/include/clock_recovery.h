@@ -0,0 +1,75 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_CLOCK_RECOVERY_H
+#define AKNET_CLOCK_RECOVERY_H
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace aknet::network {
+
+    struct ClockRecoveryConfig {
+        std::uint32_t sample_rate = 48000;  // nominal rate of both clocks
+        double bandwidth = 0.05;            // Hz, once locked: lower rejects more jitter, follows drift slower
+        double acquire_bandwidth = 1.0;     // Hz, at the start, narrowing down to `bandwidth`
+        double acquire_seconds = 10.0;      // how long the narrowing takes
+        double max_ppm = 1000.0;            // estimates are clamped to ±this
+    };
+
+    // -------------------------------------------------------------------------
+    // ClockRecovery: estimates the rate of a sender's clock against ours from the timestamps of its packets
+    // (the sender's sample positions) and their arrival times (our clock).
+    //
+    // Queueing in the network only ever delays packets, so over each window of 50 ms the packet that arrived
+    // earliest against the prediction stands for the sender's clock; the others are discarded. A second-order
+    // delay-locked loop corrects its phase and its period estimate by that packet's error, once per window.
+    // Its bandwidth starts wide, to lock within seconds, and narrows over acquire_seconds so that
+    // what jitter is left averages out. Errors far beyond the usual ones are clipped before reaching the loop.
+    //
+    // Single-threaded: the jitter buffer runs it on the audio thread as it files packets.
+    // -------------------------------------------------------------------------
+    class ClockRecovery {
+    public:
+        // Throws std::invalid_argument on a zero sample rate or a bandwidth that is not positive
+        explicit ClockRecovery(const ClockRecoveryConfig& config = {});
+
+        const ClockRecoveryConfig& config() const noexcept { return config_; }
+
+        // A packet: the sender's position of its first frame (unwrapped) and when it arrived, in steady clock
+        // nanoseconds. Packets older than the newest one so far (reordered) are ignored.
+        void update(std::int64_t timestamp, std::int64_t arrival_ns) noexcept;
+
+        // Forget the sender (it restarted): the next packet starts a new acquisition
+        void reset() noexcept;
+
+        // Sender frames per one of our frames: above 1 when the sender's clock runs fast. 1 before any packet.
+        double ratio() const noexcept { return nominal_period_ / period_; }
+
+        // The same, as the sender's offset in parts per million
+        double drift_ppm() const noexcept { return (ratio() - 1) * 1e6; }
+
+        // The acquisition is over: the estimate is as good as the locked bandwidth makes it
+        bool locked() const noexcept { return started_ && elapsed_ >= config_.acquire_seconds; }
+
+    private:
+        const ClockRecoveryConfig config_;
+        const double nominal_period_;       // seconds per frame
+
+        bool started_ = false;
+        std::int64_t origin_ns_ = 0;        // first arrival: times are in seconds from it
+        std::int64_t timestamp_ = 0;        // newest packet
+        double predicted_ = 0;              // arrival time of `timestamp_` without queueing delay
+        double period_;                     // seconds per sender frame, on our clock
+        double elapsed_ = 0;                // seconds since the first packet
+        double mean_error_ = 0;             // average magnitude of the errors, for clipping
+        double window_error_ = std::numeric_limits<double>::infinity(); // earliest arrival of the window
+        std::int64_t window_frames_ = 0;
+    };
+
+} // namespace aknet::network
+
+#endif // AKNET_CLOCK_RECOVERY_H
@@ -0,0 +1,162 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_JITTER_BUFFER_H
+#define AKNET_JITTER_BUFFER_H
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "clock_recovery.h"
+
+namespace aknet::network {
+
+    // Packets carry `packet_frames` interleaved frames and an RTP-style timestamp: the sample position of
+    // their first frame, a 32-bit counter that wraps.
+    struct JitterBufferConfig {
+        std::uint32_t sample_rate = 48000;
+        std::uint32_t channels = 2;
+        std::uint32_t packet_frames = 48;      // 1 ms at 48 kHz, the AES67 default
+        std::uint32_t queue_packets = 256;     // packets in flight between the two threads
+        std::uint32_t min_depth_frames = 48;   // the target depth adapts between these two
+        std::uint32_t max_depth_frames = 4800; // also the reordering window
+        std::uint32_t max_block_frames = 1024; // largest pop(): playout starts with a block and the depth buffered
+        double jitter_margin = 4.0;            // target depth: one packet plus this many times the jitter
+        double target_hold = 3.0;              // seconds a raised target depth holds before it comes down
+        double target_release = 1.0;           // seconds, time constant of its fall after that
+        double clock_bandwidth = 0.05;         // Hz, of the sender clock recovery once locked
+    };
+
+    // Counters since construction, read with relaxed loads (cheap, lock-free)
+    struct JitterBufferStats {
+        std::uint64_t received = 0;          // packets stored for playout
+        std::uint64_t late = 0;              // arrived after their playout time, dropped
+        std::uint64_t lost = 0;              // missing at their playout time, replaced by silence
+        std::uint64_t duplicates = 0;
+        std::uint64_t reordered = 0;         // arrived after a later packet, still in time
+        std::uint64_t overflows = 0;         // dropped: queue full or beyond the reordering window
+        std::uint64_t underruns = 0;         // playout caught up with the newest packet: rebuffering
+        std::uint64_t skipped_frames = 0;    // dropped to bring the depth back down to the target
+        std::uint64_t resyncs = 0;           // timestamp discontinuities (sender restarts)
+        std::uint32_t depth_frames = 0;      // buffered ahead of playout, after the last pop
+        std::uint32_t target_depth_frames = 0;
+        std::chrono::microseconds jitter{};  // interarrival jitter estimate (RFC 3550)
+        double drift_ppm = 0;                // sender's clock against ours, from the clock recovery
+    };
+
+    // -------------------------------------------------------------------------
+    // JitterBuffer: reorders the packets of one incoming stream and plays them out at a steady pace.
+    // One network thread pushes packets as they arrive; one audio thread pops blocks of planar frames.
+    // Both sides are lock-free, allocation-free and wait-free: packets cross a single-producer single-consumer
+    // queue, and the audio thread files them by timestamp in its own reorder buffer as it drains it.
+    //
+    // The depth (audio buffered ahead of playout, i.e. the added latency) tracks a target computed from
+    // the measured jitter: on a clean LAN it stays near one packet. When jitter grows, or a packet comes late,
+    // the target grows at once and the playout rebuffers on underrun. The target is the peak of what recent
+    // packets needed, held for target_hold then released over target_release, so delay spikes that recur
+    // every few seconds keep it up; when the network settles, the target shrinks and playout skips packets
+    // to follow it.
+    //
+    // The sender's clock is not ours: played at our rate, the depth drifts by its offset (100 ppm is 4.8 frames
+    // a second at 48 kHz) until it underruns or gets trimmed. A ClockRecovery estimates the offset from the
+    // packets' timestamps and arrivals, and playout_ratio() turns it into the rate to play at, through an
+    // ASRC (StreamPlayout does both).
+    // -------------------------------------------------------------------------
+    class JitterBuffer {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // Throws std::invalid_argument on zero sizes (max_block_frames included) or depths that cannot hold a packet
+        explicit JitterBuffer(const JitterBufferConfig& config = {});
+
+        JitterBuffer(const JitterBuffer&) = delete;
+        JitterBuffer& operator=(const JitterBuffer&) = delete;
+
+        const JitterBufferConfig& config() const noexcept { return config_; }
+
+        // Network thread: queue a packet of packet_frames * channels interleaved samples. Returns false
+        // (and counts an overflow) if the queue is full or the packet has the wrong size.
+        bool push(std::uint32_t timestamp, std::span<const float> samples, Clock::time_point arrival = Clock::now()) noexcept;
+
+        // Audio thread: write the next `frames` frames to one buffer per channel. Silence while (re)buffering
+        // and in place of missing packets. Blocks of more than max_block_frames never start playout.
+        void pop(std::span<float* const> channels, std::uint32_t frames) noexcept;
+
+        // Audio thread: sender frames to play per one of our frames, for an ASRC feeding on pop(). The
+        // recovered clock ratio, nudged by up to 100 ppm to bring the average depth back to the target.
+        double playout_ratio() const noexcept;
+
+        JitterBufferStats stats() const noexcept;
+
+    private:
+        struct QueuedPacket {
+            std::uint32_t timestamp;
+            std::int64_t arrival_ns;
+        };
+
+        void drain() noexcept;
+        void file(const QueuedPacket& packet, const float* samples) noexcept;
+        void resync(std::int64_t timestamp) noexcept;
+        void update_jitter(std::int64_t timestamp, std::int64_t arrival_ns) noexcept;
+        void update_target(std::int64_t needed, std::int64_t arrival_ns) noexcept;
+        void trim(std::uint32_t frames) noexcept;
+        std::int64_t depth() const noexcept { return newest_end_ - read_; }
+        std::int64_t packet_start(std::int64_t frame) const noexcept;
+        std::size_t slot_of(std::int64_t timestamp) const noexcept;
+        void silence(std::span<float* const> channels, std::uint32_t from, std::uint32_t to) noexcept;
+
+        const JitterBufferConfig config_;
+        const std::size_t packet_samples_;
+
+        // Queue: filled by the network thread, drained by the audio thread
+        std::vector<QueuedPacket> queue_;
+        std::vector<float> queue_samples_;
+        alignas(64) std::atomic<std::uint64_t> queue_tail_{0};
+        std::uint64_t cached_head_ = 0;      // network thread's last view of queue_head_
+        alignas(64) std::atomic<std::uint64_t> queue_head_{0};
+
+        // Reorder buffer and playout: audio thread only. Timestamps are unwrapped to 64 bits, and packets sit
+        // on a grid of packet_frames from the first one (the origin).
+        std::vector<std::int64_t> slot_timestamps_; // -1: empty
+        std::vector<float> slot_samples_;
+        std::size_t slot_mask_ = 0;
+        std::int64_t window_ = 0;            // frames ahead of playout a packet may be filed at
+        std::vector<float*> outputs_;        // pop()'s channel pointers, advanced
+        bool started_ = false;               // a first packet set the origin
+        bool playing_ = false;               // false: (re)buffering up to the target depth
+        std::int64_t origin_ = 0;
+        std::int64_t read_ = 0;              // next frame to play
+        std::int64_t newest_end_ = 0;        // end of the newest packet received
+        std::uint32_t last_timestamp_ = 0;   // last wire timestamp, to unwrap the next one
+        std::int64_t last_unwrapped_ = 0;
+        std::uint32_t out_of_window_ = 0;    // consecutive packets off the grid or the window
+        double jitter_ = 0;                  // frames
+        double previous_transit_ = 0;
+        bool has_transit_ = false;
+        std::int64_t target_ = 0;            // frames
+        double peak_ = 0;                    // largest depth recent packets needed, in frames
+        std::int64_t peak_ns_ = 0;           // arrival of the packet that set it
+        std::int64_t min_depth_ = 0;         // lowest depth after a pop in the current trim period
+        std::int64_t period_frames_ = 0;     // frames played in the current trim period
+        ClockRecovery clock_;
+        double mean_depth_ = 0;              // depth after a pop, averaged over about a second
+
+        // Each counter has a single writer
+        std::atomic<std::uint64_t> received_{0}, late_{0}, lost_{0}, duplicates_{0}, reordered_{0};
+        std::atomic<std::uint64_t> overflows_{0}, underruns_{0}, skipped_frames_{0}, resyncs_{0};
+        std::atomic<std::uint64_t> push_overflows_{0}; // network thread
+        std::atomic<std::uint32_t> depth_frames_{0}, target_depth_frames_{0};
+        std::atomic<std::int64_t> jitter_ns_{0};
+        std::atomic<double> drift_ppm_{0};
+    };
+
+} // namespace aknet::network
+
+#endif // AKNET_JITTER_BUFFER_H
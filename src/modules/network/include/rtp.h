@@ -0,0 +1,130 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_RTP_H
+#define AKNET_RTP_H
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <kernels.h>
+
+#include "jitter_buffer.h"
+#include "udp_socket.h"
+
+namespace aknet::network {
+
+    // -------------------------------------------------------------------------
+    // RTP packets (RFC 3550) carrying linear PCM the AES67 way: L16 or L24 big-endian interleaved samples,
+    // a fixed number of frames per packet, timestamps counting frames.
+    // -------------------------------------------------------------------------
+
+    inline constexpr std::size_t rtp_header_bytes = 12;
+
+    struct RtpHeader {
+        std::uint8_t payload_type = 96;  // dynamic range, as AES67 streams use
+        bool marker = false;
+        std::uint16_t sequence = 0;
+        std::uint32_t timestamp = 0;
+        std::uint32_t ssrc = 0;
+    };
+
+    struct RtpPacket {
+        RtpHeader header;
+        std::span<const std::byte> payload;
+    };
+
+    // Write a version 2 header without CSRCs or extension to the first rtp_header_bytes of `out`
+    void write_rtp_header(const RtpHeader& header, std::byte* out) noexcept;
+
+    // Header and payload of a packet, skipping CSRCs, extension and padding. nullopt if it is not RTP version 2
+    // or its lengths do not add up.
+    std::optional<RtpPacket> parse_rtp(std::span<const std::byte> packet) noexcept;
+
+    // One stream: who sends it and what its packets carry
+    struct RtpStreamConfig {
+        std::uint32_t ssrc = 0;
+        std::uint8_t payload_type = 96;
+        kernels::SampleFormat format = kernels::SampleFormat::int24;
+        std::uint32_t channels = 2;
+        std::uint32_t packet_frames = 48;
+
+        std::size_t payload_bytes() const noexcept {
+            return std::size_t{packet_frames} * channels * kernels::bytes_per_sample(format);
+        }
+    };
+
+    // -------------------------------------------------------------------------
+    // RtpSender: packetizes one stream into a socket's send batch. Senders of many streams share a socket,
+    // and one UdpSocket::flush() per packet period sends all their packets with a few syscalls.
+    // -------------------------------------------------------------------------
+    class RtpSender {
+    public:
+        // Throws std::invalid_argument on zero channels or frames, or packets too large for the socket
+        RtpSender(UdpSocket& socket, const Endpoint& destination, const RtpStreamConfig& config,
+                  std::uint32_t first_timestamp = 0, std::uint16_t first_sequence = 0);
+
+        const RtpStreamConfig& config() const noexcept { return config_; }
+
+        // Stage the next packet: packet_frames * channels interleaved samples.
+        // Throws std::invalid_argument on a wrong sample count.
+        void send(std::span<const float> samples);
+
+        std::uint32_t next_timestamp() const noexcept { return timestamp_; }
+        std::uint16_t next_sequence() const noexcept { return sequence_; }
+
+    private:
+        UdpSocket& socket_;
+        const Endpoint destination_;
+        const RtpStreamConfig config_;
+        std::uint32_t timestamp_;
+        std::uint16_t sequence_;
+    };
+
+    struct RtpReceiverStats {
+        std::uint64_t packets = 0;       // handed to a jitter buffer
+        std::uint64_t unknown = 0;       // no stream registered for the SSRC
+        std::uint64_t malformed = 0;     // not RTP, or not the stream's payload type or size
+        std::uint64_t rejected = 0;      // the jitter buffer's queue was full
+    };
+
+    // -------------------------------------------------------------------------
+    // RtpReceiver: the network thread's loop for every stream arriving on one socket. Each receive takes a
+    // batch of packets from the kernel, decodes them and pushes them to their stream's jitter buffer, with
+    // the kernel's arrival timestamp when the socket has them.
+    // -------------------------------------------------------------------------
+    class RtpReceiver {
+    public:
+        explicit RtpReceiver(UdpSocket& socket) : socket_(socket) {}
+
+        // Route packets with `config.ssrc` to `buffer` (whose channels and packet frames must match the
+        // stream's). Not while poll() runs. Throws std::invalid_argument on a mismatch or a known SSRC.
+        void add_stream(const RtpStreamConfig& config, JitterBuffer& buffer);
+
+        // One receive on the socket, waiting up to `timeout`. Returns the packets handed to jitter buffers.
+        std::size_t poll(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+        RtpReceiverStats stats() const noexcept { return stats_; }
+
+    private:
+        struct Stream {
+            RtpStreamConfig config;
+            JitterBuffer* buffer;
+            std::vector<float> samples;
+        };
+
+        UdpSocket& socket_;
+        std::vector<Stream> streams_; // sorted by SSRC
+        RtpReceiverStats stats_;
+    };
+
+} // namespace aknet::network
+
+#endif // AKNET_RTP_H
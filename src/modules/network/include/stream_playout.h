@@ -0,0 +1,53 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_STREAM_PLAYOUT_H
+#define AKNET_STREAM_PLAYOUT_H
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <asrc.h>
+#include <graph.h>
+
+#include "jitter_buffer.h"
+
+namespace aknet::network {
+
+    // -------------------------------------------------------------------------
+    // StreamPlayout: the engine node of a received stream, one output port per channel. Each block pulls
+    // frames from the stream's jitter buffer through an ASRC running at the buffer's playout_ratio(), so
+    // the stream plays on our clock without the buffer drifting. Adds the ASRC's latency (32 frames with
+    // the default filter) to the buffer's.
+    //
+    // The jitter buffer must outlive the node; the node is its only consumer.
+    // -------------------------------------------------------------------------
+    class StreamPlayout : public engine::Node {
+    public:
+        // `asrc` sets the filter; its channels and block size come from the buffer and the engine
+        explicit StreamPlayout(JitterBuffer& buffer, const engine::AsrcConfig& asrc = {});
+
+        std::size_t input_count() const override { return 0; }
+        std::size_t output_count() const override { return buffer_.config().channels; }
+
+        // Throws std::invalid_argument if the engine does not run at the stream's sample rate (the ASRC
+        // follows clock drift, it does not convert between rates), or if its blocks, through the ASRC, are
+        // larger than the buffer's max_block_frames
+        void prepare(const engine::ProcessSpec& spec) override;
+        void process(const engine::ProcessBlock& block) noexcept override;
+
+    private:
+        JitterBuffer& buffer_;
+        engine::AsrcConfig asrc_config_;
+        std::unique_ptr<engine::Asrc> asrc_;
+        std::vector<float> input_;         // frames popped from the buffer, planar
+        std::vector<float*> channels_;
+    };
+
+} // namespace aknet::network
+
+#endif // AKNET_STREAM_PLAYOUT_H
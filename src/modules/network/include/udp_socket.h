@@ -0,0 +1,119 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_UDP_SOCKET_H
+#define AKNET_UDP_SOCKET_H
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace aknet::network {
+
+    // IPv4 address and port, in host byte order
+    struct Endpoint {
+        std::uint32_t address = 0;
+        std::uint16_t port = 0;
+
+        // "a.b.c.d:port". Throws std::invalid_argument on anything else.
+        static Endpoint parse(std::string_view text);
+        std::string to_string() const;
+
+        bool operator==(const Endpoint&) const = default;
+    };
+
+    struct UdpSocketConfig {
+        Endpoint local{};                       // 0.0.0.0:0: every address, an ephemeral port
+        std::uint32_t batch = 64;               // packets per receive() and per send syscall
+        std::uint32_t max_packet_bytes = 1500;  // larger received packets are dropped
+        int buffer_bytes = 4 << 20;             // kernel send and receive buffers
+        bool timestamps = true;                 // kernel receive timestamps (SO_TIMESTAMPING, Linux)
+        bool offload = true;                    // UDP segmentation offload on send, GRO on receive (Linux)
+    };
+
+    struct ReceivedPacket {
+        std::span<const std::byte> data;
+        Endpoint source;
+        std::chrono::steady_clock::time_point arrival; // kernel timestamp if enabled, else when receive() returned
+    };
+
+    // Counters since construction
+    struct UdpSocketStats {
+        std::uint64_t receive_calls = 0;     // receive syscalls that returned packets
+        std::uint64_t received = 0;          // packets, after splitting coalesced (GRO) ones
+        std::uint64_t truncated = 0;         // longer than max_packet_bytes, dropped
+        std::uint64_t send_calls = 0;        // send syscalls
+        std::uint64_t sent = 0;              // packets
+        std::uint64_t send_errors = 0;       // packets the kernel refused (full buffer, unreachable...)
+    };
+
+    // -------------------------------------------------------------------------
+    // UdpSocket: a non-blocking IPv4 UDP socket that moves packets in batches, for many streams of small
+    // packets (RTP audio: hundreds of streams at a packet per millisecond). On Linux a receive() or flush()
+    // is one recvmmsg/sendmmsg for up to `batch` packets; with offload, runs of same-size packets to one
+    // destination leave as a single segmentation-offloaded (GSO) message, and the kernel may hand over
+    // received packets coalesced (GRO), which receive() splits again. Elsewhere the same calls loop over
+    // recvmsg/sendmsg.
+    //
+    // Packet memory is allocated once, at construction: `batch` receive buffers and `batch` send buffers,
+    // with their message headers, address and control buffers already pointing at them, so the hot path
+    // fills in lengths only. Not thread-safe: use a socket from one thread (usually one per direction).
+    // -------------------------------------------------------------------------
+    class UdpSocket {
+    public:
+        // Throws std::invalid_argument on a zero batch or packet size, std::system_error if the socket cannot
+        // be created or bound
+        explicit UdpSocket(const UdpSocketConfig& config = {});
+        ~UdpSocket();
+
+        UdpSocket(const UdpSocket&) = delete;
+        UdpSocket& operator=(const UdpSocket&) = delete;
+
+        const UdpSocketConfig& config() const noexcept { return config_; }
+
+        // Bound address, with the port the kernel chose
+        Endpoint local_endpoint() const;
+
+        // Features the kernel accepted (the config asks for them)
+        bool segmentation_offload() const noexcept { return gso_; }
+        bool receive_offload() const noexcept { return gro_; }
+        bool kernel_timestamps() const noexcept { return timestamps_; }
+
+        int native_handle() const noexcept { return fd_; }
+
+        // Wait up to `timeout` for packets (zero: do not wait), then take up to `batch` messages from the
+        // kernel. The packets stay valid until the next receive().
+        std::span<const ReceivedPacket> receive(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+        // Reserve room for a packet of `bytes` to `destination` and return it for the caller to fill in.
+        // Packets are sent by flush(), or by stage() itself once `batch` are waiting.
+        // Throws std::invalid_argument if bytes is zero or more than max_packet_bytes.
+        std::span<std::byte> stage(const Endpoint& destination, std::size_t bytes);
+
+        // Send the staged packets. Returns how many the kernel took; the others are dropped and counted.
+        std::size_t flush();
+
+        UdpSocketStats stats() const noexcept { return stats_; }
+
+    private:
+        struct Buffers;
+
+        UdpSocketConfig config_;
+        int fd_ = -1;
+        bool gso_ = false;
+        bool gro_ = false;
+        bool timestamps_ = false;
+        std::unique_ptr<Buffers> buffers_;
+        UdpSocketStats stats_;
+    };
+
+} // namespace aknet::network
+
+#endif // AKNET_UDP_SOCKET_H
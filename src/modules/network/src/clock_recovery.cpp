@@ -0,0 +1,93 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "clock_recovery.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+
+namespace aknet::network {
+
+    namespace {
+        // Window errors beyond this many times their average magnitude, plus the floor, are clipped
+        constexpr double clip_factor = 4.0;
+        constexpr double clip_floor = 0.5e-3; // seconds
+
+        // Gain of the average error magnitude
+        constexpr double error_gain = 1.0 / 64.0;
+
+        // Packets the loop takes the earliest of, in seconds of audio
+        constexpr double window_seconds = 0.05;
+
+        // Largest loop gain per window: a packet after a long gap must not make the loop unstable
+        constexpr double max_omega = 0.5;
+
+        ClockRecoveryConfig validated(const ClockRecoveryConfig& config) {
+            if (config.sample_rate == 0) throw std::invalid_argument("Clock recovery sample rate must not be zero");
+            if (!(config.bandwidth > 0) || !(config.acquire_bandwidth > 0) || !(config.max_ppm > 0) ||
+                config.acquire_seconds < 0) {
+                throw std::invalid_argument("Clock recovery bandwidths and maximum drift must be positive");
+            }
+            return config;
+        }
+    }
+
+    ClockRecovery::ClockRecovery(const ClockRecoveryConfig& config)
+        : config_(validated(config)),
+          nominal_period_(1.0 / config.sample_rate),
+          period_(nominal_period_) {}
+
+    void ClockRecovery::update(std::int64_t timestamp, std::int64_t arrival_ns) noexcept {
+        if (!started_) {
+            started_ = true;
+            origin_ns_ = arrival_ns;
+            timestamp_ = timestamp;
+            predicted_ = 0;
+            return;
+        }
+        const std::int64_t frames = timestamp - timestamp_;
+        if (frames <= 0) return;
+        timestamp_ = timestamp;
+
+        // Queueing only ever delays packets: the earliest one of a window is the closest to the sender's clock
+        predicted_ += static_cast<double>(frames) * period_;
+        const double arrival = static_cast<double>(arrival_ns - origin_ns_) * 1e-9;
+        window_error_ = std::min(window_error_, arrival - predicted_);
+        window_frames_ += frames;
+        const double interval = static_cast<double>(window_frames_) * nominal_period_;
+        if (interval < window_seconds) return;
+
+        const double limit = clip_factor * mean_error_ + clip_floor;
+        const double error = std::clamp(window_error_, -limit, limit);
+        mean_error_ += (std::abs(error) - mean_error_) * error_gain;
+
+        // The bandwidth narrows geometrically from the acquisition one to the locked one
+        elapsed_ += interval;
+        const double progress = config_.acquire_seconds > 0 ? std::min(elapsed_ / config_.acquire_seconds, 1.0) : 1.0;
+        const double bandwidth = config_.acquire_bandwidth * std::pow(config_.bandwidth / config_.acquire_bandwidth, progress);
+
+        // Second-order loop damped at 1 / sqrt(2), its gains for this window
+        const double omega = std::min(2 * std::numbers::pi * bandwidth * interval, max_omega);
+        predicted_ += std::numbers::sqrt2 * omega * error;
+        period_ += omega * omega * error / static_cast<double>(window_frames_);
+
+        const double max_drift = config_.max_ppm * 1e-6;
+        period_ = std::clamp(period_, nominal_period_ / (1 + max_drift), nominal_period_ / (1 - max_drift));
+        window_error_ = std::numeric_limits<double>::infinity();
+        window_frames_ = 0;
+    }
+
+    void ClockRecovery::reset() noexcept {
+        started_ = false;
+        period_ = nominal_period_;
+        elapsed_ = 0;
+        mean_error_ = 0;
+        window_error_ = std::numeric_limits<double>::infinity();
+        window_frames_ = 0;
+    }
+
+} // namespace aknet::network
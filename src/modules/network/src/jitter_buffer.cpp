@@ -0,0 +1,299 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "jitter_buffer.h"
+
+#include <counters.h>
+#include <kernels.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace aknet::network {
+
+    namespace {
+        // Gain of the RFC 3550 jitter estimator
+        constexpr double jitter_gain = 1.0 / 16.0;
+
+        // Packets off the grid or the window in a row before the stream is considered restarted
+        constexpr std::uint32_t resync_after = 4;
+
+        // Playout ratio correction per second of average depth error: the error closes with a 20 s time
+        // constant, slow enough to be inaudible, and never by more than max_depth_correction
+        constexpr double depth_correction_gain = 0.05;
+        constexpr double max_depth_correction = 100e-6;
+
+        JitterBufferConfig validated(const JitterBufferConfig& config) {
+            if (config.sample_rate == 0 || config.channels == 0 || config.packet_frames == 0 || config.queue_packets == 0 ||
+                config.max_block_frames == 0) {
+                throw std::invalid_argument("Jitter buffer sample rate, channels, packet frames, queue size and block size must not be zero");
+            }
+            if (config.max_depth_frames < config.packet_frames || config.min_depth_frames > config.max_depth_frames) {
+                throw std::invalid_argument("Jitter buffer depths must satisfy min <= max and packet frames <= max");
+            }
+            if (!(config.target_hold >= 0) || !(config.target_release > 0)) {
+                throw std::invalid_argument("Jitter buffer target hold must not be negative, and its release must be positive");
+            }
+            return config;
+        }
+    }
+
+    JitterBuffer::JitterBuffer(const JitterBufferConfig& config)
+        : config_(validated(config)),
+          packet_samples_(std::size_t{config.packet_frames} * config.channels),
+          queue_(std::bit_ceil(config.queue_packets)),
+          queue_samples_(queue_.size() * packet_samples_),
+          outputs_(config.channels),
+          clock_({.sample_rate = config.sample_rate, .bandwidth = config.clock_bandwidth}) {
+        // Room for the packet being played and every packet up to the maximum depth and a block after it: playout
+        // starts with that much buffered
+        const std::size_t ahead = std::size_t{config.max_depth_frames} + config.max_block_frames;
+        const std::size_t slots = std::bit_ceil(ahead / config.packet_frames + 2);
+        slot_timestamps_.assign(slots, -1);
+        slot_samples_.resize(slots * packet_samples_);
+        slot_mask_ = slots - 1;
+        window_ = static_cast<std::int64_t>((slots - 1) * config.packet_frames);
+        target_ = std::clamp<std::int64_t>(config.packet_frames, config.min_depth_frames, config.max_depth_frames);
+        peak_ = static_cast<double>(target_);
+        target_depth_frames_.store(static_cast<std::uint32_t>(target_), std::memory_order_relaxed);
+    }
+
+    // -------------------------------------------------------------------------
+    // Network thread
+    // -------------------------------------------------------------------------
+
+    bool JitterBuffer::push(std::uint32_t timestamp, std::span<const float> samples, Clock::time_point arrival) noexcept {
+        const auto tail = queue_tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ >= queue_.size()) cached_head_ = queue_head_.load(std::memory_order_acquire);
+        if (samples.size() != packet_samples_ || tail - cached_head_ >= queue_.size()) {
+            bump(push_overflows_);
+            return false;
+        }
+
+        const std::size_t index = tail & (queue_.size() - 1);
+        queue_[index] = {
+            .timestamp = timestamp,
+            .arrival_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(arrival.time_since_epoch()).count(),
+        };
+        std::ranges::copy(samples, queue_samples_.begin() + static_cast<std::ptrdiff_t>(index * packet_samples_));
+        queue_tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // -------------------------------------------------------------------------
+    // Audio thread
+    // -------------------------------------------------------------------------
+
+    void JitterBuffer::pop(std::span<float* const> channels, std::uint32_t frames) noexcept {
+        drain();
+
+        if (!playing_) {
+            // Start once the block can be played with the target depth left behind it
+            if (!started_ || depth() < target_ + frames || frames > config_.max_block_frames) {
+                silence(channels, 0, frames);
+                depth_frames_.store(static_cast<std::uint32_t>(std::max<std::int64_t>(depth(), 0)), std::memory_order_relaxed);
+                return;
+            }
+            playing_ = true;
+            min_depth_ = depth();
+            mean_depth_ = static_cast<double>(depth() - frames);
+            period_frames_ = 0;
+        }
+
+        const std::int64_t pf = config_.packet_frames;
+        std::uint32_t done = 0;
+        while (done < frames) {
+            if (read_ >= newest_end_) {
+                // Nothing left: rebuffer, holding playout where it is
+                bump(underruns_);
+                playing_ = false;
+                silence(channels, done, frames);
+                break;
+            }
+
+            const std::int64_t start = packet_start(read_);
+            const std::int64_t offset = read_ - start;
+            const auto n = static_cast<std::uint32_t>(std::min<std::int64_t>(pf - offset, frames - done));
+            const std::size_t slot = slot_of(start);
+            if (slot_timestamps_[slot] == start) {
+                for (std::size_t c = 0; c < outputs_.size(); c++) outputs_[c] = channels[c] + done;
+                const float* samples = slot_samples_.data() + slot * packet_samples_;
+                kernels::deinterleave(samples + offset * config_.channels, outputs_, n);
+            } else {
+                if (offset == 0) bump(lost_);
+                silence(channels, done, done + n);
+            }
+
+            read_ += n;
+            done += n;
+            if (offset + n == pf) slot_timestamps_[slot] = -1;
+        }
+
+        if (playing_) {
+            mean_depth_ += (static_cast<double>(depth()) - mean_depth_) * frames / config_.sample_rate;
+            trim(frames);
+        }
+        depth_frames_.store(static_cast<std::uint32_t>(std::max<std::int64_t>(depth(), 0)), std::memory_order_relaxed);
+    }
+
+    void JitterBuffer::drain() noexcept {
+        auto head = queue_head_.load(std::memory_order_relaxed);
+        const auto tail = queue_tail_.load(std::memory_order_acquire);
+        for (; head != tail; head++) {
+            const std::size_t index = head & (queue_.size() - 1);
+            file(queue_[index], queue_samples_.data() + index * packet_samples_);
+        }
+        queue_head_.store(head, std::memory_order_release);
+    }
+
+    void JitterBuffer::file(const QueuedPacket& packet, const float* samples) noexcept {
+        // Unwrap the 32-bit timestamp around the previous one
+        const std::int64_t timestamp = last_unwrapped_ + static_cast<std::int32_t>(packet.timestamp - last_timestamp_);
+        last_timestamp_ = packet.timestamp;
+        last_unwrapped_ = timestamp;
+
+        if (!started_) resync(timestamp);
+
+        const std::int64_t pf = config_.packet_frames;
+        const bool on_grid = (timestamp - origin_) % pf == 0;
+        if (!on_grid || timestamp - read_ >= window_ || read_ - timestamp > window_) {
+            // A few strays are dropped; a run of them means the sender restarted with a new timeline
+            if (++out_of_window_ < resync_after) {
+                bump(overflows_);
+                return;
+            }
+            bump(resyncs_);
+            resync(timestamp);
+        }
+        out_of_window_ = 0;
+        update_jitter(timestamp, packet.arrival_ns);
+        clock_.update(timestamp, packet.arrival_ns);
+        drift_ppm_.store(clock_.drift_ppm(), std::memory_order_relaxed);
+
+        // A packet is in time if the depth covers how far it arrived behind the newest one
+        update_target(newest_end_ - timestamp, packet.arrival_ns);
+        if (timestamp < read_) {
+            // Too late: rebuffer up to the raised target, so that the next one this late is in time
+            bump(late_);
+            playing_ = false;
+            return;
+        }
+
+        const std::size_t slot = slot_of(timestamp);
+        if (slot_timestamps_[slot] == timestamp) {
+            bump(duplicates_);
+            return;
+        }
+        std::copy_n(samples, packet_samples_, slot_samples_.begin() + static_cast<std::ptrdiff_t>(slot * packet_samples_));
+        slot_timestamps_[slot] = timestamp;
+        bump(received_);
+
+        if (timestamp + pf <= newest_end_) {
+            bump(reordered_);
+        } else {
+            newest_end_ = timestamp + pf;
+        }
+    }
+
+    void JitterBuffer::resync(std::int64_t timestamp) noexcept {
+        std::ranges::fill(slot_timestamps_, -1);
+        started_ = true;
+        playing_ = false;
+        origin_ = timestamp;
+        read_ = timestamp;
+        newest_end_ = timestamp;
+        has_transit_ = false;
+        peak_ = static_cast<double>(target_);
+        peak_ns_ = 0;
+        clock_.reset();
+    }
+
+    void JitterBuffer::update_jitter(std::int64_t timestamp, std::int64_t arrival_ns) noexcept {
+        // Transit time in frames, up to a constant offset between the sender's clock and ours
+        const double arrival = static_cast<double>(arrival_ns) * 1e-9 * config_.sample_rate;
+        const double transit = arrival - static_cast<double>(timestamp);
+        if (has_transit_) jitter_ += (std::abs(transit - previous_transit_) - jitter_) * jitter_gain;
+        previous_transit_ = transit;
+        has_transit_ = true;
+        jitter_ns_.store(std::llround(jitter_ * 1e9 / config_.sample_rate), std::memory_order_relaxed);
+    }
+
+    void JitterBuffer::update_target(std::int64_t needed, std::int64_t arrival_ns) noexcept {
+        // The peak holds, then decays; what this packet needed, or the jitter asks for, raises it at once
+        const double since = static_cast<double>(arrival_ns - peak_ns_) * 1e-9 - config_.target_hold;
+        const double held = since > 0 ? peak_ * std::exp(-since / config_.target_release) : peak_;
+        const auto wanted = std::max<double>(static_cast<double>(needed),
+                                             config_.packet_frames + config_.jitter_margin * jitter_);
+        if (wanted >= held) {
+            peak_ = wanted;
+            peak_ns_ = arrival_ns;
+        }
+        target_ = std::clamp<std::int64_t>(std::llround(std::max(wanted, held)), config_.min_depth_frames,
+                                           config_.max_depth_frames);
+        target_depth_frames_.store(static_cast<std::uint32_t>(target_), std::memory_order_relaxed);
+    }
+
+    double JitterBuffer::playout_ratio() const noexcept {
+        if (!playing_) return clock_.ratio();
+        // The depth after a pop goes down to the target and back up by a packet as packets arrive
+        const double wanted = static_cast<double>(target_) + config_.packet_frames / 2.0;
+        const double error = (mean_depth_ - wanted) / config_.sample_rate;
+        return clock_.ratio() * (1 + std::clamp(error * depth_correction_gain, -max_depth_correction, max_depth_correction));
+    }
+
+    // Once a second of playout, skip the whole packets the depth never needed: whatever stayed above the
+    // target for the whole period.
+    void JitterBuffer::trim(std::uint32_t frames) noexcept {
+        min_depth_ = std::min(min_depth_, depth());
+        period_frames_ += frames;
+        if (period_frames_ < config_.sample_rate) return;
+
+        const std::int64_t pf = config_.packet_frames;
+        if (const std::int64_t surplus = min_depth_ - target_; surplus >= pf) {
+            const std::int64_t end = read_ + surplus / pf * pf;
+            for (std::int64_t start = packet_start(read_); start + pf <= end; start += pf) {
+                if (std::int64_t& slot = slot_timestamps_[slot_of(start)]; slot == start) slot = -1;
+            }
+            bump(skipped_frames_, static_cast<std::uint64_t>(end - read_));
+            read_ = end;
+        }
+        min_depth_ = depth();
+        period_frames_ = 0;
+    }
+
+    std::int64_t JitterBuffer::packet_start(std::int64_t frame) const noexcept {
+        const std::int64_t pf = config_.packet_frames;
+        const std::int64_t offset = frame - origin_;
+        return origin_ + (offset >= 0 ? offset / pf : (offset - pf + 1) / pf) * pf;
+    }
+
+    std::size_t JitterBuffer::slot_of(std::int64_t timestamp) const noexcept {
+        return static_cast<std::size_t>((timestamp - origin_) / config_.packet_frames) & slot_mask_;
+    }
+
+    void JitterBuffer::silence(std::span<float* const> channels, std::uint32_t from, std::uint32_t to) noexcept {
+        for (float* channel : channels) std::fill(channel + from, channel + to, 0.0f);
+    }
+
+    JitterBufferStats JitterBuffer::stats() const noexcept {
+        return {
+            .received = received_.load(std::memory_order_relaxed),
+            .late = late_.load(std::memory_order_relaxed),
+            .lost = lost_.load(std::memory_order_relaxed),
+            .duplicates = duplicates_.load(std::memory_order_relaxed),
+            .reordered = reordered_.load(std::memory_order_relaxed),
+            .overflows = overflows_.load(std::memory_order_relaxed) + push_overflows_.load(std::memory_order_relaxed),
+            .underruns = underruns_.load(std::memory_order_relaxed),
+            .skipped_frames = skipped_frames_.load(std::memory_order_relaxed),
+            .resyncs = resyncs_.load(std::memory_order_relaxed),
+            .depth_frames = depth_frames_.load(std::memory_order_relaxed),
+            .target_depth_frames = target_depth_frames_.load(std::memory_order_relaxed),
+            .jitter = std::chrono::microseconds(jitter_ns_.load(std::memory_order_relaxed) / 1000),
+            .drift_ppm = drift_ppm_.load(std::memory_order_relaxed),
+        };
+    }
+
+} // namespace aknet::network
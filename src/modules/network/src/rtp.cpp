@@ -0,0 +1,154 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "rtp.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace aknet::network {
+
+    namespace {
+        void put16(std::byte* out, std::uint16_t value) noexcept {
+            out[0] = static_cast<std::byte>(value >> 8);
+            out[1] = static_cast<std::byte>(value);
+        }
+
+        void put32(std::byte* out, std::uint32_t value) noexcept {
+            put16(out, static_cast<std::uint16_t>(value >> 16));
+            put16(out + 2, static_cast<std::uint16_t>(value));
+        }
+
+        std::uint16_t get16(const std::byte* in) noexcept {
+            return static_cast<std::uint16_t>(std::to_integer<unsigned>(in[0]) << 8 | std::to_integer<unsigned>(in[1]));
+        }
+
+        std::uint32_t get32(const std::byte* in) noexcept {
+            return std::uint32_t{get16(in)} << 16 | get16(in + 2);
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Packets
+    // -------------------------------------------------------------------------
+
+    void write_rtp_header(const RtpHeader& header, std::byte* out) noexcept {
+        out[0] = std::byte{0x80}; // version 2
+        out[1] = static_cast<std::byte>((header.marker ? 0x80 : 0) | (header.payload_type & 0x7F));
+        put16(out + 2, header.sequence);
+        put32(out + 4, header.timestamp);
+        put32(out + 8, header.ssrc);
+    }
+
+    std::optional<RtpPacket> parse_rtp(std::span<const std::byte> packet) noexcept {
+        if (packet.size() < rtp_header_bytes) return {};
+        const auto first = std::to_integer<unsigned>(packet[0]);
+        if (first >> 6 != 2) return {};
+
+        RtpPacket result;
+        result.header.marker = (std::to_integer<unsigned>(packet[1]) & 0x80) != 0;
+        result.header.payload_type = static_cast<std::uint8_t>(std::to_integer<unsigned>(packet[1]) & 0x7F);
+        result.header.sequence = get16(packet.data() + 2);
+        result.header.timestamp = get32(packet.data() + 4);
+        result.header.ssrc = get32(packet.data() + 8);
+
+        std::size_t begin = rtp_header_bytes + 4 * (first & 0x0F);
+        if (first & 0x10) {
+            if (packet.size() < begin + 4) return {};
+            begin += 4 + 4 * std::size_t{get16(packet.data() + begin + 2)};
+        }
+        std::size_t end = packet.size();
+        if (first & 0x20) {
+            const auto padding = std::to_integer<std::size_t>(packet.back());
+            if (padding == 0 || padding > end) return {};
+            end -= padding;
+        }
+        if (begin > end) return {};
+        result.payload = packet.subspan(begin, end - begin);
+        return result;
+    }
+
+    // -------------------------------------------------------------------------
+    // RtpSender
+    // -------------------------------------------------------------------------
+
+    RtpSender::RtpSender(UdpSocket& socket, const Endpoint& destination, const RtpStreamConfig& config,
+                         std::uint32_t first_timestamp, std::uint16_t first_sequence)
+        : socket_(socket),
+          destination_(destination),
+          config_(config),
+          timestamp_(first_timestamp),
+          sequence_(first_sequence) {
+        if (config.channels == 0 || config.packet_frames == 0) {
+            throw std::invalid_argument("RTP stream channels and packet frames must not be zero");
+        }
+        if (rtp_header_bytes + config.payload_bytes() > socket.config().max_packet_bytes) {
+            throw std::invalid_argument("RTP stream packets are larger than the socket's maximum packet size");
+        }
+    }
+
+    void RtpSender::send(std::span<const float> samples) {
+        const std::size_t count = std::size_t{config_.packet_frames} * config_.channels;
+        if (samples.size() != count) {
+            throw std::invalid_argument("RTP packet must hold packet_frames * channels samples");
+        }
+
+        const auto packet = socket_.stage(destination_, rtp_header_bytes + config_.payload_bytes());
+        write_rtp_header({.payload_type = config_.payload_type, .sequence = sequence_, .timestamp = timestamp_,
+                          .ssrc = config_.ssrc},
+                         packet.data());
+        kernels::encode(config_.format, samples.data(), packet.data() + rtp_header_bytes, count);
+
+        sequence_++;
+        timestamp_ += config_.packet_frames;
+    }
+
+    // -------------------------------------------------------------------------
+    // RtpReceiver
+    // -------------------------------------------------------------------------
+
+    void RtpReceiver::add_stream(const RtpStreamConfig& config, JitterBuffer& buffer) {
+        if (config.channels != buffer.config().channels || config.packet_frames != buffer.config().packet_frames) {
+            throw std::invalid_argument("RTP stream and jitter buffer differ in channels or packet frames");
+        }
+        const auto at = std::ranges::lower_bound(streams_, config.ssrc, {}, [](const Stream& s) { return s.config.ssrc; });
+        if (at != streams_.end() && at->config.ssrc == config.ssrc) {
+            throw std::invalid_argument("RTP stream SSRC is already registered");
+        }
+        streams_.insert(at, {config, &buffer, std::vector<float>(std::size_t{config.packet_frames} * config.channels)});
+    }
+
+    std::size_t RtpReceiver::poll(std::chrono::milliseconds timeout) {
+        std::size_t delivered = 0;
+        for (const auto& received : socket_.receive(timeout)) {
+            const auto packet = parse_rtp(received.data);
+            if (!packet) {
+                stats_.malformed++;
+                continue;
+            }
+            const auto at = std::ranges::lower_bound(streams_, packet->header.ssrc, {},
+                                                     [](const Stream& s) { return s.config.ssrc; });
+            if (at == streams_.end() || at->config.ssrc != packet->header.ssrc) {
+                stats_.unknown++;
+                continue;
+            }
+            Stream& stream = *at;
+            if (packet->header.payload_type != stream.config.payload_type ||
+                packet->payload.size() != stream.config.payload_bytes()) {
+                stats_.malformed++;
+                continue;
+            }
+
+            kernels::decode(stream.config.format, packet->payload.data(), stream.samples.data(), stream.samples.size());
+            if (stream.buffer->push(packet->header.timestamp, stream.samples, received.arrival)) {
+                delivered++;
+            } else {
+                stats_.rejected++;
+            }
+        }
+        stats_.packets += delivered;
+        return delivered;
+    }
+
+} // namespace aknet::network
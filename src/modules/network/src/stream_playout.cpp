@@ -0,0 +1,41 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "stream_playout.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace aknet::network {
+
+    StreamPlayout::StreamPlayout(JitterBuffer& buffer, const engine::AsrcConfig& asrc)
+        : buffer_(buffer), asrc_config_(asrc) {
+        asrc_config_.channels = buffer.config().channels;
+    }
+
+    void StreamPlayout::prepare(const engine::ProcessSpec& spec) {
+        if (spec.sample_rate != buffer_.config().sample_rate) {
+            throw std::invalid_argument("Stream playout needs the engine to run at the stream's sample rate");
+        }
+        asrc_config_.max_block = spec.block_size;
+        auto asrc = std::make_unique<engine::Asrc>(asrc_config_);
+        if (asrc->max_input_frames() > buffer_.config().max_block_frames) {
+            throw std::invalid_argument("Stream playout blocks are larger than the jitter buffer's max_block_frames");
+        }
+        asrc_ = std::move(asrc);
+
+        const std::size_t stride = asrc_->max_input_frames();
+        input_.assign(stride * asrc_config_.channels, 0.0f);
+        channels_.resize(asrc_config_.channels);
+        for (std::size_t c = 0; c < channels_.size(); c++) channels_[c] = input_.data() + c * stride;
+    }
+
+    void StreamPlayout::process(const engine::ProcessBlock& block) noexcept {
+        asrc_->set_ratio(buffer_.playout_ratio());
+        const std::uint32_t frames = asrc_->input_frames(block.frames);
+        buffer_.pop(channels_, frames);
+        asrc_->process(channels_, block.outputs, block.frames);
+    }
+
+} // namespace aknet::network
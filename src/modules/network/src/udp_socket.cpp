@@ -0,0 +1,398 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "udp_socket.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <format>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/net_tstamp.h>
+#include <netinet/udp.h>
+#endif
+
+#if defined(__linux__) && !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
+#if defined(__linux__) && !defined(UDP_GRO)
+#define UDP_GRO 104
+#endif
+
+namespace aknet::network {
+
+    namespace {
+#ifdef __linux__
+        using Message = mmsghdr;
+#else
+        struct Message {
+            msghdr msg_hdr;
+            unsigned msg_len;
+        };
+#endif
+
+        // Room for a timestamp and a GRO segment size, or a GSO segment size
+        struct alignas(alignof(cmsghdr)) Control {
+            std::byte data[128];
+        };
+
+        // Kernel limits on one segmentation-offloaded message
+        constexpr std::size_t max_offload_segments = 64;
+        constexpr std::size_t max_offload_bytes = 65000;
+
+        // Largest message with GRO on: a whole coalesced run of segments
+        constexpr std::size_t max_coalesced_bytes = 65536;
+
+        // SCM_TIMESTAMPING payload: software, (deprecated), hardware
+        struct Timestamping {
+            timespec ts[3];
+        };
+
+        sockaddr_in to_sockaddr(const Endpoint& endpoint) noexcept {
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(endpoint.address);
+            address.sin_port = htons(endpoint.port);
+            return address;
+        }
+
+        Endpoint from_sockaddr(const sockaddr_in& address) noexcept {
+            return {ntohl(address.sin_addr.s_addr), ntohs(address.sin_port)};
+        }
+
+        [[noreturn]] void throw_errno(const std::string& what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        // Up to n messages in one call, or a loop where there is no recvmmsg. Returns the count, or -1 with errno
+        // set if the first one failed.
+        int receive_messages(int fd, Message* messages, std::size_t n) noexcept {
+#ifdef __linux__
+            return recvmmsg(fd, messages, static_cast<unsigned>(n), MSG_DONTWAIT, nullptr);
+#else
+            for (std::size_t i = 0; i < n; i++) {
+                const ssize_t bytes = recvmsg(fd, &messages[i].msg_hdr, MSG_DONTWAIT);
+                if (bytes < 0) return i > 0 ? static_cast<int>(i) : -1;
+                messages[i].msg_len = static_cast<unsigned>(bytes);
+            }
+            return static_cast<int>(n);
+#endif
+        }
+
+        int send_messages(int fd, Message* messages, std::size_t n) noexcept {
+#ifdef __linux__
+            return sendmmsg(fd, messages, static_cast<unsigned>(n), MSG_DONTWAIT);
+#else
+            for (std::size_t i = 0; i < n; i++) {
+                const ssize_t bytes = sendmsg(fd, &messages[i].msg_hdr, MSG_DONTWAIT);
+                if (bytes < 0) return i > 0 ? static_cast<int>(i) : -1;
+                messages[i].msg_len = static_cast<unsigned>(bytes);
+            }
+            return static_cast<int>(n);
+#endif
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Endpoint
+    // -------------------------------------------------------------------------
+
+    Endpoint Endpoint::parse(std::string_view text) {
+        const auto invalid = [&] { return std::invalid_argument(std::format("Invalid IPv4 endpoint: '{}'", text)); };
+
+        Endpoint endpoint;
+        const char* p = text.data();
+        const char* end = text.data() + text.size();
+        for (int i = 0; i < 4; i++) {
+            unsigned byte = 0;
+            const auto [next, ec] = std::from_chars(p, end, byte);
+            if (ec != std::errc{} || byte > 255 || next == end || *next != (i < 3 ? '.' : ':')) throw invalid();
+            endpoint.address = endpoint.address << 8 | byte;
+            p = next + 1;
+        }
+        const auto [next, ec] = std::from_chars(p, end, endpoint.port);
+        if (ec != std::errc{} || next != end || p == end) throw invalid();
+        return endpoint;
+    }
+
+    std::string Endpoint::to_string() const {
+        return std::format("{}.{}.{}.{}:{}", address >> 24, address >> 16 & 0xFF, address >> 8 & 0xFF, address & 0xFF,
+                           port);
+    }
+
+    // -------------------------------------------------------------------------
+    // Buffers: allocated and wired together once
+    // -------------------------------------------------------------------------
+
+    struct UdpSocket::Buffers {
+        Buffers(std::size_t batch, std::size_t max_packet, std::size_t receive_bytes)
+            : receive_bytes(receive_bytes),
+              receive_data(batch * receive_bytes),
+              receive_iov(batch),
+              receive_names(batch),
+              receive_control(batch),
+              receive_messages(batch),
+              packets(receive_bytes > max_packet ? batch * max_offload_segments : batch),
+              max_packet(max_packet),
+              send_data(batch * max_packet),
+              send_iov(batch),
+              send_destinations(batch),
+              send_names(batch),
+              send_control(batch),
+              send_messages(batch),
+              send_segments(batch) {
+            for (std::size_t i = 0; i < batch; i++) {
+                receive_iov[i] = {receive_data.data() + i * receive_bytes, receive_bytes};
+                msghdr& r = receive_messages[i].msg_hdr;
+                r.msg_name = &receive_names[i];
+                r.msg_iov = &receive_iov[i];
+                r.msg_iovlen = 1;
+                r.msg_control = receive_control[i].data;
+
+                send_iov[i].iov_base = send_data.data() + i * max_packet;
+                send_messages[i].msg_hdr.msg_name = &send_names[i];
+                send_messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            }
+        }
+
+        // Receive: one buffer per message
+        std::size_t receive_bytes;
+        std::vector<std::byte> receive_data;
+        std::vector<iovec> receive_iov;
+        std::vector<sockaddr_in> receive_names;
+        std::vector<Control> receive_control;
+        std::vector<Message> receive_messages;
+        std::vector<ReceivedPacket> packets;
+
+        // Send: one buffer per staged packet; a message covers one packet, or a run of them with offload
+        std::size_t max_packet;
+        std::vector<std::byte> send_data;
+        std::vector<iovec> send_iov;
+        std::vector<Endpoint> send_destinations;
+        std::vector<sockaddr_in> send_names;
+        std::vector<Control> send_control;
+        std::vector<Message> send_messages;
+        std::vector<std::size_t> send_segments; // packets per message
+        std::size_t staged = 0;
+    };
+
+    // -------------------------------------------------------------------------
+    // UdpSocket
+    // -------------------------------------------------------------------------
+
+    UdpSocket::UdpSocket(const UdpSocketConfig& config) : config_(config) {
+        if (config.batch == 0 || config.max_packet_bytes == 0) {
+            throw std::invalid_argument("UDP socket batch and packet sizes must not be zero");
+        }
+
+        fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd_ < 0) throw_errno("Cannot create UDP socket");
+        const auto fail = [&](const std::string& what) {
+            const int error = errno;
+            close(fd_);
+            errno = error;
+            throw_errno(what);
+        };
+
+        if (fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK) < 0) fail("Cannot make UDP socket non-blocking");
+        fcntl(fd_, F_SETFD, FD_CLOEXEC);
+
+        // Best effort: the kernel caps these (net.core.rmem_max and wmem_max)
+        setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &config.buffer_bytes, sizeof config.buffer_bytes);
+        setsockopt(fd_, SOL_SOCKET, SO_SNDBUF, &config.buffer_bytes, sizeof config.buffer_bytes);
+
+        const sockaddr_in local = to_sockaddr(config.local);
+        if (bind(fd_, reinterpret_cast<const sockaddr*>(&local), sizeof local) < 0) {
+            fail("Cannot bind UDP socket to " + config.local.to_string());
+        }
+
+#ifdef __linux__
+        if (config.offload) {
+            // GSO is requested per message; reading the option tells whether the kernel knows it
+            int segment = 0;
+            socklen_t length = sizeof segment;
+            gso_ = getsockopt(fd_, IPPROTO_UDP, UDP_SEGMENT, &segment, &length) == 0;
+            const int on = 1;
+            gro_ = setsockopt(fd_, IPPROTO_UDP, UDP_GRO, &on, sizeof on) == 0;
+        }
+        if (config.timestamps) {
+            const int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+            timestamps_ = setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof flags) == 0;
+        }
+#endif
+
+        const std::size_t receive_bytes = gro_ ? std::max<std::size_t>(max_coalesced_bytes, config.max_packet_bytes)
+                                               : config.max_packet_bytes;
+        buffers_ = std::make_unique<Buffers>(config.batch, config.max_packet_bytes, receive_bytes);
+    }
+
+    UdpSocket::~UdpSocket() {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    Endpoint UdpSocket::local_endpoint() const {
+        sockaddr_in address{};
+        socklen_t length = sizeof address;
+        if (getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &length) < 0) throw_errno("getsockname");
+        return from_sockaddr(address);
+    }
+
+    std::span<const ReceivedPacket> UdpSocket::receive(std::chrono::milliseconds timeout) {
+        Buffers& b = *buffers_;
+        const std::size_t batch = b.receive_messages.size();
+        for (auto& message : b.receive_messages) {
+            message.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            message.msg_hdr.msg_controllen = timestamps_ || gro_ ? sizeof(Control) : 0;
+            message.msg_hdr.msg_flags = 0;
+        }
+
+        int n = receive_messages(fd_, b.receive_messages.data(), batch);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && timeout.count() > 0) {
+            pollfd descriptor{fd_, POLLIN, 0};
+            if (poll(&descriptor, 1, static_cast<int>(timeout.count())) > 0) {
+                n = receive_messages(fd_, b.receive_messages.data(), batch);
+            }
+        }
+        if (n <= 0) return {};
+        stats_.receive_calls++;
+
+        // Kernel timestamps are on the real-time clock: move them to the steady one, as of now
+        const auto steady_now = std::chrono::steady_clock::now();
+        timespec real_now{};
+        if (timestamps_) clock_gettime(CLOCK_REALTIME, &real_now);
+
+        std::size_t count = 0;
+        for (int i = 0; i < n; i++) {
+            const msghdr& header = b.receive_messages[i].msg_hdr;
+            const std::size_t length = b.receive_messages[i].msg_len;
+            if (header.msg_flags & MSG_TRUNC) {
+                stats_.truncated++;
+                continue;
+            }
+
+            auto arrival = steady_now;
+            std::size_t segment = length;
+#ifdef __linux__
+            auto* h = const_cast<msghdr*>(&header);
+            for (cmsghdr* c = CMSG_FIRSTHDR(h); c != nullptr; c = CMSG_NXTHDR(h, c)) {
+                if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SO_TIMESTAMPING) {
+                    Timestamping stamp{};
+                    std::memcpy(&stamp, CMSG_DATA(c), sizeof stamp);
+                    const auto age = std::chrono::seconds(real_now.tv_sec - stamp.ts[0].tv_sec) +
+                                     std::chrono::nanoseconds(real_now.tv_nsec - stamp.ts[0].tv_nsec);
+                    if (age.count() > 0) arrival -= age;
+                } else if (c->cmsg_level == IPPROTO_UDP && c->cmsg_type == UDP_GRO) {
+                    int size = 0;
+                    std::memcpy(&size, CMSG_DATA(c), sizeof size);
+                    if (size > 0) segment = static_cast<std::size_t>(size);
+                }
+            }
+#endif
+
+            // A coalesced message holds segments of `segment` bytes, the last one possibly shorter
+            const auto* data = static_cast<const std::byte*>(header.msg_iov->iov_base);
+            const Endpoint source = from_sockaddr(*static_cast<const sockaddr_in*>(header.msg_name));
+            for (std::size_t offset = 0; offset < length; offset += segment) {
+                const std::size_t bytes = std::min(segment, length - offset);
+                if (bytes > config_.max_packet_bytes || count == b.packets.size()) {
+                    stats_.truncated++;
+                    continue;
+                }
+                b.packets[count++] = {{data + offset, bytes}, source, arrival};
+            }
+        }
+        stats_.received += count;
+        return {b.packets.data(), count};
+    }
+
+    std::span<std::byte> UdpSocket::stage(const Endpoint& destination, std::size_t bytes) {
+        Buffers& b = *buffers_;
+        if (bytes == 0 || bytes > b.max_packet) {
+            throw std::invalid_argument(std::format("UDP packet of {} bytes, the socket sends 1 to {}", bytes, b.max_packet));
+        }
+        if (b.staged == b.send_iov.size()) flush();
+
+        const std::size_t i = b.staged++;
+        b.send_iov[i].iov_len = bytes;
+        b.send_destinations[i] = destination;
+        return {static_cast<std::byte*>(b.send_iov[i].iov_base), bytes};
+    }
+
+    std::size_t UdpSocket::flush() {
+        Buffers& b = *buffers_;
+
+        // Messages: runs of equal-size packets to one destination become one offloaded message
+        std::size_t messages = 0;
+        for (std::size_t i = 0; i < b.staged;) {
+            const std::size_t size = b.send_iov[i].iov_len;
+            std::size_t n = 1;
+            if (gso_) {
+                while (i + n < b.staged && n < max_offload_segments && (n + 1) * size <= max_offload_bytes &&
+                       b.send_iov[i + n].iov_len == size && b.send_destinations[i + n] == b.send_destinations[i]) {
+                    n++;
+                }
+            }
+
+            msghdr& header = b.send_messages[messages].msg_hdr;
+            b.send_names[messages] = to_sockaddr(b.send_destinations[i]);
+            header.msg_iov = &b.send_iov[i];
+            header.msg_iovlen = n;
+            header.msg_control = nullptr;
+            header.msg_controllen = 0;
+#ifdef __linux__
+            if (n > 1) {
+                header.msg_control = b.send_control[messages].data;
+                header.msg_controllen = CMSG_SPACE(sizeof(std::uint16_t));
+                cmsghdr* c = CMSG_FIRSTHDR(&header);
+                c->cmsg_level = IPPROTO_UDP;
+                c->cmsg_type = UDP_SEGMENT;
+                c->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+                const auto segment = static_cast<std::uint16_t>(size);
+                std::memcpy(CMSG_DATA(c), &segment, sizeof segment);
+            }
+#endif
+            b.send_segments[messages++] = n;
+            i += n;
+        }
+        b.staged = 0;
+
+        std::size_t sent = 0;
+        for (std::size_t m = 0; m < messages;) {
+            const int n = send_messages(fd_, b.send_messages.data() + m, messages - m);
+            stats_.send_calls++;
+            if (n >= 0) {
+                for (int k = 0; k < n; k++) sent += b.send_segments[m + k];
+                m += static_cast<std::size_t>(n);
+                continue;
+            }
+            if (errno == EINTR) continue;
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                // The send buffer is full: whatever is left would fail the same way
+                for (; m < messages; m++) stats_.send_errors += b.send_segments[m];
+                break;
+            }
+            // This message failed alone (unreachable destination...); a device that cannot offload fails the
+            // offloaded ones with EIO, so stop offloading
+            if (errno == EIO && b.send_segments[m] > 1) gso_ = false;
+            stats_.send_errors += b.send_segments[m++];
+        }
+        stats_.sent += sent;
+        return sent;
+    }
+
+} // namespace aknet::network
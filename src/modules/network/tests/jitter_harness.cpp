@@ -0,0 +1,116 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "jitter_harness.h"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+
+namespace aknet::test {
+
+    JitterProfile JitterProfile::parse(std::string_view text) {
+        JitterProfile profile;
+        while (!text.empty()) {
+            const auto newline = text.find('\n');
+            std::string_view line = text.substr(0, newline);
+            text = newline == std::string_view::npos ? std::string_view{} : text.substr(newline + 1);
+
+            while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) line.remove_prefix(1);
+            while (!line.empty() && (line.back() == ' ' || line.back() == '\r')) line.remove_suffix(1);
+            if (line.empty() || line.front() == '#') continue;
+
+            std::uint32_t sequence = 0;
+            std::int64_t delay = 0;
+            const char* end = line.data() + line.size();
+            auto result = std::from_chars(line.data(), end, sequence);
+            if (result.ec == std::errc{} && result.ptr != end && *result.ptr == ' ') {
+                result = std::from_chars(result.ptr + 1, end, delay);
+            } else {
+                result.ec = std::errc::invalid_argument;
+            }
+            if (result.ec != std::errc{} || result.ptr != end || delay < 0) {
+                throw std::invalid_argument("Malformed jitter profile line: " + std::string(line));
+            }
+            profile.packets.push_back({sequence, std::chrono::microseconds(delay)});
+        }
+        return profile;
+    }
+
+    ReplayResult replay(const JitterProfile& profile, const network::JitterBufferConfig& config,
+                        const ReplayOptions& options) {
+        using std::chrono::nanoseconds;
+        const auto frame_time = [&](double frames) {
+            return nanoseconds(static_cast<std::int64_t>(frames * 1e9 / config.sample_rate + 0.5));
+        };
+
+        // Arrivals in time order (stable: equal times keep the profile's order)
+        struct Arrival {
+            nanoseconds time;
+            std::uint32_t sequence;
+        };
+        std::vector<Arrival> arrivals;
+        for (const auto& packet : profile.packets) {
+            arrivals.push_back({frame_time(double(packet.sequence) * config.packet_frames) + packet.delay, packet.sequence});
+        }
+        std::ranges::stable_sort(arrivals, {}, &Arrival::time);
+
+        network::JitterBuffer buffer(config);
+        ReplayResult result;
+
+        std::vector<float> packet(std::size_t{config.packet_frames} * config.channels);
+        std::vector<std::vector<float>> outputs(config.channels, std::vector<float>(options.block_frames));
+        std::vector<float*> channels;
+        for (auto& output : outputs) channels.push_back(output.data());
+
+        bool playing = false;
+        std::int64_t previous = -1;
+        std::size_t next_arrival = 0;
+        for (std::uint64_t block = 0;; block++) {
+            const nanoseconds now = options.audio_offset + frame_time(double(block) * options.block_frames);
+            // The stream ends when everything has arrived and less than a block is left to play
+            if (next_arrival == arrivals.size() && buffer.stats().depth_frames < options.block_frames) break;
+
+            // Packets that arrived by now; channel c of frame f carries (f + 1) * (c + 1)
+            for (; next_arrival < arrivals.size() && arrivals[next_arrival].time <= now; next_arrival++) {
+                const std::uint32_t sequence = arrivals[next_arrival].sequence;
+                for (std::uint32_t i = 0; i < config.packet_frames; i++) {
+                    const auto frame = std::uint64_t{sequence} * config.packet_frames + i;
+                    for (std::uint32_t c = 0; c < config.channels; c++) {
+                        packet[i * config.channels + c] = static_cast<float>((frame + 1) * (c + 1));
+                    }
+                }
+                const std::uint32_t timestamp = options.first_timestamp + sequence * config.packet_frames;
+                buffer.push(timestamp, packet, network::JitterBuffer::Clock::time_point(arrivals[next_arrival].time));
+            }
+
+            buffer.pop(channels, options.block_frames);
+            result.blocks++;
+            result.depth.push_back(buffer.stats().depth_frames);
+
+            bool latency_recorded = false;
+            for (std::uint32_t i = 0; i < options.block_frames; i++) {
+                const float value = outputs[0][i];
+                if (value == 0.0f) {
+                    if (playing) result.silent_frames++;
+                    continue;
+                }
+                const auto frame = static_cast<std::int64_t>(value) - 1;
+                if (playing && frame != previous + 1) result.discontinuities++;
+                playing = true;
+                previous = frame;
+                if (!latency_recorded) {
+                    const auto latency = now + frame_time(i) - frame_time(double(frame));
+                    result.latency.push_back(std::chrono::duration_cast<std::chrono::microseconds>(latency));
+                    latency_recorded = true;
+                }
+            }
+        }
+
+        result.stats = buffer.stats();
+        return result;
+    }
+
+} // namespace aknet::test
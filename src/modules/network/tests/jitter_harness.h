@@ -0,0 +1,62 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_JITTER_HARNESS_H
+#define AKNET_JITTER_HARNESS_H
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <jitter_buffer.h>
+
+namespace aknet::test {
+
+    // -------------------------------------------------------------------------
+    // Jitter profile: the fate of each packet of a stream, as recorded on a network.
+    // Packet k leaves the sender k packet periods after the first one and arrives `delay` later; packets
+    // missing from the profile are lost, and packets listed twice are duplicated.
+    //
+    // Recorded profiles are text, one packet per line: "<sequence> <delay in µs>". Blank lines and lines
+    // starting with '#' are ignored.
+    // -------------------------------------------------------------------------
+    struct JitterProfile {
+        struct Packet {
+            std::uint32_t sequence;
+            std::chrono::microseconds delay;
+        };
+        std::vector<Packet> packets;
+
+        // Throws std::invalid_argument on a malformed line
+        static JitterProfile parse(std::string_view text);
+    };
+
+    struct ReplayOptions {
+        std::uint32_t block_frames = 64;                 // frames popped per audio block
+        std::uint32_t first_timestamp = 0;               // RTP timestamp of packet 0
+        std::chrono::microseconds audio_offset{0};       // first audio block, after packet 0 is sent
+    };
+
+    // What came out of the jitter buffer
+    struct ReplayResult {
+        network::JitterBufferStats stats;
+        std::uint64_t blocks = 0;
+        std::uint64_t silent_frames = 0;                // frames of silence after playout started
+        std::uint64_t discontinuities = 0;              // jumps in the played sequence of frames
+        std::vector<std::uint32_t> depth;               // depth after each block
+        std::vector<std::chrono::microseconds> latency; // per block playing audio: send time to playout time
+    };
+
+    // Replay a profile through a jitter buffer on a simulated clock: packets are pushed at their arrival time
+    // and blocks popped at the block rate, in time order, on this thread. Sample values identify their frame,
+    // so the output shows what played when. Runs are deterministic.
+    ReplayResult replay(const JitterProfile& profile, const network::JitterBufferConfig& config,
+                        const ReplayOptions& options = {});
+
+} // namespace aknet::test
+
+#endif // AKNET_JITTER_HARNESS_H
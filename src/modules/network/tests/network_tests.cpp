@@ -0,0 +1,579 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <clock_recovery.h>
+#include <jitter_buffer.h>
+#include <rtp.h>
+#include <stream_playout.h>
+#include <udp_socket.h>
+
+#include "jitter_harness.h"
+
+using namespace aknet;
+using namespace std::chrono_literals;
+
+// ------------------------------------------------------------------------------------------------
+// Helpers
+// ------------------------------------------------------------------------------------------------
+
+// Profile of `count` packets with a delay drawn for each (fixed seed: runs are reproducible)
+template <typename Delay>
+test::JitterProfile generated_profile(std::uint32_t count, Delay delay) {
+    std::mt19937 rng(1234);
+    test::JitterProfile profile;
+    for (std::uint32_t i = 0; i < count; i++) profile.packets.push_back({i, delay(i, rng)});
+    return profile;
+}
+
+// Switched LAN: 100 µs and a few µs of jitter
+test::JitterProfile lan_profile(std::uint32_t count) {
+    return generated_profile(count, [](std::uint32_t, std::mt19937& rng) {
+        return std::chrono::microseconds(100 + rng() % 20);
+    });
+}
+
+std::chrono::microseconds max_latency(const test::ReplayResult& result, std::size_t from_block = 0) {
+    const auto begin = result.latency.begin() + static_cast<std::ptrdiff_t>(std::min(from_block, result.latency.size()));
+    return begin == result.latency.end() ? 0us : *std::max_element(begin, result.latency.end());
+}
+
+// Simulated clocks: packet k leaves a sender running `ppm` off our clock at k packet periods of its
+// clock, and arrives after a base delay plus queueing jitter (exponential, `jitter_us` on average) and,
+// with `bursts`, 1 packet in 100 held 30 ms behind a burst
+struct DriftingSender {
+    double ppm = 0;
+    double jitter_us = 200;
+    bool bursts = false;
+    std::mt19937 rng{4321};
+
+    // Arrival of the packet starting at sender frame `frame`, in nanoseconds of our clock
+    std::int64_t arrival_ns(std::int64_t frame) {
+        const double sent = static_cast<double>(frame) / (48000.0 * (1 + ppm * 1e-6));
+        double delay = 100e-6 + std::exponential_distribution<double>(1e6 / jitter_us)(rng);
+        if (bursts && rng() % 100 == 0) delay += 30e-3;
+        return std::llround((sent + delay) * 1e9);
+    }
+};
+
+// What a drifting sender's 440 Hz sine (amplitude 0.5, channel 0) sounds like after its jitter buffer, played
+// through a StreamPlayout or popped directly, 64 frames per block of our clock
+struct PlayoutRun {
+    std::vector<float> played;
+    network::JitterBufferStats warmed_up; // after 10 s, once the target depth has adapted to the jitter
+    network::JitterBufferStats stats;
+};
+
+PlayoutRun play_drifting(DriftingSender sender, double seconds, bool resample) {
+    const network::JitterBufferConfig config{.sample_rate = 48000, .channels = 1, .packet_frames = 48};
+    network::JitterBuffer buffer(config);
+    network::StreamPlayout playout(buffer);
+    playout.prepare({.sample_rate = 48000, .block_size = 64});
+
+    PlayoutRun run;
+    std::vector<float> packet(48);
+    std::vector<float> block(64);
+    float* outputs[] = {block.data()};
+    std::int64_t next_frame = 0;
+    std::int64_t next_arrival = sender.arrival_ns(0);
+    const auto blocks = static_cast<std::uint64_t>(seconds * 48000 / 64);
+    for (std::uint64_t b = 0; b < blocks; b++) {
+        const auto now = static_cast<std::int64_t>(b * 64 * 1e9 / 48000);
+        // Packets arrive in order: the queueing delay of one holds the next ones up behind it
+        while (next_arrival <= now) {
+            for (int i = 0; i < 48; i++) {
+                packet[i] = static_cast<float>(0.5 * std::sin(2 * std::numbers::pi * 440 * (next_frame + i) / 48000));
+            }
+            buffer.push(static_cast<std::uint32_t>(next_frame), packet,
+                        network::JitterBuffer::Clock::time_point(std::chrono::nanoseconds(next_arrival)));
+            next_frame += 48;
+            next_arrival = std::max(next_arrival, sender.arrival_ns(next_frame));
+        }
+        if (resample) {
+            playout.process({.inputs = {}, .outputs = outputs, .frames = 64});
+        } else {
+            buffer.pop(outputs, 64);
+        }
+        run.played.insert(run.played.end(), block.begin(), block.end());
+        if (b == 10 * 48000 / 64) run.warmed_up = buffer.stats();
+    }
+    run.stats = buffer.stats();
+    return run;
+}
+
+// Largest deviation of a played sine from its own continuation: a sine satisfies
+// x[n] = 2 cos(w) x[n - 1] - x[n - 2], and any gap, skip or repeat breaks that
+float max_glitch(std::span<const float> played, double frequency) {
+    const auto k = static_cast<float>(2 * std::cos(2 * std::numbers::pi * frequency));
+    float worst = 0;
+    for (std::size_t i = 2; i < played.size(); i++) {
+        worst = std::max(worst, std::abs(played[i] - k * played[i - 1] + played[i - 2]));
+    }
+    return worst;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Tests
+// ------------------------------------------------------------------------------------------------
+
+TEST_CASE("Network | Jitter buffer", "[network]") {
+
+    const network::JitterBufferConfig config{.sample_rate = 48000, .channels = 2, .packet_frames = 48};
+
+    SECTION("a clean LAN stream plays continuously with about a packet of depth") {
+        const auto result = test::replay(lan_profile(5000), config);
+
+        REQUIRE(result.stats.received == 5000);
+        REQUIRE(result.stats.lost == 0);
+        REQUIRE(result.stats.late == 0);
+        REQUIRE(result.stats.underruns == 0);
+        REQUIRE(result.discontinuities == 0);
+        REQUIRE(result.silent_frames == 0);
+        REQUIRE(result.stats.target_depth_frames <= 2 * config.packet_frames);
+
+        // One packet of packetization, one block and one packet of depth, and the network delay
+        REQUIRE(max_latency(result) < 4ms);
+    }
+
+    SECTION("reordered and duplicated packets play once, in order") {
+        auto profile = lan_profile(1000);
+        for (std::size_t i = 100; i + 1 < 900; i += 10) std::swap(profile.packets[i].delay, profile.packets[i + 1].delay);
+        for (std::size_t i = 100; i < 900; i += 10) profile.packets[i].delay += 1500us;
+        for (std::uint32_t i = 201; i < 221; i += 2) profile.packets.push_back({i, 300us});
+
+        const auto result = test::replay(profile, config);
+
+        // The first packet held back can come too late for a buffer tuned to the LAN; the target then grows
+        REQUIRE(result.stats.late <= 1);
+        REQUIRE(result.stats.received + result.stats.late == 1000);
+        REQUIRE(result.stats.reordered + result.stats.late == 80);
+        REQUIRE(result.stats.duplicates == 10);
+        REQUIRE(result.stats.lost == result.stats.late);
+        REQUIRE(result.discontinuities == result.stats.late);
+    }
+
+    SECTION("lost packets are played as silence without shifting the timeline") {
+        auto profile = lan_profile(1000);
+        std::erase_if(profile.packets, [](const auto& p) { return p.sequence % 100 == 50; });
+
+        const auto result = test::replay(profile, config);
+
+        REQUIRE(result.stats.received == 990);
+        REQUIRE(result.stats.lost == 10);
+        REQUIRE(result.silent_frames == 10 * config.packet_frames);
+        REQUIRE(result.discontinuities == 10);
+        REQUIRE(result.stats.underruns == 0);
+    }
+
+    SECTION("the depth grows with jitter, and comes back down once it settles") {
+        // Two seconds of LAN, two of up to 6 ms of jitter, then eight of LAN again: the target holds for three
+        // seconds, then comes down over a few
+        const auto profile = generated_profile(12000, [](std::uint32_t i, std::mt19937& rng) {
+            const bool noisy = i >= 2000 && i < 4000;
+            return std::chrono::microseconds(100 + (noisy ? rng() % 6000 : rng() % 20));
+        });
+        const auto result = test::replay(profile, config);
+
+        const auto blocks_per_second = config.sample_rate / 64;
+        const auto max_depth = [&](std::size_t from, std::size_t to) {
+            return *std::max_element(result.depth.begin() + from * blocks_per_second,
+                                     result.depth.begin() + to * blocks_per_second);
+        };
+        REQUIRE(max_depth(3, 4) > 4 * config.packet_frames);
+        REQUIRE(max_depth(6, 7) > 4 * config.packet_frames);
+        REQUIRE(max_depth(10, 11) <= 3 * config.packet_frames);
+        REQUIRE(result.stats.skipped_frames > 0);
+        // Only while the estimator converges at the start of the burst
+        REQUIRE(result.stats.late < 20);
+        REQUIRE(max_latency(result, 11 * blocks_per_second) < 5ms);
+    }
+
+    SECTION("recurring delay spikes keep the depth up, and only the first ones come late") {
+        // 20 s of LAN with one packet in `period` held back 4 ms
+        for (const std::uint32_t period : {250u, 500u, 1000u, 2000u}) {
+            const auto profile = generated_profile(20000, [&](std::uint32_t i, std::mt19937& rng) {
+                return std::chrono::microseconds(100 + rng() % 20 + (i % period == period / 2 ? 4000 : 0));
+            });
+            const auto result = test::replay(profile, config);
+
+            REQUIRE(result.stats.late <= 2);
+            REQUIRE(result.stats.lost == result.stats.late);
+            REQUIRE(result.stats.underruns == 0);
+            REQUIRE(result.stats.target_depth_frames >= 4000 * config.sample_rate / 1'000'000);
+        }
+    }
+
+    SECTION("timestamps wrap around 32 bits") {
+        const auto result = test::replay(lan_profile(1000), config, {.first_timestamp = 0xFFFF'FFFFu - 48 * 500 + 1});
+        REQUIRE(result.stats.received == 1000);
+        REQUIRE(result.stats.resyncs == 0);
+        REQUIRE(result.discontinuities == 0);
+    }
+
+    SECTION("a sender restarting on a new timeline is followed after a few packets") {
+        auto profile = lan_profile(2000);
+        network::JitterBufferConfig small = config;
+        small.max_depth_frames = 480;
+        // Sequence numbers jump by a minute: timestamps far outside the window
+        for (auto& packet : profile.packets) {
+            if (packet.sequence >= 1000) packet.sequence += 60'000;
+        }
+        const auto result = test::replay(profile, small);
+
+        REQUIRE(result.stats.resyncs == 1);
+        REQUIRE(result.stats.overflows == 3);
+        REQUIRE(result.stats.received == 1997);
+    }
+
+    SECTION("blocks longer than the maximum depth start playing") {
+        network::JitterBufferConfig small = config;
+        small.max_depth_frames = 480;
+        const auto result = test::replay(lan_profile(2000), small, {.block_frames = 1024});
+
+        REQUIRE(result.stats.resyncs == 0);
+        REQUIRE(result.stats.overflows == 0);
+        REQUIRE(result.stats.received == 2000);
+        // The only underrun is the last block, which the stream's end leaves short
+        REQUIRE(result.stats.underruns <= 1);
+        REQUIRE(result.stats.lost == 0);
+        REQUIRE(result.latency.size() + 3 >= result.blocks);
+
+        // Larger blocks than the buffer was sized for only play silence
+        small.max_block_frames = 512;
+        network::JitterBuffer buffer(small);
+        std::vector<float> packet(48 * small.channels, 1.0f);
+        std::vector<std::vector<float>> blocks(small.channels, std::vector<float>(1024, -1.0f));
+        std::vector<float*> outputs;
+        for (auto& block : blocks) outputs.push_back(block.data());
+        for (std::uint32_t i = 0; i < 20; i++) buffer.push(i * 48, packet);
+        buffer.pop(outputs, 1024);
+        REQUIRE(std::ranges::all_of(blocks[0], [](float x) { return x == 0.0f; }));
+        REQUIRE(buffer.stats().depth_frames == 20 * 48);
+    }
+
+    SECTION("profiles recorded as text replay the same way") {
+        const auto profile = test::JitterProfile::parse(R"(
+            # sequence delay_us
+            0 120
+            1 118
+            3 900
+            2 2400
+            4 130
+            4 135
+            5 119
+        )");
+        REQUIRE(profile.packets.size() == 7);
+        REQUIRE(profile.packets[3].delay == 2400us);
+
+        const auto result = test::replay(profile, config);
+        REQUIRE(result.stats.received + result.stats.late == 6);
+        REQUIRE(result.stats.duplicates == 1);
+        REQUIRE(result.stats.reordered + result.stats.late == 1);
+
+        REQUIRE_THROWS_AS(test::JitterProfile::parse("1 2 3"), std::invalid_argument);
+    }
+
+    SECTION("invalid configurations are rejected") {
+        REQUIRE_THROWS_AS(network::JitterBuffer({.channels = 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(network::JitterBuffer({.max_block_frames = 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(network::JitterBuffer({.packet_frames = 480, .max_depth_frames = 240}), std::invalid_argument);
+        REQUIRE_THROWS_AS(network::JitterBuffer({.min_depth_frames = 500, .max_depth_frames = 400}), std::invalid_argument);
+    }
+
+    SECTION("packets cross from a network thread to an audio thread") {
+        network::JitterBuffer buffer({.channels = 1, .packet_frames = 48, .queue_packets = 64});
+        constexpr std::uint32_t packets = 20000;
+        std::atomic<bool> done{false};
+
+        std::thread network([&] {
+            std::vector<float> packet(48);
+            for (std::uint32_t i = 0; i < packets; i++) {
+                std::ranges::fill(packet, static_cast<float>(i % 1000 + 1));
+                while (!buffer.push(i * 48, packet)) std::this_thread::yield();
+            }
+            done = true;
+        });
+
+        std::vector<float> block(48);
+        float* channel = block.data();
+        std::uint64_t played = 0;
+        while (!done || buffer.stats().received < packets) {
+            buffer.pop({&channel, 1}, 48);
+            played += std::ranges::count_if(block, [](float v) { return v != 0.0f; });
+        }
+        network.join();
+
+        const auto stats = buffer.stats();
+        REQUIRE(stats.received == packets);
+        REQUIRE(stats.late + stats.lost + stats.skipped_frames / 48 <= packets);
+        REQUIRE(played > 0);
+    }
+}
+
+TEST_CASE("Network | Clock recovery", "[network]") {
+
+    // Feeds `seconds` of a sender's packets to a clock recovery, and returns its worst error after `settled`
+    const auto worst_error = [](DriftingSender sender, double seconds, double settled) {
+        network::ClockRecovery clock;
+        double worst = 0;
+        for (std::int64_t frame = 0; frame < static_cast<std::int64_t>(seconds * 48000); frame += 48) {
+            clock.update(frame, sender.arrival_ns(frame));
+            if (frame >= settled * 48000) worst = std::max(worst, std::abs(clock.drift_ppm() - sender.ppm));
+        }
+        REQUIRE(clock.locked());
+        return worst;
+    };
+
+    SECTION("the drift of simulated clocks is found within a ppm through LAN jitter") {
+        for (const double ppm : {0.0, 37.0, 100.0, -250.0, 800.0}) {
+            INFO(ppm << " ppm");
+            REQUIRE(worst_error({.ppm = ppm}, 60, 20) < 1.0);
+        }
+    }
+
+    SECTION("heavy jitter and bursts only cost a few ppm") {
+        REQUIRE(worst_error({.ppm = 100, .jitter_us = 2000, .bursts = true}, 90, 30) < 5.0);
+    }
+
+    SECTION("acquisition is within a few ppm in seconds") {
+        REQUIRE(worst_error({.ppm = -250}, 20, 1) < 20.0);
+        REQUIRE(worst_error({.ppm = -250}, 20, 3) < 5.0);
+    }
+
+    SECTION("reordered packets are ignored, and a reset starts over") {
+        network::ClockRecovery clock;
+        DriftingSender sender{.ppm = 200, .jitter_us = 1};
+        for (std::int64_t frame = 0; frame < 48000 * 20; frame += 48) {
+            clock.update(frame, sender.arrival_ns(frame));
+            clock.update(frame - 480, sender.arrival_ns(frame) + 5'000'000); // a stray, 10 packets old
+        }
+        REQUIRE(std::abs(clock.drift_ppm() - 200) < 0.5);
+
+        clock.reset();
+        REQUIRE_FALSE(clock.locked());
+        REQUIRE(clock.ratio() == 1.0);
+    }
+
+    SECTION("invalid configurations are rejected") {
+        REQUIRE_THROWS_AS(network::ClockRecovery({.sample_rate = 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(network::ClockRecovery({.bandwidth = 0}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Network | Stream playout", "[network]") {
+
+    SECTION("without drift compensation, a sender's clock offset makes the buffer underrun or skip") {
+        const auto fast = play_drifting({.ppm = 300}, 60, false);
+        REQUIRE(fast.stats.skipped_frames > 0);
+        REQUIRE(max_glitch(fast.played, 440.0 / 48000) > 0.1f);
+
+        const auto slow = play_drifting({.ppm = -300}, 60, false);
+        REQUIRE(slow.stats.underruns > 0);
+    }
+
+    SECTION("through the ASRC, drifting senders play without a glitch at a steady depth") {
+        for (const double ppm : {0.0, 300.0, -300.0}) {
+            INFO(ppm << " ppm");
+            const auto run = play_drifting({.ppm = ppm}, 120, true);
+            REQUIRE(run.stats.late == 0);
+            REQUIRE(run.stats.underruns == run.warmed_up.underruns);
+            REQUIRE(run.stats.skipped_frames == run.warmed_up.skipped_frames);
+            REQUIRE(run.stats.lost == 0);
+            REQUIRE(std::abs(run.stats.drift_ppm - ppm) < 1.0);
+            REQUIRE(run.stats.depth_frames <= run.stats.target_depth_frames + 2 * 64);
+
+            // Once warmed up, the sine (at 440 Hz of the sender's clock) continues without a break
+            REQUIRE(max_glitch(std::span(run.played).subspan(10 * 48000), 440.0 * (1 + ppm * 1e-6) / 48000) < 1e-3f);
+        }
+    }
+
+    SECTION("the engine must run at the stream's rate") {
+        network::JitterBuffer buffer({.sample_rate = 48000});
+        network::StreamPlayout playout(buffer);
+        REQUIRE(playout.output_count() == 2);
+        REQUIRE_THROWS_AS(playout.prepare({.sample_rate = 44100}), std::invalid_argument);
+    }
+
+    SECTION("engine blocks must fit the buffer's largest block") {
+        network::JitterBuffer buffer({.sample_rate = 48000, .max_block_frames = 256});
+        network::StreamPlayout playout(buffer);
+        REQUIRE_NOTHROW(playout.prepare({.sample_rate = 48000, .block_size = 128}));
+        REQUIRE_THROWS_AS(playout.prepare({.sample_rate = 48000, .block_size = 512}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Network | RTP", "[network]") {
+
+    SECTION("headers round-trip") {
+        std::array<std::byte, network::rtp_header_bytes + 4> packet{};
+        const network::RtpHeader header{.payload_type = 97, .marker = true, .sequence = 0xBEEF,
+                                        .timestamp = 0xFFFF'FFF0u, .ssrc = 0x1234'5678};
+        network::write_rtp_header(header, packet.data());
+
+        const auto parsed = network::parse_rtp(packet);
+        REQUIRE(parsed.has_value());
+        REQUIRE(parsed->header.payload_type == 97);
+        REQUIRE(parsed->header.marker);
+        REQUIRE(parsed->header.sequence == 0xBEEF);
+        REQUIRE(parsed->header.timestamp == 0xFFFF'FFF0u);
+        REQUIRE(parsed->header.ssrc == 0x1234'5678);
+        REQUIRE(parsed->payload.size() == 4);
+    }
+
+    SECTION("CSRCs, extensions and padding are skipped") {
+        std::vector<std::byte> packet(network::rtp_header_bytes + 4 + 8 + 6 + 2);
+        network::write_rtp_header({}, packet.data());
+        packet[0] |= std::byte{0x20 | 0x10 | 0x01}; // padding, extension, one CSRC
+        packet[network::rtp_header_bytes + 4 + 3] = std::byte{1}; // extension of one word
+        packet.back() = std::byte{2};
+
+        const auto parsed = network::parse_rtp(packet);
+        REQUIRE(parsed.has_value());
+        REQUIRE(parsed->payload.size() == 6);
+        REQUIRE(parsed->payload.data() == packet.data() + network::rtp_header_bytes + 12);
+    }
+
+    SECTION("anything else is rejected") {
+        std::array<std::byte, network::rtp_header_bytes> packet{};
+        REQUIRE_FALSE(network::parse_rtp(std::span(packet).first(11)).has_value());
+        REQUIRE_FALSE(network::parse_rtp(packet).has_value()); // version 0
+        network::write_rtp_header({}, packet.data());
+        packet[0] |= std::byte{0x03}; // CSRCs past the end
+        REQUIRE_FALSE(network::parse_rtp(packet).has_value());
+    }
+}
+
+TEST_CASE("Network | UDP socket", "[network]") {
+
+    const auto loopback = network::Endpoint::parse("127.0.0.1:0");
+
+    SECTION("endpoints parse and print") {
+        const auto endpoint = network::Endpoint::parse("239.69.1.2:5004");
+        REQUIRE(endpoint.address == 0xEF45'0102);
+        REQUIRE(endpoint.port == 5004);
+        REQUIRE(endpoint.to_string() == "239.69.1.2:5004");
+        for (const auto* text : {"", "1.2.3:4", "1.2.3.256:4", "1.2.3.4", "1.2.3.4:", "1.2.3.4:70000", "1.2.3.4:5x"}) {
+            REQUIRE_THROWS_AS(network::Endpoint::parse(text), std::invalid_argument);
+        }
+    }
+
+    for (const bool offload : {false, true}) {
+        DYNAMIC_SECTION("batches cross the loopback interface, offload " << offload) {
+            network::UdpSocket receiver({.local = loopback, .offload = offload});
+            network::UdpSocket sender({.local = loopback, .batch = 32, .offload = offload});
+            const auto destination = receiver.local_endpoint();
+            REQUIRE(destination.port != 0);
+
+            // Runs of equal sizes (offloaded together when possible), then a few odd ones
+            constexpr std::size_t count = 100;
+            const auto size_of = [](std::size_t i) { return i < 80 ? std::size_t{300} : 100 + i; };
+            const auto before = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < count; i++) {
+                const auto packet = sender.stage(destination, size_of(i));
+                std::ranges::fill(packet, static_cast<std::byte>(i));
+            }
+            sender.flush();
+
+            std::vector<std::vector<std::byte>> received;
+            while (received.size() < count) {
+                const auto packets = receiver.receive(100ms);
+                if (packets.empty()) break;
+                for (const auto& packet : packets) {
+                    REQUIRE(packet.source == sender.local_endpoint());
+                    REQUIRE(packet.arrival >= before - 1ms);
+                    REQUIRE(packet.arrival <= std::chrono::steady_clock::now());
+                    received.emplace_back(packet.data.begin(), packet.data.end());
+                }
+            }
+
+            REQUIRE(sender.stats().sent == count);
+            REQUIRE(sender.stats().send_errors == 0);
+            REQUIRE(received.size() == count);
+            for (std::size_t i = 0; i < count; i++) {
+                REQUIRE(received[i].size() == size_of(i));
+                REQUIRE(std::ranges::all_of(received[i], [&](std::byte b) { return b == static_cast<std::byte>(i); }));
+            }
+            REQUIRE(receiver.stats().receive_calls < count / 4);
+            if (sender.segmentation_offload()) REQUIRE(sender.stats().send_calls <= 4);
+        }
+    }
+
+    SECTION("packets larger than the maximum are dropped") {
+        network::UdpSocket receiver({.local = loopback, .max_packet_bytes = 200, .offload = false});
+        network::UdpSocket sender({.local = loopback});
+        std::ranges::fill(sender.stage(receiver.local_endpoint(), 500), std::byte{1});
+        std::ranges::fill(sender.stage(receiver.local_endpoint(), 100), std::byte{2});
+        sender.flush();
+
+        std::size_t received = 0;
+        while (received + receiver.stats().truncated < 2) {
+            const auto packets = receiver.receive(100ms);
+            REQUIRE_FALSE((packets.empty() && receiver.stats().truncated == 0 && received == 0));
+            received += packets.size();
+        }
+        REQUIRE(received == 1);
+        REQUIRE(receiver.stats().truncated == 1);
+        REQUIRE_THROWS_AS(receiver.stage(sender.local_endpoint(), 201), std::invalid_argument);
+    }
+
+    SECTION("RTP streams reach their jitter buffers") {
+        network::UdpSocket sender({.local = loopback});
+        network::UdpSocket receiver_socket({.local = loopback});
+        network::RtpReceiver receiver(receiver_socket);
+
+        constexpr std::uint32_t streams = 8;
+        constexpr std::uint32_t packets = 20;
+        std::vector<std::unique_ptr<network::JitterBuffer>> buffers;
+        std::vector<network::RtpSender> senders;
+        for (std::uint32_t s = 0; s < streams; s++) {
+            const network::RtpStreamConfig config{.ssrc = 1000 + s, .channels = 2, .packet_frames = 48};
+            buffers.push_back(std::make_unique<network::JitterBuffer>(network::JitterBufferConfig{.channels = 2}));
+            receiver.add_stream(config, *buffers.back());
+            senders.emplace_back(sender, receiver_socket.local_endpoint(), config, 0xFFFF'FF00u);
+        }
+        REQUIRE_THROWS_AS(receiver.add_stream({.ssrc = 1000}, *buffers.front()), std::invalid_argument);
+
+        // Stream s carries (s + 1) / 16 on the left channel and its negation on the right
+        std::vector<float> samples(2 * 48);
+        for (std::uint32_t p = 0; p < packets; p++) {
+            for (std::uint32_t s = 0; s < streams; s++) {
+                for (std::size_t i = 0; i < samples.size(); i++) samples[i] = (i % 2 ? -1.0f : 1.0f) * float(s + 1) / 16;
+                senders[s].send(samples);
+            }
+            sender.flush();
+        }
+        // A stranger, and a stream's packet of the wrong size
+        const auto stranger = sender.stage(receiver_socket.local_endpoint(), network::rtp_header_bytes + 4);
+        network::write_rtp_header({.ssrc = 7}, stranger.data());
+        const auto truncated = sender.stage(receiver_socket.local_endpoint(), network::rtp_header_bytes + 4);
+        network::write_rtp_header({.ssrc = 1000}, truncated.data());
+        sender.flush();
+
+        while (receiver.stats().packets + receiver.stats().unknown + receiver.stats().malformed < streams * packets + 2) {
+            if (receiver.poll(100ms) == 0 && receiver_socket.stats().received == 0) break;
+        }
+        REQUIRE(receiver.stats().packets == streams * packets);
+        REQUIRE(receiver.stats().unknown == 1);
+        REQUIRE(receiver.stats().malformed == 1);
+
+        std::array<float, 64> left{}, right{};
+        const std::array<float*, 2> channels = {left.data(), right.data()};
+        for (std::uint32_t s = 0; s < streams; s++) {
+            buffers[s]->pop(channels, 64);
+            REQUIRE(buffers[s]->stats().received == packets);
+            REQUIRE(left[0] == float(s + 1) / 16);
+            REQUIRE(right[63] == -float(s + 1) / 16);
+        }
+    }
+}
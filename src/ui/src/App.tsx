@@ -1,14 +1,25 @@
+import { useEffect } from "react";
 import { exposed } from "@saucer-dev/types";
 
+import { Meters } from "@/components/meters";
 import { Button } from "@/components/ui/button";
 
+// The core answers commands with events, which wait in its queue until we poll them
+const EVENT_POLL_MS = 50;
+
 function handleClick() {
-  exposed<void, [void]>("log_test_msg")();
+  exposed<boolean, [void]>("log_test_msg")();
 }
 
 function App() {
+  useEffect(() => {
+    const timer = setInterval(() => exposed<number, [void]>("poll_events")(), EVENT_POLL_MS);
+    return () => clearInterval(timer);
+  }, []);
+
   return (
-    <div className="flex min-h-svh flex-col items-center justify-center">
+    <div className="flex min-h-svh flex-col items-center justify-center gap-4">
+      <Meters />
       <Button onClick={handleClick}>Click me</Button>
     </div>
   );
@@ -0,0 +1,63 @@
+import { useEffect, useRef } from "react";
+import { exposed } from "@saucer-dev/types";
+
+import { decodeFrame, type MeterFrame } from "@/lib/telemetry";
+
+// Levels shown, in level codes: -60 dBFS (code 120) to +6 dBFS (code 252)
+const LOW_CODE = 120;
+const HIGH_CODE = 252;
+
+function draw(canvas: HTMLCanvasElement, frame: MeterFrame) {
+  const context = canvas.getContext("2d");
+  if (!context) return;
+
+  const { width, height } = canvas;
+  const channels = frame.peak.length;
+  const barWidth = width / channels;
+  const scale = (code: number) => Math.max(0, Math.min(1, (code - LOW_CODE) / (HIGH_CODE - LOW_CODE))) * height;
+
+  context.clearRect(0, 0, width, height);
+  for (let c = 0; c < channels; c++) {
+    const x = c * barWidth;
+    const rms = scale(frame.rms[c]);
+    const peak = scale(frame.peak[c]);
+    const truePeak = scale(frame.truePeak[c]);
+    context.fillStyle = "#22c55e";
+    context.fillRect(x, height - rms, Math.max(1, barWidth - 1), rms);
+    context.fillStyle = "#eab308";
+    context.fillRect(x, height - peak, Math.max(1, barWidth - 1), 2);
+    // Red from 0 dBFS up: the converter would clip between samples
+    context.fillStyle = frame.truePeak[c] >= 240 ? "#ef4444" : "#f8fafc";
+    context.fillRect(x, height - truePeak, Math.max(1, barWidth - 1), 1);
+  }
+}
+
+// Level meters of every channel the core meters, on a canvas. Frames are pulled once per animation frame,
+// with one request in flight at most, so a slow UI skips snapshots instead of queueing them.
+export function Meters({ width = 1024, height = 160 }: { width?: number; height?: number }) {
+  const canvas = useRef<HTMLCanvasElement>(null);
+
+  useEffect(() => {
+    const fetchFrame = exposed<string, [void]>("telemetry_frame");
+    let pending = false;
+    let request = 0;
+
+    const tick = () => {
+      request = requestAnimationFrame(tick);
+      if (pending) return;
+      pending = true;
+      fetchFrame()
+        .then((text) => {
+          const frame = text ? decodeFrame(text) : null;
+          if (frame && canvas.current) draw(canvas.current, frame);
+        })
+        .finally(() => {
+          pending = false;
+        });
+    };
+    request = requestAnimationFrame(tick);
+    return () => cancelAnimationFrame(request);
+  }, []);
+
+  return <canvas ref={canvas} width={width} height={height} className="rounded-md bg-black" />;
+}
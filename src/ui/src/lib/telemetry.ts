@@ -0,0 +1,47 @@
+// Telemetry frames from the core: meter snapshots in a compact binary layout, base64 encoded.
+// The layout is documented in src/core/include/telemetry.h.
+
+const FRAME_MAGIC = 0x4d544b41; // "AKTM"
+const FRAME_VERSION = 2;
+
+export interface MeterFrame {
+  sequence: bigint;
+  sampleTime: bigint;
+  frames: number;
+  replaced: number; // snapshots superseded by this one since the previous frame
+  ageUs: number; // how old the snapshot was when the core encoded it
+  peak: Uint8Array; // level codes, one per channel
+  truePeak: Uint8Array;
+  rms: Uint8Array;
+}
+
+// Level code to dBFS: half-dB steps from -120 dBFS, 0 for silence
+export function codeToDb(code: number): number {
+  return code === 0 ? -Infinity : code / 2 - 120;
+}
+
+// Parse a frame, or null if it is not one this version understands
+export function decodeFrame(base64: string): MeterFrame | null {
+  const binary = atob(base64);
+  const bytes = new Uint8Array(binary.length);
+  for (let i = 0; i < binary.length; i++) bytes[i] = binary.charCodeAt(i);
+
+  const view = new DataView(bytes.buffer);
+  if (bytes.length < 8 || view.getUint32(0, true) !== FRAME_MAGIC || view.getUint16(4, true) !== FRAME_VERSION) {
+    return null;
+  }
+  const headerBytes = view.getUint16(6, true);
+  const channels = view.getUint32(8, true);
+  if (bytes.length < headerBytes + 3 * channels) return null;
+
+  return {
+    sequence: view.getBigUint64(16, true),
+    sampleTime: view.getBigUint64(24, true),
+    frames: view.getUint32(32, true),
+    replaced: view.getUint32(12, true),
+    ageUs: view.getUint32(36, true),
+    peak: bytes.subarray(headerBytes, headerBytes + channels),
+    truePeak: bytes.subarray(headerBytes + channels, headerBytes + 2 * channels),
+    rms: bytes.subarray(headerBytes + 2 * channels, headerBytes + 3 * channels),
+  };
+}
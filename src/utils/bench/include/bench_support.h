@@ -0,0 +1,160 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_BENCH_SUPPORT_H
+#define AKNET_BENCH_SUPPORT_H
+
+#pragma once
+
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <format>
+#include <initializer_list>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace aknet::bench {
+
+    // -------------------------------------------------------------------------
+    // Command line and output shared by the aknet_*_bench tools.
+    // Every bench takes `--format text|csv|json` and options of the form `--name <value>`, and prints its
+    // results as tables: aligned columns for reading, csv and json (schema 1) for diffing across releases.
+    // -------------------------------------------------------------------------
+
+    enum class Format { text, csv, json };
+
+    // A positive integer
+    template <std::integral T>
+    bool parse_count(std::string_view value, T& out) {
+        return std::from_chars(value.data(), value.data() + value.size(), out).ec == std::errc{} && out > 0;
+    }
+
+    // Parse the command line into Options, which has a `format` member. `option(options, name, value)` takes
+    // every other option and returns false for an unknown name or a bad value. nullopt: print the usage.
+    template <typename Options, typename Handler>
+    std::optional<Options> parse_options(int argc, char** argv, Handler option) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string_view name = argv[i];
+            if (i + 1 == argc) return {};
+            const std::string_view value = argv[++i];
+            if (name == "--format") {
+                if (value == "text") {
+                    options.format = Format::text;
+                } else if (value == "csv") {
+                    options.format = Format::csv;
+                } else if (value == "json") {
+                    options.format = Format::json;
+                } else {
+                    return {};
+                }
+            } else if (!option(options, name, value)) {
+                return {};
+            }
+        }
+        return options;
+    }
+
+    struct Column {
+        std::string_view key;        // json key and csv header
+        std::string_view header;     // text header
+        int width = 0;               // text width, unit included; 0: not shown as text
+        int precision = 0;           // digits after the point of floating point values
+        std::string_view unit = {};  // text only, after the value
+        bool left = false;           // text only: left-aligned
+    };
+
+    // One value of a row: text, an integer or a floating point number
+    class Cell {
+    public:
+        Cell(std::string_view text) : value_(text) {}
+        Cell(const std::string& text) : value_(std::string_view(text)) {}
+        Cell(const char* text) : value_(std::string_view(text)) {}
+        template <std::integral T>
+        Cell(T value) : value_(static_cast<std::int64_t>(value)) {}
+        Cell(double value) : value_(value) {}
+
+        std::string format(const Column& column, Format format) const {
+            if (const auto* text = std::get_if<std::string_view>(&value_)) {
+                if (format == Format::json) return std::format("\"{}\"", *text);
+                if (format == Format::csv) return std::string(*text);
+                return column.left ? std::format("{:<{}}", *text, column.width) : std::format("{:>{}}", *text, column.width);
+            }
+            const int width = column.width - static_cast<int>(column.unit.size());
+            if (const auto* number = std::get_if<std::int64_t>(&value_)) {
+                if (format != Format::text) return std::format("{}", *number);
+                return std::format("{:>{}}{}", *number, width, column.unit);
+            }
+            const double number = std::get<double>(value_);
+            if (format != Format::text) return std::format("{:.{}f}", number, column.precision);
+            return std::format("{:>{}.{}f}{}", number, width, column.precision, column.unit);
+        }
+
+    private:
+        std::variant<std::string_view, std::int64_t, double> value_;
+    };
+
+    // Rows must not outlive the strings their text cells refer to
+    struct Table {
+        std::string_view name;       // json key of the table's array
+        std::vector<Column> columns;
+        std::vector<std::vector<Cell>> rows;
+
+        void add(std::initializer_list<Cell> row) { rows.emplace_back(row); }
+    };
+
+    // Print the tables one after the other: separated by a blank line as text and csv, as the arrays of one
+    // json object
+    inline void print(Format format, std::initializer_list<Table> tables) {
+        if (format == Format::json) std::cout << "{\n  \"schema\": 1";
+        bool first_table = true;
+        for (const auto& table : tables) {
+            if (format == Format::json) {
+                std::cout << std::format(",\n  \"{}\": [\n", table.name);
+            } else if (!first_table) {
+                std::cout << "\n";
+            }
+            first_table = false;
+
+            std::string line;
+            for (const auto& column : table.columns) {
+                if (format == Format::csv) {
+                    line += std::format("{}{}", line.empty() ? "" : ",", column.key);
+                } else if (format == Format::text && column.width > 0) {
+                    line += line.empty() ? "" : " ";
+                    line += column.left ? std::format("{:<{}}", column.header, column.width)
+                                        : std::format("{:>{}}", column.header, column.width);
+                }
+            }
+            if (format != Format::json) std::cout << line << "\n";
+
+            for (std::size_t r = 0; r < table.rows.size(); r++) {
+                line.clear();
+                for (std::size_t c = 0; c < table.columns.size(); c++) {
+                    const Column& column = table.columns[c];
+                    const std::string value = table.rows[r][c].format(column, format);
+                    if (format == Format::json) {
+                        line += std::format("{}\"{}\": {}", line.empty() ? "    {" : ", ", column.key, value);
+                    } else if (format == Format::csv) {
+                        line += std::format("{}{}", line.empty() ? "" : ",", value);
+                    } else if (column.width > 0) {
+                        line += std::format("{}{}", line.empty() ? "" : " ", value);
+                    }
+                }
+                if (format == Format::json) line += r + 1 < table.rows.size() ? "}," : "}";
+                std::cout << line << "\n";
+            }
+            if (format == Format::json) std::cout << "  ]";
+        }
+        if (format == Format::json) std::cout << "\n}\n";
+    }
+
+} // namespace aknet::bench
+
+#endif // AKNET_BENCH_SUPPORT_H
@@ -0,0 +1,22 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_COUNTERS_H
+#define AKNET_COUNTERS_H
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace aknet {
+
+    // Increment of a counter with a single writer: no read-modify-write needed. Readers load it relaxed.
+    inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t n = 1) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+} // namespace aknet
+
+#endif // AKNET_COUNTERS_H
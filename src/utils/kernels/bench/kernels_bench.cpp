@@ -0,0 +1,222 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+// aknet_kernels_bench: throughput of the sample kernels, for every implementation this CPU supports.
+//
+//   aknet_kernels_bench [--format text|csv|json] [--filter <substring>] [--samples <n>]
+//
+// Each kernel runs on a 64-sample block (an audio block, in L1) and on 64 Ki samples (in L2/L3).
+// Throughput counts the bytes read and written per call, from the median time of `samples` timings;
+// speedup is against the scalar implementation on the same size. Results are printed in a fixed order
+// with fixed columns, so the csv and json outputs can be diffed across releases and machines.
+
+#include <kernels.h>
+#include <bench_support.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace aknet;
+using kernels::Isa;
+using kernels::SampleFormat;
+
+namespace {
+
+    // ---------------------------------------------------------------------------------------------
+    // Measurement
+    // ---------------------------------------------------------------------------------------------
+
+    using bench_clock = std::chrono::steady_clock;
+
+    struct Result {
+        std::string name;
+        std::string isa;
+        std::size_t count = 0;      // samples per call
+        double ns_per_call = 0;     // median
+        double gb_per_second = 0;   // bytes read and written
+        double speedup = 1;         // against scalar
+    };
+
+    struct Options {
+        bench::Format format = bench::Format::text;
+        std::string filter;
+        std::size_t samples = 2000;
+    };
+
+    // Median time of `call`, timed in batches so that small blocks are not dominated by the clock
+    double median_ns(std::size_t samples, std::size_t batch, const std::function<void()>& call) {
+        for (std::size_t i = 0; i < batch * 16; i++) call();
+
+        std::vector<double> timings;
+        timings.reserve(samples);
+        for (std::size_t s = 0; s < samples; s++) {
+            const auto t0 = bench_clock::now();
+            for (std::size_t i = 0; i < batch; i++) call();
+            const auto t1 = bench_clock::now();
+            timings.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(batch));
+        }
+        std::ranges::sort(timings);
+        return timings[timings.size() / 2];
+    }
+
+    class Suite {
+    public:
+        explicit Suite(Options options) : options_(std::move(options)) {}
+
+        const std::vector<Result>& results() const { return results_; }
+
+        // Time `call` on `count` samples with every implementation, moving `bytes` per call
+        void run(const std::string& name, std::size_t count, std::size_t bytes, const std::function<void()>& call) {
+            const std::string full_name = std::format("{}/{}", name, count);
+            if (full_name.find(options_.filter) == std::string::npos) return;
+
+            const Isa initial = kernels::active_isa();
+            const std::size_t batch = std::max<std::size_t>(1, 16384 / count);
+            double scalar_ns = 0;
+            for (const Isa isa : {Isa::scalar, Isa::sse2, Isa::avx2, Isa::avx512, Isa::neon}) {
+                if (!kernels::use_isa(isa)) continue;
+                const double ns = median_ns(options_.samples, batch, call);
+                if (isa == Isa::scalar) scalar_ns = ns;
+                results_.push_back({
+                    .name = full_name,
+                    .isa = std::string(kernels::isa_name(isa)),
+                    .count = count,
+                    .ns_per_call = ns,
+                    .gb_per_second = static_cast<double>(bytes) / ns,
+                    .speedup = ns > 0 ? scalar_ns / ns : 0,
+                });
+            }
+            kernels::use_isa(initial);
+        }
+
+    private:
+        const Options options_;
+        std::vector<Result> results_;
+    };
+
+    // ---------------------------------------------------------------------------------------------
+    // Benchmarks (run in this order)
+    // ---------------------------------------------------------------------------------------------
+
+    void bench_size(Suite& suite, std::size_t count) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+        std::vector<float> a(count), b(count), c(2 * count);
+        for (auto& s : a) s = uniform(rng);
+        for (auto& s : b) s = uniform(rng);
+        std::vector<std::byte> wire(4 * count);
+        for (auto& byte : wire) byte = static_cast<std::byte>(rng());
+
+        constexpr std::size_t f = sizeof(float);
+        for (const auto& [format, label] : {std::pair{SampleFormat::int16, "16"}, std::pair{SampleFormat::int24, "24"},
+                                           std::pair{SampleFormat::int32, "32"}}) {
+            const std::size_t bytes = kernels::bytes_per_sample(format) * count;
+            suite.run(std::format("decode_i{}", label), count, bytes + f * count, [&, format] {
+                kernels::decode(format, wire.data(), a.data(), count);
+            });
+            suite.run(std::format("encode_i{}", label), count, bytes + f * count, [&, format] {
+                kernels::encode(format, b.data(), wire.data(), count);
+            });
+        }
+
+        // Gains alternate around 1 so that repeated calls keep the values in range
+        float gain = 1.0001f;
+        suite.run("apply_gain", count, 2 * f * count, [&] {
+            kernels::apply_gain(a.data(), count, gain);
+            gain = 1.0f / gain;
+        });
+        suite.run("apply_gain_ramp", count, 2 * f * count, [&] {
+            kernels::apply_gain_ramp(a.data(), count, gain, 1.0f / gain);
+            gain = 1.0f / gain;
+        });
+        suite.run("mix_add", count, 3 * f * count, [&] {
+            kernels::mix_add(a.data(), b.data(), count, gain);
+            gain = -gain;
+        });
+        suite.run("mix_add_ramp", count, 3 * f * count, [&] {
+            kernels::mix_add_ramp(a.data(), b.data(), count, gain, -gain);
+            gain = -gain;
+        });
+
+        volatile float sum = 0.0f;
+        suite.run("dot", count, 2 * f * count, [&] {
+            sum = kernels::dot(a.data(), b.data(), count);
+        });
+        suite.run("peak", count, f * count, [&] {
+            sum = kernels::peak(a.data(), count);
+        });
+
+        // True peaks read the samples before the block: a block after its history
+        std::vector<float> history(kernels::true_peak_history + count);
+        std::copy(a.begin(), a.end(), history.begin() + kernels::true_peak_history);
+        suite.run("true_peak", count, f * count, [&] {
+            sum = kernels::true_peak(history.data() + kernels::true_peak_history, count);
+        });
+
+        // Stereo: count frames, 2 * count samples
+        const std::array<const float*, 2> sources = {a.data(), b.data()};
+        const std::array<float*, 2> destinations = {a.data(), b.data()};
+        suite.run("interleave_2ch", count, 4 * f * count, [&] {
+            kernels::interleave(sources, c.data(), count);
+        });
+        suite.run("deinterleave_2ch", count, 4 * f * count, [&] {
+            kernels::deinterleave(c.data(), destinations, count);
+        });
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Output
+    // ---------------------------------------------------------------------------------------------
+
+    void print(const Options& options, const std::vector<Result>& results) {
+        bench::Table table{"results", {
+            {.key = "name", .header = "benchmark", .width = 28, .left = true},
+            {.key = "isa", .header = "isa", .width = 7},
+            {.key = "count"},
+            {.key = "ns_per_call", .header = "ns/call", .width = 12, .precision = 1},
+            {.key = "gb_per_second", .header = "GB/s", .width = 10, .precision = 2},
+            {.key = "speedup", .header = "speedup", .width = 8, .precision = 2, .unit = "x"},
+        }};
+        for (const auto& r : results) table.add({r.name, r.isa, r.count, r.ns_per_call, r.gb_per_second, r.speedup});
+        bench::print(options.format, {table});
+    }
+
+    std::optional<Options> parse_options(int argc, char** argv) {
+        return bench::parse_options<Options>(argc, argv, [](Options& options, std::string_view name, std::string_view value) {
+            if (name == "--filter") {
+                options.filter = value;
+                return true;
+            }
+            return name == "--samples" && bench::parse_count(value, options.samples);
+        });
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_options(argc, argv);
+    if (!options) {
+        std::cerr << "Usage: " << argv[0] << " [--format text|csv|json] [--filter <substring>] [--samples <n>]"
+                  << std::endl;
+        return 1;
+    }
+
+    Suite suite(*options);
+    bench_size(suite, 64);
+    bench_size(suite, 64 * 1024);
+
+    print(*options, suite.results());
+    return 0;
+}
@@ -0,0 +1,97 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_KERNELS_H
+#define AKNET_KERNELS_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// -------------------------------------------------------------------------
+// Sample kernels: conversions between network sample formats and host float32, gains, mixes and meters.
+//
+// Every kernel has a scalar reference and vector implementations (SSE2, AVX2, AVX-512 on x86-64, NEON on
+// arm64), picked at run time from the CPU's features, so binaries do not depend on the build machine.
+// The vector implementations are bit-exact with the scalar ones: same operations in the same order,
+// no fused multiply-add. Setting AKNET_KERNELS_ISA=scalar|sse2|avx2|avx512|neon in the environment
+// selects an implementation instead, if the CPU supports it (e.g. to compare them on one machine).
+//
+// Float samples are in [-1, 1). Encoding scales, clamps to the format's range and rounds to nearest even;
+// NaN encodes as the format's minimum. Pointers need no particular alignment. Kernels are real-time safe.
+// -------------------------------------------------------------------------
+namespace aknet::kernels {
+
+    // Packed big-endian (network order) integer samples
+    enum class SampleFormat { int16, int24, int32 };
+
+    constexpr std::size_t bytes_per_sample(SampleFormat format) noexcept {
+        switch (format) {
+            case SampleFormat::int16: return 2;
+            case SampleFormat::int24: return 3;
+            case SampleFormat::int32: return 4;
+        }
+        return 0;
+    }
+
+    // count samples from `in` (count * bytes_per_sample bytes) to floats
+    void decode(SampleFormat format, const std::byte* in, float* out, std::size_t count) noexcept;
+
+    // count floats to samples in `out` (count * bytes_per_sample bytes)
+    void encode(SampleFormat format, const float* in, std::byte* out, std::size_t count) noexcept;
+
+    // buffer[i] *= gain
+    void apply_gain(float* buffer, std::size_t count, float gain) noexcept;
+
+    // buffer[i] *= from + i * (to - from) / count: a linear ramp reaching `to` just after the last sample,
+    // so consecutive ramps chain without a step
+    void apply_gain_ramp(float* buffer, std::size_t count, float from, float to) noexcept;
+
+    // out[i] += in[i] * gain
+    void mix_add(float* out, const float* in, std::size_t count, float gain = 1.0f) noexcept;
+
+    // out[i] += in[i] * ramp, the ramp as in apply_gain_ramp()
+    void mix_add_ramp(float* out, const float* in, std::size_t count, float from, float to) noexcept;
+
+    // Sum of a[i] * b[i] (a FIR filter's taps), in 8 partial sums (element i goes to sum i % 8) added pairwise
+    // at the end, so that every implementation returns the same value
+    float dot(const float* a, const float* b, std::size_t count) noexcept;
+
+    // Largest magnitude of count samples, 0 for none. NaNs are skipped.
+    float peak(const float* in, std::size_t count) noexcept;
+
+    // True peak (ITU-R BS.1770-4, annex 2): the largest magnitude of the signal oversampled four times by the
+    // standard's 48-tap interpolation filter, at the count samples from `in`. The filter also reads the
+    // true_peak_history samples before `in`, which must be readable: the end of the previous block (zeros
+    // before the first one). NaNs are skipped.
+    inline constexpr std::size_t true_peak_history = 11;
+    float true_peak(const float* in, std::size_t count) noexcept;
+
+    // Planar channels <-> one interleaved buffer of frames * channels.size() samples
+    void interleave(std::span<const float* const> channels, float* out, std::size_t frames) noexcept;
+    void deinterleave(const float* in, std::span<float* const> channels, std::size_t frames) noexcept;
+
+    // -------------------------------------------------------------------------
+    // Dispatch
+    // -------------------------------------------------------------------------
+    enum class Isa { scalar, sse2, avx2, avx512, neon };
+
+    std::string_view isa_name(Isa isa) noexcept;
+
+    // Whether this binary has the implementation and this CPU can run it
+    bool isa_supported(Isa isa) noexcept;
+
+    // Implementation in use: the best supported one, unless AKNET_KERNELS_ISA or use_isa() chose another
+    Isa active_isa() noexcept;
+
+    // Switch every kernel to an implementation (tests and benchmarks). Returns false if it is not supported.
+    // Not synchronised with kernels running on other threads.
+    bool use_isa(Isa isa) noexcept;
+
+} // namespace aknet::kernels
+
+#endif // AKNET_KERNELS_H
@@ -0,0 +1,101 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_KERNEL_TABLE_H
+#define AKNET_KERNEL_TABLE_H
+
+#pragma once
+
+#include "kernels.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace aknet::kernels::detail {
+
+    // One implementation of every kernel. The vector tables only implement what they speed up
+    // and take the rest from the scalar table.
+    struct KernelTable {
+        using Decode = void (*)(const std::byte* in, float* out, std::size_t count) noexcept;
+        using Encode = void (*)(const float* in, std::byte* out, std::size_t count) noexcept;
+
+        Decode decode_i16;
+        Decode decode_i24;
+        Decode decode_i32;
+        Encode encode_i16;
+        Encode encode_i24;
+        Encode encode_i32;
+        void (*gain)(float* buffer, std::size_t count, float gain) noexcept;
+        void (*gain_ramp)(float* buffer, std::size_t count, float from, float step) noexcept;
+        void (*mix_add)(float* out, const float* in, std::size_t count, float gain) noexcept;
+        void (*mix_add_ramp)(float* out, const float* in, std::size_t count, float from, float step) noexcept;
+        float (*dot)(const float* a, const float* b, std::size_t count) noexcept;
+        float (*peak)(const float* in, std::size_t count) noexcept;
+        float (*true_peak)(const float* in, std::size_t count) noexcept;
+        void (*interleave2)(const float* left, const float* right, float* out, std::size_t frames) noexcept;
+        void (*deinterleave2)(const float* in, float* left, float* right, std::size_t frames) noexcept;
+    };
+
+    extern const KernelTable scalar_table;
+#if defined(__x86_64__) || defined(_M_X64)
+    extern const KernelTable sse2_table;
+    extern const KernelTable avx2_table;
+    extern const KernelTable avx512_table;
+#endif
+#if defined(__aarch64__)
+    extern const KernelTable neon_table;
+#endif
+
+    // -------------------------------------------------------------------------
+    // Sample scales and clamp bounds, shared by every implementation
+    // -------------------------------------------------------------------------
+    inline constexpr float i16_scale = 32768.0f;      // 2^15
+    inline constexpr float i24_scale = 8388608.0f;    // 2^23
+    inline constexpr float i32_scale = 2147483648.0f; // 2^31
+
+    // Largest floats that convert to the format: 2^31 - 1 is not a float, 2147483520 is the one below it
+    inline constexpr float i16_max = 32767.0f;
+    inline constexpr float i24_max = 8388607.0f;
+    inline constexpr float i32_max = 2147483520.0f;
+
+    // BS.1770-4 true-peak interpolation filter: one row of taps per phase of the 4x oversampled signal.
+    // Output phase p at sample i is the sum over k of true_peak_filter[p][k] * in[i - k].
+    inline constexpr std::size_t true_peak_phases = 4;
+    inline constexpr std::size_t true_peak_taps = true_peak_history + 1;
+    inline constexpr float true_peak_filter[true_peak_phases][true_peak_taps] = {
+        {0.0017089843750f, 0.0109863281250f, -0.0196533203125f, 0.0332031250000f, -0.0594482421875f, 0.1373291015625f,
+         0.9721679687500f, -0.1022949218750f, 0.0476074218750f, -0.0266113281250f, 0.0148925781250f, -0.0083007812500f},
+        {-0.0291748046875f, 0.0292968750000f, -0.0517578125000f, 0.0891113281250f, -0.1665039062500f, 0.4650878906250f,
+         0.7797851562500f, -0.2003173828125f, 0.1015625000000f, -0.0582275390625f, 0.0330810546875f, -0.0189208984375f},
+        {-0.0189208984375f, 0.0330810546875f, -0.0582275390625f, 0.1015625000000f, -0.2003173828125f, 0.7797851562500f,
+         0.4650878906250f, -0.1665039062500f, 0.0891113281250f, -0.0517578125000f, 0.0292968750000f, -0.0291748046875f},
+        {-0.0083007812500f, 0.0148925781250f, -0.0266113281250f, 0.0476074218750f, -0.1022949218750f, 0.9721679687500f,
+         0.1373291015625f, -0.0594482421875f, 0.0332031250000f, -0.0196533203125f, 0.0109863281250f, 0.0017089843750f},
+    };
+
+    // Scalar kernels, which the vector loops call for their tails. The ramps start at element `begin`,
+    // so a tail continues the ramp of the vector part.
+    void decode_i16_scalar(const std::byte* in, float* out, std::size_t count) noexcept;
+    void decode_i24_scalar(const std::byte* in, float* out, std::size_t count) noexcept;
+    void decode_i32_scalar(const std::byte* in, float* out, std::size_t count) noexcept;
+    void encode_i16_scalar(const float* in, std::byte* out, std::size_t count) noexcept;
+    void encode_i24_scalar(const float* in, std::byte* out, std::size_t count) noexcept;
+    void encode_i32_scalar(const float* in, std::byte* out, std::size_t count) noexcept;
+    void gain_scalar(float* buffer, std::size_t count, float gain) noexcept;
+    void gain_ramp_scalar(float* buffer, std::size_t begin, std::size_t count, float from, float step) noexcept;
+    void mix_add_scalar(float* out, const float* in, std::size_t count, float gain) noexcept;
+    void mix_add_ramp_scalar(float* out, const float* in, std::size_t begin, std::size_t count, float from,
+                             float step) noexcept;
+    // dot(): the partial sums of a vector loop continue with elements [begin, count), begin a multiple of 8
+    inline constexpr std::size_t dot_lanes = 8;
+    float dot_scalar(const float* a, const float* b, std::size_t begin, std::size_t count, float* lanes) noexcept;
+    // peak() and true_peak() over elements [begin, count), from the peak of the elements before
+    float peak_scalar(const float* in, std::size_t begin, std::size_t count, float peak) noexcept;
+    float true_peak_scalar(const float* in, std::size_t begin, std::size_t count, float peak) noexcept;
+    void interleave2_scalar(const float* left, const float* right, float* out, std::size_t frames) noexcept;
+    void deinterleave2_scalar(const float* in, float* left, float* right, std::size_t frames) noexcept;
+
+} // namespace aknet::kernels::detail
+
+#endif // AKNET_KERNEL_TABLE_H
@@ -0,0 +1,202 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "kernels.h"
+#include "kernel_table.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+namespace aknet::kernels {
+
+    namespace {
+        using detail::KernelTable;
+
+        constexpr Isa all_isas[] = {Isa::scalar, Isa::sse2, Isa::avx2, Isa::avx512, Isa::neon};
+
+        const KernelTable* table_of(Isa isa) noexcept {
+            switch (isa) {
+                case Isa::scalar: return &detail::scalar_table;
+#if defined(__x86_64__) || defined(_M_X64)
+                case Isa::sse2: return &detail::sse2_table;
+                case Isa::avx2: return &detail::avx2_table;
+                case Isa::avx512: return &detail::avx512_table;
+#endif
+#if defined(__aarch64__)
+                case Isa::neon: return &detail::neon_table;
+#endif
+                default: return nullptr;
+            }
+        }
+
+        bool cpu_has(Isa isa) noexcept {
+            switch (isa) {
+                case Isa::scalar: return true;
+#if defined(__x86_64__) || defined(_M_X64)
+                // __builtin_cpu_supports also checks that the OS saves the wide registers (XCR0)
+                case Isa::sse2: return true;
+                case Isa::avx2:
+                    __builtin_cpu_init();
+                    return __builtin_cpu_supports("avx2");
+                case Isa::avx512:
+                    __builtin_cpu_init();
+                    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+#if defined(__aarch64__)
+                case Isa::neon: return true;
+#endif
+                default: return false;
+            }
+        }
+
+        Isa best_isa() noexcept {
+            Isa best = Isa::scalar;
+            for (const Isa isa : all_isas) {
+                if (isa_supported(isa)) best = isa;
+            }
+            return best;
+        }
+
+        // AKNET_KERNELS_ISA, if it names a supported implementation, else the best one
+        Isa initial_isa() noexcept {
+            if (const char* name = std::getenv("AKNET_KERNELS_ISA")) {
+                for (const Isa isa : all_isas) {
+                    if (isa_name(isa) == name && isa_supported(isa)) return isa;
+                }
+            }
+            return best_isa();
+        }
+
+        // Selected on first use rather than by a static initialiser, so kernels also work from other
+        // static initialisers. Threads racing through the first selection pick the same table.
+        std::atomic<const KernelTable*> table_ptr{nullptr};
+        std::atomic<Isa> active{Isa::scalar};
+
+        const KernelTable& select() noexcept {
+            const Isa isa = initial_isa();
+            active.store(isa, std::memory_order_relaxed);
+            const KernelTable* selected = table_of(isa);
+            table_ptr.store(selected, std::memory_order_relaxed);
+            return *selected;
+        }
+
+        const KernelTable& table() noexcept {
+            if (const KernelTable* current = table_ptr.load(std::memory_order_relaxed)) return *current;
+            return select();
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Dispatch
+    // -------------------------------------------------------------------------
+
+    std::string_view isa_name(Isa isa) noexcept {
+        switch (isa) {
+            case Isa::scalar: return "scalar";
+            case Isa::sse2: return "sse2";
+            case Isa::avx2: return "avx2";
+            case Isa::avx512: return "avx512";
+            case Isa::neon: return "neon";
+        }
+        return "unknown";
+    }
+
+    bool isa_supported(Isa isa) noexcept {
+        return table_of(isa) != nullptr && cpu_has(isa);
+    }
+
+    Isa active_isa() noexcept {
+        table();
+        return active.load(std::memory_order_relaxed);
+    }
+
+    bool use_isa(Isa isa) noexcept {
+        if (!isa_supported(isa)) return false;
+        active.store(isa, std::memory_order_relaxed);
+        table_ptr.store(table_of(isa), std::memory_order_relaxed);
+        return true;
+    }
+
+    // -------------------------------------------------------------------------
+    // Kernels
+    // -------------------------------------------------------------------------
+
+    void decode(SampleFormat format, const std::byte* in, float* out, std::size_t count) noexcept {
+        switch (format) {
+            case SampleFormat::int16: table().decode_i16(in, out, count); break;
+            case SampleFormat::int24: table().decode_i24(in, out, count); break;
+            case SampleFormat::int32: table().decode_i32(in, out, count); break;
+        }
+    }
+
+    void encode(SampleFormat format, const float* in, std::byte* out, std::size_t count) noexcept {
+        switch (format) {
+            case SampleFormat::int16: table().encode_i16(in, out, count); break;
+            case SampleFormat::int24: table().encode_i24(in, out, count); break;
+            case SampleFormat::int32: table().encode_i32(in, out, count); break;
+        }
+    }
+
+    void apply_gain(float* buffer, std::size_t count, float gain) noexcept {
+        table().gain(buffer, count, gain);
+    }
+
+    void apply_gain_ramp(float* buffer, std::size_t count, float from, float to) noexcept {
+        if (count == 0) return;
+        table().gain_ramp(buffer, count, from, (to - from) / static_cast<float>(count));
+    }
+
+    void mix_add(float* out, const float* in, std::size_t count, float gain) noexcept {
+        table().mix_add(out, in, count, gain);
+    }
+
+    void mix_add_ramp(float* out, const float* in, std::size_t count, float from, float to) noexcept {
+        if (count == 0) return;
+        table().mix_add_ramp(out, in, count, from, (to - from) / static_cast<float>(count));
+    }
+
+    float dot(const float* a, const float* b, std::size_t count) noexcept {
+        return table().dot(a, b, count);
+    }
+
+    float peak(const float* in, std::size_t count) noexcept {
+        return table().peak(in, count);
+    }
+
+    float true_peak(const float* in, std::size_t count) noexcept {
+        return table().true_peak(in, count);
+    }
+
+    void interleave(std::span<const float* const> channels, float* out, std::size_t frames) noexcept {
+        const std::size_t stride = channels.size();
+        if (stride == 2) {
+            table().interleave2(channels[0], channels[1], out, frames);
+            return;
+        }
+        if (stride == 1) {
+            std::copy_n(channels[0], frames, out);
+            return;
+        }
+        for (std::size_t i = 0; i < frames; i++) {
+            for (std::size_t c = 0; c < stride; c++) out[i * stride + c] = channels[c][i];
+        }
+    }
+
+    void deinterleave(const float* in, std::span<float* const> channels, std::size_t frames) noexcept {
+        const std::size_t stride = channels.size();
+        if (stride == 2) {
+            table().deinterleave2(in, channels[0], channels[1], frames);
+            return;
+        }
+        if (stride == 1) {
+            std::copy_n(in, frames, channels[0]);
+            return;
+        }
+        for (std::size_t c = 0; c < stride; c++) {
+            for (std::size_t i = 0; i < frames; i++) channels[c][i] = in[i * stride + c];
+        }
+    }
+
+} // namespace aknet::kernels
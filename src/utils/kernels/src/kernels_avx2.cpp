@@ -0,0 +1,262 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "kernel_table.h"
+
+#include <immintrin.h>
+
+// Built with -mavx2 (see CMakeLists.txt) and only called once dispatch has checked the CPU for AVX2.
+// Nothing from here may be inlined into code that runs without the check.
+namespace aknet::kernels::detail {
+
+    namespace {
+        constexpr std::size_t width = 8;
+
+        // Constants come from functions: a namespace-scope __m256i would be initialised with AVX instructions
+        // at program start, on any CPU.
+
+        // Byte shuffles, within each 128-bit lane
+        __m256i bswap16_mask() noexcept {
+            return _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                    1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+        }
+
+        __m256i bswap32_mask() noexcept {
+            return _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        }
+
+        // Four packed 24-bit samples (12 bytes) of a lane -> the top three bytes of its four 32-bit words
+        __m256i unpack24_mask() noexcept {
+            return _mm256_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9,
+                                    -1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9);
+        }
+
+        // And back, to the first 12 bytes of the lane
+        __m256i pack24_mask() noexcept {
+            return _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+        }
+
+        // Eight 24-bit samples are 24 bytes, six 32-bit words: words 0-2 belong to the low lane, 3-5 to the high one
+        __m256i spread24() noexcept { return _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0); }
+        __m256i gather24() noexcept { return _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 0, 0); }
+        __m256i words24() noexcept { return _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0); }
+
+        __m256i to_int(__m256 v, float scale, float low, float high) noexcept {
+            v = _mm256_mul_ps(v, _mm256_set1_ps(scale));
+            v = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(low)), _mm256_set1_ps(high));
+            return _mm256_cvtps_epi32(v);
+        }
+
+        __m256 ramp(std::size_t i, __m256 from, __m256 step) noexcept {
+            const auto index = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)),
+                                                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+            return _mm256_add_ps(from, _mm256_mul_ps(step, _mm256_cvtepi32_ps(index)));
+        }
+
+        void decode_i16(const std::byte* in, float* out, std::size_t count) noexcept {
+            const auto scale = _mm256_set1_ps(1.0f / i16_scale);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+                v = _mm_shuffle_epi8(v, _mm256_castsi256_si128(bswap16_mask()));
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v)), scale));
+            }
+            decode_i16_scalar(in + 2 * i, out + i, count - i);
+        }
+
+        void decode_i24(const std::byte* in, float* out, std::size_t count) noexcept {
+            const auto scale = _mm256_set1_ps(1.0f / i24_scale);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                // Masked load: reads the 24 bytes and nothing past them
+                auto v = _mm256_maskload_epi32(reinterpret_cast<const int*>(in + 3 * i), words24());
+                v = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(v, spread24()), unpack24_mask());
+                v = _mm256_srai_epi32(v, 8);
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+            }
+            decode_i24_scalar(in + 3 * i, out + i, count - i);
+        }
+
+        void decode_i32(const std::byte* in, float* out, std::size_t count) noexcept {
+            const auto scale = _mm256_set1_ps(1.0f / i32_scale);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 4 * i));
+                v = _mm256_shuffle_epi8(v, bswap32_mask());
+                _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+            }
+            decode_i32_scalar(in + 4 * i, out + i, count - i);
+        }
+
+        void encode_i16(const float* in, std::byte* out, std::size_t count) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto v = to_int(_mm256_loadu_ps(in + i), i16_scale, -i16_scale, i16_max);
+                auto packed = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+                packed = _mm_shuffle_epi8(packed, _mm256_castsi256_si128(bswap16_mask()));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), packed);
+            }
+            encode_i16_scalar(in + i, out + 2 * i, count - i);
+        }
+
+        void encode_i24(const float* in, std::byte* out, std::size_t count) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                auto v = to_int(_mm256_loadu_ps(in + i), i24_scale, -i24_scale, i24_max);
+                v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, pack24_mask()), gather24());
+                _mm256_maskstore_epi32(reinterpret_cast<int*>(out + 3 * i), words24(), v);
+            }
+            encode_i24_scalar(in + i, out + 3 * i, count - i);
+        }
+
+        void encode_i32(const float* in, std::byte* out, std::size_t count) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto v = to_int(_mm256_loadu_ps(in + i), i32_scale, -i32_scale, i32_max);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4 * i), _mm256_shuffle_epi8(v, bswap32_mask()));
+            }
+            encode_i32_scalar(in + i, out + 4 * i, count - i);
+        }
+
+        void gain(float* buffer, std::size_t count, float gain) noexcept {
+            const auto g = _mm256_set1_ps(gain);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                _mm256_storeu_ps(buffer + i, _mm256_mul_ps(_mm256_loadu_ps(buffer + i), g));
+            }
+            gain_scalar(buffer + i, count - i, gain);
+        }
+
+        void gain_ramp(float* buffer, std::size_t count, float from, float step) noexcept {
+            const auto f = _mm256_set1_ps(from);
+            const auto s = _mm256_set1_ps(step);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                _mm256_storeu_ps(buffer + i, _mm256_mul_ps(_mm256_loadu_ps(buffer + i), ramp(i, f, s)));
+            }
+            gain_ramp_scalar(buffer, i, count, from, step);
+        }
+
+        void mix_add(float* out, const float* in, std::size_t count, float gain) noexcept {
+            const auto g = _mm256_set1_ps(gain);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto scaled = _mm256_mul_ps(_mm256_loadu_ps(in + i), g);
+                _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), scaled));
+            }
+            mix_add_scalar(out + i, in + i, count - i, gain);
+        }
+
+        void mix_add_ramp(float* out, const float* in, std::size_t count, float from, float step) noexcept {
+            const auto f = _mm256_set1_ps(from);
+            const auto s = _mm256_set1_ps(step);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto scaled = _mm256_mul_ps(_mm256_loadu_ps(in + i), ramp(i, f, s));
+                _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), scaled));
+            }
+            mix_add_ramp_scalar(out, in, i, count, from, step);
+        }
+
+        float dot(const float* a, const float* b, std::size_t count) noexcept {
+            auto sums = _mm256_setzero_ps();
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                sums = _mm256_add_ps(sums, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+            }
+            alignas(32) float lanes[dot_lanes];
+            _mm256_store_ps(lanes, sums);
+            return dot_scalar(a, b, i, count, lanes);
+        }
+
+        // Magnitude: the sign bit cleared
+        __m256 magnitude(__m256 v) noexcept {
+            return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+        }
+
+        // Largest lane of running maxima. _mm256_max_ps(v, m) is m where v is NaN: NaNs are skipped, as in
+        // peak_scalar(), and the maxima never hold one.
+        float max_lane(__m256 m) noexcept {
+            auto half = _mm_max_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1));
+            half = _mm_max_ps(half, _mm_movehl_ps(half, half));
+            half = _mm_max_ss(half, _mm_shuffle_ps(half, half, 1));
+            return _mm_cvtss_f32(half);
+        }
+
+        float peak(const float* in, std::size_t count) noexcept {
+            auto m = _mm256_setzero_ps();
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) m = _mm256_max_ps(magnitude(_mm256_loadu_ps(in + i)), m);
+            return peak_scalar(in, i, count, max_lane(m));
+        }
+
+        // Each input vector feeds the four phases, which sum their taps in the scalar order
+        float true_peak(const float* in, std::size_t count) noexcept {
+            auto m = _mm256_setzero_ps();
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                __m256 y[true_peak_phases];
+                for (auto& v : y) v = _mm256_setzero_ps();
+                for (std::size_t k = 0; k < true_peak_taps; k++) {
+                    const auto x = _mm256_loadu_ps(in + i - k);
+                    for (std::size_t p = 0; p < true_peak_phases; p++) {
+                        y[p] = _mm256_add_ps(y[p], _mm256_mul_ps(_mm256_set1_ps(true_peak_filter[p][k]), x));
+                    }
+                }
+                for (const auto& v : y) m = _mm256_max_ps(magnitude(v), m);
+            }
+            return true_peak_scalar(in, i, count, max_lane(m));
+        }
+
+        void interleave2(const float* left, const float* right, float* out, std::size_t frames) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= frames; i += width) {
+                const auto l = _mm256_loadu_ps(left + i);
+                const auto r = _mm256_loadu_ps(right + i);
+                // unpack works within lanes: frames 0, 1, 4, 5 and 2, 3, 6, 7
+                const auto lo = _mm256_unpacklo_ps(l, r);
+                const auto hi = _mm256_unpackhi_ps(l, r);
+                _mm256_storeu_ps(out + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+                _mm256_storeu_ps(out + 2 * i + width, _mm256_permute2f128_ps(lo, hi, 0x31));
+            }
+            interleave2_scalar(left + i, right + i, out + 2 * i, frames - i);
+        }
+
+        void deinterleave2(const float* in, float* left, float* right, std::size_t frames) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= frames; i += width) {
+                const auto a = _mm256_loadu_ps(in + 2 * i);
+                const auto b = _mm256_loadu_ps(in + 2 * i + width);
+                // shuffle works within lanes: frames 0, 1, 4, 5, 2, 3, 6, 7 once split
+                const auto l = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                const auto r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                constexpr int order = _MM_SHUFFLE(3, 1, 2, 0);
+                _mm256_storeu_ps(left + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l), order)));
+                _mm256_storeu_ps(right + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), order)));
+            }
+            deinterleave2_scalar(in + 2 * i, left + i, right + i, frames - i);
+        }
+    }
+
+    const KernelTable avx2_table{
+        .decode_i16 = decode_i16,
+        .decode_i24 = decode_i24,
+        .decode_i32 = decode_i32,
+        .encode_i16 = encode_i16,
+        .encode_i24 = encode_i24,
+        .encode_i32 = encode_i32,
+        .gain = gain,
+        .gain_ramp = gain_ramp,
+        .mix_add = mix_add,
+        .mix_add_ramp = mix_add_ramp,
+        .dot = dot,
+        .peak = peak,
+        .true_peak = true_peak,
+        .interleave2 = interleave2,
+        .deinterleave2 = deinterleave2,
+    };
+
+} // namespace aknet::kernels::detail
@@ -0,0 +1,247 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "kernel_table.h"
+
+#include <immintrin.h>
+
+// Built with -mavx512f -mavx512bw (see CMakeLists.txt) and only called once dispatch has checked the CPU
+// for both. Nothing from here may be inlined into code that runs without the check.
+namespace aknet::kernels::detail {
+
+    namespace {
+        constexpr std::size_t width = 16;
+
+        // Constants come from functions: a namespace-scope __m512i would be initialised with AVX-512
+        // instructions at program start, on any CPU.
+
+        // Byte shuffles, the same in each 128-bit lane
+        __m512i bswap32_mask() noexcept {
+            return _mm512_broadcast_i32x4(_mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+        }
+
+        __m256i bswap16_mask() noexcept {
+            return _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+        }
+
+        // Four packed 24-bit samples (12 bytes) of a lane -> the top three bytes of its four 32-bit words
+        __m512i unpack24_mask() noexcept {
+            return _mm512_broadcast_i32x4(_mm_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9));
+        }
+
+        // And back, to the first 12 bytes of the lane
+        __m512i pack24_mask() noexcept {
+            return _mm512_broadcast_i32x4(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        }
+
+        // Sixteen 24-bit samples are 48 bytes, twelve 32-bit words, three for each lane
+        __m512i spread24() noexcept { return _mm512_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0, 6, 7, 8, 0, 9, 10, 11, 0); }
+        __m512i gather24() noexcept { return _mm512_setr_epi32(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0, 0, 0, 0); }
+        constexpr __mmask64 bytes24 = 0xFFFF'FFFF'FFFF;
+
+        __m512i to_int(__m512 v, float scale, float low, float high) noexcept {
+            v = _mm512_mul_ps(v, _mm512_set1_ps(scale));
+            v = _mm512_min_ps(_mm512_max_ps(v, _mm512_set1_ps(low)), _mm512_set1_ps(high));
+            return _mm512_cvtps_epi32(v);
+        }
+
+        __m512 ramp(std::size_t i, __m512 from, __m512 step) noexcept {
+            const auto index = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(i)),
+                                                _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+            return _mm512_add_ps(from, _mm512_mul_ps(step, _mm512_cvtepi32_ps(index)));
+        }
+
+        void decode_i16(const std::byte* in, float* out, std::size_t count) noexcept {
+            const auto scale = _mm512_set1_ps(1.0f / i16_scale);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i));
+                v = _mm256_shuffle_epi8(v, bswap16_mask());
+                _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(v)), scale));
+            }
+            decode_i16_scalar(in + 2 * i, out + i, count - i);
+        }
+
+        void decode_i24(const std::byte* in, float* out, std::size_t count) noexcept {
+            const auto scale = _mm512_set1_ps(1.0f / i24_scale);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                // Masked load: reads the 48 bytes and nothing past them
+                auto v = _mm512_maskz_loadu_epi8(bytes24, in + 3 * i);
+                v = _mm512_shuffle_epi8(_mm512_permutexvar_epi32(spread24(), v), unpack24_mask());
+                v = _mm512_srai_epi32(v, 8);
+                _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_cvtepi32_ps(v), scale));
+            }
+            decode_i24_scalar(in + 3 * i, out + i, count - i);
+        }
+
+        void decode_i32(const std::byte* in, float* out, std::size_t count) noexcept {
+            const auto scale = _mm512_set1_ps(1.0f / i32_scale);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto v = _mm512_shuffle_epi8(_mm512_loadu_si512(in + 4 * i), bswap32_mask());
+                _mm512_storeu_ps(out + i, _mm512_mul_ps(_mm512_cvtepi32_ps(v), scale));
+            }
+            decode_i32_scalar(in + 4 * i, out + i, count - i);
+        }
+
+        void encode_i16(const float* in, std::byte* out, std::size_t count) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto v = to_int(_mm512_loadu_ps(in + i), i16_scale, -i16_scale, i16_max);
+                const auto packed = _mm256_shuffle_epi8(_mm512_cvtsepi32_epi16(v), bswap16_mask());
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), packed);
+            }
+            encode_i16_scalar(in + i, out + 2 * i, count - i);
+        }
+
+        void encode_i24(const float* in, std::byte* out, std::size_t count) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                auto v = to_int(_mm512_loadu_ps(in + i), i24_scale, -i24_scale, i24_max);
+                v = _mm512_permutexvar_epi32(gather24(), _mm512_shuffle_epi8(v, pack24_mask()));
+                _mm512_mask_storeu_epi8(out + 3 * i, bytes24, v);
+            }
+            encode_i24_scalar(in + i, out + 3 * i, count - i);
+        }
+
+        void encode_i32(const float* in, std::byte* out, std::size_t count) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto v = to_int(_mm512_loadu_ps(in + i), i32_scale, -i32_scale, i32_max);
+                _mm512_storeu_si512(out + 4 * i, _mm512_shuffle_epi8(v, bswap32_mask()));
+            }
+            encode_i32_scalar(in + i, out + 4 * i, count - i);
+        }
+
+        void gain(float* buffer, std::size_t count, float gain) noexcept {
+            const auto g = _mm512_set1_ps(gain);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                _mm512_storeu_ps(buffer + i, _mm512_mul_ps(_mm512_loadu_ps(buffer + i), g));
+            }
+            gain_scalar(buffer + i, count - i, gain);
+        }
+
+        void gain_ramp(float* buffer, std::size_t count, float from, float step) noexcept {
+            const auto f = _mm512_set1_ps(from);
+            const auto s = _mm512_set1_ps(step);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                _mm512_storeu_ps(buffer + i, _mm512_mul_ps(_mm512_loadu_ps(buffer + i), ramp(i, f, s)));
+            }
+            gain_ramp_scalar(buffer, i, count, from, step);
+        }
+
+        void mix_add(float* out, const float* in, std::size_t count, float gain) noexcept {
+            const auto g = _mm512_set1_ps(gain);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto scaled = _mm512_mul_ps(_mm512_loadu_ps(in + i), g);
+                _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_loadu_ps(out + i), scaled));
+            }
+            mix_add_scalar(out + i, in + i, count - i, gain);
+        }
+
+        void mix_add_ramp(float* out, const float* in, std::size_t count, float from, float step) noexcept {
+            const auto f = _mm512_set1_ps(from);
+            const auto s = _mm512_set1_ps(step);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto scaled = _mm512_mul_ps(_mm512_loadu_ps(in + i), ramp(i, f, s));
+                _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_loadu_ps(out + i), scaled));
+            }
+            mix_add_ramp_scalar(out, in, i, count, from, step);
+        }
+
+        // 8 partial sums like the other implementations, so 256-bit vectors: 16 would sum in another order
+        float dot(const float* a, const float* b, std::size_t count) noexcept {
+            auto sums = _mm256_setzero_ps();
+            std::size_t i = 0;
+            for (; i + dot_lanes <= count; i += dot_lanes) {
+                sums = _mm256_add_ps(sums, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+            }
+            alignas(32) float lanes[dot_lanes];
+            _mm256_store_ps(lanes, sums);
+            return dot_scalar(a, b, i, count, lanes);
+        }
+
+        // Largest lane of running maxima. _mm512_max_ps(v, m) is m where v is NaN: NaNs are skipped, as in
+        // peak_scalar(), and the maxima never hold one.
+        float max_lane(__m512 m) noexcept {
+            return _mm512_reduce_max_ps(m);
+        }
+
+        float peak(const float* in, std::size_t count) noexcept {
+            auto m = _mm512_setzero_ps();
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) m = _mm512_max_ps(_mm512_abs_ps(_mm512_loadu_ps(in + i)), m);
+            return peak_scalar(in, i, count, max_lane(m));
+        }
+
+        // Each input vector feeds the four phases, which sum their taps in the scalar order
+        float true_peak(const float* in, std::size_t count) noexcept {
+            auto m = _mm512_setzero_ps();
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                __m512 y[true_peak_phases];
+                for (auto& v : y) v = _mm512_setzero_ps();
+                for (std::size_t k = 0; k < true_peak_taps; k++) {
+                    const auto x = _mm512_loadu_ps(in + i - k);
+                    for (std::size_t p = 0; p < true_peak_phases; p++) {
+                        y[p] = _mm512_add_ps(y[p], _mm512_mul_ps(_mm512_set1_ps(true_peak_filter[p][k]), x));
+                    }
+                }
+                for (const auto& v : y) m = _mm512_max_ps(_mm512_abs_ps(v), m);
+            }
+            return true_peak_scalar(in, i, count, max_lane(m));
+        }
+
+        // Indices into the concatenation of two vectors: 0-15 the first one, 16-31 the second one
+        void interleave2(const float* left, const float* right, float* out, std::size_t frames) noexcept {
+            const auto first = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+            const auto second = _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+            std::size_t i = 0;
+            for (; i + width <= frames; i += width) {
+                const auto l = _mm512_loadu_ps(left + i);
+                const auto r = _mm512_loadu_ps(right + i);
+                _mm512_storeu_ps(out + 2 * i, _mm512_permutex2var_ps(l, first, r));
+                _mm512_storeu_ps(out + 2 * i + width, _mm512_permutex2var_ps(l, second, r));
+            }
+            interleave2_scalar(left + i, right + i, out + 2 * i, frames - i);
+        }
+
+        void deinterleave2(const float* in, float* left, float* right, std::size_t frames) noexcept {
+            const auto even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+            const auto odd = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+            std::size_t i = 0;
+            for (; i + width <= frames; i += width) {
+                const auto a = _mm512_loadu_ps(in + 2 * i);
+                const auto b = _mm512_loadu_ps(in + 2 * i + width);
+                _mm512_storeu_ps(left + i, _mm512_permutex2var_ps(a, even, b));
+                _mm512_storeu_ps(right + i, _mm512_permutex2var_ps(a, odd, b));
+            }
+            deinterleave2_scalar(in + 2 * i, left + i, right + i, frames - i);
+        }
+    }
+
+    const KernelTable avx512_table{
+        .decode_i16 = decode_i16,
+        .decode_i24 = decode_i24,
+        .decode_i32 = decode_i32,
+        .encode_i16 = encode_i16,
+        .encode_i24 = encode_i24,
+        .encode_i32 = encode_i32,
+        .gain = gain,
+        .gain_ramp = gain_ramp,
+        .mix_add = mix_add,
+        .mix_add_ramp = mix_add_ramp,
+        .dot = dot,
+        .peak = peak,
+        .true_peak = true_peak,
+        .interleave2 = interleave2,
+        .deinterleave2 = deinterleave2,
+    };
+
+} // namespace aknet::kernels::detail
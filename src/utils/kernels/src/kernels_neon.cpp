@@ -0,0 +1,223 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "kernel_table.h"
+
+#include <arm_neon.h>
+
+// NEON is part of arm64: this file needs no extra compiler flag
+namespace aknet::kernels::detail {
+
+    namespace {
+        constexpr std::size_t width = 4;
+
+        // Scale, clamp and round four floats, as encode_*_scalar() do. Comparisons and selects rather than
+        // vmaxq/vminq, which return NaN for NaN instead of the bound.
+        int32x4_t to_int(float32x4_t v, float scale, float low, float high) noexcept {
+            const auto lo = vdupq_n_f32(low);
+            const auto hi = vdupq_n_f32(high);
+            v = vmulq_n_f32(v, scale);
+            v = vbslq_f32(vcgtq_f32(v, lo), v, lo);
+            v = vbslq_f32(vcltq_f32(v, hi), v, hi);
+            return vcvtnq_s32_f32(v);
+        }
+
+        float32x4_t ramp(std::size_t i, float32x4_t from, float32x4_t step) noexcept {
+            constexpr std::uint32_t offsets[width] = {0, 1, 2, 3};
+            const auto index = vaddq_u32(vdupq_n_u32(static_cast<std::uint32_t>(i)), vld1q_u32(offsets));
+            return vaddq_f32(from, vmulq_f32(step, vcvtq_f32_u32(index)));
+        }
+
+        const std::uint8_t* bytes(const std::byte* p) noexcept { return reinterpret_cast<const std::uint8_t*>(p); }
+        std::uint8_t* bytes(std::byte* p) noexcept { return reinterpret_cast<std::uint8_t*>(p); }
+
+        void decode_i16(const std::byte* in, float* out, std::size_t count) noexcept {
+            constexpr float scale = 1.0f / i16_scale;
+            std::size_t i = 0;
+            for (; i + 2 * width <= count; i += 2 * width) {
+                const auto v = vreinterpretq_s16_u8(vrev16q_u8(vld1q_u8(bytes(in + 2 * i))));
+                vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+                vst1q_f32(out + i + width, vmulq_n_f32(vcvtq_f32_s32(vmovl_high_s16(v)), scale));
+            }
+            decode_i16_scalar(in + 2 * i, out + i, count - i);
+        }
+
+        void decode_i24(const std::byte* in, float* out, std::size_t count) noexcept {
+            constexpr float scale = 1.0f / i24_scale;
+            std::size_t i = 0;
+            for (; i + 2 * width <= count; i += 2 * width) {
+                // Eight samples, split by byte: most significant ones in val[0]
+                const auto b = vld3_u8(bytes(in + 3 * i));
+                const auto top = vreinterpretq_s16_u16(vorrq_u16(vshll_n_u8(b.val[0], 8), vmovl_u8(b.val[1])));
+                const auto low = vmovl_u8(b.val[2]);
+                const auto lo = vorrq_s32(vshll_n_s16(vget_low_s16(top), 8),
+                                          vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low))));
+                const auto hi = vorrq_s32(vshll_high_n_s16(top, 8), vreinterpretq_s32_u32(vmovl_high_u16(low)));
+                vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(lo), scale));
+                vst1q_f32(out + i + width, vmulq_n_f32(vcvtq_f32_s32(hi), scale));
+            }
+            decode_i24_scalar(in + 3 * i, out + i, count - i);
+        }
+
+        void decode_i32(const std::byte* in, float* out, std::size_t count) noexcept {
+            constexpr float scale = 1.0f / i32_scale;
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto v = vreinterpretq_s32_u8(vrev32q_u8(vld1q_u8(bytes(in + 4 * i))));
+                vst1q_f32(out + i, vmulq_n_f32(vcvtq_f32_s32(v), scale));
+            }
+            decode_i32_scalar(in + 4 * i, out + i, count - i);
+        }
+
+        void encode_i16(const float* in, std::byte* out, std::size_t count) noexcept {
+            std::size_t i = 0;
+            for (; i + 2 * width <= count; i += 2 * width) {
+                const auto lo = to_int(vld1q_f32(in + i), i16_scale, -i16_scale, i16_max);
+                const auto hi = to_int(vld1q_f32(in + i + width), i16_scale, -i16_scale, i16_max);
+                const auto packed = vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi));
+                vst1q_u8(bytes(out + 2 * i), vrev16q_u8(vreinterpretq_u8_s16(packed)));
+            }
+            encode_i16_scalar(in + i, out + 2 * i, count - i);
+        }
+
+        void encode_i24(const float* in, std::byte* out, std::size_t count) noexcept {
+            std::size_t i = 0;
+            for (; i + 2 * width <= count; i += 2 * width) {
+                const auto lo = vreinterpretq_u32_s32(to_int(vld1q_f32(in + i), i24_scale, -i24_scale, i24_max));
+                const auto hi = vreinterpretq_u32_s32(to_int(vld1q_f32(in + i + width), i24_scale, -i24_scale, i24_max));
+                uint8x8x3_t b;
+                b.val[0] = vmovn_u16(vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16)));
+                b.val[1] = vmovn_u16(vcombine_u16(vshrn_n_u32(lo, 8), vshrn_n_u32(hi, 8)));
+                b.val[2] = vmovn_u16(vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)));
+                vst3_u8(bytes(out + 3 * i), b);
+            }
+            encode_i24_scalar(in + i, out + 3 * i, count - i);
+        }
+
+        void encode_i32(const float* in, std::byte* out, std::size_t count) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto v = to_int(vld1q_f32(in + i), i32_scale, -i32_scale, i32_max);
+                vst1q_u8(bytes(out + 4 * i), vrev32q_u8(vreinterpretq_u8_s32(v)));
+            }
+            encode_i32_scalar(in + i, out + 4 * i, count - i);
+        }
+
+        void gain(float* buffer, std::size_t count, float gain) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) vst1q_f32(buffer + i, vmulq_n_f32(vld1q_f32(buffer + i), gain));
+            gain_scalar(buffer + i, count - i, gain);
+        }
+
+        void gain_ramp(float* buffer, std::size_t count, float from, float step) noexcept {
+            const auto f = vdupq_n_f32(from);
+            const auto s = vdupq_n_f32(step);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                vst1q_f32(buffer + i, vmulq_f32(vld1q_f32(buffer + i), ramp(i, f, s)));
+            }
+            gain_ramp_scalar(buffer, i, count, from, step);
+        }
+
+        // Multiply then add, never vmlaq/vfmaq: a fused multiply-add rounds once and would differ from scalar code
+        void mix_add(float* out, const float* in, std::size_t count, float gain) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                vst1q_f32(out + i, vaddq_f32(vld1q_f32(out + i), vmulq_n_f32(vld1q_f32(in + i), gain)));
+            }
+            mix_add_scalar(out + i, in + i, count - i, gain);
+        }
+
+        void mix_add_ramp(float* out, const float* in, std::size_t count, float from, float step) noexcept {
+            const auto f = vdupq_n_f32(from);
+            const auto s = vdupq_n_f32(step);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto scaled = vmulq_f32(vld1q_f32(in + i), ramp(i, f, s));
+                vst1q_f32(out + i, vaddq_f32(vld1q_f32(out + i), scaled));
+            }
+            mix_add_ramp_scalar(out, in, i, count, from, step);
+        }
+
+        float dot(const float* a, const float* b, std::size_t count) noexcept {
+            auto low = vdupq_n_f32(0.0f);
+            auto high = vdupq_n_f32(0.0f);
+            std::size_t i = 0;
+            for (; i + dot_lanes <= count; i += dot_lanes) {
+                low = vaddq_f32(low, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+                high = vaddq_f32(high, vmulq_f32(vld1q_f32(a + i + width), vld1q_f32(b + i + width)));
+            }
+            float lanes[dot_lanes];
+            vst1q_f32(lanes, low);
+            vst1q_f32(lanes + width, high);
+            return dot_scalar(a, b, i, count, lanes);
+        }
+
+        // Largest lane of running maxima. vmaxnmq_f32 returns the number of a number and a NaN: NaNs are
+        // skipped, as in peak_scalar(), and the maxima never hold one.
+        float max_lane(float32x4_t m) noexcept {
+            return vmaxnmvq_f32(m);
+        }
+
+        float peak(const float* in, std::size_t count) noexcept {
+            auto m = vdupq_n_f32(0.0f);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) m = vmaxnmq_f32(vabsq_f32(vld1q_f32(in + i)), m);
+            return peak_scalar(in, i, count, max_lane(m));
+        }
+
+        // Each input vector feeds the four phases, which sum their taps in the scalar order
+        float true_peak(const float* in, std::size_t count) noexcept {
+            auto m = vdupq_n_f32(0.0f);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                float32x4_t y[true_peak_phases];
+                for (auto& v : y) v = vdupq_n_f32(0.0f);
+                for (std::size_t k = 0; k < true_peak_taps; k++) {
+                    const auto x = vld1q_f32(in + i - k);
+                    for (std::size_t p = 0; p < true_peak_phases; p++) {
+                        y[p] = vaddq_f32(y[p], vmulq_n_f32(x, true_peak_filter[p][k]));
+                    }
+                }
+                for (const auto& v : y) m = vmaxnmq_f32(vabsq_f32(v), m);
+            }
+            return true_peak_scalar(in, i, count, max_lane(m));
+        }
+
+        void interleave2(const float* left, const float* right, float* out, std::size_t frames) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= frames; i += width) vst2q_f32(out + 2 * i, {{vld1q_f32(left + i), vld1q_f32(right + i)}});
+            interleave2_scalar(left + i, right + i, out + 2 * i, frames - i);
+        }
+
+        void deinterleave2(const float* in, float* left, float* right, std::size_t frames) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= frames; i += width) {
+                const auto v = vld2q_f32(in + 2 * i);
+                vst1q_f32(left + i, v.val[0]);
+                vst1q_f32(right + i, v.val[1]);
+            }
+            deinterleave2_scalar(in + 2 * i, left + i, right + i, frames - i);
+        }
+    }
+
+    const KernelTable neon_table{
+        .decode_i16 = decode_i16,
+        .decode_i24 = decode_i24,
+        .decode_i32 = decode_i32,
+        .encode_i16 = encode_i16,
+        .encode_i24 = encode_i24,
+        .encode_i32 = encode_i32,
+        .gain = gain,
+        .gain_ramp = gain_ramp,
+        .mix_add = mix_add,
+        .mix_add_ramp = mix_add_ramp,
+        .dot = dot,
+        .peak = peak,
+        .true_peak = true_peak,
+        .interleave2 = interleave2,
+        .deinterleave2 = deinterleave2,
+    };
+
+} // namespace aknet::kernels::detail
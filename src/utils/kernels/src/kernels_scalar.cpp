@@ -0,0 +1,175 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "kernel_table.h"
+
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace aknet::kernels::detail {
+
+    namespace {
+        // Clamp with the semantics of the vector max/min instructions: NaN gives `low`
+        float clamp_sample(float v, float low, float high) noexcept {
+            v = v > low ? v : low;
+            return v < high ? v : high;
+        }
+
+        // Larger of a running peak and a magnitude, with the semantics of the vector max instructions: a NaN
+        // sample gives `peak`, so NaNs are skipped
+        float max_magnitude(float peak, float v) noexcept {
+            const float magnitude = std::abs(v);
+            return magnitude > peak ? magnitude : peak;
+        }
+
+        // Round to nearest even, as the vector conversions do in the default rounding mode
+        std::int32_t round_sample(float v) noexcept {
+            return static_cast<std::int32_t>(__builtin_rintf(v));
+        }
+
+        std::int32_t load_be24(const std::byte* p) noexcept {
+            const auto u = (std::to_integer<std::uint32_t>(p[0]) << 24) | (std::to_integer<std::uint32_t>(p[1]) << 16) |
+                           (std::to_integer<std::uint32_t>(p[2]) << 8);
+            return static_cast<std::int32_t>(u) >> 8;
+        }
+
+        void store_be24(std::byte* p, std::int32_t v) noexcept {
+            const auto u = static_cast<std::uint32_t>(v);
+            p[0] = static_cast<std::byte>(u >> 16);
+            p[1] = static_cast<std::byte>(u >> 8);
+            p[2] = static_cast<std::byte>(u);
+        }
+
+        template <typename T>
+        T load_be(const std::byte* p) noexcept {
+            T v;
+            std::memcpy(&v, p, sizeof v);
+            if constexpr (std::endian::native == std::endian::little) v = std::byteswap(v);
+            return v;
+        }
+
+        template <typename T>
+        void store_be(std::byte* p, T v) noexcept {
+            if constexpr (std::endian::native == std::endian::little) v = std::byteswap(v);
+            std::memcpy(p, &v, sizeof v);
+        }
+    }
+
+    void decode_i16_scalar(const std::byte* in, float* out, std::size_t count) noexcept {
+        for (std::size_t i = 0; i < count; i++) {
+            out[i] = static_cast<float>(load_be<std::int16_t>(in + 2 * i)) * (1.0f / i16_scale);
+        }
+    }
+
+    void decode_i24_scalar(const std::byte* in, float* out, std::size_t count) noexcept {
+        for (std::size_t i = 0; i < count; i++) {
+            out[i] = static_cast<float>(load_be24(in + 3 * i)) * (1.0f / i24_scale);
+        }
+    }
+
+    void decode_i32_scalar(const std::byte* in, float* out, std::size_t count) noexcept {
+        for (std::size_t i = 0; i < count; i++) {
+            out[i] = static_cast<float>(load_be<std::int32_t>(in + 4 * i)) * (1.0f / i32_scale);
+        }
+    }
+
+    void encode_i16_scalar(const float* in, std::byte* out, std::size_t count) noexcept {
+        for (std::size_t i = 0; i < count; i++) {
+            const auto v = round_sample(clamp_sample(in[i] * i16_scale, -i16_scale, i16_max));
+            store_be(out + 2 * i, static_cast<std::int16_t>(v));
+        }
+    }
+
+    void encode_i24_scalar(const float* in, std::byte* out, std::size_t count) noexcept {
+        for (std::size_t i = 0; i < count; i++) {
+            store_be24(out + 3 * i, round_sample(clamp_sample(in[i] * i24_scale, -i24_scale, i24_max)));
+        }
+    }
+
+    void encode_i32_scalar(const float* in, std::byte* out, std::size_t count) noexcept {
+        for (std::size_t i = 0; i < count; i++) {
+            store_be(out + 4 * i, round_sample(clamp_sample(in[i] * i32_scale, -i32_scale, i32_max)));
+        }
+    }
+
+    void gain_scalar(float* buffer, std::size_t count, float gain) noexcept {
+        for (std::size_t i = 0; i < count; i++) buffer[i] *= gain;
+    }
+
+    void gain_ramp_scalar(float* buffer, std::size_t begin, std::size_t count, float from, float step) noexcept {
+        for (std::size_t i = begin; i < count; i++) buffer[i] *= from + step * static_cast<float>(i);
+    }
+
+    void mix_add_scalar(float* out, const float* in, std::size_t count, float gain) noexcept {
+        for (std::size_t i = 0; i < count; i++) out[i] += in[i] * gain;
+    }
+
+    void mix_add_ramp_scalar(float* out, const float* in, std::size_t begin, std::size_t count, float from,
+                             float step) noexcept {
+        for (std::size_t i = begin; i < count; i++) out[i] += in[i] * (from + step * static_cast<float>(i));
+    }
+
+    float dot_scalar(const float* a, const float* b, std::size_t begin, std::size_t count, float* lanes) noexcept {
+        for (std::size_t i = begin; i < count; i++) lanes[i % dot_lanes] += a[i] * b[i];
+        for (std::size_t i = 0; i < 4; i++) lanes[i] += lanes[i + 4];
+        return (lanes[0] + lanes[2]) + (lanes[1] + lanes[3]);
+    }
+
+    float peak_scalar(const float* in, std::size_t begin, std::size_t count, float peak) noexcept {
+        for (std::size_t i = begin; i < count; i++) peak = max_magnitude(peak, in[i]);
+        return peak;
+    }
+
+    float true_peak_scalar(const float* in, std::size_t begin, std::size_t count, float peak) noexcept {
+        for (std::size_t i = begin; i < count; i++) {
+            for (std::size_t p = 0; p < true_peak_phases; p++) {
+                float y = 0.0f;
+                for (std::size_t k = 0; k < true_peak_taps; k++) y += true_peak_filter[p][k] * *(in + i - k);
+                peak = max_magnitude(peak, y);
+            }
+        }
+        return peak;
+    }
+
+    void interleave2_scalar(const float* left, const float* right, float* out, std::size_t frames) noexcept {
+        for (std::size_t i = 0; i < frames; i++) {
+            out[2 * i] = left[i];
+            out[2 * i + 1] = right[i];
+        }
+    }
+
+    void deinterleave2_scalar(const float* in, float* left, float* right, std::size_t frames) noexcept {
+        for (std::size_t i = 0; i < frames; i++) {
+            left[i] = in[2 * i];
+            right[i] = in[2 * i + 1];
+        }
+    }
+
+    const KernelTable scalar_table{
+        .decode_i16 = decode_i16_scalar,
+        .decode_i24 = decode_i24_scalar,
+        .decode_i32 = decode_i32_scalar,
+        .encode_i16 = encode_i16_scalar,
+        .encode_i24 = encode_i24_scalar,
+        .encode_i32 = encode_i32_scalar,
+        .gain = gain_scalar,
+        .gain_ramp = [](float* buffer, std::size_t count, float from, float step) noexcept {
+            gain_ramp_scalar(buffer, 0, count, from, step);
+        },
+        .mix_add = mix_add_scalar,
+        .mix_add_ramp = [](float* out, const float* in, std::size_t count, float from, float step) noexcept {
+            mix_add_ramp_scalar(out, in, 0, count, from, step);
+        },
+        .dot = [](const float* a, const float* b, std::size_t count) noexcept {
+            float lanes[dot_lanes]{};
+            return dot_scalar(a, b, 0, count, lanes);
+        },
+        .peak = [](const float* in, std::size_t count) noexcept { return peak_scalar(in, 0, count, 0.0f); },
+        .true_peak = [](const float* in, std::size_t count) noexcept { return true_peak_scalar(in, 0, count, 0.0f); },
+        .interleave2 = interleave2_scalar,
+        .deinterleave2 = deinterleave2_scalar,
+    };
+
+} // namespace aknet::kernels::detail
@@ -0,0 +1,212 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "kernel_table.h"
+
+#include <emmintrin.h>
+
+// SSE2 is part of x86-64: this file needs no extra compiler flag. 24-bit samples need a byte shuffle
+// (SSSE3), so they stay scalar at this level.
+namespace aknet::kernels::detail {
+
+    namespace {
+        constexpr std::size_t width = 4;
+
+        __m128i bswap16(__m128i v) noexcept {
+            return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        }
+
+        __m128i bswap32(__m128i v) noexcept {
+            v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+            return bswap16(v);
+        }
+
+        // Scale, clamp and round four floats, as encode_*_scalar() do
+        __m128i to_int(__m128 v, float scale, float low, float high) noexcept {
+            v = _mm_mul_ps(v, _mm_set1_ps(scale));
+            v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(low)), _mm_set1_ps(high));
+            return _mm_cvtps_epi32(v);
+        }
+
+        // Ramp values from + step * i for i, i + 1, i + 2, i + 3
+        __m128 ramp(std::size_t i, __m128 from, __m128 step) noexcept {
+            const auto index = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(i)), _mm_setr_epi32(0, 1, 2, 3));
+            return _mm_add_ps(from, _mm_mul_ps(step, _mm_cvtepi32_ps(index)));
+        }
+
+        void decode_i16(const std::byte* in, float* out, std::size_t count) noexcept {
+            const auto scale = _mm_set1_ps(1.0f / i16_scale);
+            std::size_t i = 0;
+            for (; i + 2 * width <= count; i += 2 * width) {
+                const auto v = bswap16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i)));
+                // Sign-extend by placing each sample in the high half of a 32-bit lane
+                const auto lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+                const auto hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+                _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+                _mm_storeu_ps(out + i + width, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+            }
+            decode_i16_scalar(in + 2 * i, out + i, count - i);
+        }
+
+        void decode_i32(const std::byte* in, float* out, std::size_t count) noexcept {
+            const auto scale = _mm_set1_ps(1.0f / i32_scale);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto v = bswap32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4 * i)));
+                _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+            }
+            decode_i32_scalar(in + 4 * i, out + i, count - i);
+        }
+
+        void encode_i16(const float* in, std::byte* out, std::size_t count) noexcept {
+            std::size_t i = 0;
+            for (; i + 2 * width <= count; i += 2 * width) {
+                const auto lo = to_int(_mm_loadu_ps(in + i), i16_scale, -i16_scale, i16_max);
+                const auto hi = to_int(_mm_loadu_ps(in + i + width), i16_scale, -i16_scale, i16_max);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), bswap16(_mm_packs_epi32(lo, hi)));
+            }
+            encode_i16_scalar(in + i, out + 2 * i, count - i);
+        }
+
+        void encode_i32(const float* in, std::byte* out, std::size_t count) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto v = to_int(_mm_loadu_ps(in + i), i32_scale, -i32_scale, i32_max);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i), bswap32(v));
+            }
+            encode_i32_scalar(in + i, out + 4 * i, count - i);
+        }
+
+        void gain(float* buffer, std::size_t count, float gain) noexcept {
+            const auto g = _mm_set1_ps(gain);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) _mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), g));
+            gain_scalar(buffer + i, count - i, gain);
+        }
+
+        void gain_ramp(float* buffer, std::size_t count, float from, float step) noexcept {
+            const auto f = _mm_set1_ps(from);
+            const auto s = _mm_set1_ps(step);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                _mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), ramp(i, f, s)));
+            }
+            gain_ramp_scalar(buffer, i, count, from, step);
+        }
+
+        void mix_add(float* out, const float* in, std::size_t count, float gain) noexcept {
+            const auto g = _mm_set1_ps(gain);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(in + i), g)));
+            }
+            mix_add_scalar(out + i, in + i, count - i, gain);
+        }
+
+        void mix_add_ramp(float* out, const float* in, std::size_t count, float from, float step) noexcept {
+            const auto f = _mm_set1_ps(from);
+            const auto s = _mm_set1_ps(step);
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                const auto scaled = _mm_mul_ps(_mm_loadu_ps(in + i), ramp(i, f, s));
+                _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), scaled));
+            }
+            mix_add_ramp_scalar(out, in, i, count, from, step);
+        }
+
+        // Two vectors of partial sums: lanes 0-3 and 4-7
+        float dot(const float* a, const float* b, std::size_t count) noexcept {
+            auto low = _mm_setzero_ps();
+            auto high = _mm_setzero_ps();
+            std::size_t i = 0;
+            for (; i + dot_lanes <= count; i += dot_lanes) {
+                low = _mm_add_ps(low, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+                high = _mm_add_ps(high, _mm_mul_ps(_mm_loadu_ps(a + i + width), _mm_loadu_ps(b + i + width)));
+            }
+            alignas(16) float lanes[dot_lanes];
+            _mm_store_ps(lanes, low);
+            _mm_store_ps(lanes + width, high);
+            return dot_scalar(a, b, i, count, lanes);
+        }
+
+        // Magnitude: the sign bit cleared
+        __m128 magnitude(__m128 v) noexcept {
+            return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+        }
+
+        // Largest lane of running maxima. _mm_max_ps(v, m) is m where v is NaN: NaNs are skipped, as in
+        // peak_scalar(), and the maxima never hold one.
+        float max_lane(__m128 m) noexcept {
+            m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+            m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+            return _mm_cvtss_f32(m);
+        }
+
+        float peak(const float* in, std::size_t count) noexcept {
+            auto m = _mm_setzero_ps();
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) m = _mm_max_ps(magnitude(_mm_loadu_ps(in + i)), m);
+            return peak_scalar(in, i, count, max_lane(m));
+        }
+
+        // Each input vector feeds the four phases, which sum their taps in the scalar order
+        float true_peak(const float* in, std::size_t count) noexcept {
+            auto m = _mm_setzero_ps();
+            std::size_t i = 0;
+            for (; i + width <= count; i += width) {
+                __m128 y[true_peak_phases];
+                for (auto& v : y) v = _mm_setzero_ps();
+                for (std::size_t k = 0; k < true_peak_taps; k++) {
+                    const auto x = _mm_loadu_ps(in + i - k);
+                    for (std::size_t p = 0; p < true_peak_phases; p++) {
+                        y[p] = _mm_add_ps(y[p], _mm_mul_ps(_mm_set1_ps(true_peak_filter[p][k]), x));
+                    }
+                }
+                for (const auto& v : y) m = _mm_max_ps(magnitude(v), m);
+            }
+            return true_peak_scalar(in, i, count, max_lane(m));
+        }
+
+        void interleave2(const float* left, const float* right, float* out, std::size_t frames) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= frames; i += width) {
+                const auto l = _mm_loadu_ps(left + i);
+                const auto r = _mm_loadu_ps(right + i);
+                _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(l, r));
+                _mm_storeu_ps(out + 2 * i + width, _mm_unpackhi_ps(l, r));
+            }
+            interleave2_scalar(left + i, right + i, out + 2 * i, frames - i);
+        }
+
+        void deinterleave2(const float* in, float* left, float* right, std::size_t frames) noexcept {
+            std::size_t i = 0;
+            for (; i + width <= frames; i += width) {
+                const auto a = _mm_loadu_ps(in + 2 * i);
+                const auto b = _mm_loadu_ps(in + 2 * i + width);
+                _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+                _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+            deinterleave2_scalar(in + 2 * i, left + i, right + i, frames - i);
+        }
+    }
+
+    const KernelTable sse2_table{
+        .decode_i16 = decode_i16,
+        .decode_i24 = decode_i24_scalar,
+        .decode_i32 = decode_i32,
+        .encode_i16 = encode_i16,
+        .encode_i24 = encode_i24_scalar,
+        .encode_i32 = encode_i32,
+        .gain = gain,
+        .gain_ramp = gain_ramp,
+        .mix_add = mix_add,
+        .mix_add_ramp = mix_add_ramp,
+        .dot = dot,
+        .peak = peak,
+        .true_peak = true_peak,
+        .interleave2 = interleave2,
+        .deinterleave2 = deinterleave2,
+    };
+
+} // namespace aknet::kernels::detail
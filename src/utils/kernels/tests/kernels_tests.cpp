@@ -0,0 +1,334 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include <kernels.h>
+
+using namespace aknet;
+using kernels::Isa;
+using kernels::SampleFormat;
+
+// ------------------------------------------------------------------------------------------------
+// Helpers
+// ------------------------------------------------------------------------------------------------
+
+// Switches the kernels to an implementation for a scope
+class UseIsa {
+    Isa previous_;
+public:
+    explicit UseIsa(Isa isa) : previous_(kernels::active_isa()) { REQUIRE(kernels::use_isa(isa)); }
+    ~UseIsa() { kernels::use_isa(previous_); }
+};
+
+std::vector<Isa> vector_isas() {
+    std::vector<Isa> isas;
+    for (const Isa isa : {Isa::sse2, Isa::avx2, Isa::avx512, Isa::neon}) {
+        if (kernels::isa_supported(isa)) isas.push_back(isa);
+    }
+    return isas;
+}
+
+// Floats around [-1, 1], with the values that exercise clamping and rounding in the mix
+std::vector<float> test_samples(std::size_t count, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uniform(-1.2f, 1.2f);
+    const std::array<float, 14> edges = {
+        0.0f, -0.0f, 1.0f, -1.0f, 0.999999f, -1.000001f,
+        0.5f / 32768.0f, 1.5f / 32768.0f, -2.5f / 8388608.0f,        // halfway: round to even
+        std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::denorm_min(), 1e30f,
+    };
+    std::vector<float> samples(count);
+    for (auto& s : samples) s = rng() % 4 == 0 ? edges[rng() % edges.size()] : uniform(rng);
+    return samples;
+}
+
+std::vector<std::byte> test_bytes(std::size_t count, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<std::byte> bytes(count);
+    for (auto& b : bytes) b = static_cast<std::byte>(rng());
+    return bytes;
+}
+
+bool same_bits(const void* a, const void* b, std::size_t size) {
+    return std::memcmp(a, b, size) == 0;
+}
+
+// Lengths around the vector widths (4, 8, 16 and their multiples) and a large one
+const std::vector<std::size_t> lengths = [] {
+    std::vector<std::size_t> v;
+    for (std::size_t n = 0; n <= 70; n++) v.push_back(n);
+    v.push_back(1021);
+    v.push_back(4096);
+    return v;
+}();
+
+// ------------------------------------------------------------------------------------------------
+// Tests
+// ------------------------------------------------------------------------------------------------
+
+TEST_CASE("Kernels | Scalar reference", "[kernels]") {
+
+    const UseIsa scalar(Isa::scalar);
+
+    SECTION("decoding reads big-endian samples, full scale being 1.0") {
+        const std::array<std::byte, 6> i16 = {std::byte{0x80}, std::byte{0x00}, std::byte{0x7F}, std::byte{0xFF},
+                                              std::byte{0x00}, std::byte{0x01}};
+        std::array<float, 3> out{};
+        kernels::decode(SampleFormat::int16, i16.data(), out.data(), 3);
+        REQUIRE(out == std::array{-1.0f, 32767.0f / 32768.0f, 1.0f / 32768.0f});
+
+        const std::array<std::byte, 6> i24 = {std::byte{0x80}, std::byte{0x00}, std::byte{0x00},
+                                              std::byte{0xFF}, std::byte{0xFF}, std::byte{0xFF}};
+        kernels::decode(SampleFormat::int24, i24.data(), out.data(), 2);
+        REQUIRE(out[0] == -1.0f);
+        REQUIRE(out[1] == -1.0f / 8388608.0f);
+
+        const std::array<std::byte, 4> i32 = {std::byte{0x40}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00}};
+        kernels::decode(SampleFormat::int32, i32.data(), out.data(), 1);
+        REQUIRE(out[0] == 0.5f);
+    }
+
+    SECTION("encoding clamps, rounds to nearest even and maps NaN to the minimum") {
+        const std::array<float, 6> in = {1.0f, -2.0f, 0.5f / 32768.0f, 1.5f / 32768.0f,
+                                         std::numeric_limits<float>::quiet_NaN(), -1.0f / 32768.0f};
+        std::array<std::byte, 12> out{};
+        kernels::encode(SampleFormat::int16, in.data(), out.data(), in.size());
+        const std::array<std::byte, 12> expected = {
+            std::byte{0x7F}, std::byte{0xFF}, std::byte{0x80}, std::byte{0x00}, std::byte{0x00}, std::byte{0x00},
+            std::byte{0x00}, std::byte{0x02}, std::byte{0x80}, std::byte{0x00}, std::byte{0xFF}, std::byte{0xFF},
+        };
+        REQUIRE(out == expected);
+
+        std::array<std::byte, 4> i32{};
+        const float full = 1.0f;
+        kernels::encode(SampleFormat::int32, &full, i32.data(), 1);
+        REQUIRE(i32 == std::array{std::byte{0x7F}, std::byte{0xFF}, std::byte{0xFF}, std::byte{0x80}});
+    }
+
+    SECTION("16 and 24-bit samples round-trip through float (32-bit ones keep 24 bits)") {
+        for (const auto format : {SampleFormat::int16, SampleFormat::int24}) {
+            const auto size = kernels::bytes_per_sample(format);
+            const auto in = test_bytes(1000 * size, 7);
+            std::vector<float> samples(1000);
+            std::vector<std::byte> out(in.size());
+            kernels::decode(format, in.data(), samples.data(), samples.size());
+            kernels::encode(format, samples.data(), out.data(), samples.size());
+            REQUIRE(out == in);
+        }
+    }
+
+    SECTION("ramps go linearly from the start gain towards the end one") {
+        std::vector<float> buffer(4, 2.0f);
+        kernels::apply_gain_ramp(buffer.data(), buffer.size(), 0.0f, 1.0f);
+        REQUIRE(buffer == std::vector{0.0f, 0.5f, 1.0f, 1.5f});
+
+        std::vector<float> mix(4, 1.0f);
+        const std::vector<float> ones(4, 1.0f);
+        kernels::mix_add_ramp(mix.data(), ones.data(), mix.size(), 1.0f, 0.0f);
+        REQUIRE(mix == std::vector{2.0f, 1.75f, 1.5f, 1.25f});
+
+        kernels::mix_add(mix.data(), ones.data(), mix.size(), 2.0f);
+        REQUIRE(mix == std::vector{4.0f, 3.75f, 3.5f, 3.25f});
+    }
+
+    SECTION("dot products sum in eight partial sums") {
+        std::vector<float> a(19), b(19, 0.5f);
+        for (std::size_t i = 0; i < a.size(); i++) a[i] = static_cast<float>(i);
+        REQUIRE(kernels::dot(a.data(), b.data(), a.size()) == 85.5f);
+        REQUIRE(kernels::dot(a.data(), b.data(), 0) == 0.0f);
+
+        // 1 + 2^-24 + 2^-24 is 1 in order, but the small terms meet in partial sums 1 and 5 first
+        const std::vector<float> ones(6, 1.0f);
+        const std::vector<float> terms = {1.0f, 0x1p-24f, 0.0f, 0.0f, 0.0f, 0x1p-24f};
+        REQUIRE(kernels::dot(terms.data(), ones.data(), 6) == 1.0f + 0x1p-23f);
+    }
+
+    SECTION("peaks are the largest magnitude, NaNs skipped") {
+        const std::vector<float> samples = {0.25f, -0.75f, std::numeric_limits<float>::quiet_NaN(), 0.5f, -0.0f};
+        REQUIRE(kernels::peak(samples.data(), samples.size()) == 0.75f);
+        REQUIRE(kernels::peak(samples.data(), 0) == 0.0f);
+        REQUIRE(kernels::peak(samples.data() + 2, 1) == 0.0f);
+    }
+
+    SECTION("true peaks see between samples, and read the history before the block") {
+        // A quarter of the sample rate, 45 degrees off the samples: they all sit at 0.707 of the wave's peak
+        std::vector<float> buffer(kernels::true_peak_history + 64);
+        for (std::size_t i = 0; i < buffer.size(); i++) {
+            buffer[i] = static_cast<float>(std::sin(std::numbers::pi / 2 * static_cast<double>(i) + std::numbers::pi / 4));
+        }
+        const float* block = buffer.data() + kernels::true_peak_history;
+        const float sample_peak = kernels::peak(block, 64);
+        const float true_peak = kernels::true_peak(block, 64);
+        REQUIRE(std::abs(sample_peak - 0.7071f) < 1e-3f);
+        REQUIRE(true_peak > 0.95f);
+        REQUIRE(true_peak < 1.05f);
+
+        // An impulse 3 samples before the block: the largest tap 3 samples from the current one
+        std::vector<float> impulse(kernels::true_peak_history + 4);
+        impulse[kernels::true_peak_history - 3] = -1.0f;
+        REQUIRE(kernels::true_peak(impulse.data() + kernels::true_peak_history, 1) == 0.1015625f);
+        REQUIRE(kernels::true_peak(impulse.data() + kernels::true_peak_history, 0) == 0.0f);
+    }
+
+    SECTION("interleaving takes any channel count") {
+        for (const std::size_t channels : {1u, 2u, 3u, 8u}) {
+            std::vector<std::vector<float>> planar(channels, std::vector<float>(5));
+            for (std::size_t c = 0; c < channels; c++) {
+                for (std::size_t i = 0; i < 5; i++) planar[c][i] = static_cast<float>(10 * c + i);
+            }
+            std::vector<const float*> sources;
+            for (const auto& p : planar) sources.push_back(p.data());
+
+            std::vector<float> interleaved(5 * channels);
+            kernels::interleave(sources, interleaved.data(), 5);
+            REQUIRE(interleaved[channels * 3 + channels - 1] == static_cast<float>(10 * (channels - 1) + 3));
+
+            std::vector<std::vector<float>> back(channels, std::vector<float>(5));
+            std::vector<float*> destinations;
+            for (auto& p : back) destinations.push_back(p.data());
+            kernels::deinterleave(interleaved.data(), destinations, 5);
+            REQUIRE(back == planar);
+        }
+    }
+}
+
+TEST_CASE("Kernels | Vector implementations match scalar", "[kernels]") {
+
+    // Offsets from an aligned allocation, so loads and stores are misaligned in every way
+    constexpr std::size_t max_length = 4096 + 3;
+    const auto floats = test_samples(max_length, 1);
+    const auto floats2 = test_samples(max_length, 2);
+    const auto bytes = test_bytes(4 * max_length, 3);
+
+    // Run `kernel(offset, n)` with the scalar implementation and the vector one, and compare its output
+    const auto compare = [&](auto kernel) {
+        for (const Isa isa : vector_isas()) {
+            for (const std::size_t n : lengths) {
+                for (std::size_t offset = 0; offset < 4; offset++) {
+                    auto expected = [&] { const UseIsa scalar(Isa::scalar); return kernel(offset, n); }();
+                    auto actual = [&] { const UseIsa vector(isa); return kernel(offset, n); }();
+                    INFO(kernels::isa_name(isa) << ", " << n << " samples at offset " << offset);
+                    REQUIRE(expected.size() == actual.size());
+                    REQUIRE(same_bits(expected.data(), actual.data(), expected.size() * sizeof(expected[0])));
+                }
+            }
+        }
+    };
+
+    SECTION("decode") {
+        for (const auto format : {SampleFormat::int16, SampleFormat::int24, SampleFormat::int32}) {
+            compare([&](std::size_t offset, std::size_t n) {
+                std::vector<float> out(n);
+                kernels::decode(format, bytes.data() + offset, out.data(), n);
+                return out;
+            });
+        }
+    }
+
+    SECTION("encode") {
+        for (const auto format : {SampleFormat::int16, SampleFormat::int24, SampleFormat::int32}) {
+            const auto size = kernels::bytes_per_sample(format);
+            compare([&](std::size_t offset, std::size_t n) {
+                // One spare sample on each side catches writes out of bounds
+                std::vector<std::byte> out((n + 2) * size + offset, std::byte{0xA5});
+                kernels::encode(format, floats.data() + offset, out.data() + size + offset, n);
+                return out;
+            });
+        }
+    }
+
+    SECTION("gains and mixes") {
+        for (const float gain : {0.0f, 0.5f, -1.3f, 1.0001f}) {
+            compare([&](std::size_t offset, std::size_t n) {
+                std::vector<float> buffer(floats.begin() + offset, floats.begin() + offset + n);
+                kernels::apply_gain(buffer.data(), n, gain);
+                return buffer;
+            });
+            compare([&](std::size_t offset, std::size_t n) {
+                std::vector<float> out(floats2.begin(), floats2.begin() + n);
+                kernels::mix_add(out.data(), floats.data() + offset, n, gain);
+                return out;
+            });
+        }
+        for (const auto [from, to] : {std::pair{0.0f, 1.0f}, std::pair{1.0f, 0.0f}, std::pair{0.3f, 0.7f}}) {
+            compare([&](std::size_t offset, std::size_t n) {
+                std::vector<float> buffer(floats.begin() + offset, floats.begin() + offset + n);
+                kernels::apply_gain_ramp(buffer.data(), n, from, to);
+                return buffer;
+            });
+            compare([&](std::size_t offset, std::size_t n) {
+                std::vector<float> out(floats2.begin(), floats2.begin() + n);
+                kernels::mix_add_ramp(out.data(), floats.data() + offset, n, from, to);
+                return out;
+            });
+        }
+    }
+
+    SECTION("dot") {
+        // Finite products only: which NaN a sum of NaNs and infinities gives depends on operand order
+        const auto finite = [](std::vector<float> v) {
+            for (auto& s : v) s = std::isfinite(s) && std::abs(s) < 2.0f ? s : 0.25f;
+            return v;
+        };
+        const auto a = finite(floats);
+        const auto b = finite(floats2);
+        compare([&](std::size_t offset, std::size_t n) {
+            return std::vector{kernels::dot(a.data() + offset, b.data(), n)};
+        });
+    }
+
+    SECTION("peak and true peak") {
+        compare([&](std::size_t offset, std::size_t n) {
+            return std::vector{kernels::peak(floats.data() + offset, n)};
+        });
+        compare([&](std::size_t offset, std::size_t n) {
+            return std::vector{kernels::true_peak(floats.data() + kernels::true_peak_history + offset, n)};
+        });
+    }
+
+    SECTION("interleave and deinterleave") {
+        compare([&](std::size_t offset, std::size_t n) {
+            const std::array<const float*, 2> channels = {floats.data() + offset, floats2.data() + 3 - offset};
+            std::vector<float> out(2 * n + 1, -7.0f);
+            kernels::interleave(channels, out.data() + 1, n);
+            return out;
+        });
+        compare([&](std::size_t offset, std::size_t n) {
+            std::vector<float> out(2 * n + 2, -7.0f);
+            const std::array<float*, 2> channels = {out.data(), out.data() + n + 1};
+            kernels::deinterleave(floats.data() + offset, channels, n);
+            return out;
+        });
+    }
+}
+
+TEST_CASE("Kernels | Dispatch", "[kernels]") {
+
+    SECTION("the active implementation is supported, and scalar always is") {
+        REQUIRE(kernels::isa_supported(kernels::active_isa()));
+        REQUIRE(kernels::isa_supported(Isa::scalar));
+    }
+
+    SECTION("implementations of another architecture are never selected") {
+        const Isa active = kernels::active_isa();
+#if defined(__x86_64__) || defined(_M_X64)
+        REQUIRE_FALSE(kernels::use_isa(Isa::neon));
+        REQUIRE(kernels::isa_supported(Isa::sse2));
+#elif defined(__aarch64__)
+        REQUIRE_FALSE(kernels::use_isa(Isa::avx2));
+        REQUIRE(kernels::isa_supported(Isa::neon));
+#endif
+        REQUIRE(kernels::active_isa() == active);
+    }
+}
@@ -0,0 +1,364 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+// aknet_logger_bench: latency and throughput numbers for the logger.
+//
+//   aknet_logger_bench [--format text|csv|json] [--filter <substring>] [--samples <n>] [--threads <n,n,...>]
+//
+// Latencies are in ns per call. They are measured over batches of calls (the clock costs more than a
+// filtered call), so the percentiles are percentiles of batch averages. Results are printed in a fixed
+// order with fixed columns, so the csv and json outputs can be diffed across releases.
+// Async benchmarks measure the callers only: the backend thread's work is not included.
+
+#include <logger.h>
+#include <bench_support.h>
+
+#include <spdlog/sinks/null_sink.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace aknet;
+
+namespace {
+
+    // ---------------------------------------------------------------------------------------------
+    // Measurement
+    // ---------------------------------------------------------------------------------------------
+
+    using bench_clock = std::chrono::steady_clock;
+
+    struct Result {
+        std::string name;
+        int threads = 1;
+        std::uint64_t calls = 0;
+        double p50 = 0, p90 = 0, p99 = 0, p999 = 0, max = 0; // ns per call
+        double calls_per_second = 0;                        // all threads together
+    };
+
+    struct Options {
+        bench::Format format = bench::Format::text;
+        std::string filter;
+        std::size_t samples = 20000;
+        std::vector<int> threads = {1, 2, 4, 8, 16};
+    };
+
+    double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.empty()) return 0;
+        const auto index = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    // Run `call` on n_threads threads, each taking `samples` timings of `batch` calls
+    Result measure(std::string name, int n_threads, std::size_t samples, std::size_t batch,
+                   const std::function<void(int thread)>& call) {
+        struct ThreadTimings {
+            std::vector<double> per_call; // ns, one per batch
+            bench_clock::time_point begin, end;
+        };
+        std::vector<ThreadTimings> per_thread(n_threads);
+        std::barrier start(n_threads);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < n_threads; t++) {
+            threads.emplace_back([&, t] {
+                auto& timings = per_thread[t];
+                timings.per_call.reserve(samples);
+
+                // Warm up (claims per-thread buffers, fills caches), then start together
+                for (std::size_t i = 0; i < batch * 16; i++) call(t);
+                start.arrive_and_wait();
+
+                timings.begin = bench_clock::now();
+                auto t0 = timings.begin;
+                for (std::size_t s = 0; s < samples; s++) {
+                    for (std::size_t i = 0; i < batch; i++) call(t);
+                    const auto t1 = bench_clock::now();
+                    timings.per_call.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() /
+                                               static_cast<double>(batch));
+                    t0 = t1;
+                }
+                timings.end = t0;
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        std::vector<double> all;
+        auto begin = per_thread.front().begin;
+        auto end = per_thread.front().end;
+        for (const auto& timings : per_thread) {
+            all.insert(all.end(), timings.per_call.begin(), timings.per_call.end());
+            begin = std::min(begin, timings.begin);
+            end = std::max(end, timings.end);
+        }
+        std::ranges::sort(all);
+
+        Result result{.name = std::move(name), .threads = n_threads};
+        result.calls = static_cast<std::uint64_t>(n_threads) * samples * batch;
+        result.p50 = percentile(all, 0.50);
+        result.p90 = percentile(all, 0.90);
+        result.p99 = percentile(all, 0.99);
+        result.p999 = percentile(all, 0.999);
+        result.max = all.empty() ? 0 : all.back();
+        const double seconds = std::chrono::duration<double>(end - begin).count();
+        result.calls_per_second = seconds > 0 ? static_cast<double>(result.calls) / seconds : 0;
+        return result;
+    }
+
+    // Benchmarks selected by --filter, and their results in run order
+    class Suite {
+    public:
+        explicit Suite(Options options) : options_(std::move(options)) {}
+
+        const Options& options() const { return options_; }
+        const std::vector<Result>& results() const { return results_; }
+
+        bool selected(std::string_view name) const { return name.find(options_.filter) != std::string_view::npos; }
+
+        void run(std::string name, int n_threads, std::size_t samples, std::size_t batch,
+                 const std::function<void(int thread)>& call) {
+            if (!selected(name)) return;
+            results_.push_back(measure(std::move(name), n_threads, std::max<std::size_t>(samples, 1), batch, call));
+        }
+
+    private:
+        const Options options_;
+        std::vector<Result> results_;
+    };
+
+    // ---------------------------------------------------------------------------------------------
+    // Setup helpers
+    // ---------------------------------------------------------------------------------------------
+
+    // Logging session in a scratch directory, shut down and removed at the end of the benchmark
+    class Session {
+    public:
+        explicit Session(const log::LogConfig& config) {
+            fs::remove_all(dir());
+            log::init(dir(), config);
+        }
+        ~Session() {
+            log::shutdown();
+            std::error_code ec;
+            fs::remove_all(dir(), ec);
+        }
+
+        static fs::path dir() { return fs::temp_directory_path() / "aknet_logger_bench"; }
+    };
+
+    // A logger whose only sink discards everything, so only the logger's own cost is measured
+    std::shared_ptr<log::Logger> null_logger() {
+        spdlog::register_logger(std::make_shared<spdlog::logger>("null", std::make_shared<spdlog::sinks::null_sink_mt>()));
+        return log::get("null");
+    }
+
+    const std::string g_arg(32, 'x');
+
+    // A user type: the async mode formats it on the caller's thread
+    struct Tag {
+        std::string name;
+    };
+
+} // namespace
+
+template<>
+struct std::formatter<Tag> : std::formatter<std::string_view> {
+    auto format(const Tag& t, std::format_context& ctx) const {
+        return std::formatter<std::string_view>::format(t.name, ctx);
+    }
+};
+
+namespace {
+
+    // ---------------------------------------------------------------------------------------------
+    // Benchmarks (run in this order)
+    // ---------------------------------------------------------------------------------------------
+
+    void bench_filtered(Suite& suite) {
+        const Session session({.console = false});
+        auto logger = log::get("bench");
+        logger->set_level(log::LogLevel::warn);
+
+        suite.run("filtered_trace_call", 1, suite.options().samples, 256, [&](int) {
+            logger->trace("value {} and {}", 42, g_arg);
+        });
+        suite.run("filtered_trace_macro", 1, suite.options().samples, 256, [&](int) {
+            AKNET_LOG_TRACE(logger, "value {} and {}", 42, g_arg);
+        });
+    }
+
+    void bench_null_sink(Suite& suite) {
+        {
+            const Session session({.console = false});
+            auto logger = null_logger();
+            suite.run("null_sink_call_sync", 1, suite.options().samples, 16, [&](int) {
+                logger->info("value {} and {} and {}", 42, 2.5, g_arg);
+            });
+        }
+        {
+            const Session session({.async = {.enabled = true, .ring_capacity = 1 << 16,
+                                             .overflow = log::OverflowPolicy::overwrite_oldest},
+                                   .console = false});
+            auto logger = null_logger();
+            suite.run("null_sink_call_async_deferred", 1, suite.options().samples, 16, [&](int) {
+                logger->info("value {} and {} and {}", 42, 2.5, g_arg);
+            });
+            suite.run("null_sink_call_async_fields", 1, suite.options().samples, 16, [&](int) {
+                logger->info("value", log::kv("int", 42), log::kv("double", 2.5), log::kv("arg", g_arg));
+            });
+            const Tag tag{"tag"};
+            suite.run("null_sink_call_async_eager", 1, suite.options().samples, 16, [&](int) {
+                logger->info("value {}", tag);
+            });
+        }
+        {
+            const Session session({.flight_recorder = {.enabled = true}, .console = false});
+            auto logger = null_logger();
+            logger->set_level(log::LogLevel::off);
+            suite.run("flight_recorder_only_call", 1, suite.options().samples, 16, [&](int) {
+                logger->trace("value {} and {} and {}", 42, 2.5, g_arg);
+            });
+        }
+        {
+            const Session session({.console = false});
+            auto logger = null_logger();
+            logger->set_rate_limit({.messages_per_second = 1, .burst = 1});
+            logger->info("value {}", 0); // uses the only token
+            suite.run("rate_limited_suppressed_call", 1, suite.options().samples, 64, [&](int) {
+                logger->info("value {}", 42);
+            });
+        }
+    }
+
+    void bench_file_sinks(Suite& suite) {
+        struct Variant {
+            const char* name;
+            log::LogConfig config;
+        };
+        const Variant variants[] = {
+            {"file_sink_spdlog_rotating", {.file = {.batched = false, .max_file_size = 1u << 30}, .console = false}},
+            {"file_sink_batched", {.file = {.max_file_size = 1u << 30}, .console = false}},
+            {"file_sink_batched_async", {.async = {.enabled = true, .ring_capacity = 1 << 16},
+                                         .file = {.max_file_size = 1u << 30}, .console = false}},
+            {"binary_sink_async", {.binary = {.enabled = true, .text_sinks = false, .max_file_size = 1u << 30},
+                                   .console = false}},
+        };
+
+        for (const auto& [name, config] : variants) {
+            const Session session(config);
+            auto logger = log::get("bench");
+            suite.run(name, 1, suite.options().samples / 4, 16, [&](int) {
+                logger->info("value {} and {} and {}", 42, 2.5, g_arg);
+            });
+        }
+    }
+
+    void bench_contention(Suite& suite) {
+        {
+            const Session session({.console = false});
+            for (int i = 0; i < 32; i++) log::get(std::format("module_{}", i));
+
+            for (const int n : suite.options().threads) {
+                suite.run("registry_lookup", n, suite.options().samples / 4, 16, [](int t) {
+                    static thread_local const std::string name = std::format("module_{}", t % 32);
+                    auto logger = log::get(name);
+                });
+            }
+        }
+        for (const int n : suite.options().threads) {
+            const Session session({.console = false});
+            auto logger = log::get("bench");
+            suite.run("shared_file_sink_batched", n, suite.options().samples / 4 / n + 1, 16, [&](int) {
+                logger->info("value {} and {} and {}", 42, 2.5, g_arg);
+            });
+        }
+        for (const int n : suite.options().threads) {
+            const Session session({.async = {.enabled = true, .ring_capacity = 1 << 16,
+                                             .overflow = log::OverflowPolicy::overwrite_oldest},
+                                   .console = false});
+            auto logger = log::get("bench");
+            suite.run("shared_file_sink_async", n, suite.options().samples / 4 / n + 1, 16, [&](int) {
+                logger->info("value {} and {} and {}", 42, 2.5, g_arg);
+            });
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Output
+    // ---------------------------------------------------------------------------------------------
+
+    void print(const Options& options, const std::vector<Result>& results) {
+        bench::Table table{"results", {
+            {.key = "name", .header = "benchmark", .width = 32, .left = true},
+            {.key = "threads", .header = "threads", .width = 7},
+            {.key = "calls"},
+            {.key = "p50_ns", .header = "p50 ns", .width = 10, .precision = 1},
+            {.key = "p90_ns", .header = "p90 ns", .width = 10, .precision = 1},
+            {.key = "p99_ns", .header = "p99 ns", .width = 10, .precision = 1},
+            {.key = "p999_ns", .header = "p99.9 ns", .width = 10, .precision = 1},
+            {.key = "max_ns", .header = "max ns", .width = 10, .precision = 1},
+            {.key = "calls_per_second", .header = "calls/s", .width = 14},
+        }};
+        for (const auto& r : results) {
+            table.add({r.name, r.threads, r.calls, r.p50, r.p90, r.p99, r.p999, r.max, r.calls_per_second});
+        }
+        bench::print(options.format, {table});
+    }
+
+    std::optional<Options> parse_options(int argc, char** argv) {
+        return bench::parse_options<Options>(argc, argv, [](Options& options, std::string_view name, std::string_view value) {
+            if (name == "--filter") {
+                options.filter = value;
+            } else if (name == "--samples") {
+                return bench::parse_count(value, options.samples);
+            } else if (name == "--threads") {
+                options.threads.clear();
+                for (std::string_view list = value; !list.empty();) {
+                    const auto comma = list.find(',');
+                    int n = 0;
+                    if (!bench::parse_count(list.substr(0, comma), n)) return false;
+                    options.threads.push_back(n);
+                    list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+                }
+            } else {
+                return false;
+            }
+            return true;
+        });
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_options(argc, argv);
+    if (!options) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--format text|csv|json] [--filter <substring>] [--samples <n>] [--threads <n,n,...>]"
+                  << std::endl;
+        return 1;
+    }
+
+    Suite suite(*options);
+    bench_filtered(suite);
+    bench_null_sink(suite);
+    bench_file_sinks(suite);
+    bench_contention(suite);
+
+    print(suite.options(), suite.results());
+    return 0;
+}
@@ -0,0 +1,108 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_BINARY_LOG_H
+#define AKNET_BINARY_LOG_H
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "log_record.h"
+
+// -------------------------------------------------------------------------
+// Compact binary log files (.aklog), written by the binary sink and decoded by aknet_logdump.
+//
+// Layout (little-endian):
+//   file header : magic (8 bytes) | version (u32)
+//   entries     : kind (u8) | body size (u32) | body
+//
+// Entry bodies:
+//   logger : id (u32) | name length (u16) | name
+//   format : id (u32) | format length (u16) | format | arg count (u8) | arg types (u8 each)
+//   record : timestamp ns (i64) | logger id (u32) | level (u8) | format id (u32) | packed arguments
+//   text   : timestamp ns (i64) | logger id (u32) | level (u8) | message
+//   event  : timestamp ns (i64) | logger id (u32) | level (u8) | format id (u32) | packed fields
+//
+// Event records are structured calls (see Logger): their format entry holds the event name and the field
+// types, and each packed field is key length (u8) | key | value.
+//
+// Logger and format entries form a dictionary written once per file, before the first record
+// that uses them, so every file (including rotated ones) can be decoded on its own.
+// Unknown entry kinds are skipped by the reader.
+// -------------------------------------------------------------------------
+namespace aknet::log::binary {
+
+    inline constexpr std::array<char, 8> file_magic = {'A', 'K', 'L', 'O', 'G', '\0', '\r', '\n'};
+    inline constexpr std::uint32_t file_version = 1;
+    inline constexpr std::string_view file_extension = ".aklog";
+
+    enum class EntryKind : std::uint8_t { logger = 1, format = 2, record = 3, text = 4, event = 5 };
+
+    // A field of a structured record, its value rendered as in the text sinks (strings unquoted)
+    struct DecodedField {
+        std::string key;
+        detail::ArgType type = detail::ArgType::none;
+        std::string value;
+    };
+
+    // A record read back from a binary log file
+    struct DecodedRecord {
+        std::int64_t timestamp_ns = 0;
+        LogLevel level = LogLevel::info;
+        std::string logger;
+        std::string message;              // for event records: the text rendering, "<event> key=value ..."
+        std::string event;                // event records only
+        std::vector<DecodedField> fields; // event records only
+    };
+
+    // -------------------------------------------------------------------------
+    // Reader: streams the records of one binary log file, or of a compressed segment of one (.aklog.akz)
+    // -------------------------------------------------------------------------
+    class Reader {
+    public:
+        // Throws std::runtime_error if the file cannot be opened or is not a binary log
+        explicit Reader(const std::filesystem::path& path);
+
+        // Read the next record. Returns false at the end of the file (or at a truncated last entry).
+        bool next(DecodedRecord& out);
+
+    private:
+        struct Format {
+            std::string format;
+            std::vector<detail::ArgType> types;
+        };
+
+        std::unique_ptr<std::istream> in_;
+        std::string body_;
+        std::unordered_map<std::uint32_t, std::string> loggers_;
+        std::unordered_map<std::uint32_t, Format> formats_;
+    };
+
+    // Format packed arguments with a format string, without knowing their C++ types.
+    // Supports the std::format replacement field syntax, including nested width/precision fields.
+    void format_packed(std::string_view fmt, std::span<const detail::ArgType> types, std::string_view payload,
+                       std::string& out);
+
+    // Render a record with the same layout as the text file sink:
+    // "%Y-%m-%d %H:%M:%S.%e [%10!n] [%8l] %v" (local time)
+    std::string format_text_line(const DecodedRecord& record);
+
+    // Render a record as one JSON object (JSON lines), fields as typed members after the fixed ones:
+    // {"time":"2026-10-17 12:00:00.123","time_ns":...,"logger":"stream","level":"warning","msg":"underrun","stream":3}
+    // "msg" is the event name of event records and the message of the others.
+    std::string format_json_line(const DecodedRecord& record);
+
+} // namespace aknet::log::binary
+
+#endif // AKNET_BINARY_LOG_H
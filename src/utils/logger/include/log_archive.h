@@ -0,0 +1,83 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_LOG_ARCHIVE_H
+#define AKNET_LOG_ARCHIVE_H
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string_view>
+#include <vector>
+
+// -------------------------------------------------------------------------
+// Compressed log segments (.akz): rotated text and binary log files, compressed in the background
+// (see ArchiveConfig in logger.h) and streamed back by archive::Reader and aknet_logdump.
+// A segment keeps its original name with the extension appended: aknet_<session>.3.log.akz
+//
+// Layout (little-endian):
+//   file header : magic (8 bytes) | version (u32)
+//   blocks      : raw size (u32) | stored size (u32) | stored bytes
+//
+// Each block holds up to block_size bytes of the original file, compressed on its own with an
+// LZ77 byte codec (the LZ4 block format); a block whose stored size equals its raw size is stored
+// uncompressed. Blocks are independent, so a truncated segment reads back up to its last full block.
+// -------------------------------------------------------------------------
+namespace aknet::log::archive {
+
+    inline constexpr std::array<char, 8> file_magic = {'A', 'K', 'Z', 'L', 'O', 'G', '\r', '\n'};
+    inline constexpr std::uint32_t file_version = 1;
+    inline constexpr std::string_view file_extension = ".akz";
+    inline constexpr std::size_t block_size = 128 * 1024;
+
+    // Compress one block into dst. Returns the compressed size, or 0 if it does not fit in capacity
+    // (incompressible data: store the block instead).
+    std::size_t compress_block(const char* src, std::size_t size, char* dst, std::size_t capacity) noexcept;
+
+    // Decompress one block of exactly raw_size bytes into dst. Returns false if the block is corrupt.
+    bool decompress_block(const char* src, std::size_t size, char* dst, std::size_t raw_size) noexcept;
+
+    // Compress the file at src into a new segment at dst (written to dst.part, then renamed).
+    // Throws std::runtime_error on I/O errors; src is left in place.
+    void compress_file(const std::filesystem::path& src, const std::filesystem::path& dst);
+
+    // -------------------------------------------------------------------------
+    // Reader: an input stream of the original bytes of a compressed segment, decompressed block by block
+    // -------------------------------------------------------------------------
+    class Reader : public std::istream {
+    public:
+        // Throws std::runtime_error if the file cannot be opened or is not a compressed segment.
+        // A corrupt block sets badbit.
+        explicit Reader(const std::filesystem::path& path);
+
+    private:
+        class Buffer : public std::streambuf {
+        public:
+            explicit Buffer(const std::filesystem::path& path);
+
+        protected:
+            int_type underflow() override;
+
+        private:
+            std::ifstream in_;
+            std::vector<char> stored_;
+            std::vector<char> block_;
+        };
+
+        std::unique_ptr<Buffer> buffer_;
+    };
+
+    // Open a log file for reading, decompressing it if it is a .akz segment
+    std::unique_ptr<std::istream> open(const std::filesystem::path& path);
+
+} // namespace aknet::log::archive
+
+#endif // AKNET_LOG_ARCHIVE_H
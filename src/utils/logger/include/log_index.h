@@ -0,0 +1,110 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_LOG_INDEX_H
+#define AKNET_LOG_INDEX_H
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "log_record.h"
+
+// -------------------------------------------------------------------------
+// Sparse time index of a text log file (.akidx), written next to it by the batched file sink and read
+// by aknet_logquery to seek to a time range, logger or level without scanning the whole file.
+// aknet_20261017_120000.log is indexed by aknet_20261017_120000.log.akidx, its rotated and archived
+// segments aknet_20261017_120000.3.log[.akz] by aknet_20261017_120000.3.log.akidx.
+//
+// Layout (little-endian):
+//   file header : magic (8 bytes) | version (u32)
+//   entries     : kind (u8) | body size (u32) | body
+//
+// Entry bodies:
+//   logger : bit (u8) | name length (u16) | name
+//   block  : offset (u64) | size (u32) | first ns (i64) | last ns (i64) | levels (u8) | loggers (u64)
+//
+// A block covers whole lines [offset, offset + size) of the log file. first/last are the earliest and
+// latest system_clock timestamps of its lines (records of several threads are not strictly ordered),
+// levels has bit (1 << level) set for every level present, loggers bit b for every logger mapped to b.
+// Loggers get bits in order of appearance; past 64 loggers bits are shared, so a mask may select a few
+// blocks too many but never misses one. Lines past the end of the last block are not indexed yet.
+// -------------------------------------------------------------------------
+namespace aknet::log::index {
+
+    inline constexpr std::array<char, 8> file_magic = {'A', 'K', 'I', 'D', 'X', '\0', '\r', '\n'};
+    inline constexpr std::uint32_t file_version = 1;
+    inline constexpr std::string_view file_extension = ".akidx";
+    inline constexpr unsigned logger_bits = 64;
+
+    enum class EntryKind : std::uint8_t { logger = 1, block = 2 };
+
+    inline constexpr std::uint64_t all_loggers = std::numeric_limits<std::uint64_t>::max();
+    inline constexpr std::uint8_t all_levels = 0xff;
+
+    struct Block {
+        std::uint64_t offset = 0;
+        std::uint32_t size = 0;
+        std::int64_t first_ns = std::numeric_limits<std::int64_t>::max();
+        std::int64_t last_ns = std::numeric_limits<std::int64_t>::min();
+        std::uint8_t levels = 0;
+        std::uint64_t loggers = 0;
+
+        void add(std::int64_t timestamp_ns, LogLevel level, unsigned logger_bit, std::size_t bytes) noexcept {
+            first_ns = std::min(first_ns, timestamp_ns);
+            last_ns = std::max(last_ns, timestamp_ns);
+            levels |= static_cast<std::uint8_t>(1u << static_cast<unsigned>(level));
+            loggers |= std::uint64_t{1} << (logger_bit % logger_bits);
+            size += static_cast<std::uint32_t>(bytes);
+        }
+
+        // Whether the block may hold lines in [from_ns, to_ns] of the selected loggers and levels
+        bool matches(std::int64_t from_ns, std::int64_t to_ns, std::uint64_t logger_mask, std::uint8_t level_mask) const noexcept {
+            return size > 0 && first_ns <= to_ns && last_ns >= from_ns && (loggers & logger_mask) && (levels & level_mask);
+        }
+    };
+
+    // Index file of a log file or of one of its segments
+    std::filesystem::path index_path(const std::filesystem::path& log_path);
+
+    // -------------------------------------------------------------------------
+    // Index: the blocks and logger names of one index file
+    // -------------------------------------------------------------------------
+    class Index {
+    public:
+        // Throws std::runtime_error if the file cannot be opened or is not an index
+        explicit Index(const std::filesystem::path& path);
+
+        const std::vector<Block>& blocks() const { return blocks_; }
+
+        // End of the indexed part of the log file
+        std::uint64_t indexed_size() const { return blocks_.empty() ? 0 : blocks_.back().offset + blocks_.back().size; }
+
+        // Bits of the loggers with this name (as written in the log lines, i.e. truncated to 10 characters); 0 if none
+        std::uint64_t logger_mask(std::string_view name) const;
+
+        // Blocks that may hold matching lines, in file order
+        std::vector<Block> select(std::int64_t from_ns, std::int64_t to_ns, std::uint64_t logger_mask = all_loggers,
+                                  std::uint8_t level_mask = all_levels) const;
+
+    private:
+        struct Logger {
+            unsigned bit;
+            std::string name;
+        };
+
+        std::vector<Block> blocks_;
+        std::vector<Logger> loggers_;
+    };
+
+} // namespace aknet::log::index
+
+#endif // AKNET_LOG_INDEX_H
@@ -0,0 +1,391 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_LOG_RECORD_H
+#define AKNET_LOG_RECORD_H
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace aknet::log {
+
+    enum class LogLevel { trace, debug, info, warn, error, critical, off };
+
+    // A named value of a structured call, made with kv() (see Logger). Only refers to the value:
+    // fields are meant to be built in the logging call's argument list.
+    template <typename T>
+    struct Field {
+        std::string_view key;
+        const T& value;
+    };
+
+    template <typename T>
+    Field<T> kv(std::string_view key, const T& value) noexcept {
+        return {key, value};
+    }
+
+    // Name of a structured call's event. Like format strings, it must be a string literal:
+    // records refer to it instead of copying it.
+    class EventName {
+    public:
+        consteval EventName(const char* name) : name_(name) {}
+        constexpr std::string_view get() const noexcept { return name_; }
+
+    private:
+        std::string_view name_;
+    };
+
+    // Forward declaration — implementation is hidden in .cpp
+    class LoggerImpl;
+
+} // namespace aknet::log
+
+// -------------------------------------------------------------------------
+// Binary log records used by the async mode and the flight recorder.
+// Internal to the logger: modules only go through aknet::log::Logger.
+// -------------------------------------------------------------------------
+namespace aknet::log::detail {
+
+    // Formats the arguments packed in a record payload; one instantiation per argument type list
+    using FormatFn = void (*)(std::string_view fmt, const char* args, std::string& out);
+
+    // Type tags of captured arguments, so records can be decoded without the original types
+    enum class ArgType : std::uint8_t {
+        none, i8, u8, i16, u16, i32, u32, i64, u64, f32, f64, boolean, character, string, pointer,
+        custom // user type copied by value: only the in-process formatter can render it
+    };
+
+    // Static description of a captured argument list, one per instantiation
+    struct ArgList {
+        FormatFn format;
+        const ArgType* types;
+        std::uint8_t count;
+        bool portable;       // no ArgType::custom: the payload can be decoded offline
+        bool fields = false; // structured call: the format is the event name, each argument has a key
+    };
+
+    // Fixed-size record written by producers into their thread's ring
+    inline constexpr std::size_t record_size = 256;
+
+    struct RecordHeader {
+        LoggerImpl* logger = nullptr;
+        std::int64_t timestamp = 0;    // record clock (see ClockSource), captured at the call site
+        std::string_view format;       // the call site's format string (static storage)
+        const ArgList* args = nullptr; // nullptr: payload already holds the formatted text
+        LogLevel level = LogLevel::info;
+        std::uint16_t length = 0;      // bytes used in payload
+    };
+
+    struct alignas(64) Record : RecordHeader {
+        static constexpr std::size_t payload_capacity = record_size - sizeof(RecordHeader);
+        char payload[payload_capacity];
+    };
+    static_assert(sizeof(Record) == record_size);
+
+    // -------------------------------------------------------------------------
+    // Argument capture (deferred formatting)
+    //
+    // Strings are copied by content (u16 length + bytes, truncated to fit the payload).
+    // Other trivially copyable values are copied by value. Anything else, or an argument list
+    // whose fixed part does not fit the payload, is formatted eagerly into the payload instead.
+    // -------------------------------------------------------------------------
+    template <typename T>
+    concept captured_as_string = std::is_convertible_v<const T&, std::string_view>;
+
+    template <typename T>
+    concept captured_by_value = !captured_as_string<T> && std::is_trivially_copyable_v<T> &&
+                                (!std::is_pointer_v<T> || std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, void>);
+
+    template <typename T>
+    concept capturable = captured_as_string<T> || captured_by_value<T>;
+
+    template <typename T>
+    inline constexpr std::size_t captured_fixed_size = captured_as_string<T> ? sizeof(std::uint16_t) : sizeof(T);
+
+    template <typename... Ts>
+    inline constexpr bool deferrable = (capturable<Ts> && ...) && sizeof...(Ts) <= 255 &&
+                                       (captured_fixed_size<Ts> + ... + 0) <= Record::payload_capacity;
+
+    // What the backend hands to std::format for a captured argument
+    template <typename T>
+    using captured_t = std::conditional_t<captured_as_string<T>, std::string_view, T>;
+
+    template <typename T>
+    constexpr ArgType arg_type_of() {
+        if constexpr (captured_as_string<T>) return ArgType::string;
+        else if constexpr (std::is_same_v<T, bool>) return ArgType::boolean;
+        else if constexpr (std::is_same_v<T, char>) return ArgType::character;
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            if constexpr (sizeof(T) == 1) return ArgType::i8;
+            else if constexpr (sizeof(T) == 2) return ArgType::i16;
+            else if constexpr (sizeof(T) == 4) return ArgType::i32;
+            else if constexpr (sizeof(T) == 8) return ArgType::i64;
+            else return ArgType::custom;
+        }
+        else if constexpr (std::is_integral_v<T>) {
+            if constexpr (sizeof(T) == 1) return ArgType::u8;
+            else if constexpr (sizeof(T) == 2) return ArgType::u16;
+            else if constexpr (sizeof(T) == 4) return ArgType::u32;
+            else if constexpr (sizeof(T) == 8) return ArgType::u64;
+            else return ArgType::custom;
+        }
+        else if constexpr (std::is_same_v<T, float>) return ArgType::f32;
+        else if constexpr (std::is_same_v<T, double>) return ArgType::f64;
+        else if constexpr (std::is_pointer_v<T>) return ArgType::pointer;
+        else return ArgType::custom;
+    }
+
+    template <typename T>
+    void encode_arg(char*& cursor, std::size_t& remaining, const T& arg) noexcept {
+        if constexpr (captured_as_string<T>) {
+            const std::string_view str = arg;
+            const auto n = static_cast<std::uint16_t>(std::min(str.size(), remaining - sizeof(std::uint16_t)));
+            std::memcpy(cursor, &n, sizeof n);
+            std::memcpy(cursor + sizeof n, str.data(), n);
+            cursor += sizeof n + n;
+            remaining -= sizeof n + n;
+        } else {
+            std::memcpy(cursor, &arg, sizeof(T));
+            cursor += sizeof(T);
+            remaining -= sizeof(T);
+        }
+    }
+
+    template <typename T>
+    captured_t<T> decode_arg(const char*& cursor) noexcept {
+        if constexpr (captured_as_string<T>) {
+            std::uint16_t n;
+            std::memcpy(&n, cursor, sizeof n);
+            const std::string_view str(cursor + sizeof n, n);
+            cursor += sizeof n + n;
+            return str;
+        } else {
+            std::array<char, sizeof(T)> raw;
+            std::memcpy(raw.data(), cursor, sizeof(T));
+            cursor += sizeof(T);
+            return std::bit_cast<T>(raw);
+        }
+    }
+
+    template <typename... Ts>
+    void format_captured(std::string_view fmt, [[maybe_unused]] const char* args, std::string& out) {
+        // Braced initialisation evaluates the decode_arg calls left to right
+        std::tuple<captured_t<Ts>...> values{decode_arg<Ts>(args)...};
+        std::apply([&](auto&... v) {
+            std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(v...));
+        }, values);
+    }
+
+    // Trailing ArgType::none keeps the array non-empty for argument-less calls
+    template <typename... Ts>
+    inline constexpr ArgType arg_types_of[] = {arg_type_of<Ts>()..., ArgType::none};
+
+    template <typename... Ts>
+    inline constexpr ArgList arg_list_of{
+        &format_captured<Ts...>, arg_types_of<Ts...>, static_cast<std::uint8_t>(sizeof...(Ts)),
+        ((arg_type_of<Ts>() != ArgType::custom) && ...)
+    };
+
+    // Output iterator for eager formatting: writes up to the end of the payload, drops the rest
+    struct PayloadWriter {
+        using difference_type = std::ptrdiff_t;
+        char* pos;
+        char* end;
+
+        PayloadWriter& operator=(char c) noexcept {
+            if (pos != end) *pos++ = c;
+            return *this;
+        }
+        PayloadWriter& operator*() noexcept { return *this; }
+        PayloadWriter& operator++() noexcept { return *this; }
+        PayloadWriter& operator++(int) noexcept { return *this; }
+    };
+
+    // Fill an acquired record: capture the arguments if possible, otherwise format them now.
+    // Arguments are only read, so the caller can still use them afterwards (flight recorder + sinks).
+    template <typename... Args>
+    void capture(Record& rec, std::format_string<Args...> fmt, const std::remove_reference_t<Args>&... args) {
+        if constexpr (deferrable<std::remove_cvref_t<Args>...>) {
+            rec.format = fmt.get();
+            rec.args = &arg_list_of<std::remove_cvref_t<Args>...>;
+
+            // Reserve room for the fixed part of every later argument so long strings cannot starve them
+            char* cursor = rec.payload;
+            std::size_t remaining = Record::payload_capacity;
+            std::size_t reserved = (captured_fixed_size<std::remove_cvref_t<Args>> + ... + 0);
+            auto encode = [&]<typename T>(const T& arg) {
+                reserved -= captured_fixed_size<T>;
+                std::size_t budget = remaining - reserved;
+                char* const start = cursor;
+                encode_arg(cursor, budget, arg);
+                remaining -= static_cast<std::size_t>(cursor - start);
+            };
+            (encode(static_cast<const std::remove_cvref_t<Args>&>(args)), ...);
+            rec.length = static_cast<std::uint16_t>(cursor - rec.payload);
+        } else {
+            rec.format = {};
+            rec.args = nullptr;
+            const auto end = std::vformat_to(PayloadWriter{rec.payload, rec.payload + Record::payload_capacity},
+                                             fmt.get(), std::make_format_args(args...));
+            rec.length = static_cast<std::uint16_t>(end.pos - rec.payload);
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Structured fields
+    //
+    // Text rendering: "<event> key=value key=value", strings quoted when they contain spaces, quotes or '='.
+    // Captured fields are packed as key length (u8) + key bytes + the value as captured above,
+    // so numeric fields cost a few memcpy and no formatting.
+    // -------------------------------------------------------------------------
+    template <typename T>
+    inline constexpr bool is_field = false;
+
+    template <typename T>
+    inline constexpr bool is_field<Field<T>> = true;
+
+    inline void append_field_text(std::string& out, std::string_view value) {
+        const bool bare = !value.empty() && std::ranges::none_of(value, [](char c) {
+            return c == ' ' || c == '"' || c == '=' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+        });
+        if (bare) {
+            out += value;
+            return;
+        }
+        out += '"';
+        for (const char c : value) {
+            if (c == '"' || c == '\\') out += '\\';
+            if (c == '\n') out += "\\n";
+            else if (c == '\t') out += "\\t";
+            else if (static_cast<unsigned char>(c) < 0x20) out += ' ';
+            else out += c;
+        }
+        out += '"';
+    }
+
+    template <typename T>
+    void append_field(std::string& out, std::string_view key, const T& value) {
+        out += ' ';
+        out += key;
+        out += '=';
+        if constexpr (captured_as_string<T>) {
+            append_field_text(out, value);
+        } else {
+            std::format_to(std::back_inserter(out), "{}", value);
+        }
+    }
+
+    // Synchronous path: render the fields directly
+    template <typename... Ts>
+    void format_fields(std::string_view event, std::string& out, const Field<Ts>&... fields) {
+        out += event;
+        (append_field(out, fields.key, fields.value), ...);
+    }
+
+    template <typename... Ts>
+    void format_captured_fields(std::string_view event, [[maybe_unused]] const char* payload, std::string& out) {
+        out += event;
+        auto field = [&]<typename T>() {
+            const auto key_length = static_cast<std::uint8_t>(*payload++);
+            const std::string_view key(payload, key_length);
+            payload += key_length;
+            append_field(out, key, decode_arg<T>(payload));
+        };
+        (field.template operator()<Ts>(), ...);
+    }
+
+    template <typename T>
+    inline constexpr std::size_t captured_field_size = 1 + captured_fixed_size<T>;
+
+    // Keys are truncated to this many bytes
+    inline constexpr std::size_t max_captured_key = 64;
+
+    constexpr std::size_t captured_key_size(std::string_view key) noexcept {
+        return std::min(key.size(), max_captured_key);
+    }
+
+    template <typename... Ts>
+    inline constexpr bool fields_deferrable = (capturable<Ts> && ...) && sizeof...(Ts) <= 255 &&
+                                              (captured_field_size<Ts> + ... + 0) <= Record::payload_capacity;
+
+    template <typename... Ts>
+    inline constexpr ArgList field_list_of{
+        &format_captured_fields<Ts...>, arg_types_of<Ts...>, static_cast<std::uint8_t>(sizeof...(Ts)),
+        ((arg_type_of<Ts>() != ArgType::custom) && ...), true
+    };
+
+    // Fill an acquired record with a structured call, falling back to its text like capture()
+    template <typename... Ts>
+    void capture_fields(Record& rec, std::string_view event, const Field<Ts>&... fields) {
+        if constexpr (fields_deferrable<Ts...>) {
+            rec.format = event;
+            rec.args = &field_list_of<Ts...>;
+
+            // As in capture(), plus room for the keys of the later fields so long strings cannot starve them
+            char* cursor = rec.payload;
+            std::size_t remaining = Record::payload_capacity;
+            std::size_t fixed = (captured_field_size<Ts> + ... + 0);
+            std::size_t keys = (captured_key_size(fields.key) + ... + 0);
+            auto encode = [&]<typename T>(const Field<T>& field) {
+                fixed -= captured_field_size<T>;
+                keys -= captured_key_size(field.key);
+                char* const start = cursor;
+                std::size_t budget = remaining - fixed;
+
+                const auto key_length = static_cast<std::uint8_t>(
+                    std::min(captured_key_size(field.key), budget - captured_field_size<T>));
+                *cursor++ = static_cast<char>(key_length);
+                std::memcpy(cursor, field.key.data(), key_length);
+                cursor += key_length;
+                budget -= 1 + key_length;
+
+                budget -= std::min(keys, budget - captured_fixed_size<T>);
+                encode_arg(cursor, budget, field.value);
+                remaining -= static_cast<std::size_t>(cursor - start);
+            };
+            (encode(fields), ...);
+            rec.length = static_cast<std::uint16_t>(cursor - rec.payload);
+        } else {
+            rec.format = {};
+            rec.args = nullptr;
+            std::string text; // not real-time safe, like any argument that cannot be captured
+            format_fields(event, text, fields...);
+            rec.length = static_cast<std::uint16_t>(std::min(text.size(), Record::payload_capacity));
+            std::memcpy(rec.payload, text.data(), rec.length);
+        }
+    }
+
+    // Render a record's message (backend side)
+    inline std::string_view render(const Record& rec, std::string& buffer) {
+        if (!rec.args) return {rec.payload, rec.length};
+        buffer.clear();
+        rec.args->format(rec.format, rec.payload, buffer);
+        return buffer;
+    }
+
+    // Reserve the next slot of the calling thread's ring. Returns nullptr if the record is dropped.
+    Record* acquire_record(LoggerImpl* logger, LogLevel lvl) noexcept;
+
+    // Make the last acquired record visible to the backend
+    void publish_record() noexcept;
+
+    // Flight recorder: same protocol on the calling thread's recorder ring (which never drops, it wraps)
+    Record* acquire_flight_record(LoggerImpl* logger, LogLevel lvl) noexcept;
+    void publish_flight_record() noexcept;
+
+} // namespace aknet::log::detail
+
+#endif // AKNET_LOG_RECORD_H
@@ -7,18 +7,138 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <filesystem>
 #include <format>
 
+#include "log_record.h"
+
+// Compile-time level floor, set from CMake with -DAKNET_MIN_LOG_LEVEL=<level> (0 = trace ... 6 = off).
+// Calls below it compile to nothing; the AKNET_LOG_* macros also skip evaluating their arguments.
+#ifndef AKNET_MIN_LOG_LEVEL
+#define AKNET_MIN_LOG_LEVEL 0
+#endif
+
 namespace aknet::log {
 
-    enum class LogLevel { trace, debug, info, warn, error, critical, off };
+    inline constexpr LogLevel min_log_level = static_cast<LogLevel>(AKNET_MIN_LOG_LEVEL);
+
+    // Whether calls at Lvl exist at all in a build with the given floor
+    template <LogLevel Lvl, LogLevel Floor = min_log_level>
+    inline constexpr bool compiled_in = Lvl >= Floor;
+
+    // What the async mode does when a thread's ring is full
+    enum class OverflowPolicy {
+        drop,             // discard the new record and count it
+        overwrite_oldest  // discard the oldest unread record and count it
+    };
+
+    // Real-time safe logging mode: each thread writes into its own preallocated ring,
+    // a backend thread drains the rings into the sinks. No locks or allocations on the caller side
+    // once the thread's ring exists (see preallocate_thread_buffer()).
+    // Arguments are captured by value (strings by content) and formatted on the backend thread,
+    // so format strings must be string literals, as they are everywhere in aknet.
+    struct AsyncConfig {
+        bool enabled = false;
+        std::size_t ring_capacity = 1024; // records per thread, rounded up to a power of two
+        OverflowPolicy overflow = OverflowPolicy::drop;
+        std::chrono::microseconds poll_interval{1000}; // backend sleep when all rings are empty
+    };
+
+    // Per-call-site rate limiting and sampling of a logger, set with Logger::set_rate_limit().
+    // A call site is identified by its format string (or event name). Sampling keeps 1 call in sample_every, then a token
+    // bucket admits at most messages_per_second on average with bursts of up to burst calls.
+    // Suppressed calls are counted and reported in a summary line. The defaults limit nothing.
+    struct RateLimitConfig {
+        double messages_per_second = 0; // 0: no token bucket
+        std::uint32_t burst = 10;
+        std::uint32_t sample_every = 1; // 1: keep every call
+    };
+
+    // Text log file of the session. By default it is written by an aknet sink that batches lines in memory
+    // and writes them from its own thread with one writev per batch, so logging calls never wait on the disk
+    // and files are rotated off the callers' path.
+    struct FileSinkConfig {
+        bool batched = true;                          // false: spdlog's rotating sink, one write per line
+        std::size_t batch_size = 64 * 1024;           // write as soon as this many bytes are pending
+        std::chrono::milliseconds max_latency{100};   // ...and at least this often when lines are pending
+        std::size_t max_file_size = 1024 * 1024 * 5;  // rotate after this many bytes
+        std::size_t max_files = 3;                    // rotated files kept next to the current one, without archive
+        bool preallocate = true;                      // reserve max_file_size on disk when opening a file
+        bool index = true;                            // write a .akidx time index next to each file (see log_index.h)
+        std::size_t index_block_size = 64 * 1024;     // bytes of lines per index entry
+    };
+
+    // Archive of rotated files: instead of keeping max_files uncompressed files, the batched text file and the
+    // binary file hand each rotated segment to a low-priority background thread that compresses it
+    // (.akz files, see log_archive.h and aknet_logdump). The oldest segments of the log directory are deleted
+    // once they take more than max_bytes. Sinks never wait on compression. spdlog's sink (batched = false)
+    // keeps its own rotation.
+    struct ArchiveConfig {
+        bool enabled = true;
+        std::size_t max_bytes = 1024 * 1024 * 512; // compressed bytes kept in the log directory
+    };
+
+    // Compact binary log file (.aklog) in the log directory, decoded with the aknet_logdump tool.
+    // Records keep their packed arguments, so nothing is formatted at log time. The binary file is written
+    // by the async backend: enabling it also enables the async mode.
+    struct BinaryLogConfig {
+        bool enabled = false;
+        bool text_sinks = true;                       // keep writing the text file and console too
+        std::size_t max_file_size = 1024 * 1024 * 64; // rotate after this many bytes
+        std::size_t max_files = 3;                    // rotated files kept next to the current one, without archive
+    };
 
-    // Forward declaration — implementation is hidden in .cpp
-    class LoggerImpl;
+    // Flight recorder: every thread also keeps its last records in memory, including levels filtered out
+    // of the sinks, to be dumped after a glitch or a crash. Dumps are .aklog files (see aknet_logdump)
+    // written to the log directory. Memory is fixed at init(): max_threads rings of records_per_thread
+    // records of 256 bytes, plus a 64 KiB alternate signal stack each with dump_on_crash, so that a stack
+    // overflow still gets its dump; threads beyond max_threads are not recorded. Recording never allocates.
+    struct FlightRecorderConfig {
+        bool enabled = false;
+        LogLevel level = LogLevel::trace;  // lowest level recorded, independent of the sink levels
+        std::size_t records_per_thread = 2048; // rounded up to a power of two
+        std::size_t max_threads = 16;
+        bool dump_on_shutdown = true;
+        bool dump_on_crash = true;         // install handlers for SIGSEGV, SIGBUS, SIGILL, SIGFPE and SIGABRT
+    };
+
+    // Clock of the timestamps taken at the call site by the async mode and the flight recorder.
+    // Records keep the raw clock value; it is converted to wall-clock time, with a calibration taken by init(),
+    // only on the backend thread or when a dump is written. (Synchronous calls are stamped by spdlog.)
+    enum class ClockSource {
+        system,           // system_clock, as in the text sinks
+        monotonic_coarse, // CLOCK_MONOTONIC_COARSE: no counter read, but only as precise as the kernel tick
+        tsc               // CPU cycle counter (rdtsc, cntvct_el0); falls back to monotonic_coarse without one
+    };
+
+    struct LogConfig {
+        AsyncConfig async = {};
+        BinaryLogConfig binary = {};
+        FlightRecorderConfig flight_recorder = {};
+        FileSinkConfig file = {};
+        ArchiveConfig archive = {};
+        bool console = true; // also print to stdout
+        ClockSource clock = ClockSource::tsc;
+    };
+
+    namespace detail {
+        class RateLimiter;
+
+        // Whether a call of the site `format` passes the limiter (see rate_limiter.h)
+        bool admit_call(RateLimiter* limiter, std::string_view format, LogLevel lvl, std::uint64_t& suppressed) noexcept;
+
+        // Format-string calls: none of the arguments is a kv() field
+        template <typename... Args>
+        concept no_fields = (!is_field<std::remove_cvref_t<Args>> && ...);
+    }
 
     // -------------------------------------------------------------------------
     // Logger: the public interface modules use for logging.
@@ -36,29 +156,97 @@ namespace aknet::log {
         Logger& operator=(Logger&&) noexcept;
 
         // Logging methods (variadic, type-safe via std::format)
-        template <typename... Args>
+        // The level check happens here, before any formatting, so a filtered call costs one atomic load.
+        // Calls filtered out of the sinks are still captured when the flight recorder's level allows them.
+        // Levels below min_log_level are compiled out entirely.
+        //
+        // Structured calls take an event name and typed fields instead of a format string:
+        //   logger_->warn("underrun", log::kv("stream", id), log::kv("depth", depth));
+        // Fields are captured without formatting (numbers and strings without allocating, like format
+        // arguments), kept typed in binary logs and rendered as "underrun stream=3 depth=12" in text.
+        template <typename... Args> requires detail::no_fields<Args...>
         void trace(std::format_string<Args...> fmt, Args&&... args) {
-            log(LogLevel::trace, std::format(fmt, std::forward<Args>(args)...));
+            if constexpr (compiled_in<LogLevel::trace>) {
+                if (!should_log(LogLevel::trace)) return;
+                write(LogLevel::trace, fmt, std::forward<Args>(args)...);
+            }
         }
-        template <typename... Args>
+        template <typename... Ts> requires (sizeof...(Ts) > 0)
+        void trace(EventName event, const Field<Ts>&... fields) {
+            if constexpr (compiled_in<LogLevel::trace>) {
+                if (!should_log(LogLevel::trace)) return;
+                write_fields(LogLevel::trace, event.get(), fields...);
+            }
+        }
+        template <typename... Args> requires detail::no_fields<Args...>
         void debug(std::format_string<Args...> fmt, Args&&... args) {
-            log(LogLevel::debug, std::format(fmt, std::forward<Args>(args)...));
+            if constexpr (compiled_in<LogLevel::debug>) {
+                if (!should_log(LogLevel::debug)) return;
+                write(LogLevel::debug, fmt, std::forward<Args>(args)...);
+            }
         }
-        template <typename... Args>
+        template <typename... Ts> requires (sizeof...(Ts) > 0)
+        void debug(EventName event, const Field<Ts>&... fields) {
+            if constexpr (compiled_in<LogLevel::debug>) {
+                if (!should_log(LogLevel::debug)) return;
+                write_fields(LogLevel::debug, event.get(), fields...);
+            }
+        }
+        template <typename... Args> requires detail::no_fields<Args...>
         void info(std::format_string<Args...> fmt, Args&&... args) {
-            log(LogLevel::info, std::format(fmt, std::forward<Args>(args)...));
+            if constexpr (compiled_in<LogLevel::info>) {
+                if (!should_log(LogLevel::info)) return;
+                write(LogLevel::info, fmt, std::forward<Args>(args)...);
+            }
         }
-        template <typename... Args>
+        template <typename... Ts> requires (sizeof...(Ts) > 0)
+        void info(EventName event, const Field<Ts>&... fields) {
+            if constexpr (compiled_in<LogLevel::info>) {
+                if (!should_log(LogLevel::info)) return;
+                write_fields(LogLevel::info, event.get(), fields...);
+            }
+        }
+        template <typename... Args> requires detail::no_fields<Args...>
         void warn(std::format_string<Args...> fmt, Args&&... args) {
-            log(LogLevel::warn, std::format(fmt, std::forward<Args>(args)...));
+            if constexpr (compiled_in<LogLevel::warn>) {
+                if (!should_log(LogLevel::warn)) return;
+                write(LogLevel::warn, fmt, std::forward<Args>(args)...);
+            }
         }
-        template <typename... Args>
+        template <typename... Ts> requires (sizeof...(Ts) > 0)
+        void warn(EventName event, const Field<Ts>&... fields) {
+            if constexpr (compiled_in<LogLevel::warn>) {
+                if (!should_log(LogLevel::warn)) return;
+                write_fields(LogLevel::warn, event.get(), fields...);
+            }
+        }
+        template <typename... Args> requires detail::no_fields<Args...>
         void error(std::format_string<Args...> fmt, Args&&... args) {
-            log(LogLevel::error, std::format(fmt, std::forward<Args>(args)...));
+            if constexpr (compiled_in<LogLevel::error>) {
+                if (!should_log(LogLevel::error)) return;
+                write(LogLevel::error, fmt, std::forward<Args>(args)...);
+            }
         }
-        template <typename... Args>
+        template <typename... Ts> requires (sizeof...(Ts) > 0)
+        void error(EventName event, const Field<Ts>&... fields) {
+            if constexpr (compiled_in<LogLevel::error>) {
+                if (!should_log(LogLevel::error)) return;
+                write_fields(LogLevel::error, event.get(), fields...);
+            }
+        }
+        template <typename... Args> requires detail::no_fields<Args...>
         void critical(std::format_string<Args...> fmt, Args&&... args) {
-            log(LogLevel::critical, std::format(fmt, std::forward<Args>(args)...));
+            if constexpr (compiled_in<LogLevel::critical>) {
+                if (!should_log(LogLevel::critical)) return;
+                write(LogLevel::critical, fmt, std::forward<Args>(args)...);
+            }
+        }
+        template <typename... Ts> requires (sizeof...(Ts) > 0)
+        void critical(EventName event, const Field<Ts>&... fields) {
+            if constexpr (compiled_in<LogLevel::critical>) {
+                if (!should_log(LogLevel::critical)) return;
+                write_fields(LogLevel::critical, event.get(), fields...);
+            }
         }
 
         // Set this logger's level
@@ -67,12 +255,96 @@ namespace aknet::log {
         // Get this logger's level
         LogLevel get_level();
 
+        // Limit how often each call site of this logger reaches the sinks (lock-free on the calling side).
+        //   log::get("stream")->set_rate_limit({.messages_per_second = 5, .burst = 20});
+        // Counts of calls suppressed since a site's last admitted call are reported just before its next one,
+        // and by flush(). Passing RateLimitConfig{} removes the limit.
+        void set_rate_limit(const RateLimitConfig& config);
+
         // Flush buffered output
         void flush();
 
+        // Whether a message at this level would currently be emitted or recorded (cheap, lock-free)
+        bool should_log(LogLevel lvl) const noexcept {
+            return lvl >= level_.load(std::memory_order_relaxed) || lvl >= record_level_;
+        }
+
     private:
+        template <typename... Args>
+        void write(LogLevel lvl, std::format_string<Args...> fmt, Args&&... args) {
+            route(lvl, fmt.get(),
+                  [&](detail::Record& rec) { detail::capture<Args...>(rec, fmt, args...); },
+                  [&] { return std::format(fmt, std::forward<Args>(args)...); });
+        }
+
+        template <typename... Ts>
+        void write_fields(LogLevel lvl, std::string_view event, const Field<Ts>&... fields) {
+            route(lvl, event,
+                  [&](detail::Record& rec) { detail::capture_fields(rec, event, fields...); },
+                  [&] {
+                      std::string msg;
+                      detail::format_fields(event, msg, fields...);
+                      return msg;
+                  });
+        }
+
+        // Send a call to the flight recorder and the sinks. `site` identifies the call site (format string or
+        // event name); capture fills a record for the recorder and the async mode, format renders the message
+        // for the synchronous sinks.
+        template <typename Capture, typename Format>
+        void route(LogLevel lvl, std::string_view site, Capture&& capture, Format&& format) {
+            if (lvl >= record_level_) {
+                if (detail::Record* rec = detail::acquire_flight_record(impl_.get(), lvl)) {
+                    capture(*rec);
+                    detail::publish_flight_record();
+                }
+            }
+            if (lvl < level_.load(std::memory_order_relaxed)) return;
+
+            if (detail::RateLimiter* limiter = limiter_.load(std::memory_order_acquire)) {
+                std::uint64_t suppressed = 0;
+                if (!detail::admit_call(limiter, site, lvl, suppressed)) return;
+                if (suppressed != 0) report_suppressed(lvl, site, suppressed);
+            }
+            deliver(lvl, capture, format);
+        }
+
+        // Send a call to the sinks
+        template <typename Capture, typename Format>
+        void deliver(LogLevel lvl, Capture& capture, Format& format) {
+            if (async_) {
+                // Copy the call into the ring slot; formatting happens on the backend
+                if (detail::Record* rec = detail::acquire_record(impl_.get(), lvl)) {
+                    capture(*rec);
+                    detail::publish_record();
+                }
+                return;
+            }
+            log(lvl, format());
+        }
+
+        template <typename... Args>
+        void emit(LogLevel lvl, std::format_string<Args...> fmt, Args&&... args) {
+            auto capture = [&](detail::Record& rec) { detail::capture<Args...>(rec, fmt, args...); };
+            auto format = [&] { return std::format(fmt, std::forward<Args>(args)...); };
+            deliver(lvl, capture, format);
+        }
+
         void log(LogLevel lvl, std::string_view msg);
+        void report_suppressed(LogLevel lvl, std::string_view format, std::uint64_t count);
         std::shared_ptr<LoggerImpl> impl_;
+
+        // Cached copy of the spdlog level, kept in sync by set_level() and set_global_log_level()
+        std::atomic<LogLevel> level_{LogLevel::off};
+
+        // Whether records go through the async backend (fixed for the lifetime of the logger)
+        bool async_ = false;
+
+        // Lowest level kept by the flight recorder, off when it is disabled (fixed for the lifetime of the logger)
+        LogLevel record_level_ = LogLevel::off;
+
+        // Current rate limiter, nullptr when unlimited (owned by impl_, which keeps replaced ones alive)
+        std::atomic<detail::RateLimiter*> limiter_{nullptr};
     };
 
     // -------------------------------------------------------------------------
@@ -80,7 +352,7 @@ namespace aknet::log {
     // -------------------------------------------------------------------------
 
     // Initialize the logging system (call once at app startup)
-    void init(std::filesystem::path log_dir = {});
+    void init(std::filesystem::path log_dir = {}, const LogConfig& config = {});
 
     // Shutdown the logging system (call once at app shutdown)
     void shutdown();
@@ -91,9 +363,51 @@ namespace aknet::log {
     // Get initialization state of the logging system
     bool is_initialized();
 
-    // Create or retrieve a named logger (each module calls this)
-    std::shared_ptr<Logger> get(const std::string& name);
+    // Allocate the calling thread's ring ahead of time (async mode). Call it from real-time threads
+    // during setup so that their first log call does not allocate.
+    void preallocate_thread_buffer();
+
+    // Number of records discarded by the async overflow policy since init()
+    std::uint64_t dropped_messages();
+
+    // Number of batches the batched file sink could not write in full (disk full...) since init(). Their
+    // lines are lost, and left out of the time index.
+    std::uint64_t failed_file_writes();
+
+    // Write the flight recorder's content to a new .aklog file in the log directory and return its path.
+    // Returns an empty path if the flight recorder is disabled or the file cannot be written.
+    std::filesystem::path dump_flight_recorder();
+
+    // Create or retrieve a named logger (each module calls this).
+    // Retrieving an existing logger is lock-free; creating one takes the registry lock. Safe to call while
+    // another thread runs shutdown(): it then returns the logger or throws as if not initialized.
+    std::shared_ptr<Logger> get(std::string_view name);
 
 } // namespace aknet::log
 
+// -------------------------------------------------------------------------
+// Logging macros: same as the Logger methods, but below the compile-time floor neither the
+// logger nor the arguments are evaluated. Prefer them when arguments are costly to compute.
+//   AKNET_LOG_DEBUG(logger_, "queue depth {}", queue.compute_depth());
+// -------------------------------------------------------------------------
+#define AKNET_LOG_IF(floor, lvl, method, logger, ...)                                 \
+    do {                                                                             \
+        if constexpr (::aknet::log::compiled_in<lvl, floor>) {                       \
+            if ((logger)->should_log(lvl)) (logger)->method(__VA_ARGS__);            \
+        }                                                                            \
+    } while (false)
+
+#define AKNET_LOG_TRACE(logger, ...) \
+    AKNET_LOG_IF(::aknet::log::min_log_level, ::aknet::log::LogLevel::trace, trace, logger, __VA_ARGS__)
+#define AKNET_LOG_DEBUG(logger, ...) \
+    AKNET_LOG_IF(::aknet::log::min_log_level, ::aknet::log::LogLevel::debug, debug, logger, __VA_ARGS__)
+#define AKNET_LOG_INFO(logger, ...) \
+    AKNET_LOG_IF(::aknet::log::min_log_level, ::aknet::log::LogLevel::info, info, logger, __VA_ARGS__)
+#define AKNET_LOG_WARN(logger, ...) \
+    AKNET_LOG_IF(::aknet::log::min_log_level, ::aknet::log::LogLevel::warn, warn, logger, __VA_ARGS__)
+#define AKNET_LOG_ERROR(logger, ...) \
+    AKNET_LOG_IF(::aknet::log::min_log_level, ::aknet::log::LogLevel::error, error, logger, __VA_ARGS__)
+#define AKNET_LOG_CRITICAL(logger, ...) \
+    AKNET_LOG_IF(::aknet::log::min_log_level, ::aknet::log::LogLevel::critical, critical, logger, __VA_ARGS__)
+
 #endif // AKNET_LOGGER_H
\ No newline at end of file
@@ -0,0 +1,254 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "async_backend.h"
+#include "logger_impl.h"
+#include "record_clock.h"
+
+#include <bit>
+
+namespace aknet::log::detail {
+
+    // -------------------------------------------------------------------------
+    // ThreadRing
+    // -------------------------------------------------------------------------
+    ThreadRing::ThreadRing(std::size_t capacity, OverflowPolicy overflow)
+        : slots_(std::make_unique<Record[]>(std::bit_ceil(std::max<std::size_t>(capacity, 2)))),
+          sequences_(std::make_unique<std::atomic<std::uint64_t>[]>(std::bit_ceil(std::max<std::size_t>(capacity, 2)))),
+          mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+          overflow_(overflow) {
+        for (std::size_t i = 0; i <= mask_; i++) sequences_[i].store(i, std::memory_order_relaxed);
+    }
+
+    Record* ThreadRing::try_acquire() noexcept {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+
+            if (tail - cached_head_ > mask_) {
+                if (overflow_ == OverflowPolicy::drop) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                // Reclaim the oldest slot: it was never read, so it is ours. If the CAS fails the consumer
+                // claimed it, and the slot is free once its copy is done.
+                auto head = cached_head_;
+                const bool reclaimed = head_.compare_exchange_strong(head, head + 1, std::memory_order_acq_rel);
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (reclaimed) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return &slots_[tail & mask_];
+                }
+            }
+        }
+
+        // The consumer may still be copying the record this slot held a lap ago
+        if (sequences_[tail & mask_].load(std::memory_order_acquire) != tail) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &slots_[tail & mask_];
+    }
+
+    void ThreadRing::publish() noexcept {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool ThreadRing::try_pop(Record& out) noexcept {
+        auto head = head_.load(std::memory_order_acquire);
+        for (;;) {
+            if (head == tail_.load(std::memory_order_acquire)) return false;
+
+            // Claim the record before reading it; on failure the producer reclaimed it and head now holds
+            // the new oldest index
+            if (head_.compare_exchange_strong(head, head + 1, std::memory_order_acq_rel)) break;
+        }
+        out = slots_[head & mask_];
+        sequences_[head & mask_].store(head + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // -------------------------------------------------------------------------
+    // Producer entry points
+    // -------------------------------------------------------------------------
+    namespace {
+        // The installed backend. Producers take a reference under g_backend_mutex (once per thread and init()),
+        // so shutdown() cannot delete it while they register a ring or drain it.
+        std::mutex g_backend_mutex;
+        std::shared_ptr<AsyncBackend> g_backend;
+        std::atomic<std::uint64_t> g_generation{0};
+
+        std::shared_ptr<AsyncBackend> current_backend() {
+            std::lock_guard lock(g_backend_mutex);
+            return g_backend;
+        }
+
+        // Per-thread handle on the ring, marks it retired when the thread exits
+        struct RingHandle {
+            std::shared_ptr<ThreadRing> ring;
+            std::uint64_t generation = 0;
+
+            ~RingHandle() {
+                if (ring) ring->retire();
+            }
+        };
+
+        thread_local RingHandle t_ring;
+
+        ThreadRing* thread_ring() noexcept {
+            const auto generation = g_generation.load(std::memory_order_acquire);
+            if (t_ring.ring && t_ring.generation == generation) return t_ring.ring.get();
+
+            // First record of this thread (or first since a new init()): register a ring
+            if (t_ring.ring) t_ring.ring->retire();
+            try {
+                const auto backend = current_backend();
+                if (!backend) {
+                    t_ring.ring.reset();
+                    return nullptr;
+                }
+                t_ring.ring = backend->register_ring();
+            } catch (...) {
+                t_ring.ring.reset();
+                return nullptr;
+            }
+            t_ring.generation = generation;
+            return t_ring.ring.get();
+        }
+    }
+
+    Record* acquire_record(LoggerImpl* logger, LogLevel lvl) noexcept {
+        ThreadRing* ring = thread_ring();
+        if (!ring) return nullptr;
+
+        Record* rec = ring->try_acquire();
+        if (!rec) return nullptr;
+
+        rec->logger = logger;
+        rec->level = lvl;
+        rec->timestamp = record_timestamp();
+        rec->length = 0;
+        return rec;
+    }
+
+    void publish_record() noexcept {
+        t_ring.ring->publish();
+    }
+
+    void set_async_backend(std::shared_ptr<AsyncBackend> backend) {
+        std::lock_guard lock(g_backend_mutex);
+        g_backend = std::move(backend);
+        g_generation.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    void prepare_thread_ring() noexcept {
+        thread_ring();
+    }
+
+    void drain_async_backend() {
+        if (const auto backend = current_backend()) backend->drain();
+    }
+
+    // -------------------------------------------------------------------------
+    // AsyncBackend
+    // -------------------------------------------------------------------------
+    AsyncBackend::AsyncBackend(const AsyncConfig& config) : config_(config) {}
+
+    AsyncBackend::~AsyncBackend() {
+        stop();
+    }
+
+    void AsyncBackend::start() {
+        if (thread_.joinable()) return;
+        stop_requested_ = false;
+        thread_ = std::thread([this] { run(); });
+    }
+
+    void AsyncBackend::stop() {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard lock(wake_mutex_);
+                stop_requested_ = true;
+            }
+            wake_.notify_one();
+            thread_.join();
+        }
+        drain();
+    }
+
+    std::shared_ptr<ThreadRing> AsyncBackend::register_ring() {
+        auto ring = std::make_shared<ThreadRing>(config_.ring_capacity, config_.overflow);
+        std::lock_guard lock(rings_mutex_);
+        rings_.push_back(ring);
+        return ring;
+    }
+
+    void AsyncBackend::add_record_sink(std::unique_ptr<RecordSink> sink) {
+        std::lock_guard lock(consume_mutex_);
+        record_sinks_.push_back(std::move(sink));
+    }
+
+    void AsyncBackend::drain() {
+        std::lock_guard lock(consume_mutex_);
+        drain_locked();
+        flush_record_sinks();
+    }
+
+    void AsyncBackend::flush_record_sinks() {
+        for (const auto& sink : record_sinks_) sink->flush();
+    }
+
+    std::uint64_t AsyncBackend::dropped() const {
+        std::lock_guard lock(rings_mutex_);
+        std::uint64_t total = retired_dropped_;
+        for (const auto& ring : rings_) total += ring->dropped();
+        return total;
+    }
+
+    void AsyncBackend::run() {
+        std::unique_lock lock(wake_mutex_);
+        while (!stop_requested_) {
+            wake_.wait_for(lock, config_.poll_interval, [this] { return stop_requested_; });
+            lock.unlock();
+            {
+                // Record sinks buffer their writes; they are flushed by flush() and stop()
+                std::lock_guard consume_lock(consume_mutex_);
+                drain_locked();
+            }
+            lock.lock();
+        }
+    }
+
+    void AsyncBackend::drain_locked() {
+        // Snapshot the ring list so producers registering now are not blocked by sink I/O
+        {
+            std::lock_guard lock(rings_mutex_);
+            drain_list_.assign(rings_.begin(), rings_.end());
+        }
+
+        Record rec;
+        for (const auto& ring : drain_list_) {
+            while (ring->try_pop(rec)) {
+                if (rec.logger->has_sinks()) {
+                    const auto time = spdlog::log_clock::time_point(
+                        std::chrono::duration_cast<spdlog::log_clock::duration>(std::chrono::nanoseconds(record_time_ns(rec.timestamp))));
+                    rec.logger->log(time, rec.level, render(rec, format_buffer_));
+                }
+                for (const auto& sink : record_sinks_) sink->write(rec);
+            }
+        }
+        drain_list_.clear();
+
+        // Free the rings of exited threads once they are fully drained
+        std::lock_guard lock(rings_mutex_);
+        std::erase_if(rings_, [this](const std::shared_ptr<ThreadRing>& ring) {
+            if (!ring->retired() || !ring->empty()) return false;
+            retired_dropped_ += ring->dropped();
+            return true;
+        });
+    }
+
+} // namespace aknet::log::detail
@@ -0,0 +1,128 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_ASYNC_BACKEND_H
+#define AKNET_ASYNC_BACKEND_H
+
+#pragma once
+
+#include "logger.h"
+#include "record_sink.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aknet::log::detail {
+
+    // -------------------------------------------------------------------------
+    // ThreadRing: single-producer / single-consumer ring of fixed-size records.
+    // The producer is the owning thread, the consumer is whoever holds the backend's
+    // consume mutex (the backend thread, or a thread calling flush()).
+    // The consumer claims the oldest record with a compare-and-swap on the head, then copies it; each
+    // slot's sequence number tells the producer when that copy is done and the slot may be written again.
+    // Under overwrite_oldest the producer reclaims the oldest record with the same compare-and-swap, so a
+    // record is either read or overwritten, never both; in the rare case the consumer is still copying the
+    // slot the producer needs, the new record is dropped instead.
+    // -------------------------------------------------------------------------
+    class ThreadRing {
+    public:
+        ThreadRing(std::size_t capacity, OverflowPolicy overflow);
+
+        // Producer side (owning thread only)
+        Record* try_acquire() noexcept;
+        void publish() noexcept;
+
+        // Consumer side: copies the oldest record out
+        bool try_pop(Record& out) noexcept;
+
+        std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+        // Set when the owning thread exits; the backend frees the ring once it is empty
+        void retire() noexcept { retired_.store(true, std::memory_order_release); }
+        bool retired() const noexcept { return retired_.load(std::memory_order_acquire); }
+        bool empty() const noexcept {
+            return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::unique_ptr<Record[]> slots_;
+        // Per slot: the index the producer may write into it next, once the consumer has copied it out
+        std::unique_ptr<std::atomic<std::uint64_t>[]> sequences_;
+        const std::size_t mask_;
+        const OverflowPolicy overflow_;
+
+        alignas(64) std::atomic<std::uint64_t> head_{0}; // next record to read
+        alignas(64) std::atomic<std::uint64_t> tail_{0}; // next slot to write
+        std::uint64_t cached_head_ = 0;                   // producer-only copy of head_
+        std::atomic<std::uint64_t> dropped_{0};
+        std::atomic<bool> retired_{false};
+    };
+
+    // -------------------------------------------------------------------------
+    // AsyncBackend: owns the rings of all producer threads and the thread draining them
+    // -------------------------------------------------------------------------
+    class AsyncBackend {
+    public:
+        explicit AsyncBackend(const AsyncConfig& config);
+        ~AsyncBackend();
+
+        AsyncBackend(const AsyncBackend&) = delete;
+        AsyncBackend& operator=(const AsyncBackend&) = delete;
+
+        // Start/stop the backend thread. stop() drains everything that was published.
+        void start();
+        void stop();
+
+        // Create the ring of a new producer thread (allocates, takes the registration lock)
+        std::shared_ptr<ThreadRing> register_ring();
+
+        // Also hand every raw record to this sink (call before start())
+        void add_record_sink(std::unique_ptr<RecordSink> sink);
+
+        // Consume every published record now and flush the record sinks (used by flush())
+        void drain();
+
+        std::uint64_t dropped() const;
+
+    private:
+        void run();
+        void drain_locked();
+        void flush_record_sinks();
+
+        const AsyncConfig config_;
+
+        mutable std::mutex rings_mutex_;
+        std::vector<std::shared_ptr<ThreadRing>> rings_;
+        std::uint64_t retired_dropped_ = 0; // drop counts of rings already freed
+
+        std::mutex consume_mutex_;
+        std::vector<std::shared_ptr<ThreadRing>> drain_list_; // reused by drain_locked()
+        std::string format_buffer_;                           // reused for deferred formatting
+        std::vector<std::unique_ptr<RecordSink>> record_sinks_;
+
+        std::mutex wake_mutex_;
+        std::condition_variable wake_;
+        bool stop_requested_ = false;
+        std::thread thread_;
+    };
+
+    // Install/remove the backend producers write to (called by init() and shutdown()). A producer registering
+    // or draining at that moment keeps the previous backend alive until it is done.
+    void set_async_backend(std::shared_ptr<AsyncBackend> backend);
+
+    // Drain the current backend, if any
+    void drain_async_backend();
+
+    // Register the calling thread's ring now instead of on its first record
+    void prepare_thread_ring() noexcept;
+
+} // namespace aknet::log::detail
+
+#endif // AKNET_ASYNC_BACKEND_H
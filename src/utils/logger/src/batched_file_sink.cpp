@@ -0,0 +1,268 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "batched_file_sink.h"
+#include "log_files.h"
+
+#include <spdlog/pattern_formatter.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace aknet::log::detail {
+
+    namespace {
+        constexpr std::size_t max_iovecs = 64;
+
+        // Write every byte of the iovecs, resuming after partial writes. Returns the bytes written: fewer
+        // than asked if the disk is full or the file closed, in which case the rest is lost.
+        std::size_t write_all(int fd, iovec* iov, std::size_t count) noexcept {
+            std::size_t written = 0;
+            while (count > 0) {
+                const auto n = ::writev(fd, iov, static_cast<int>(count));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) break;
+
+                auto done = static_cast<std::size_t>(n);
+                written += done;
+                while (count > 0 && done >= iov->iov_len) {
+                    done -= iov->iov_len;
+                    iov++;
+                    count--;
+                }
+                if (count > 0) {
+                    iov->iov_base = static_cast<char*>(iov->iov_base) + done;
+                    iov->iov_len -= done;
+                }
+            }
+            return written;
+        }
+    }
+
+    BatchedFileSink::BatchedFileSink(std::filesystem::path path, const FileSinkConfig& config,
+                                     std::shared_ptr<LogArchiver> archiver)
+        : path_(std::move(path)), config_(config), archiver_(std::move(archiver)),
+          formatter_(std::make_unique<spdlog::pattern_formatter>()), index_(config.index_block_size) {
+        // Chunk vectors never grow past the back-pressure bound, so reserve it once
+        const std::size_t max_chunks = max_pending_batches * (config_.batch_size / chunk_capacity + 1) + 1;
+        pending_.reserve(max_chunks);
+        free_.reserve(max_chunks);
+        writing_.reserve(max_chunks);
+
+        open_file(false);
+        if (fd_ < 0) throw std::runtime_error("Cannot open log file: " + path_.string());
+
+        thread_ = std::thread([this] { run(); });
+    }
+
+    BatchedFileSink::~BatchedFileSink() {
+        {
+            std::lock_guard lock(buffer_mutex_);
+            stop_requested_ = true;
+        }
+        batch_ready_.notify_one();
+        space_available_.notify_all();
+        thread_.join();
+
+        write_pending();
+        close_file();
+    }
+
+    void BatchedFileSink::log(const spdlog::details::log_msg& msg) {
+        std::unique_lock lock(buffer_mutex_);
+        formatted_.clear();
+        formatter_->format(msg, formatted_);
+
+        // Back-pressure: only when the writer is far behind the callers
+        const std::size_t max_pending = max_pending_batches * std::max(config_.batch_size, chunk_capacity);
+        space_available_.wait(lock, [&] { return pending_bytes_ < max_pending || stop_requested_; });
+
+        append(formatted_.data(), formatted_.size());
+        if (config_.index) {
+            const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch()).count();
+            pending_index_.add(timestamp, static_cast<LogLevel>(msg.level), logger_bit({msg.logger_name.data(), msg.logger_name.size()}), formatted_.size());
+        }
+        if (pending_bytes_ >= config_.batch_size) batch_ready_.notify_one();
+    }
+
+    void BatchedFileSink::flush() {
+        write_pending();
+    }
+
+    void BatchedFileSink::set_pattern(const std::string& pattern) {
+        std::lock_guard lock(buffer_mutex_);
+        formatter_ = std::make_unique<spdlog::pattern_formatter>(pattern);
+    }
+
+    void BatchedFileSink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) {
+        std::lock_guard lock(buffer_mutex_);
+        formatter_ = std::move(sink_formatter);
+    }
+
+    void BatchedFileSink::append(const char* data, std::size_t size) {
+        pending_bytes_ += size;
+        while (size > 0) {
+            if (pending_.empty() || pending_.back().size == chunk_capacity) {
+                if (free_.empty()) {
+                    pending_.emplace_back();
+                } else {
+                    pending_.push_back(std::move(free_.back()));
+                    free_.pop_back();
+                }
+            }
+            Chunk& chunk = pending_.back();
+            const auto n = std::min(size, chunk_capacity - chunk.size);
+            std::memcpy(chunk.data.get() + chunk.size, data, n);
+            chunk.size += n;
+            data += n;
+            size -= n;
+        }
+    }
+
+    unsigned BatchedFileSink::logger_bit(std::string_view name) {
+        // Lines mostly come from the same logger as the previous one
+        if (last_logger_ < logger_names_.size() && logger_names_[last_logger_] == name) return static_cast<unsigned>(last_logger_);
+
+        const auto it = std::ranges::find(logger_names_, name);
+        last_logger_ = static_cast<std::size_t>(it - logger_names_.begin());
+        if (it == logger_names_.end()) logger_names_.emplace_back(name);
+        return static_cast<unsigned>(last_logger_);
+    }
+
+    void BatchedFileSink::run() {
+        std::unique_lock lock(buffer_mutex_);
+        while (!stop_requested_) {
+            batch_ready_.wait_for(lock, config_.max_latency, [this] {
+                return stop_requested_ || pending_bytes_ >= config_.batch_size;
+            });
+            if (pending_bytes_ == 0) continue;
+
+            lock.unlock();
+            write_pending();
+            lock.lock();
+        }
+    }
+
+    void BatchedFileSink::write_pending() {
+        std::lock_guard io_lock(io_mutex_);
+
+        std::size_t bytes = 0;
+        index::Block batch;
+        std::size_t logger_count = 0;
+        {
+            std::lock_guard lock(buffer_mutex_);
+            writing_.swap(pending_);
+            bytes = std::exchange(pending_bytes_, 0);
+            batch = std::exchange(pending_index_, {});
+            logger_count = logger_names_.size();
+        }
+        space_available_.notify_all();
+        if (bytes == 0) return;
+
+        write_chunks(bytes, batch, logger_count);
+
+        std::lock_guard lock(buffer_mutex_);
+        for (auto& chunk : writing_) {
+            chunk.size = 0;
+            free_.push_back(std::move(chunk));
+        }
+        writing_.clear();
+    }
+
+    void BatchedFileSink::write_chunks(std::size_t bytes, const index::Block& batch, std::size_t logger_count) {
+        // Rotate between batches, like spdlog rotates between lines. The index moves with its file.
+        if (file_size_ > 0 && file_size_ + bytes > config_.max_file_size) {
+            close_file();
+            if (archiver_) {
+                archiver_->rotate(path_);
+            } else {
+                rotate_files(path_, config_.max_files);
+                if (config_.index) rotate_files(path_, config_.max_files, index::file_extension);
+            }
+            open_file(true);
+        }
+        if (fd_ < 0) {
+            failed_batches_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Name new loggers in the index before the block that refers to them
+        if (config_.index && index_.logger_count() < logger_count) {
+            std::lock_guard lock(buffer_mutex_);
+            for (std::size_t i = index_.logger_count(); i < logger_count; i++) index_.add_logger(logger_names_[i]);
+        }
+
+        std::array<iovec, max_iovecs> iov{};
+        std::size_t written = 0;
+        for (std::size_t first = 0; first < writing_.size(); first += max_iovecs) {
+            const auto count = std::min(max_iovecs, writing_.size() - first);
+            std::size_t size = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                iov[i].iov_base = writing_[first + i].data.get();
+                iov[i].iov_len = writing_[first + i].size;
+                size += iov[i].iov_len;
+            }
+            const auto n = write_all(fd_, iov.data(), count);
+            written += n;
+            if (n < size) break;
+        }
+
+        // A batch that did not make it whole is lost, logging carries on. Only whole batches are indexed,
+        // and the file size stays what is on disk, for rotation and the next batch's offset.
+        if (written == bytes) {
+            index_.add(batch, file_size_);
+        } else {
+            failed_batches_.fetch_add(1, std::memory_order_relaxed);
+        }
+        file_size_ += written;
+    }
+
+    void BatchedFileSink::open_file(bool truncate) {
+        fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+        if (fd_ < 0) return;
+
+        struct stat st{};
+        file_size_ = ::fstat(fd_, &st) == 0 ? static_cast<std::size_t>(st.st_size) : 0;
+        if (config_.preallocate) preallocate();
+        if (config_.index) (void)index_.open(index::index_path(path_));
+    }
+
+    void BatchedFileSink::close_file() noexcept {
+        if (fd_ < 0) return;
+        index_.close();
+
+        // Give back the preallocated blocks past the end of the data
+        struct stat st{};
+        if (config_.preallocate && ::fstat(fd_, &st) == 0) (void)::ftruncate(fd_, st.st_size);
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    void BatchedFileSink::preallocate() noexcept {
+        if (file_size_ >= config_.max_file_size) return;
+        const auto length = static_cast<off_t>(config_.max_file_size - file_size_);
+
+        // Reserve the blocks without changing the file size, so readers never see unwritten bytes.
+        // Best effort: file systems without support simply allocate on write.
+#if defined(__linux__)
+        (void)::fallocate(fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(file_size_), length);
+#elif defined(__APPLE__)
+        fstore_t store{F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, length, 0};
+        if (::fcntl(fd_, F_PREALLOCATE, &store) == -1) {
+            store.fst_flags = F_ALLOCATEALL;
+            (void)::fcntl(fd_, F_PREALLOCATE, &store);
+        }
+#endif
+    }
+
+} // namespace aknet::log::detail
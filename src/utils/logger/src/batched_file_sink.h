@@ -0,0 +1,107 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_BATCHED_FILE_SINK_H
+#define AKNET_BATCHED_FILE_SINK_H
+
+#pragma once
+
+#include "index_writer.h"
+#include "log_archiver.h"
+#include "logger.h"
+
+#include <spdlog/sinks/sink.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aknet::log::detail {
+
+    // -------------------------------------------------------------------------
+    // BatchedFileSink: rotating text file sink that batches lines in memory.
+    // Callers format and copy their line into the pending chunks; a writer thread writes the chunks with
+    // one writev per batch, once batch_size bytes are pending or max_latency has passed. Rotation and
+    // preallocation happen on the writer side, so callers never wait on the disk (unless the writer
+    // falls more than max_pending_batches behind, in which case they wait for it).
+    // Files are named and rotated like spdlog's rotating_file_sink, or handed to the archiver if there is one.
+    // Each file gets a sparse time index (.akidx) built from the batches as they are written.
+    // -------------------------------------------------------------------------
+    class BatchedFileSink final : public spdlog::sinks::sink {
+    public:
+        static constexpr std::size_t chunk_capacity = 16 * 1024;
+        static constexpr std::size_t max_pending_batches = 16;
+
+        BatchedFileSink(std::filesystem::path path, const FileSinkConfig& config,
+                        std::shared_ptr<LogArchiver> archiver = nullptr);
+        ~BatchedFileSink() override;
+
+        BatchedFileSink(const BatchedFileSink&) = delete;
+        BatchedFileSink& operator=(const BatchedFileSink&) = delete;
+
+        void log(const spdlog::details::log_msg& msg) override;
+
+        // Write everything pending now (blocks until it is written)
+        void flush() override;
+
+        void set_pattern(const std::string& pattern) override;
+        void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+        // Batches not written in full (disk full, file too large...): their lines are lost
+        std::uint64_t failed_batches() const noexcept { return failed_batches_.load(std::memory_order_relaxed); }
+
+    private:
+        struct Chunk {
+            std::unique_ptr<char[]> data = std::make_unique<char[]>(chunk_capacity);
+            std::size_t size = 0;
+        };
+
+        void append(const char* data, std::size_t size);
+        unsigned logger_bit(std::string_view name);
+        void run();
+        void write_pending();
+        void write_chunks(std::size_t bytes, const index::Block& batch, std::size_t logger_count);
+        void open_file(bool truncate);
+        void close_file() noexcept;
+        void preallocate() noexcept;
+
+        const std::filesystem::path path_;
+        const FileSinkConfig config_;
+        const std::shared_ptr<LogArchiver> archiver_;
+
+        // Callers' side (buffer_mutex_)
+        std::mutex buffer_mutex_;
+        std::unique_ptr<spdlog::formatter> formatter_;
+        spdlog::memory_buf_t formatted_;
+        std::vector<Chunk> pending_;
+        std::vector<Chunk> free_;
+        std::size_t pending_bytes_ = 0;
+        std::condition_variable batch_ready_;
+        std::condition_variable space_available_;
+        bool stop_requested_ = false;
+        index::Block pending_index_;             // lines of the pending chunks
+        std::vector<std::string> logger_names_;  // index logger bit (modulo 64) -> name
+        std::size_t last_logger_ = 0;            // logger_names_ slot of the previous line
+
+        // Writer's side (io_mutex_, always taken before buffer_mutex_)
+        std::mutex io_mutex_;
+        std::vector<Chunk> writing_;
+        IndexWriter index_;
+        int fd_ = -1;
+        std::size_t file_size_ = 0;
+        std::atomic<std::uint64_t> failed_batches_{0};
+
+        std::thread thread_;
+    };
+
+} // namespace aknet::log::detail
+
+#endif // AKNET_BATCHED_FILE_SINK_H
@@ -0,0 +1,352 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "binary_log.h"
+#include "log_archive.h"
+
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <format>
+#include <iterator>
+#include <stdexcept>
+#include <variant>
+
+namespace aknet::log::binary {
+
+    namespace {
+
+        using detail::ArgType;
+
+        // Bounds-checked reads from an entry body
+        class Cursor {
+        public:
+            explicit Cursor(std::string_view data) : data_(data) {}
+
+            template <typename T>
+            T read() {
+                T value;
+                std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+                return value;
+            }
+
+            std::string_view take(std::size_t n) {
+                if (n > data_.size() - pos_) throw std::runtime_error("Corrupted binary log entry");
+                const auto out = data_.substr(pos_, n);
+                pos_ += n;
+                return out;
+            }
+
+            std::string_view rest() {
+                return take(data_.size() - pos_);
+            }
+
+        private:
+            std::string_view data_;
+            std::size_t pos_ = 0;
+        };
+
+        // Decoded argument; integers are widened, which std::format renders identically
+        using Value = std::variant<std::int64_t, std::uint64_t, float, double, bool, char, std::string_view, const void*>;
+
+        Value decode_value(ArgType type, Cursor& cursor) {
+            switch (type) {
+                case ArgType::i8: return static_cast<std::int64_t>(cursor.read<std::int8_t>());
+                case ArgType::u8: return static_cast<std::uint64_t>(cursor.read<std::uint8_t>());
+                case ArgType::i16: return static_cast<std::int64_t>(cursor.read<std::int16_t>());
+                case ArgType::u16: return static_cast<std::uint64_t>(cursor.read<std::uint16_t>());
+                case ArgType::i32: return static_cast<std::int64_t>(cursor.read<std::int32_t>());
+                case ArgType::u32: return static_cast<std::uint64_t>(cursor.read<std::uint32_t>());
+                case ArgType::i64: return cursor.read<std::int64_t>();
+                case ArgType::u64: return cursor.read<std::uint64_t>();
+                case ArgType::f32: return cursor.read<float>();
+                case ArgType::f64: return cursor.read<double>();
+                case ArgType::boolean: return cursor.read<bool>();
+                case ArgType::character: return cursor.read<char>();
+                case ArgType::string: return cursor.take(cursor.read<std::uint16_t>());
+                case ArgType::pointer: return cursor.read<const void*>();
+                default: throw std::runtime_error("Binary log argument type cannot be decoded");
+            }
+        }
+
+        std::size_t parse_index(std::string_view id, std::size_t& next_auto) {
+            if (id.empty()) return next_auto++;
+            std::size_t index = 0;
+            const auto [ptr, ec] = std::from_chars(id.data(), id.data() + id.size(), index);
+            if (ec != std::errc{} || ptr != id.data() + id.size()) throw std::format_error("invalid argument id");
+            return index;
+        }
+
+        // Replace nested "{}" / "{n}" fields of a format spec by the integer arguments they refer to
+        std::string resolve_spec(std::string_view spec, const std::vector<Value>& values, std::size_t& next_auto) {
+            std::string resolved;
+            for (std::size_t i = 0; i < spec.size(); i++) {
+                if (spec[i] != '{') {
+                    resolved += spec[i];
+                    continue;
+                }
+                const auto close = spec.find('}', i);
+                if (close == std::string_view::npos) throw std::format_error("unterminated nested field");
+                const auto index = parse_index(spec.substr(i + 1, close - i - 1), next_auto);
+                if (index >= values.size()) throw std::format_error("argument index out of range");
+                std::visit([&]<typename T>(const T& v) {
+                    if constexpr (std::is_same_v<T, std::int64_t> || std::is_same_v<T, std::uint64_t>) {
+                        resolved += std::to_string(v);
+                    } else {
+                        throw std::format_error("width or precision argument is not an integer");
+                    }
+                }, values[index]);
+                i = close;
+            }
+            return resolved;
+        }
+
+        void format_field(std::string_view field, const std::vector<Value>& values, std::size_t& next_auto,
+                          std::string& out) {
+            const auto colon = field.find(':');
+            const auto index = parse_index(field.substr(0, colon), next_auto);
+            if (index >= values.size()) throw std::format_error("argument index out of range");
+
+            std::string single = "{:";
+            if (colon != std::string_view::npos) single += resolve_spec(field.substr(colon + 1), values, next_auto);
+            single += '}';
+
+            std::visit([&](const auto& v) {
+                std::vformat_to(std::back_inserter(out), single, std::make_format_args(v));
+            }, values[index]);
+        }
+
+        void append_value(const Value& value, std::string& out) {
+            std::visit([&](const auto& v) { std::format_to(std::back_inserter(out), "{}", v); }, value);
+        }
+
+        void append_json_string(std::string_view str, std::string& out) {
+            out += '"';
+            for (const char c : str) {
+                switch (c) {
+                    case '"': out += "\\\""; break;
+                    case '\\': out += "\\\\"; break;
+                    case '\n': out += "\\n"; break;
+                    case '\r': out += "\\r"; break;
+                    case '\t': out += "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            std::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned>(c));
+                        } else {
+                            out += c;
+                        }
+                }
+            }
+            out += '"';
+        }
+
+        void append_json_value(const DecodedField& field, std::string& out) {
+            switch (field.type) {
+                case ArgType::i8: case ArgType::u8: case ArgType::i16: case ArgType::u16:
+                case ArgType::i32: case ArgType::u32: case ArgType::i64: case ArgType::u64:
+                case ArgType::boolean:
+                    out += field.value;
+                    return;
+                case ArgType::f32: case ArgType::f64:
+                    // inf and nan have no JSON spelling
+                    if (field.value.find_first_of("in") == std::string::npos) out += field.value;
+                    else out += "null";
+                    return;
+                default:
+                    append_json_string(field.value, out);
+            }
+        }
+
+        // Fields of an event record, also rendered into its message as the text sinks do
+        void decode_fields(std::string_view event, std::span<const ArgType> types, Cursor& cursor, DecodedRecord& out) {
+            out.event = event;
+            out.message = out.event;
+            for (const auto type : types) {
+                DecodedField& field = out.fields.emplace_back();
+                field.key = cursor.take(cursor.read<std::uint8_t>());
+                field.type = type;
+                append_value(decode_value(type, cursor), field.value);
+
+                out.message += ' ';
+                out.message += field.key;
+                out.message += '=';
+                if (type == ArgType::string) detail::append_field_text(out.message, field.value);
+                else out.message += field.value;
+            }
+        }
+
+        // "YYYY-MM-DD HH:MM:SS.mmm", local time
+        std::string format_time(std::int64_t timestamp_ns) {
+            constexpr std::int64_t ns_per_s = 1'000'000'000;
+            auto seconds = timestamp_ns / ns_per_s;
+            auto ns = timestamp_ns % ns_per_s;
+            if (ns < 0) {
+                ns += ns_per_s;
+                seconds--;
+            }
+
+            const auto t = static_cast<std::time_t>(seconds);
+            std::tm tm{};
+            localtime_r(&t, &tm);
+            char date[32];
+            std::strftime(date, sizeof date, "%Y-%m-%d %H:%M:%S", &tm);
+            return std::format("{}.{:03}", date, ns / 1'000'000);
+        }
+
+        std::string_view level_name(LogLevel lvl) {
+            switch (lvl) {
+                case LogLevel::trace: return "trace";
+                case LogLevel::debug: return "debug";
+                case LogLevel::info: return "info";
+                case LogLevel::warn: return "warning";
+                case LogLevel::error: return "error";
+                case LogLevel::critical: return "critical";
+                case LogLevel::off: return "off";
+            }
+            return "info";
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Formatting
+    // -------------------------------------------------------------------------
+    void format_packed(std::string_view fmt, std::span<const ArgType> types, std::string_view payload,
+                       std::string& out) {
+        Cursor cursor(payload);
+        std::vector<Value> values;
+        values.reserve(types.size());
+        for (const auto type : types) values.push_back(decode_value(type, cursor));
+
+        std::size_t next_auto = 0;
+        for (std::size_t i = 0; i < fmt.size(); i++) {
+            const char c = fmt[i];
+            if ((c == '{' || c == '}') && i + 1 < fmt.size() && fmt[i + 1] == c) {
+                out += c; // escaped brace
+                i++;
+                continue;
+            }
+            if (c != '{') {
+                out += c;
+                continue;
+            }
+
+            // Find the matching '}', allowing one level of nested fields in the spec
+            std::size_t end = i + 1;
+            for (int depth = 1; end < fmt.size(); end++) {
+                if (fmt[end] == '{') depth++;
+                else if (fmt[end] == '}' && --depth == 0) break;
+            }
+            const auto field = fmt.substr(i + 1, end - i - 1);
+            try {
+                format_field(field, values, next_auto, out);
+            } catch (const std::format_error&) {
+                out += fmt.substr(i, end - i + 1); // keep the raw field rather than losing the record
+            }
+            i = end;
+        }
+    }
+
+    std::string format_text_line(const DecodedRecord& record) {
+        const std::string_view name = std::string_view(record.logger).substr(0, 10);
+        return std::format("{} [{:>10}] [{:>8}] {}", format_time(record.timestamp_ns), name, level_name(record.level),
+                           record.message);
+    }
+
+    std::string format_json_line(const DecodedRecord& record) {
+        std::string out = "{\"time\":\"" + format_time(record.timestamp_ns) + "\"";
+        std::format_to(std::back_inserter(out), ",\"time_ns\":{},\"logger\":", record.timestamp_ns);
+        append_json_string(record.logger, out);
+        std::format_to(std::back_inserter(out), ",\"level\":\"{}\",\"msg\":", level_name(record.level));
+        append_json_string(record.fields.empty() && record.event.empty() ? record.message : record.event, out);
+        for (const auto& field : record.fields) {
+            out += ',';
+            append_json_string(field.key, out);
+            out += ':';
+            append_json_value(field, out);
+        }
+        out += '}';
+        return out;
+    }
+
+    // -------------------------------------------------------------------------
+    // Reader
+    // -------------------------------------------------------------------------
+    Reader::Reader(const std::filesystem::path& path) : in_(archive::open(path)) {
+
+        std::array<char, file_magic.size()> magic{};
+        std::uint32_t version = 0;
+        in_->read(magic.data(), magic.size());
+        in_->read(reinterpret_cast<char*>(&version), sizeof version);
+        if (!*in_ || magic != file_magic) throw std::runtime_error("Not a binary log file: " + path.string());
+        if (version != file_version) {
+            throw std::runtime_error("Unsupported binary log version " + std::to_string(version));
+        }
+    }
+
+    bool Reader::next(DecodedRecord& out) {
+        for (;;) {
+            EntryKind kind;
+            std::uint32_t size = 0;
+            in_->read(reinterpret_cast<char*>(&kind), sizeof kind);
+            in_->read(reinterpret_cast<char*>(&size), sizeof size);
+            if (!*in_) return false;
+
+            body_.resize(size);
+            in_->read(body_.data(), size);
+            if (!*in_) return false; // truncated last entry (e.g. the process crashed mid-write)
+
+            Cursor cursor(body_);
+            switch (kind) {
+                case EntryKind::logger: {
+                    const auto id = cursor.read<std::uint32_t>();
+                    loggers_[id] = std::string(cursor.take(cursor.read<std::uint16_t>()));
+                    break;
+                }
+                case EntryKind::format: {
+                    const auto id = cursor.read<std::uint32_t>();
+                    Format format;
+                    format.format = std::string(cursor.take(cursor.read<std::uint16_t>()));
+                    const auto count = cursor.read<std::uint8_t>();
+                    for (int i = 0; i < count; i++) format.types.push_back(cursor.read<ArgType>());
+                    formats_[id] = std::move(format);
+                    break;
+                }
+                case EntryKind::record:
+                case EntryKind::text:
+                case EntryKind::event: {
+                    out.timestamp_ns = cursor.read<std::int64_t>();
+                    const auto logger_id = cursor.read<std::uint32_t>();
+                    out.level = static_cast<LogLevel>(cursor.read<std::uint8_t>());
+
+                    const auto logger = loggers_.find(logger_id);
+                    out.logger = logger != loggers_.end() ? logger->second : "?";
+
+                    out.message.clear();
+                    out.event.clear();
+                    out.fields.clear();
+                    if (kind == EntryKind::text) {
+                        out.message = cursor.rest();
+                        return true;
+                    }
+
+                    const auto format_id = cursor.read<std::uint32_t>();
+                    const auto format = formats_.find(format_id);
+                    if (format == formats_.end()) {
+                        out.message = std::format("<unknown format {}>", format_id);
+                        return true;
+                    }
+                    if (kind == EntryKind::event) {
+                        decode_fields(format->second.format, format->second.types, cursor, out);
+                    } else {
+                        format_packed(format->second.format, format->second.types, cursor.rest(), out.message);
+                    }
+                    return true;
+                }
+                default:
+                    break; // unknown entry kind, skipped
+            }
+        }
+    }
+
+} // namespace aknet::log::binary
@@ -0,0 +1,68 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "binary_sink.h"
+#include "log_files.h"
+#include "logger_impl.h"
+
+#include <stdexcept>
+
+namespace aknet::log::detail {
+
+    BinarySink::BinarySink(std::filesystem::path path, std::size_t max_file_size, std::size_t max_files,
+                           std::shared_ptr<LogArchiver> archiver)
+        : path_(std::move(path)), max_file_size_(max_file_size), max_files_(max_files), archiver_(std::move(archiver)) {
+        open_file();
+    }
+
+    BinarySink::~BinarySink() = default;
+
+    void BinarySink::write(const Record& rec) {
+        if (writer_.size() >= max_file_size_) rotate();
+
+        ensure_logger(*rec.logger);
+
+        if (rec.args && rec.args->portable) {
+            writer_.write_record(rec, format_id(rec));
+        } else {
+            writer_.write_text(rec, render(rec, text_));
+        }
+    }
+
+    void BinarySink::flush() {
+        writer_.flush();
+    }
+
+    void BinarySink::open_file() {
+        if (!writer_.open(path_.c_str())) throw std::runtime_error("Cannot open binary log file: " + path_.string());
+
+        known_loggers_.clear();
+        formats_.clear();
+    }
+
+    void BinarySink::rotate() {
+        writer_.close();
+        if (archiver_) {
+            archiver_->rotate(path_);
+        } else {
+            rotate_files(path_, max_files_);
+        }
+        open_file();
+    }
+
+    std::uint32_t BinarySink::format_id(const Record& rec) {
+        const FormatKey key{rec.format.data(), rec.args};
+        if (const auto it = formats_.find(key); it != formats_.end()) return it->second;
+
+        const auto id = static_cast<std::uint32_t>(formats_.size());
+        formats_.emplace(key, id);
+        writer_.write_format(id, rec);
+        return id;
+    }
+
+    void BinarySink::ensure_logger(const LoggerImpl& logger) {
+        if (known_loggers_.insert(logger.id()).second) writer_.write_logger(logger.id(), logger.name());
+    }
+
+} // namespace aknet::log::detail
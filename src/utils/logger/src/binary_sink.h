@@ -0,0 +1,73 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_BINARY_SINK_H
+#define AKNET_BINARY_SINK_H
+
+#pragma once
+
+#include "binary_writer.h"
+#include "log_archiver.h"
+#include "record_sink.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace aknet::log::detail {
+
+    // -------------------------------------------------------------------------
+    // BinarySink: writes raw records to a .aklog file (format in binary_log.h).
+    // Records keep their packed arguments; only arguments of user types are rendered to text.
+    // Rotates like the text sink: base.aklog, base.1.aklog, ... base.<max_files>.aklog, or through the archiver
+    // -------------------------------------------------------------------------
+    class BinarySink final : public RecordSink {
+    public:
+        BinarySink(std::filesystem::path path, std::size_t max_file_size, std::size_t max_files,
+                   std::shared_ptr<LogArchiver> archiver = nullptr);
+        ~BinarySink() override;
+
+        BinarySink(const BinarySink&) = delete;
+        BinarySink& operator=(const BinarySink&) = delete;
+
+        void write(const Record& rec) override;
+        void flush() override;
+
+    private:
+        struct FormatKey {
+            const char* format;
+            const ArgList* args;
+            bool operator==(const FormatKey&) const = default;
+        };
+
+        struct FormatKeyHash {
+            std::size_t operator()(const FormatKey& key) const noexcept {
+                return std::hash<const void*>{}(key.format) ^ (std::hash<const void*>{}(key.args) << 1);
+            }
+        };
+
+        void open_file();
+        void rotate();
+        std::uint32_t format_id(const Record& rec);
+        void ensure_logger(const LoggerImpl& logger);
+
+        const std::filesystem::path path_;
+        const std::size_t max_file_size_;
+        const std::size_t max_files_;
+        const std::shared_ptr<LogArchiver> archiver_;
+
+        BinaryWriter writer_;
+
+        // Per-file dictionaries: cleared on rotation so every file is self-contained
+        std::unordered_set<std::uint32_t> known_loggers_;
+        std::unordered_map<FormatKey, std::uint32_t, FormatKeyHash> formats_;
+
+        std::string text_; // scratch for records rendered to text
+    };
+
+} // namespace aknet::log::detail
+
+#endif // AKNET_BINARY_SINK_H
@@ -0,0 +1,122 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "binary_writer.h"
+#include "logger_impl.h"
+#include "record_clock.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace aknet::log::detail {
+
+    namespace {
+        // timestamp (i64) | logger id (u32) | level (u8)
+        constexpr std::size_t record_header_size = sizeof(std::int64_t) + sizeof(std::uint32_t) + 1;
+    }
+
+    BinaryWriter::BinaryWriter(std::size_t buffer_size)
+        : buffer_(std::make_unique<char[]>(buffer_size)), capacity_(buffer_size) {}
+
+    BinaryWriter::~BinaryWriter() {
+        close();
+    }
+
+    bool BinaryWriter::open(const char* path) noexcept {
+        close();
+        fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) return false;
+
+        size_ = 0;
+        put_bytes(binary::file_magic.data(), binary::file_magic.size());
+        put(binary::file_version);
+        return true;
+    }
+
+    void BinaryWriter::close() noexcept {
+        if (fd_ < 0) return;
+        flush();
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    void BinaryWriter::begin_entry(binary::EntryKind kind, std::size_t body_size) noexcept {
+        put(kind);
+        put(static_cast<std::uint32_t>(body_size));
+    }
+
+    void BinaryWriter::put_bytes(const void* data, std::size_t size) noexcept {
+        const auto* bytes = static_cast<const char*>(data);
+        size_ += size;
+        while (size > 0) {
+            if (used_ == capacity_) flush();
+            const auto n = std::min(size, capacity_ - used_);
+            std::memcpy(buffer_.get() + used_, bytes, n);
+            used_ += n;
+            bytes += n;
+            size -= n;
+        }
+    }
+
+    void BinaryWriter::put_string(std::string_view str) noexcept {
+        const auto n = static_cast<std::uint16_t>(std::min<std::size_t>(str.size(), UINT16_MAX));
+        put(n);
+        put_bytes(str.data(), n);
+    }
+
+    void BinaryWriter::flush() noexcept {
+        std::size_t done = 0;
+        while (fd_ >= 0 && done < used_) {
+            const auto n = ::write(fd_, buffer_.get() + done, used_ - done);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break; // disk full or closed: the buffered bytes are lost, logging carries on
+            done += static_cast<std::size_t>(n);
+        }
+        used_ = 0;
+    }
+
+    void BinaryWriter::write_logger(std::uint32_t id, std::string_view name) noexcept {
+        begin_entry(binary::EntryKind::logger, sizeof id + string_size(name));
+        put(id);
+        put_string(name);
+    }
+
+    void BinaryWriter::write_format(std::uint32_t id, const Record& rec) noexcept {
+        begin_entry(binary::EntryKind::format, sizeof id + string_size(rec.format) + 1 + rec.args->count);
+        put(id);
+        put_string(rec.format);
+        put(rec.args->count);
+        put_bytes(rec.args->types, rec.args->count);
+    }
+
+    void BinaryWriter::put_record_header(const Record& rec) noexcept {
+        put(record_time_ns(rec.timestamp));
+        put(rec.logger->id());
+        put(static_cast<std::uint8_t>(rec.level));
+    }
+
+    void BinaryWriter::write_record(const Record& rec, std::uint32_t format_id) noexcept {
+        const auto kind = rec.args->fields ? binary::EntryKind::event : binary::EntryKind::record;
+        begin_entry(kind, record_header_size + sizeof format_id + rec.length);
+        put_record_header(rec);
+        put(format_id);
+        put_bytes(rec.payload, rec.length);
+    }
+
+    void BinaryWriter::write_text(const Record& rec, std::string_view message) noexcept {
+        begin_entry(binary::EntryKind::text, record_header_size + message.size());
+        put_record_header(rec);
+        put_bytes(message.data(), message.size());
+    }
+
+    std::size_t BinaryWriter::string_size(std::string_view str) noexcept {
+        return sizeof(std::uint16_t) + std::min<std::size_t>(str.size(), UINT16_MAX);
+    }
+
+} // namespace aknet::log::detail
@@ -0,0 +1,73 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_BINARY_WRITER_H
+#define AKNET_BINARY_WRITER_H
+
+#pragma once
+
+#include "binary_log.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace aknet::log::detail {
+
+    // -------------------------------------------------------------------------
+    // BinaryWriter: buffered writer of .aklog files (format in binary_log.h).
+    // Only uses open/write/close on a buffer allocated up front, so it can run in a signal handler.
+    // Entries are written as a header (kind + body size) followed by the body pieces,
+    // so callers compute the body size before writing it.
+    // -------------------------------------------------------------------------
+    class BinaryWriter {
+    public:
+        explicit BinaryWriter(std::size_t buffer_size = 64 * 1024);
+        ~BinaryWriter();
+
+        BinaryWriter(const BinaryWriter&) = delete;
+        BinaryWriter& operator=(const BinaryWriter&) = delete;
+
+        // Create (truncate) the file and write the file header. Returns false if it cannot be opened.
+        bool open(const char* path) noexcept;
+        void close() noexcept;
+        bool is_open() const noexcept { return fd_ >= 0; }
+
+        void begin_entry(binary::EntryKind kind, std::size_t body_size) noexcept;
+
+        template <typename T>
+        void put(const T& value) noexcept {
+            put_bytes(&value, sizeof value);
+        }
+        void put_bytes(const void* data, std::size_t size) noexcept;
+        void put_string(std::string_view str) noexcept; // u16 length + bytes, truncated
+
+        void flush() noexcept;
+
+        // Typed entries (bodies as described in binary_log.h)
+        void write_logger(std::uint32_t id, std::string_view name) noexcept;
+        void write_format(std::uint32_t id, const Record& rec) noexcept;
+        void write_record(const Record& rec, std::uint32_t format_id) noexcept; // packed arguments or fields
+        void write_text(const Record& rec, std::string_view message) noexcept;
+
+        // Bytes written to the current file, including buffered ones
+        std::size_t size() const noexcept { return size_; }
+
+        // Body size taken by put_string(str)
+        static std::size_t string_size(std::string_view str) noexcept;
+
+    private:
+        void put_record_header(const Record& rec) noexcept;
+
+        std::unique_ptr<char[]> buffer_;
+        const std::size_t capacity_;
+        std::size_t used_ = 0;
+        std::size_t size_ = 0;
+        int fd_ = -1;
+    };
+
+} // namespace aknet::log::detail
+
+#endif // AKNET_BINARY_WRITER_H
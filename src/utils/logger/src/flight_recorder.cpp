@@ -0,0 +1,338 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "flight_recorder.h"
+#include "logger_impl.h"
+#include "record_clock.h"
+
+#include <bit>
+#include <charconv>
+#include <csignal>
+#include <cstring>
+
+namespace aknet::log::detail {
+
+    namespace {
+        constexpr std::size_t max_dumped_loggers = 256;
+        constexpr std::size_t format_table_size = 4096; // power of two
+    }
+
+    // -------------------------------------------------------------------------
+    // FlightRing
+    // -------------------------------------------------------------------------
+    FlightRing::FlightRing(std::size_t capacity, bool signal_stack)
+        : slots_(std::make_unique<Record[]>(std::bit_ceil(std::max<std::size_t>(capacity, 2)))),
+          mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+          signal_stack_(signal_stack ? std::make_unique<std::byte[]>(signal_stack_size) : nullptr) {}
+
+    Record* FlightRing::acquire() noexcept {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+
+        // Announce the overwrite before touching the slot, so a concurrent dump can tell its copy is torn
+        writing_.store(tail + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return &slots_[tail & mask_];
+    }
+
+    void FlightRing::publish() noexcept {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    std::uint64_t FlightRing::begin() const noexcept {
+        const auto writing = writing_.load(std::memory_order_acquire);
+        return writing > mask_ + 1 ? writing - (mask_ + 1) : 0;
+    }
+
+    bool FlightRing::still_valid(std::uint64_t index) const noexcept {
+        // The slot of `index` is reused by index + capacity, announced as writing_ == index + capacity + 1
+        return writing_.load(std::memory_order_relaxed) - index <= mask_ + 1;
+    }
+
+    bool FlightRing::read(std::uint64_t index, Record& out) const noexcept {
+        if (!still_valid(index)) return false;
+        std::memcpy(static_cast<void*>(&out), &slots_[index & mask_], sizeof(Record));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return still_valid(index);
+    }
+
+    bool FlightRing::try_claim() noexcept {
+        bool expected = false;
+        return owned_.compare_exchange_strong(expected, true, std::memory_order_acq_rel);
+    }
+
+    // -------------------------------------------------------------------------
+    // FlightRecorder
+    // -------------------------------------------------------------------------
+    FlightRecorder::FlightRecorder(const FlightRecorderConfig& config, const std::filesystem::path& log_path)
+        : prefix_((log_path.parent_path() / log_path.stem()).string() + "_flight_"),
+          cursors_(std::make_unique<Cursor[]>(config.max_threads)),
+          formats_(std::make_unique<FormatSlot[]>(format_table_size)) {
+        rings_.reserve(config.max_threads);
+        for (std::size_t i = 0; i < config.max_threads; i++) {
+            rings_.push_back(std::make_shared<FlightRing>(config.records_per_thread, config.dump_on_crash));
+        }
+        seen_loggers_.reserve(max_dumped_loggers);
+    }
+
+    std::shared_ptr<FlightRing> FlightRecorder::claim_ring() noexcept {
+        for (const auto& ring : rings_) {
+            if (ring->try_claim()) return ring;
+        }
+        return nullptr;
+    }
+
+    bool FlightRecorder::dump(bool in_signal_handler, PathBuffer& path) noexcept {
+        if (dumping_.test_and_set(std::memory_order_acquire)) return false;
+
+        const bool opened = make_path(path) && writer_.open(path.data());
+        if (opened) {
+            seen_loggers_.clear();
+            std::fill_n(formats_.get(), format_table_size, FormatSlot{});
+            format_count_ = 0;
+
+            // Records published after this point are not part of the dump
+            const std::size_t count = rings_.size();
+            for (std::size_t i = 0; i < count; i++) {
+                cursors_[i].ring = rings_[i].get();
+                cursors_[i].next = 0;
+                cursors_[i].end = rings_[i]->end();
+                advance(cursors_[i]);
+            }
+
+            // Merge the rings by timestamp
+            for (;;) {
+                Cursor* oldest = nullptr;
+                for (std::size_t i = 0; i < count; i++) {
+                    Cursor& cursor = cursors_[i];
+                    if (cursor.loaded && (!oldest || cursor.rec.timestamp < oldest->rec.timestamp)) {
+                        oldest = &cursor;
+                    }
+                }
+                if (!oldest) break;
+                write_record(oldest->rec, in_signal_handler);
+                advance(*oldest);
+            }
+            writer_.close();
+        }
+
+        dumping_.clear(std::memory_order_release);
+        return opened;
+    }
+
+    bool FlightRecorder::advance(Cursor& cursor) noexcept {
+        while (cursor.next < cursor.end) {
+            // Skip what the owning thread overwrote since the last read
+            const auto index = std::max(cursor.next, cursor.ring->begin());
+            if (index >= cursor.end) break;
+            cursor.next = index + 1;
+            if (cursor.ring->read(index, cursor.rec)) return cursor.loaded = true;
+        }
+        return cursor.loaded = false;
+    }
+
+    void FlightRecorder::write_record(const Record& rec, bool in_signal_handler) noexcept {
+        ensure_logger(*rec.logger);
+
+        if (!rec.args) {
+            writer_.write_text(rec, {rec.payload, rec.length});
+        } else if (rec.args->portable) {
+            writer_.write_record(rec, format_id(rec));
+        } else if (in_signal_handler) {
+            writer_.write_text(rec, rec.format);
+        } else {
+            try {
+                writer_.write_text(rec, render(rec, text_));
+            } catch (...) {
+                writer_.write_text(rec, rec.format);
+            }
+        }
+    }
+
+    void FlightRecorder::ensure_logger(const LoggerImpl& logger) noexcept {
+        const auto id = logger.id();
+        if (std::find(seen_loggers_.begin(), seen_loggers_.end(), id) != seen_loggers_.end()) return;
+
+        // Past the reserved capacity the entry is simply written again, to stay allocation free
+        if (seen_loggers_.size() < max_dumped_loggers) seen_loggers_.push_back(id);
+        writer_.write_logger(id, logger.name());
+    }
+
+    std::uint32_t FlightRecorder::format_id(const Record& rec) noexcept {
+        const char* format = rec.format.data();
+        const auto hash = (reinterpret_cast<std::uintptr_t>(format) ^ reinterpret_cast<std::uintptr_t>(rec.args)) *
+                          std::uintptr_t{0x9E3779B97F4A7C15ull};
+
+        for (std::size_t probe = 0; probe < format_table_size; probe++) {
+            FormatSlot& slot = formats_[(hash + probe) & (format_table_size - 1)];
+            if (slot.format == format && slot.args == rec.args) return slot.id;
+            if (!slot.format) {
+                slot = {format, rec.args, format_count_};
+                break;
+            }
+        }
+
+        // New format (or a full table: the format is then described again under a new id)
+        writer_.write_format(format_count_, rec);
+        return format_count_++;
+    }
+
+    bool FlightRecorder::make_path(PathBuffer& path) noexcept {
+        const auto n = dump_count_.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (prefix_.size() >= path.size()) return false;
+
+        char* out = std::copy(prefix_.begin(), prefix_.end(), path.data());
+        char* const last = path.data() + path.size() - 1;
+        const auto [end, ec] = std::to_chars(out, last, n);
+        if (ec != std::errc{}) return false;
+        out = end;
+
+        const std::string_view extension = binary::file_extension;
+        if (static_cast<std::size_t>(last - out) < extension.size()) return false;
+        out = std::copy(extension.begin(), extension.end(), out);
+        *out = '\0';
+        return true;
+    }
+
+    // -------------------------------------------------------------------------
+    // Producer entry points
+    // -------------------------------------------------------------------------
+    namespace {
+        std::atomic<FlightRecorder*> g_recorder{nullptr};
+        std::atomic<std::uint64_t> g_generation{0};
+
+        // Use `stack` as the calling thread's alternate signal stack, unless it has one already (its own, or
+        // a sanitizer's). Returns whether it was installed.
+        bool use_signal_stack(std::byte* stack, std::size_t size) noexcept {
+            stack_t current{};
+            if (!stack || sigaltstack(nullptr, &current) != 0 || !(current.ss_flags & SS_DISABLE)) return false;
+            stack_t alternate{};
+            alternate.ss_sp = stack;
+            alternate.ss_size = size;
+            return sigaltstack(&alternate, nullptr) == 0;
+        }
+
+        void drop_signal_stack() noexcept {
+            stack_t disabled{};
+            disabled.ss_flags = SS_DISABLE;
+            sigaltstack(&disabled, nullptr);
+        }
+
+        // Per-thread handle on the ring, gives it back (with its signal stack) when the thread exits
+        struct FlightHandle {
+            std::shared_ptr<FlightRing> ring;
+            std::uint64_t generation = 0;
+            bool signal_stack = false; // the ring's signal stack is this thread's
+
+            void reset() noexcept {
+                if (!ring) return;
+                if (signal_stack) drop_signal_stack();
+                signal_stack = false;
+                ring->release();
+                ring.reset();
+            }
+
+            ~FlightHandle() { reset(); }
+        };
+
+        thread_local FlightHandle t_flight;
+
+        FlightRing* flight_ring() noexcept {
+            const auto generation = g_generation.load(std::memory_order_acquire);
+            if (t_flight.generation == generation) return t_flight.ring.get(); // null: no ring left for this thread
+
+            // First record of this thread since init(): claim a ring from the pool
+            t_flight.reset();
+            t_flight.generation = generation;
+            if (FlightRecorder* recorder = g_recorder.load(std::memory_order_acquire)) {
+                t_flight.ring = recorder->claim_ring();
+                if (t_flight.ring) {
+                    t_flight.signal_stack = use_signal_stack(t_flight.ring->signal_stack(), FlightRing::signal_stack_size);
+                }
+            }
+            return t_flight.ring.get();
+        }
+    }
+
+    Record* acquire_flight_record(LoggerImpl* logger, LogLevel lvl) noexcept {
+        FlightRing* ring = flight_ring();
+        if (!ring) return nullptr;
+
+        Record* rec = ring->acquire();
+        rec->logger = logger;
+        rec->level = lvl;
+        rec->timestamp = record_timestamp();
+        rec->length = 0;
+        return rec;
+    }
+
+    void publish_flight_record() noexcept {
+        t_flight.ring->publish();
+    }
+
+    void set_flight_recorder(FlightRecorder* recorder) noexcept {
+        g_recorder.store(recorder, std::memory_order_release);
+        g_generation.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // -------------------------------------------------------------------------
+    // Crash handlers
+    // -------------------------------------------------------------------------
+    namespace {
+        constexpr std::array fatal_signals = {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT};
+
+        std::array<struct sigaction, fatal_signals.size()> g_previous_actions{};
+        bool g_handlers_installed = false;
+        FlightRecorder::PathBuffer g_crash_dump_path{};
+
+        // Alternate signal stack of the thread that installs the handlers (the main thread, usually).
+        // Static: it stays valid for as long as that thread may use it.
+        alignas(16) std::byte g_installer_signal_stack[FlightRing::signal_stack_size];
+        bool g_installer_signal_stack_used = false;
+
+        void restore_handler(int sig) noexcept {
+            for (std::size_t i = 0; i < fatal_signals.size(); i++) {
+                if (fatal_signals[i] == sig) sigaction(sig, &g_previous_actions[i], nullptr);
+            }
+        }
+
+        void on_fatal_signal(int sig) {
+            if (FlightRecorder* recorder = g_recorder.load(std::memory_order_acquire)) {
+                recorder->dump(true, g_crash_dump_path);
+            }
+
+            // Let the previous handler (or the default action) deal with the signal once we return
+            restore_handler(sig);
+            raise(sig);
+        }
+    }
+
+    void install_crash_handlers() noexcept {
+        if (g_handlers_installed) return;
+
+        // Handlers run on an alternate stack, so that a stack overflow still gets its dump. Threads with
+        // a flight ring use the ring's; this thread uses a static one.
+        if (!g_installer_signal_stack_used) {
+            g_installer_signal_stack_used = use_signal_stack(g_installer_signal_stack, sizeof g_installer_signal_stack);
+        }
+
+        struct sigaction action{};
+        action.sa_handler = on_fatal_signal;
+        action.sa_flags = SA_ONSTACK | SA_RESETHAND;
+        sigemptyset(&action.sa_mask);
+        for (std::size_t i = 0; i < fatal_signals.size(); i++) {
+            sigaction(fatal_signals[i], &action, &g_previous_actions[i]);
+        }
+        g_handlers_installed = true;
+    }
+
+    void remove_crash_handlers() noexcept {
+        if (!g_handlers_installed) return;
+
+        for (std::size_t i = 0; i < fatal_signals.size(); i++) {
+            sigaction(fatal_signals[i], &g_previous_actions[i], nullptr);
+        }
+        g_handlers_installed = false;
+    }
+
+} // namespace aknet::log::detail
@@ -0,0 +1,133 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_FLIGHT_RECORDER_H
+#define AKNET_FLIGHT_RECORDER_H
+
+#pragma once
+
+#include "logger.h"
+#include "binary_writer.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace aknet::log::detail {
+
+    // -------------------------------------------------------------------------
+    // FlightRing: one thread's recent records. The owning thread overwrites the oldest record
+    // when full; dumps read it concurrently and skip the records overwritten while they were copied.
+    // With crash dumps on, it also carries the owner's alternate signal stack, so that the crash handler
+    // still runs when the thread overflowed its own stack.
+    // -------------------------------------------------------------------------
+    class FlightRing {
+    public:
+        static constexpr std::size_t signal_stack_size = 64 * 1024;
+
+        explicit FlightRing(std::size_t capacity, bool signal_stack = false);
+
+        // Producer side (owning thread only)
+        Record* acquire() noexcept;
+        void publish() noexcept;
+
+        // Reader side: records in [begin(), end()) may be read; read() fails if the record was overwritten
+        std::uint64_t begin() const noexcept;
+        std::uint64_t end() const noexcept { return tail_.load(std::memory_order_acquire); }
+        bool read(std::uint64_t index, Record& out) const noexcept;
+
+        // A ring belongs to one thread at a time. Released rings keep their records until the next owner
+        // overwrites them, so the last records of an exited thread still show up in dumps.
+        bool try_claim() noexcept;
+        void release() noexcept { owned_.store(false, std::memory_order_release); }
+
+        // signal_stack_size bytes, or nullptr
+        std::byte* signal_stack() const noexcept { return signal_stack_.get(); }
+
+    private:
+        bool still_valid(std::uint64_t index) const noexcept;
+
+        std::unique_ptr<Record[]> slots_;
+        const std::size_t mask_;
+        std::unique_ptr<std::byte[]> signal_stack_;
+
+        alignas(64) std::atomic<std::uint64_t> tail_{0};    // records published
+        std::atomic<std::uint64_t> writing_{0};             // index + 1 of the record being written
+        std::atomic<bool> owned_{false};
+    };
+
+    // -------------------------------------------------------------------------
+    // FlightRecorder: fixed pool of rings and the dump writer.
+    // Everything a dump needs is allocated in the constructor so a dump can run in a signal handler.
+    // -------------------------------------------------------------------------
+    class FlightRecorder {
+    public:
+        static constexpr std::size_t path_capacity = 1024;
+        using PathBuffer = std::array<char, path_capacity>;
+
+        // Dumps are written to <dir>/<stem>_flight_<n>.aklog, from the session log path
+        FlightRecorder(const FlightRecorderConfig& config, const std::filesystem::path& log_path);
+
+        FlightRecorder(const FlightRecorder&) = delete;
+        FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+        // Hand a free ring to the calling thread (no allocation). nullptr when max_threads rings are taken.
+        std::shared_ptr<FlightRing> claim_ring() noexcept;
+
+        // Write every ring's records, merged in timestamp order, to a new dump file whose path is stored
+        // in `path`. Returns false if another dump is running or the file cannot be created.
+        // In a signal handler, records holding user types are written with their format string only,
+        // since rendering them would call arbitrary formatters.
+        bool dump(bool in_signal_handler, PathBuffer& path) noexcept;
+
+    private:
+        struct Cursor {
+            FlightRing* ring = nullptr;
+            std::uint64_t next = 0;
+            std::uint64_t end = 0;
+            bool loaded = false;
+            Record rec;
+        };
+
+        struct FormatSlot {
+            const char* format = nullptr;
+            const ArgList* args = nullptr;
+            std::uint32_t id = 0;
+        };
+
+        bool advance(Cursor& cursor) noexcept;
+        void write_record(const Record& rec, bool in_signal_handler) noexcept;
+        void ensure_logger(const LoggerImpl& logger) noexcept;
+        std::uint32_t format_id(const Record& rec) noexcept;
+        bool make_path(PathBuffer& path) noexcept;
+
+        std::vector<std::shared_ptr<FlightRing>> rings_;
+
+        // Dump state, owned by whoever holds dumping_
+        std::atomic_flag dumping_;
+        std::atomic<std::uint32_t> dump_count_{0};
+        std::string prefix_; // "<dir>/<stem>_flight_"
+        BinaryWriter writer_;
+        std::unique_ptr<Cursor[]> cursors_;
+        std::vector<std::uint32_t> seen_loggers_;      // fixed capacity, reserved up front
+        std::unique_ptr<FormatSlot[]> formats_;        // open addressing on the format pointer
+        std::uint32_t format_count_ = 0;
+        std::string text_;                             // scratch for user types (not in signal handlers)
+    };
+
+    // Install/remove the recorder producers write to (called by init() and shutdown())
+    void set_flight_recorder(FlightRecorder* recorder) noexcept;
+
+    // Fatal signal handlers dumping the current recorder, then chaining to the previous handlers
+    void install_crash_handlers() noexcept;
+    void remove_crash_handlers() noexcept;
+
+} // namespace aknet::log::detail
+
+#endif // AKNET_FLIGHT_RECORDER_H
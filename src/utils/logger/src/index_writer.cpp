@@ -0,0 +1,103 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "index_writer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace aknet::log::detail {
+
+    namespace {
+        template<typename T>
+        char* put(char* p, T value) noexcept {
+            std::memcpy(p, &value, sizeof value);
+            return p + sizeof value;
+        }
+
+        void write_all(int fd, const char* data, std::size_t size) noexcept {
+            while (size > 0) {
+                const auto n = ::write(fd, data, size);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return; // the index is best effort: queries fall back to scanning
+                data += n;
+                size -= static_cast<std::size_t>(n);
+            }
+        }
+    }
+
+    bool IndexWriter::open(const std::filesystem::path& path) {
+        close();
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) return false;
+
+        char header[index::file_magic.size() + sizeof index::file_version];
+        put(std::copy(index::file_magic.begin(), index::file_magic.end(), header), index::file_version);
+        write_all(fd_, header, sizeof header);
+
+        block_ = {};
+        logger_count_ = 0;
+        return true;
+    }
+
+    void IndexWriter::close() noexcept {
+        if (fd_ < 0) return;
+        write_block();
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    void IndexWriter::add_logger(std::string_view name) noexcept {
+        if (fd_ < 0) return;
+        name = name.substr(0, 1024);
+
+        char body[1 + 2 + 1024];
+        char* p = put(body, static_cast<std::uint8_t>(logger_count_++ % index::logger_bits));
+        p = put(p, static_cast<std::uint16_t>(name.size()));
+        p = std::copy(name.begin(), name.end(), p);
+        write_entry(index::EntryKind::logger, body, static_cast<std::size_t>(p - body));
+    }
+
+    void IndexWriter::add(const index::Block& batch, std::uint64_t offset) noexcept {
+        if (fd_ < 0 || batch.size == 0) return;
+
+        // Blocks cover contiguous bytes: a batch after a gap (one that failed to write) starts a new one
+        if (block_.size != 0 && offset != block_.offset + block_.size) write_block();
+        if (block_.size == 0) block_.offset = offset;
+        block_.size += batch.size;
+        block_.first_ns = std::min(block_.first_ns, batch.first_ns);
+        block_.last_ns = std::max(block_.last_ns, batch.last_ns);
+        block_.levels |= batch.levels;
+        block_.loggers |= batch.loggers;
+
+        if (block_.size >= block_size_) write_block();
+    }
+
+    void IndexWriter::write_block() noexcept {
+        if (block_.size == 0) return;
+
+        char body[8 + 4 + 8 + 8 + 1 + 8];
+        char* p = put(body, block_.offset);
+        p = put(p, block_.size);
+        p = put(p, block_.first_ns);
+        p = put(p, block_.last_ns);
+        p = put(p, block_.levels);
+        put(p, block_.loggers);
+        write_entry(index::EntryKind::block, body, sizeof body);
+        block_ = {};
+    }
+
+    void IndexWriter::write_entry(index::EntryKind kind, const char* body, std::size_t size) noexcept {
+        char entry[1 + 4 + 1 + 2 + 1024];
+        char* p = put(entry, kind);
+        p = put(p, static_cast<std::uint32_t>(size));
+        p = std::copy(body, body + size, p);
+        write_all(fd_, entry, static_cast<std::size_t>(p - entry));
+    }
+
+} // namespace aknet::log::detail
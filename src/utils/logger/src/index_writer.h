@@ -0,0 +1,57 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_INDEX_WRITER_H
+#define AKNET_INDEX_WRITER_H
+
+#pragma once
+
+#include <log_index.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace aknet::log::detail {
+
+    // -------------------------------------------------------------------------
+    // IndexWriter: writes the .akidx index of one log file (format in log_index.h).
+    // Batches written to the log file are merged into one block until it holds block_size bytes,
+    // so the index stays sparse whatever the batch sizes. Not thread-safe: used by the sink's writer.
+    // -------------------------------------------------------------------------
+    class IndexWriter {
+    public:
+        explicit IndexWriter(std::size_t block_size) : block_size_(block_size) {}
+        ~IndexWriter() { close(); }
+
+        IndexWriter(const IndexWriter&) = delete;
+        IndexWriter& operator=(const IndexWriter&) = delete;
+
+        // Start a new index (truncated). Returns false if it cannot be created.
+        bool open(const std::filesystem::path& path);
+
+        // Write the pending block and close the index
+        void close() noexcept;
+
+        // Loggers are named in the order of their bits: the next one gets bit logger_count() % logger_bits
+        std::size_t logger_count() const noexcept { return logger_count_; }
+        void add_logger(std::string_view name) noexcept;
+
+        // Account for a batch of lines (offset ignored) written at offset in the log file
+        void add(const index::Block& batch, std::uint64_t offset) noexcept;
+
+    private:
+        void write_block() noexcept;
+        void write_entry(index::EntryKind kind, const char* body, std::size_t size) noexcept;
+
+        const std::size_t block_size_;
+        int fd_ = -1;
+        index::Block block_;
+        std::size_t logger_count_ = 0;
+    };
+
+} // namespace aknet::log::detail
+
+#endif // AKNET_INDEX_WRITER_H
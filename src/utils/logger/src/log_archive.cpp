@@ -0,0 +1,263 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "log_archive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace aknet::log::archive {
+
+    namespace {
+        // Codec limits (LZ4 block format): matches are at least min_match bytes, at most max_offset back,
+        // and the last bytes of a block are always literals
+        constexpr std::size_t min_match = 4;
+        constexpr std::size_t max_offset = 65535;
+        constexpr std::size_t last_literals = 5;
+        constexpr std::size_t match_start_margin = 12;
+        constexpr int hash_bits = 14;
+
+        std::uint32_t read32(const unsigned char* p) noexcept {
+            std::uint32_t value;
+            std::memcpy(&value, p, sizeof value);
+            return value;
+        }
+
+        std::uint32_t hash(std::uint32_t sequence) noexcept {
+            return (sequence * 2654435761u) >> (32 - hash_bits);
+        }
+
+        // Length extension bytes: 255, 255, ..., remainder
+        unsigned char* put_length(unsigned char* op, std::size_t length) noexcept {
+            while (length >= 255) {
+                *op++ = 255;
+                length -= 255;
+            }
+            *op++ = static_cast<unsigned char>(length);
+            return op;
+        }
+
+        bool get_length(const unsigned char*& ip, const unsigned char* end, std::size_t& length) noexcept {
+            unsigned char byte;
+            do {
+                if (ip == end) return false;
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        }
+
+        template<typename T>
+        void write_value(std::ofstream& out, T value) {
+            out.write(reinterpret_cast<const char*>(&value), sizeof value);
+        }
+
+        template<typename T>
+        bool read_value(std::ifstream& in, T& value) {
+            return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof value));
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Block codec
+    // -------------------------------------------------------------------------
+    std::size_t compress_block(const char* src, std::size_t size, char* dst, std::size_t capacity) noexcept {
+        const auto* const in = reinterpret_cast<const unsigned char*>(src);
+        const auto* const end = in + size;
+        auto* op = reinterpret_cast<unsigned char*>(dst);
+        auto* const out_end = op + capacity;
+
+        // Sequence: token | literal length extension | literals | offset (u16) | match length extension
+        const auto emit = [&](const unsigned char* literals, std::size_t literal_count, std::size_t offset,
+                              std::size_t match_length) -> bool {
+            const std::size_t worst = 1 + literal_count / 255 + 1 + literal_count + 2 + match_length / 255 + 1;
+            if (static_cast<std::size_t>(out_end - op) < worst) return false;
+
+            const auto match_code = match_length >= min_match ? match_length - min_match : 0;
+            unsigned char* token = op++;
+            *token = static_cast<unsigned char>(std::min<std::size_t>(literal_count, 15) << 4);
+            if (literal_count >= 15) op = put_length(op, literal_count - 15);
+            std::memcpy(op, literals, literal_count);
+            op += literal_count;
+
+            if (match_length == 0) return true; // last literals
+            *op++ = static_cast<unsigned char>(offset);
+            *op++ = static_cast<unsigned char>(offset >> 8);
+            *token |= static_cast<unsigned char>(std::min<std::size_t>(match_code, 15));
+            if (match_code >= 15) op = put_length(op, match_code - 15);
+            return true;
+        };
+
+        const unsigned char* anchor = in;
+        if (size > match_start_margin) {
+            // Positions of the last occurrence of each hashed 4-byte sequence
+            std::uint32_t table[1 << hash_bits] = {};
+            const auto* const match_limit = end - match_start_margin;
+
+            const unsigned char* ip = in + 1;
+            table[hash(read32(in))] = 0;
+            while (ip < match_limit) {
+                const auto sequence = read32(ip);
+                const auto slot = hash(sequence);
+                const unsigned char* candidate = in + table[slot];
+                table[slot] = static_cast<std::uint32_t>(ip - in);
+
+                if (candidate >= ip || static_cast<std::size_t>(ip - candidate) > max_offset || read32(candidate) != sequence) {
+                    // Skip faster through data that does not compress
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
+
+                // Extend the match forward, stopping before the trailing literals
+                const unsigned char* match_end = ip + min_match;
+                const unsigned char* from = candidate + min_match;
+                while (match_end < end - last_literals && *match_end == *from) {
+                    match_end++;
+                    from++;
+                }
+
+                if (!emit(anchor, static_cast<std::size_t>(ip - anchor), static_cast<std::size_t>(ip - candidate),
+                          static_cast<std::size_t>(match_end - ip))) {
+                    return 0;
+                }
+                ip = anchor = match_end;
+            }
+        }
+
+        if (!emit(anchor, static_cast<std::size_t>(end - anchor), 0, 0)) return 0;
+        return static_cast<std::size_t>(op - reinterpret_cast<unsigned char*>(dst));
+    }
+
+    bool decompress_block(const char* src, std::size_t size, char* dst, std::size_t raw_size) noexcept {
+        const auto* ip = reinterpret_cast<const unsigned char*>(src);
+        const auto* const end = ip + size;
+        auto* const out = reinterpret_cast<unsigned char*>(dst);
+        auto* op = out;
+        auto* const out_end = out + raw_size;
+
+        while (ip < end) {
+            const unsigned char token = *ip++;
+
+            std::size_t literal_count = token >> 4;
+            if (literal_count == 15 && !get_length(ip, end, literal_count)) return false;
+            if (static_cast<std::size_t>(end - ip) < literal_count ||
+                static_cast<std::size_t>(out_end - op) < literal_count) {
+                return false;
+            }
+            std::memcpy(op, ip, literal_count);
+            ip += literal_count;
+            op += literal_count;
+            if (ip == end) break; // last literals
+
+            if (end - ip < 2) return false;
+            const std::size_t offset = ip[0] | (ip[1] << 8);
+            ip += 2;
+            if (offset == 0 || offset > static_cast<std::size_t>(op - out)) return false;
+
+            std::size_t match_length = token & 15;
+            if (match_length == 15 && !get_length(ip, end, match_length)) return false;
+            match_length += min_match;
+            if (static_cast<std::size_t>(out_end - op) < match_length) return false;
+
+            // Byte by byte: the match may overlap the bytes it produces
+            const unsigned char* from = op - offset;
+            for (std::size_t i = 0; i < match_length; i++) *op++ = *from++;
+        }
+        return op == out_end;
+    }
+
+    // -------------------------------------------------------------------------
+    // Segment files
+    // -------------------------------------------------------------------------
+    void compress_file(const std::filesystem::path& src, const std::filesystem::path& dst) {
+        std::ifstream in(src, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open log segment: " + src.string());
+
+        auto part = dst;
+        part += ".part";
+        std::ofstream out(part, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("Cannot create compressed segment: " + part.string());
+
+        out.write(file_magic.data(), file_magic.size());
+        write_value(out, file_version);
+
+        std::vector<char> raw(block_size);
+        std::vector<char> compressed(block_size);
+        while (in) {
+            in.read(raw.data(), static_cast<std::streamsize>(raw.size()));
+            const auto raw_size = static_cast<std::size_t>(in.gcount());
+            if (raw_size == 0) break;
+
+            // Stored as is unless compression saves something
+            const auto compressed_size = compress_block(raw.data(), raw_size, compressed.data(), raw_size - 1);
+            const bool stored = compressed_size == 0;
+            write_value(out, static_cast<std::uint32_t>(raw_size));
+            write_value(out, static_cast<std::uint32_t>(stored ? raw_size : compressed_size));
+            out.write(stored ? raw.data() : compressed.data(),
+                      static_cast<std::streamsize>(stored ? raw_size : compressed_size));
+        }
+
+        out.close();
+        if (!out || in.bad()) {
+            std::error_code ec;
+            std::filesystem::remove(part, ec);
+            throw std::runtime_error("Cannot write compressed segment: " + part.string());
+        }
+        std::filesystem::rename(part, dst);
+    }
+
+    // -------------------------------------------------------------------------
+    // Reader
+    // -------------------------------------------------------------------------
+    Reader::Buffer::Buffer(const std::filesystem::path& path) : in_(path, std::ios::binary) {
+        if (!in_) throw std::runtime_error("Cannot open compressed log segment: " + path.string());
+
+        std::array<char, file_magic.size()> magic{};
+        std::uint32_t version = 0;
+        in_.read(magic.data(), magic.size());
+        if (!in_ || magic != file_magic || !read_value(in_, version)) {
+            throw std::runtime_error("Not a compressed log segment: " + path.string());
+        }
+        if (version != file_version) {
+            throw std::runtime_error("Unsupported compressed log segment version " + std::to_string(version));
+        }
+    }
+
+    Reader::Buffer::int_type Reader::Buffer::underflow() {
+        if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+        std::uint32_t raw_size = 0;
+        std::uint32_t stored_size = 0;
+        if (!read_value(in_, raw_size) || !read_value(in_, stored_size)) return traits_type::eof();
+        if (raw_size == 0 || raw_size > block_size || stored_size > raw_size) throw std::runtime_error("Corrupt compressed log block");
+
+        stored_.resize(stored_size);
+        block_.resize(raw_size);
+        if (!in_.read(stored_.data(), stored_size)) return traits_type::eof(); // truncated last block
+
+        if (stored_size == raw_size) {
+            block_.swap(stored_);
+        } else if (!decompress_block(stored_.data(), stored_size, block_.data(), raw_size)) {
+            throw std::runtime_error("Corrupt compressed log block");
+        }
+
+        setg(block_.data(), block_.data(), block_.data() + raw_size);
+        return traits_type::to_int_type(*gptr());
+    }
+
+    Reader::Reader(const std::filesystem::path& path) : std::istream(nullptr), buffer_(std::make_unique<Buffer>(path)) {
+        rdbuf(buffer_.get());
+    }
+
+    std::unique_ptr<std::istream> open(const std::filesystem::path& path) {
+        if (path.extension() == file_extension) return std::make_unique<Reader>(path);
+
+        auto in = std::make_unique<std::ifstream>(path, std::ios::binary);
+        if (!*in) throw std::runtime_error("Cannot open log file: " + path.string());
+        return in;
+    }
+
+} // namespace aknet::log::archive
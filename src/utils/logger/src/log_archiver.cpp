@@ -0,0 +1,178 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "log_archiver.h"
+#include "log_files.h"
+
+#include <log_archive.h>
+#include <log_index.h>
+
+#include <algorithm>
+#include <charconv>
+#include <exception>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#if defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace aknet::log::detail {
+
+    namespace {
+        // Compression competes with nothing that matters: let the scheduler run it last
+        void lower_thread_priority() noexcept {
+#if defined(__APPLE__)
+            pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#else
+            // On Linux the nice value is per thread: this only affects the calling thread
+            (void)::setpriority(PRIO_PROCESS, 0, 19);
+#endif
+        }
+
+        // Highest segment number of the file at path already in dir: base.N.log, base.N.log.akz or
+        // base.N.log.akidx, left by an earlier session. 0 if there is none.
+        std::size_t highest_segment(const fs::path& dir, const fs::path& path) {
+            const std::string prefix = path.stem().string() + ".";
+            const std::string extension = path.extension().string();
+
+            std::size_t highest = 0;
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator(dir, ec)) {
+                const std::string name = entry.path().filename().string();
+                if (!name.starts_with(prefix)) continue;
+
+                const char* first = name.data() + prefix.size();
+                const char* last = name.data() + name.size();
+                std::size_t number = 0;
+                const auto [end, error] = std::from_chars(first, last, number);
+                if (error != std::errc{} || end == first) continue;
+
+                const std::string_view rest(end, static_cast<std::size_t>(last - end));
+                if (!rest.starts_with(extension)) continue;
+                const auto suffix = rest.substr(extension.size());
+                if (suffix.empty() || suffix == archive::file_extension || suffix == index::file_extension) {
+                    highest = std::max(highest, number);
+                }
+            }
+            return highest;
+        }
+    }
+
+    LogArchiver::LogArchiver(const ArchiveConfig& config, fs::path log_dir)
+        : config_(config), log_dir_(std::move(log_dir)), thread_([this] { run(); }) {}
+
+    LogArchiver::~LogArchiver() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_requested_ = true;
+        }
+        queued_.notify_one();
+        thread_.join();
+    }
+
+    void LogArchiver::rotate(const fs::path& path) {
+        std::size_t number;
+        {
+            // Numbering carries on from the segments of earlier sessions, which must not be overwritten
+            std::lock_guard lock(mutex_);
+            auto [count, first] = segment_counts_.try_emplace(path.string(), 0);
+            if (first) count->second = highest_segment(log_dir_, path);
+            number = ++count->second;
+        }
+
+        const auto segment = rotated_path(path, number);
+        std::error_code ec;
+        fs::rename(path, segment, ec);
+        if (ec) return; // the file is left in place and overwritten by the sink, as without archiving
+
+        // A time index is small and stays uncompressed, next to the segment
+        if (fs::exists(index::index_path(path), ec)) fs::rename(index::index_path(path), index::index_path(segment), ec);
+
+        {
+            std::lock_guard lock(mutex_);
+            queue_.push_back(segment);
+        }
+        queued_.notify_one();
+    }
+
+    void LogArchiver::wait_idle() {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [this] { return queue_.empty() && !busy_; });
+    }
+
+    void LogArchiver::run() {
+        lower_thread_priority();
+
+        std::unique_lock lock(mutex_);
+        for (;;) {
+            queued_.wait(lock, [this] { return stop_requested_ || !queue_.empty(); });
+            if (queue_.empty()) break; // stop requested and nothing left
+
+            const auto segment = std::move(queue_.front());
+            queue_.pop_front();
+            busy_ = true;
+
+            lock.unlock();
+            archive(segment);
+            lock.lock();
+
+            busy_ = false;
+            if (queue_.empty()) idle_.notify_all();
+        }
+    }
+
+    void LogArchiver::archive(const fs::path& segment) {
+        auto compressed = segment;
+        compressed += archive::file_extension;
+
+        try {
+            archive::compress_file(segment, compressed);
+            std::error_code ec;
+            fs::remove(segment, ec);
+            enforce_retention();
+        } catch (const std::exception& ex) {
+            // The segment stays uncompressed: nothing is lost
+            std::cerr << "Log segment compression failed: " << ex.what() << std::endl;
+        }
+    }
+
+    void LogArchiver::enforce_retention() {
+        struct Segment {
+            fs::path path;
+            fs::file_time_type time;
+            std::uintmax_t size;
+        };
+
+        std::vector<Segment> segments;
+        std::uintmax_t total = 0;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(log_dir_, ec)) {
+            if (!entry.is_regular_file(ec) || entry.path().extension() != archive::file_extension) continue;
+
+            const auto size = entry.file_size(ec);
+            if (ec) continue;
+            segments.push_back({entry.path(), entry.last_write_time(ec), size});
+            total += size;
+        }
+        if (total <= config_.max_bytes) return;
+
+        // Oldest first; segments written within the same clock tick go by name (rotation order)
+        std::ranges::sort(segments, [](const Segment& a, const Segment& b) {
+            return a.time != b.time ? a.time < b.time : a.path < b.path;
+        });
+        for (const auto& segment : segments) {
+            if (total <= config_.max_bytes) break;
+            if (fs::remove(segment.path, ec)) total -= segment.size;
+            fs::remove(index::index_path(segment.path), ec);
+        }
+    }
+
+} // namespace aknet::log::detail
@@ -0,0 +1,68 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_LOG_ARCHIVER_H
+#define AKNET_LOG_ARCHIVER_H
+
+#pragma once
+
+#include "logger.h"
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace aknet::log::detail {
+
+    // -------------------------------------------------------------------------
+    // LogArchiver: compresses rotated log segments on a low-priority background thread.
+    // Sinks hand over their closed file with rotate(), which only renames it and queues it, so the
+    // sink's thread never waits on compression. Segments are numbered in rotation order instead of
+    // shifted (base.1.log is the oldest; numbering carries on after the segments earlier sessions left
+    // in the directory), compressed to base.N.log.akz (see log_archive.h), and the oldest .akz files
+    // of the log directory are deleted beyond max_bytes. A file's time index
+    // (base.log.akidx, see log_index.h) follows it uncompressed, as base.N.log.akidx.
+    // Shared by the sinks that rotate through it, so it outlives them; pending segments are
+    // compressed before it is destroyed.
+    // -------------------------------------------------------------------------
+    class LogArchiver {
+    public:
+        LogArchiver(const ArchiveConfig& config, std::filesystem::path log_dir);
+        ~LogArchiver();
+
+        LogArchiver(const LogArchiver&) = delete;
+        LogArchiver& operator=(const LogArchiver&) = delete;
+
+        // Move the closed file at path to the next segment name and queue it for compression
+        void rotate(const std::filesystem::path& path);
+
+        // Block until every queued segment is compressed
+        void wait_idle();
+
+    private:
+        void run();
+        void archive(const std::filesystem::path& segment);
+        void enforce_retention();
+
+        const ArchiveConfig config_;
+        const std::filesystem::path log_dir_;
+
+        std::mutex mutex_;
+        std::condition_variable queued_;
+        std::condition_variable idle_;
+        std::deque<std::filesystem::path> queue_;
+        std::unordered_map<std::string, std::size_t> segment_counts_; // per rotated file
+        bool busy_ = false;
+        bool stop_requested_ = false;
+
+        std::thread thread_;
+    };
+
+} // namespace aknet::log::detail
+
+#endif // AKNET_LOG_ARCHIVER_H
@@ -0,0 +1,29 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "log_files.h"
+
+#include <string>
+
+namespace aknet::log::detail {
+
+    std::filesystem::path rotated_path(const std::filesystem::path& path, std::size_t index) {
+        if (index == 0) return path;
+        auto rotated = path;
+        rotated.replace_filename(path.stem().string() + "." + std::to_string(index) + path.extension().string());
+        return rotated;
+    }
+
+    void rotate_files(const std::filesystem::path& path, std::size_t max_files, std::string_view suffix) {
+        std::error_code ec;
+        for (std::size_t i = max_files; i > 0; i--) {
+            auto src = rotated_path(path, i - 1);
+            auto dst = rotated_path(path, i);
+            src += suffix;
+            dst += suffix;
+            if (std::filesystem::exists(src, ec)) std::filesystem::rename(src, dst, ec);
+        }
+    }
+
+} // namespace aknet::log::detail
@@ -0,0 +1,26 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_LOG_FILES_H
+#define AKNET_LOG_FILES_H
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace aknet::log::detail {
+
+    // Name of the index-th rotated file, as spdlog's rotating sink names them:
+    // logs/aknet.log, logs/aknet.1.log, logs/aknet.2.log, ...
+    std::filesystem::path rotated_path(const std::filesystem::path& path, std::size_t index);
+
+    // Shift base -> base.1 -> ... -> base.<max_files>, dropping the oldest. The caller has closed base.
+    // With a suffix, shifts the companion files named <file><suffix> instead (e.g. time indexes).
+    void rotate_files(const std::filesystem::path& path, std::size_t max_files, std::string_view suffix = {});
+
+} // namespace aknet::log::detail
+
+#endif // AKNET_LOG_FILES_H
@@ -0,0 +1,93 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "log_index.h"
+#include "log_archive.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace aknet::log::index {
+
+    namespace {
+        template<typename T>
+        T take(const char*& p) noexcept {
+            T value;
+            std::memcpy(&value, p, sizeof value);
+            p += sizeof value;
+            return value;
+        }
+
+        constexpr std::size_t block_body_size = 8 + 4 + 8 + 8 + 1 + 8;
+    }
+
+    std::filesystem::path index_path(const std::filesystem::path& log_path) {
+        auto path = log_path;
+        if (path.extension() == archive::file_extension) path.replace_extension(); // the segment's own name
+        path += file_extension;
+        return path;
+    }
+
+    Index::Index(const std::filesystem::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open log index: " + path.string());
+
+        std::array<char, file_magic.size()> magic{};
+        std::uint32_t version = 0;
+        in.read(magic.data(), magic.size());
+        in.read(reinterpret_cast<char*>(&version), sizeof version);
+        if (!in || magic != file_magic) throw std::runtime_error("Not a log index: " + path.string());
+        if (version != file_version) throw std::runtime_error("Unsupported log index version " + std::to_string(version));
+
+        std::string body;
+        for (;;) {
+            EntryKind kind;
+            std::uint32_t size = 0;
+            in.read(reinterpret_cast<char*>(&kind), sizeof kind);
+            in.read(reinterpret_cast<char*>(&size), sizeof size);
+            if (!in) break;
+
+            body.resize(size);
+            if (!in.read(body.data(), size)) break; // truncated last entry
+
+            const char* p = body.data();
+            if (kind == EntryKind::logger && size >= 3) {
+                const auto bit = take<std::uint8_t>(p);
+                const auto length = take<std::uint16_t>(p);
+                if (size < 3u + length) continue;
+                loggers_.push_back({bit, std::string(p, length)});
+            } else if (kind == EntryKind::block && size >= block_body_size) {
+                Block block;
+                block.offset = take<std::uint64_t>(p);
+                block.size = take<std::uint32_t>(p);
+                block.first_ns = take<std::int64_t>(p);
+                block.last_ns = take<std::int64_t>(p);
+                block.levels = take<std::uint8_t>(p);
+                block.loggers = take<std::uint64_t>(p);
+                blocks_.push_back(block);
+            }
+        }
+    }
+
+    std::uint64_t Index::logger_mask(std::string_view name) const {
+        std::uint64_t mask = 0;
+        for (const auto& logger : loggers_) {
+            if (std::string_view(logger.name).substr(0, 10) == name.substr(0, 10)) {
+                mask |= std::uint64_t{1} << (logger.bit % logger_bits);
+            }
+        }
+        return mask;
+    }
+
+    std::vector<Block> Index::select(std::int64_t from_ns, std::int64_t to_ns, std::uint64_t logger_mask,
+                                     std::uint8_t level_mask) const {
+        std::vector<Block> selected;
+        for (const auto& block : blocks_) {
+            if (block.matches(from_ns, to_ns, logger_mask, level_mask)) selected.push_back(block);
+        }
+        return selected;
+    }
+
+} // namespace aknet::log::index
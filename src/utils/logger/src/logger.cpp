@@ -1,82 +1,107 @@
 #include "logger.h"
+#include "logger_impl.h"
+#include "async_backend.h"
+#include "batched_file_sink.h"
+#include "binary_sink.h"
+#include "flight_recorder.h"
+#include "log_archiver.h"
+#include "record_clock.h"
 
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/rotating_file_sink.h>
 
+#include <array>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <mutex>
+#include <ranges>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace fs = std::filesystem;
 
 namespace aknet::log {
 
     // -------------------------------------------------------------------------
-    // LoggerImpl: the hidden implementation that holds a spdlog::logger
+    // Global state (protected by mutex)
     // -------------------------------------------------------------------------
-    class LoggerImpl {
-    public:
-        explicit LoggerImpl(std::shared_ptr<spdlog::logger> spd) : spd_(std::move(spd)) {}
-
-        void log(LogLevel lvl, std::string_view msg) {
-            spd_->log(to_spdlog_level(lvl), "{}", msg);
-        }
-
-        void set_level(LogLevel lvl) {
-            spd_->set_level(to_spdlog_level(lvl));
-        }
-
-        LogLevel get_level() {
-            switch (spdlog::level::level_enum spd_lvl = spd_->level()) {
-                case spdlog::level::trace: return LogLevel::trace;
-                case spdlog::level::debug: return LogLevel::debug;
-                case spdlog::level::info: return LogLevel::info;
-                case spdlog::level::warn: return LogLevel::warn;
-                case spdlog::level::err: return LogLevel::error;
-                case spdlog::level::critical: return LogLevel::critical;
-                default: return LogLevel::off;
+    namespace {
+        // Transparent hashing so lookups by std::string_view do not build a std::string
+        struct NameHash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view name) const noexcept {
+                return std::hash<std::string_view>{}(name);
             }
+        };
 
-        }
+        using LoggerMap = std::unordered_map<std::string, std::shared_ptr<Logger>, NameHash, std::equal_to<>>;
 
-        void flush() {
-            spd_->flush();
+        std::mutex g_mutex;
+        std::vector<spdlog::sink_ptr> g_sinks;
+        std::shared_ptr<detail::AsyncBackend> g_async_backend; // also held by producers registering a ring
+        std::shared_ptr<detail::BatchedFileSink> g_batched_sink; // also in g_sinks
+        std::unique_ptr<detail::FlightRecorder> g_flight_recorder;
+        std::shared_ptr<detail::LogArchiver> g_archiver; // also held by the sinks rotating through it
+        FlightRecorderConfig g_flight_config;
+
+        // Logger registry: immutable snapshots, replaced (copy-on-write) under g_mutex when a name is added,
+        // and read by get() without locking. Superseded snapshots stay alive until shutdown() since readers
+        // may still hold them; there is one per logger name, so this is bounded by the number of modules.
+        std::atomic<const LoggerMap*> g_loggers{nullptr};
+        std::vector<std::unique_ptr<const LoggerMap>> g_logger_snapshots;
+
+        // Lock-free readers of g_loggers, counted so shutdown() can wait for them before freeing the
+        // snapshots. Striped by thread so get() does not contend on one cache line.
+        struct alignas(64) ReaderCount {
+            std::atomic<std::uint32_t> value{0};
+        };
+        std::array<ReaderCount, 16> g_registry_readers;
+        std::atomic<std::uint32_t> g_next_reader_stripe{0};
+
+        std::atomic<std::uint32_t>& registry_readers() {
+            thread_local const std::size_t stripe =
+                    g_next_reader_stripe.fetch_add(1, std::memory_order_relaxed) % g_registry_readers.size();
+            return g_registry_readers[stripe].value;
         }
 
-    private:
-        static spdlog::level::level_enum to_spdlog_level(LogLevel lvl) {
-            switch (lvl) {
-                case LogLevel::trace: return spdlog::level::trace;
-                case LogLevel::debug: return spdlog::level::debug;
-                case LogLevel::info: return spdlog::level::info;
-                case LogLevel::warn: return spdlog::level::warn;
-                case LogLevel::error: return spdlog::level::err;
-                case LogLevel::critical: return spdlog::level::critical;
-                case LogLevel::off: return spdlog::level::off;
+        // Unpublish the registry and free its snapshots once no get() can still be reading one (g_mutex held)
+        void retire_logger_snapshots() {
+            // Sequentially consistent with get(): a reader that saw the old registry had already counted itself
+            g_loggers.store(nullptr);
+            for (const auto& readers : g_registry_readers) {
+                while (readers.value.load() != 0) std::this_thread::yield();
             }
-            return spdlog::level::info;
+            g_logger_snapshots.clear();
         }
 
-        std::shared_ptr<spdlog::logger> spd_;
-    };
+        std::atomic<bool> g_initialized{false};
 
-    // -------------------------------------------------------------------------
-    // Global state (protected by mutex)
-    // -------------------------------------------------------------------------
-    namespace {
-        std::mutex g_mutex;
-        std::vector<spdlog::sink_ptr> g_sinks;
-        std::unordered_map<std::string, std::shared_ptr<Logger>> g_loggers;
-        bool g_initialized = false;
+        // Publish a copy of the current registry with one more logger (g_mutex held)
+        void publish_logger(std::string_view name, std::shared_ptr<Logger> logger) {
+            const LoggerMap* current = g_loggers.load(std::memory_order_relaxed);
+            auto next = current ? std::make_unique<LoggerMap>(*current) : std::make_unique<LoggerMap>();
+            next->emplace(name, std::move(logger));
+
+            g_loggers.store(next.get(), std::memory_order_release);
+            g_logger_snapshots.push_back(std::move(next));
+        }
     }
 
     // -------------------------------------------------------------------------
     // Helpers
     // -------------------------------------------------------------------------
 
+    // Wrap a spdlog logger with the modes of the current session (g_mutex held)
+    std::shared_ptr<LoggerImpl> make_impl(std::shared_ptr<spdlog::logger> spd_logger) {
+        const LogLevel record_level = g_flight_recorder ? g_flight_config.level : LogLevel::off;
+        return std::make_shared<LoggerImpl>(std::move(spd_logger), g_async_backend != nullptr, record_level);
+    }
+
     /*
      * WARNING: hardcoded the default logs dir to "home/Desktop/Logs/aknet in the logger.cpp
      * This will only work on macOS.
@@ -103,17 +128,44 @@ namespace aknet::log {
     // -------------------------------------------------------------------------
     // Logger implementation
     // -------------------------------------------------------------------------
-    Logger::Logger(std::shared_ptr<LoggerImpl> impl) : impl_(std::move(impl)) {}
+    Logger::Logger(std::shared_ptr<LoggerImpl> impl) : impl_(std::move(impl)) {
+        if (impl_) {
+            level_.store(impl_->get_level(), std::memory_order_relaxed);
+            async_ = impl_->async();
+            record_level_ = impl_->record_level();
+        }
+    }
     Logger::~Logger() = default;
-    Logger::Logger(Logger&&) noexcept = default;
-    Logger& Logger::operator=(Logger&&) noexcept = default;
+
+    // std::atomic is not movable, so the cached level is carried over by hand.
+    // A moved-from logger has no impl_ and is left at LogLevel::off.
+    Logger::Logger(Logger&& other) noexcept
+        : impl_(std::move(other.impl_)),
+          level_(other.level_.exchange(LogLevel::off, std::memory_order_relaxed)),
+          async_(other.async_),
+          record_level_(std::exchange(other.record_level_, LogLevel::off)),
+          limiter_(other.limiter_.exchange(nullptr, std::memory_order_acq_rel)) {}
+
+    Logger& Logger::operator=(Logger&& other) noexcept {
+        if (this != &other) {
+            impl_ = std::move(other.impl_);
+            level_.store(other.level_.exchange(LogLevel::off, std::memory_order_relaxed), std::memory_order_relaxed);
+            async_ = other.async_;
+            record_level_ = std::exchange(other.record_level_, LogLevel::off);
+            limiter_.store(other.limiter_.exchange(nullptr, std::memory_order_acq_rel), std::memory_order_release);
+        }
+        return *this;
+    }
 
     void Logger::log(LogLevel lvl, std::string_view msg) {
         if (impl_) impl_->log(lvl, msg);
     }
 
     void Logger::set_level(LogLevel lvl) {
-        if (impl_) impl_->set_level(lvl);
+        if (impl_) {
+            impl_->set_level(lvl);
+            level_.store(lvl, std::memory_order_relaxed);
+        }
     }
 
     LogLevel Logger::get_level() {
@@ -121,17 +173,40 @@ namespace aknet::log {
         throw std::runtime_error("Cannot get logger level because logger not initialized");
     }
 
+    void Logger::set_rate_limit(const RateLimitConfig& config) {
+        if (!impl_) return;
+        detail::RateLimiter* previous = limiter_.exchange(impl_->set_rate_limit(config), std::memory_order_acq_rel);
+
+        // Do not lose the counts of the limiter being replaced
+        if (previous) {
+            previous->take_suppressed([this](std::string_view format, LogLevel lvl, std::uint64_t count) {
+                report_suppressed(lvl, format, count);
+            });
+        }
+    }
+
+    void Logger::report_suppressed(LogLevel lvl, std::string_view format, std::uint64_t count) {
+        emit(lvl, "{} similar messages suppressed: {}", count, format);
+    }
+
     void Logger::flush() {
-        if (impl_) impl_->flush();
+        if (!impl_) return;
+        if (detail::RateLimiter* limiter = limiter_.load(std::memory_order_acquire)) {
+            limiter->take_suppressed([this](std::string_view format, LogLevel lvl, std::uint64_t count) {
+                report_suppressed(lvl, format, count);
+            });
+        }
+        if (async_) detail::drain_async_backend();
+        impl_->flush();
     }
 
     // -------------------------------------------------------------------------
     // Global functions
     // -------------------------------------------------------------------------
-    void init(fs::path log_dir) {
+    void init(fs::path log_dir, const LogConfig& config) {
         std::lock_guard lock(g_mutex);
 
-        if (g_initialized) return;
+        if (g_initialized.load(std::memory_order_relaxed)) return;
 
         if (log_dir.empty()) {
             log_dir = default_log_dir();
@@ -140,36 +215,113 @@ namespace aknet::log {
 
         const auto log_path = log_dir / session_filename();
 
+        // Records of this session are stamped with this clock, anchored to the system clock now
+        detail::calibrate_record_clock(config.clock);
+
         try {
-            // File sink: rotating, max 5MB, max 3 files
-            auto file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
-                log_path.string(), 1024 * 1024 * 5, 3);
-            file_sink->set_level(spdlog::level::trace);
-            g_sinks.push_back(file_sink);
+            // Rotated segments go to the archiver when enabled
+            if (config.archive.enabled) g_archiver = std::make_shared<detail::LogArchiver>(config.archive, log_dir);
+
+            if (!config.binary.enabled || config.binary.text_sinks) {
+                // File sink: rotating, batched unless asked otherwise
+                spdlog::sink_ptr file_sink;
+                if (config.file.batched) {
+                    g_batched_sink = std::make_shared<detail::BatchedFileSink>(log_path, config.file, g_archiver);
+                    file_sink = g_batched_sink;
+                } else {
+                    file_sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+                        log_path.string(), config.file.max_file_size, config.file.max_files);
+
+                    // Flush all loggers every 2 seconds (the batched sink bounds its own latency)
+                    spdlog::flush_every(std::chrono::seconds(2));
+                }
+                file_sink->set_level(spdlog::level::trace);
+                g_sinks.push_back(file_sink);
+
+                // Console sink
+                if (config.console) {
+                    auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+                    console_sink->set_level(spdlog::level::trace);
+                    g_sinks.push_back(console_sink);
+                }
+            }
 
-            // Console sink
-            auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-            console_sink->set_level(spdlog::level::trace);
-            g_sinks.push_back(console_sink);
+            // Async mode: producers write into per-thread rings, drained into g_sinks by the backend thread
+            if (config.async.enabled || config.binary.enabled) {
+                auto async_config = config.async;
+                async_config.enabled = true;
+                g_async_backend = std::make_shared<detail::AsyncBackend>(async_config);
+
+                if (config.binary.enabled) {
+                    auto binary_path = log_path;
+                    binary_path.replace_extension(binary::file_extension);
+                    g_async_backend->add_record_sink(std::make_unique<detail::BinarySink>(
+                        binary_path, config.binary.max_file_size, config.binary.max_files, g_archiver));
+                }
+
+                g_async_backend->start();
+                detail::set_async_backend(g_async_backend);
+            }
 
-            // Flush all loggers every 2 seconds
-            spdlog::flush_every(std::chrono::seconds(2));
+            // Flight recorder: fixed pool of per-thread rings, dumped next to the session log
+            if (config.flight_recorder.enabled) {
+                g_flight_recorder = std::make_unique<detail::FlightRecorder>(config.flight_recorder, log_path);
+                g_flight_config = config.flight_recorder;
+                detail::set_flight_recorder(g_flight_recorder.get());
+                if (g_flight_config.dump_on_crash) detail::install_crash_handlers();
+            }
 
-            g_initialized = true;
+            g_initialized.store(true, std::memory_order_release);
         }
-        catch (const spdlog::spdlog_ex &ex) {
+        catch (const std::exception &ex) {
             std::cerr << "Logging initialization failed: " << ex.what() << std::endl;
             g_sinks.clear(); // Clear any partially populated sinks to maintain consistent state
+            g_batched_sink.reset();
+            if (g_async_backend) {
+                detail::set_async_backend(nullptr);
+                g_async_backend.reset();
+            }
+            g_flight_recorder.reset();
+            g_archiver.reset();
         }
     }
 
     void shutdown() {
         std::lock_guard lock(g_mutex);
 
+        // Dump before the registry goes away: records point to the loggers that wrote them
+        if (g_flight_recorder) {
+            detail::remove_crash_handlers();
+            detail::set_flight_recorder(nullptr);
+            if (g_flight_config.dump_on_shutdown) {
+                detail::FlightRecorder::PathBuffer path;
+                g_flight_recorder->dump(false, path);
+            }
+            g_flight_recorder.reset();
+        }
+
+        // Stop producers from reaching the backend, then drain what they already published
+        if (g_async_backend) {
+            detail::set_async_backend(nullptr);
+            g_async_backend->stop();
+            g_async_backend.reset();
+        }
+
+        // Loggers may outlive shutdown (held by modules), so their sinks are not closed here
+        for (const auto& sink : g_sinks) sink->flush();
+
         spdlog::shutdown();
         g_sinks.clear();
-        g_loggers.clear();
-        g_initialized = false;
+        g_batched_sink.reset();
+
+        // Finish compressing what the sinks rotated; sinks of loggers still held keep the archiver alive
+        if (g_archiver) {
+            g_archiver->wait_idle();
+            g_archiver.reset();
+        }
+
+        retire_logger_snapshots();
+        g_initialized.store(false, std::memory_order_release);
     }
 
     void set_global_log_level(LogLevel lvl) {
@@ -186,46 +338,92 @@ namespace aknet::log {
             case LogLevel::off: spd_lvl = spdlog::level::off; break;
         }
         spdlog::set_level(spd_lvl);
+
+        // Keep the cached level of every wrapper in sync with spdlog
+        if (const LoggerMap* loggers = g_loggers.load(std::memory_order_relaxed)) {
+            for (const auto& logger : *loggers | std::views::values) {
+                logger->set_level(lvl);
+            }
+        }
     }
 
     bool is_initialized() {
+        return g_initialized.load(std::memory_order_acquire);
+    }
+
+    void preallocate_thread_buffer() {
+        detail::prepare_thread_ring();
+    }
+
+    std::uint64_t dropped_messages() {
+        std::lock_guard lock(g_mutex);
+        return g_async_backend ? g_async_backend->dropped() : 0;
+    }
+
+    std::uint64_t failed_file_writes() {
+        std::lock_guard lock(g_mutex);
+        return g_batched_sink ? g_batched_sink->failed_batches() : 0;
+    }
+
+    fs::path dump_flight_recorder() {
         std::lock_guard lock(g_mutex);
-        return g_initialized;
+        if (!g_flight_recorder) return {};
+
+        detail::FlightRecorder::PathBuffer path;
+        if (!g_flight_recorder->dump(false, path)) return {};
+        return fs::path(path.data());
     }
 
-    std::shared_ptr<Logger> get(const std::string& name) {
+    std::shared_ptr<Logger> get(std::string_view name) {
+        // Fast path: lock-free lookup in the current registry snapshot, counted as a reader so shutdown()
+        // does not free the snapshot under it
+        {
+            auto& readers = registry_readers();
+            readers.fetch_add(1);
+            std::shared_ptr<Logger> logger;
+            if (const LoggerMap* loggers = g_loggers.load()) {
+                if (auto it = loggers->find(name); it != loggers->end()) logger = it->second;
+            }
+            readers.fetch_sub(1, std::memory_order_release);
+            if (logger) return logger;
+        }
+
         std::lock_guard lock(g_mutex);
 
-        // Check if we already have a wrapper for this logger
-        if (auto it = g_loggers.find(name); it != g_loggers.end()) {
-            return it->second;
+        // Another thread may have created it while we were waiting for the lock
+        if (const LoggerMap* loggers = g_loggers.load(std::memory_order_relaxed)) {
+            if (auto it = loggers->find(name); it != loggers->end()) {
+                return it->second;
+            }
         }
 
+        const std::string name_str(name);
+
         // Check if the logger already exists in the spdlog registry, but we don't have it cached
-        auto spd_logger = spdlog::get(name);
+        auto spd_logger = spdlog::get(name_str);
         if (spd_logger) {
-            auto logger = std::make_shared<Logger>(std::make_shared<LoggerImpl>(spd_logger));
-            g_loggers[name] = logger;
+            auto logger = std::make_shared<Logger>(make_impl(spd_logger));
+            publish_logger(name, logger);
             return logger;
         }
 
         // Make sure that the logging system is initialized
-        if (!g_initialized || g_sinks.empty()) {
+        if (!g_initialized.load(std::memory_order_relaxed)) {
             std::cerr << "Logging system not initialized. Call log::init() first." << std::endl;
             throw std::runtime_error("Logging system not initialized");
         }
 
         // Create anew spdlog logger with shared sinks
-        if (empty(name)) {
+        if (name.empty()) {
             throw std::invalid_argument("Logger name cannot be empty");
         }
-        auto new_spd_logger = std::make_shared<spdlog::logger>(name, g_sinks.begin(), g_sinks.end());
+        auto new_spd_logger = std::make_shared<spdlog::logger>(name_str, g_sinks.begin(), g_sinks.end());
         new_spd_logger->set_level(spdlog::level::trace);
         new_spd_logger->set_pattern("%Y-%m-%d %H:%M:%S.%e [%10!n] %^[%8l]%$ %v");
         spdlog::register_logger(new_spd_logger);
 
-        auto logger = std::make_shared<Logger>(std::make_shared<LoggerImpl>(new_spd_logger));
-        g_loggers[name] = logger;
+        auto logger = std::make_shared<Logger>(make_impl(new_spd_logger));
+        publish_logger(name, logger);
         return logger;
     }
 
@@ -0,0 +1,112 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_LOGGER_IMPL_H
+#define AKNET_LOGGER_IMPL_H
+
+#pragma once
+
+#include "logger.h"
+#include "rate_limiter.h"
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace aknet::log {
+
+    // -------------------------------------------------------------------------
+    // LoggerImpl: the hidden implementation that holds a spdlog::logger
+    // -------------------------------------------------------------------------
+    class LoggerImpl {
+    public:
+        LoggerImpl(std::shared_ptr<spdlog::logger> spd, bool async = false, LogLevel record_level = LogLevel::off)
+            : spd_(std::move(spd)), async_(async), record_level_(record_level),
+              id_(next_id_.fetch_add(1, std::memory_order_relaxed)) {}
+
+        void log(LogLevel lvl, std::string_view msg) {
+            spd_->log(to_spdlog_level(lvl), "{}", msg);
+        }
+
+        // Used by the async backend: the timestamp is the one captured at the call site
+        void log(spdlog::log_clock::time_point time, LogLevel lvl, std::string_view msg) {
+            spd_->log(time, spdlog::source_loc{}, to_spdlog_level(lvl), msg);
+        }
+
+        void set_level(LogLevel lvl) {
+            spd_->set_level(to_spdlog_level(lvl));
+        }
+
+        LogLevel get_level() {
+            return from_spdlog_level(spd_->level());
+        }
+
+        void flush() {
+            spd_->flush();
+        }
+
+        bool async() const { return async_; }
+
+        // Lowest level kept by the flight recorder (LogLevel::off when it is disabled)
+        LogLevel record_level() const { return record_level_; }
+
+        // Install a new rate limiter (nullptr for none). Replaced limiters stay alive with the logger,
+        // since callers may still be using them.
+        detail::RateLimiter* set_rate_limit(const RateLimitConfig& config) {
+            if (config.messages_per_second <= 0 && config.sample_every <= 1) return nullptr;
+
+            std::lock_guard lock(limiters_mutex_);
+            limiters_.push_back(std::make_unique<detail::RateLimiter>(config));
+            return limiters_.back().get();
+        }
+
+        // Process-unique id, used to refer to the logger in binary logs
+        std::uint32_t id() const { return id_; }
+        const std::string& name() const { return spd_->name(); }
+        bool has_sinks() const { return !spd_->sinks().empty(); }
+
+        static spdlog::level::level_enum to_spdlog_level(LogLevel lvl) {
+            switch (lvl) {
+                case LogLevel::trace: return spdlog::level::trace;
+                case LogLevel::debug: return spdlog::level::debug;
+                case LogLevel::info: return spdlog::level::info;
+                case LogLevel::warn: return spdlog::level::warn;
+                case LogLevel::error: return spdlog::level::err;
+                case LogLevel::critical: return spdlog::level::critical;
+                case LogLevel::off: return spdlog::level::off;
+            }
+            return spdlog::level::info;
+        }
+
+        static LogLevel from_spdlog_level(spdlog::level::level_enum lvl) {
+            switch (lvl) {
+                case spdlog::level::trace: return LogLevel::trace;
+                case spdlog::level::debug: return LogLevel::debug;
+                case spdlog::level::info: return LogLevel::info;
+                case spdlog::level::warn: return LogLevel::warn;
+                case spdlog::level::err: return LogLevel::error;
+                case spdlog::level::critical: return LogLevel::critical;
+                default: return LogLevel::off;
+            }
+        }
+
+    private:
+        std::shared_ptr<spdlog::logger> spd_;
+        bool async_;
+        LogLevel record_level_;
+        std::uint32_t id_;
+
+        std::mutex limiters_mutex_;
+        std::vector<std::unique_ptr<detail::RateLimiter>> limiters_;
+
+        static inline std::atomic<std::uint32_t> next_id_{0};
+    };
+
+} // namespace aknet::log
+
+#endif // AKNET_LOGGER_IMPL_H
@@ -0,0 +1,98 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "rate_limiter.h"
+#include "record_clock.h"
+
+#include <algorithm>
+
+namespace aknet::log::detail {
+
+    namespace {
+        // Key of a site being claimed, until its length and level are written
+        constexpr char claiming[1] = {};
+    }
+
+    RateLimiter::RateLimiter(const RateLimitConfig& config)
+        : sample_every_(std::max<std::uint32_t>(config.sample_every, 1)),
+          interval_ns_(config.messages_per_second > 0 ? static_cast<std::int64_t>(1e9 / config.messages_per_second) : 0),
+          tolerance_ns_(interval_ns_ * (std::max<std::uint32_t>(config.burst, 1) - 1)),
+          sites_(std::make_unique<Site[]>(max_sites)) {}
+
+    bool RateLimiter::admit(std::string_view format, LogLevel lvl, std::uint64_t& suppressed) noexcept {
+        Site* site = find_site(format, lvl);
+        if (!site) return true;
+
+        bool admitted = site->calls.fetch_add(1, std::memory_order_relaxed) % sample_every_ == 0;
+
+        if (admitted && interval_ns_ > 0) {
+            const std::int64_t now = record_time_ns(record_timestamp());
+            auto tat = site->tat.load(std::memory_order_relaxed);
+            for (;;) {
+                const auto start = std::max(tat, now);
+                if (start - now > tolerance_ns_) {
+                    admitted = false;
+                    break;
+                }
+                if (site->tat.compare_exchange_weak(tat, start + interval_ns_, std::memory_order_relaxed)) break;
+            }
+        }
+
+        if (!admitted) {
+            site->suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        // Cheap check first: the exchange is a write to a shared line
+        suppressed = site->suppressed.load(std::memory_order_relaxed) == 0
+                         ? 0
+                         : site->suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    void RateLimiter::take_suppressed(
+        const std::function<void(std::string_view format, LogLevel lvl, std::uint64_t count)>& report) {
+        for (std::size_t i = 0; i < max_sites; i++) {
+            Site& site = sites_[i];
+            const char* key = site.key.load(std::memory_order_acquire);
+            if (!key || key == claiming || site.suppressed.load(std::memory_order_relaxed) == 0) continue;
+
+            if (const auto count = site.suppressed.exchange(0, std::memory_order_relaxed)) {
+                report({key, site.length.load(std::memory_order_relaxed)}, site.level.load(std::memory_order_relaxed),
+                       count);
+            }
+        }
+    }
+
+    bool admit_call(RateLimiter* limiter, std::string_view format, LogLevel lvl, std::uint64_t& suppressed) noexcept {
+        return limiter->admit(format, lvl, suppressed);
+    }
+
+    RateLimiter::Site* RateLimiter::find_site(std::string_view format, LogLevel lvl) noexcept {
+        // The same format string may be logged at several levels: each is a site of its own
+        const char* key = format.data();
+        const auto hash = (reinterpret_cast<std::uintptr_t>(key) ^ static_cast<std::uintptr_t>(lvl)) *
+                          std::uintptr_t{0x9E3779B97F4A7C15ull};
+
+        for (std::size_t probe = 0; probe < max_probes; probe++) {
+            Site& site = sites_[((hash >> 16) + probe) & (max_sites - 1)];
+            const char* current = site.key.load(std::memory_order_acquire);
+            if (current == nullptr) {
+                // Claim the free slot, describe the site, then publish its key
+                if (!site.key.compare_exchange_strong(current, claiming, std::memory_order_acquire)) {
+                    if (current != claiming) continue;
+                    return nullptr;
+                }
+                site.length.store(format.size(), std::memory_order_relaxed);
+                site.level.store(lvl, std::memory_order_relaxed);
+                site.key.store(key, std::memory_order_release);
+                return &site;
+            }
+            // Another thread is claiming this slot, maybe for this very site: this call is not limited
+            if (current == claiming) return nullptr;
+            if (current == key && site.level.load(std::memory_order_relaxed) == lvl) return &site;
+        }
+        return nullptr;
+    }
+
+} // namespace aknet::log::detail
@@ -0,0 +1,63 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_RATE_LIMITER_H
+#define AKNET_RATE_LIMITER_H
+
+#pragma once
+
+#include "logger.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+
+namespace aknet::log::detail {
+
+    // -------------------------------------------------------------------------
+    // RateLimiter: per-call-site sampling and token bucket of one logger.
+    // Call sites are keyed by their format string pointer and level in a fixed open-addressing table,
+    // claimed with a CAS on first use. The bucket is a GCRA (one atomic "theoretical arrival time"
+    // per site) on the record clock, so admit() is a handful of atomic operations and never locks or
+    // allocates.
+    // -------------------------------------------------------------------------
+    class RateLimiter {
+    public:
+        static constexpr std::size_t max_sites = 512; // power of two
+        static constexpr std::size_t max_probes = 16;
+
+        explicit RateLimiter(const RateLimitConfig& config);
+
+        // Whether this call may be logged. When it may, `suppressed` receives the number of calls
+        // of the same site suppressed since the last admitted one.
+        // Sites that do not fit in the table are never limited.
+        bool admit(std::string_view format, LogLevel lvl, std::uint64_t& suppressed) noexcept;
+
+        // Hand out (and reset) the suppressed counts of every site
+        void take_suppressed(const std::function<void(std::string_view format, LogLevel lvl, std::uint64_t count)>& report);
+
+    private:
+        // key is published last (release): length and level are set once a reader acquires it
+        struct Site {
+            std::atomic<const char*> key{nullptr};
+            std::atomic<std::size_t> length{0};
+            std::atomic<LogLevel> level{LogLevel::off};
+            std::atomic<std::int64_t> tat{0}; // GCRA theoretical arrival time, record clock ns
+            std::atomic<std::uint64_t> calls{0};
+            std::atomic<std::uint64_t> suppressed{0};
+        };
+
+        Site* find_site(std::string_view format, LogLevel lvl) noexcept;
+
+        const std::uint32_t sample_every_;
+        const std::int64_t interval_ns_;  // 0: no token bucket
+        const std::int64_t tolerance_ns_; // burst - 1 intervals
+        std::unique_ptr<Site[]> sites_;
+    };
+
+} // namespace aknet::log::detail
+
+#endif // AKNET_RATE_LIMITER_H
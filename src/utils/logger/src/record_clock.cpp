@@ -0,0 +1,121 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "record_clock.h"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace aknet::log::detail {
+
+    std::atomic<ClockSource> g_record_clock{ClockSource::system};
+
+    namespace {
+        // wall = anchor_wall + (timestamp - anchor_ticks) * ns_per_tick
+        std::atomic<std::int64_t> g_anchor_ticks{0};
+        std::atomic<std::int64_t> g_anchor_wall_ns{0};
+        std::atomic<double> g_ns_per_tick{1.0};
+
+        std::int64_t system_now_ns() noexcept {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        std::int64_t steady_now_ns() noexcept {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        // The precise clock behind read_coarse_clock()
+        std::int64_t monotonic_now_ns() noexcept {
+            timespec ts{};
+#if !defined(CLOCK_MONOTONIC_COARSE) && defined(CLOCK_MONOTONIC_RAW_APPROX)
+            clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+            return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+        }
+
+        // Nanoseconds per counter tick, 0 if the counter cannot be used
+        double measure_tick_period() {
+#if defined(__aarch64__)
+            // The generic timer advertises its frequency
+            std::uint64_t frequency;
+            asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+            return frequency ? 1e9 / static_cast<double>(frequency) : 0.0;
+#elif defined(__x86_64__) || defined(__i386__)
+            // Only an invariant TSC ticks at a constant rate across frequency changes and sleep states
+            unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+            if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8))) return 0.0;
+
+            // Count ticks against the steady clock for a few milliseconds. The clock reads at each end bound the
+            // error to ~2e-5 of the window, so long sessions can drift by tens of milliseconds per hour from
+            // the system clock; the anchor is taken again at every init().
+            constexpr std::int64_t window_ns = 5'000'000;
+            const auto steady_start = steady_now_ns();
+            const auto ticks_start = read_tick_counter();
+            std::int64_t steady_end;
+            do {
+                steady_end = steady_now_ns();
+            } while (steady_end - steady_start < window_ns);
+            const auto ticks_end = read_tick_counter();
+
+            // A counter that does not advance steadily (virtualized, stopped) is not usable
+            if (ticks_end <= ticks_start) return 0.0;
+            return static_cast<double>(steady_end - steady_start) / static_cast<double>(ticks_end - ticks_start);
+#else
+            return 0.0;
+#endif
+        }
+
+        // The counter's rate does not change during the process: measure it once
+        double tick_period() {
+            static const double period = measure_tick_period();
+            return period;
+        }
+    }
+
+    void calibrate_record_clock(ClockSource source) {
+        if (source == ClockSource::tsc && (!has_tick_counter || !std::isfinite(tick_period()) || tick_period() <= 0.0)) {
+            source = ClockSource::monotonic_coarse;
+        }
+
+        std::int64_t anchor_ticks = 0;
+        std::int64_t anchor_wall = 0;
+        double ns_per_tick = 1.0;
+        switch (source) {
+            case ClockSource::tsc:
+                ns_per_tick = tick_period();
+                anchor_wall = system_now_ns();
+                anchor_ticks = read_tick_counter();
+                break;
+            case ClockSource::monotonic_coarse:
+                // Anchor on the precise monotonic clock: the coarse one can lag it by a tick
+                anchor_wall = system_now_ns();
+                anchor_ticks = monotonic_now_ns();
+                break;
+            case ClockSource::system:
+                break;
+        }
+
+        g_anchor_ticks.store(anchor_ticks, std::memory_order_relaxed);
+        g_anchor_wall_ns.store(anchor_wall, std::memory_order_relaxed);
+        g_ns_per_tick.store(ns_per_tick, std::memory_order_relaxed);
+        g_record_clock.store(source, std::memory_order_relaxed);
+    }
+
+    std::int64_t record_time_ns(std::int64_t timestamp) noexcept {
+        const auto delta = timestamp - g_anchor_ticks.load(std::memory_order_relaxed);
+        const auto ns_per_tick = g_ns_per_tick.load(std::memory_order_relaxed);
+
+        // Integer path for nanosecond sources: a double cannot hold epoch nanoseconds exactly
+        const auto elapsed = ns_per_tick == 1.0 ? delta : std::llround(static_cast<double>(delta) * ns_per_tick);
+        return g_anchor_wall_ns.load(std::memory_order_relaxed) + elapsed;
+    }
+
+} // namespace aknet::log::detail
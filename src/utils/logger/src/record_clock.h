@@ -0,0 +1,88 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_RECORD_CLOCK_H
+#define AKNET_RECORD_CLOCK_H
+
+#pragma once
+
+#include "logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace aknet::log::detail {
+
+    // -------------------------------------------------------------------------
+    // Record clock: timestamps of async and flight recorder records.
+    // Records store raw ticks of the configured ClockSource, read at the call site; they are converted
+    // to system_clock nanoseconds only when a record leaves the process (sinks, binary files, dumps),
+    // with the calibration taken by calibrate_record_clock() in init().
+    // -------------------------------------------------------------------------
+
+    // Set by calibrate_record_clock(); relaxed atomics so producers of a previous session stay race-free
+    extern std::atomic<ClockSource> g_record_clock;
+
+    // Whether this build has a cycle counter readable from user space
+    inline constexpr bool has_tick_counter =
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+        true;
+#else
+        false;
+#endif
+
+    inline std::int64_t read_tick_counter() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return static_cast<std::int64_t>(__rdtsc());
+#elif defined(__aarch64__)
+        std::uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return static_cast<std::int64_t>(ticks);
+#else
+        return 0;
+#endif
+    }
+
+    inline std::int64_t read_coarse_clock() noexcept {
+        timespec ts{};
+#if defined(CLOCK_MONOTONIC_COARSE)
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#elif defined(CLOCK_MONOTONIC_RAW_APPROX)
+        clock_gettime(CLOCK_MONOTONIC_RAW_APPROX, &ts);
+#else
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+        return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+    }
+
+    // Timestamp stored in records, taken at the call site
+    inline std::int64_t record_timestamp() noexcept {
+        switch (g_record_clock.load(std::memory_order_relaxed)) {
+            case ClockSource::tsc:
+                return read_tick_counter();
+            case ClockSource::monotonic_coarse:
+                return read_coarse_clock();
+            case ClockSource::system:
+                break;
+        }
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // Select the clock and anchor it to the system clock. A tsc source falls back to monotonic_coarse
+    // where there is no usable counter. Called by init() before any record is captured.
+    void calibrate_record_clock(ClockSource source);
+
+    // Record timestamp -> system_clock nanoseconds since the epoch (async-signal-safe)
+    std::int64_t record_time_ns(std::int64_t timestamp) noexcept;
+
+} // namespace aknet::log::detail
+
+#endif // AKNET_RECORD_CLOCK_H
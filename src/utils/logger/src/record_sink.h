@@ -0,0 +1,29 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_RECORD_SINK_H
+#define AKNET_RECORD_SINK_H
+
+#pragma once
+
+#include "log_record.h"
+
+namespace aknet::log::detail {
+
+    // -------------------------------------------------------------------------
+    // RecordSink: receives the raw records drained by the async backend,
+    // next to the spdlog sinks that receive the formatted text.
+    // Only called from the consumer side (one thread at a time).
+    // -------------------------------------------------------------------------
+    class RecordSink {
+    public:
+        virtual ~RecordSink() = default;
+
+        virtual void write(const Record& rec) = 0;
+        virtual void flush() = 0;
+    };
+
+} // namespace aknet::log::detail
+
+#endif // AKNET_RECORD_SINK_H
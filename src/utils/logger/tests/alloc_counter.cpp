@@ -0,0 +1,56 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "alloc_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+// Replacement global allocation functions that count allocations per thread.
+// Only linked into test executables, never into the libraries.
+
+namespace {
+    thread_local std::size_t t_alloc_count = 0;
+
+    void* counted_alloc(std::size_t size) {
+        ++t_alloc_count;
+        if (size == 0) size = 1;
+        if (void* p = std::malloc(size)) return p;
+        throw std::bad_alloc();
+    }
+
+    void* counted_aligned_alloc(std::size_t size, std::align_val_t al) {
+        ++t_alloc_count;
+        const auto alignment = static_cast<std::size_t>(al);
+        size = (size + alignment - 1) / alignment * alignment;
+        if (size == 0) size = alignment;
+        if (void* p = std::aligned_alloc(alignment, size)) return p;
+        throw std::bad_alloc();
+    }
+}
+
+namespace aknet::test {
+    std::size_t thread_alloc_count() noexcept { return t_alloc_count; }
+}
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void* operator new(std::size_t size, std::align_val_t al) { return counted_aligned_alloc(size, al); }
+void* operator new[](std::size_t size, std::align_val_t al) { return counted_aligned_alloc(size, al); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return counted_alloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return counted_alloc(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
@@ -0,0 +1,30 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_ALLOC_COUNTER_H
+#define AKNET_ALLOC_COUNTER_H
+
+#pragma once
+
+#include <cstddef>
+
+namespace aknet::test {
+
+    // Number of calls to the global operator new made by the calling thread so far.
+    // Backed by replacement operator new/delete in alloc_counter.cpp (test executables only).
+    std::size_t thread_alloc_count() noexcept;
+
+    // Counts the allocations made by the calling thread between construction and count()
+    class AllocCounter {
+    public:
+        AllocCounter() noexcept : start_(thread_alloc_count()) {}
+        std::size_t count() const noexcept { return thread_alloc_count() - start_; }
+
+    private:
+        std::size_t start_;
+    };
+
+} // namespace aknet::test
+
+#endif // AKNET_ALLOC_COUNTER_H
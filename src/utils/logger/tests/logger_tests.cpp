@@ -4,12 +4,25 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
+#include <csignal>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <thread>
 
 #include <logger.h>
+#include <binary_log.h>
+#include <log_archive.h>
+#include <log_index.h>
+
+#include "alloc_counter.h"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <spdlog/spdlog.h>
 
@@ -35,6 +48,83 @@ public:
     const fs::path& path() const { return path_; }
 };
 
+// Helper to count the lines of the session log file in a directory that contain a string
+int count_log_lines(const fs::path& dir, const std::string& needle) {
+    for (const auto &entry: fs::directory_iterator(dir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".log") {
+            std::ifstream file(entry.path());
+            std::string line;
+            int count = 0;
+            while (std::getline(file, line)) {
+                if (line.find(needle) != std::string::npos) count++;
+            }
+            return count;
+        }
+    }
+    return -1;
+}
+
+// Helper to find the files with a given extension in a directory, sorted by name
+std::vector<fs::path> files_with_extension(const fs::path& dir, const std::string& extension) {
+    std::vector<fs::path> files;
+    for (const auto &entry: fs::directory_iterator(dir)) {
+        if (entry.is_regular_file() && entry.path().extension() == extension) files.push_back(entry.path());
+    }
+    std::ranges::sort(files);
+    return files;
+}
+
+// Helper to read all the lines of a file (compressed segments included)
+std::vector<std::string> read_lines(const fs::path& path) {
+    const auto file = log::archive::open(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(*file, line)) lines.push_back(line);
+    return lines;
+}
+
+// Helper to decode every record of a binary log file into text lines
+std::vector<std::string> decode_binary_log(const fs::path& path) {
+    log::binary::Reader reader(path);
+    log::binary::DecodedRecord record;
+    std::vector<std::string> lines;
+    while (reader.next(record)) lines.push_back(log::binary::format_text_line(record));
+    return lines;
+}
+
+// Recurse until the stack overflows (SIGSEGV on the guard page)
+[[gnu::noinline]] int overflow_stack(int depth) {
+    volatile char frame[1024];
+    frame[0] = static_cast<char>(depth);
+    if (depth < 0) return 0; // never: the stack runs out first
+    return overflow_stack(depth + 1) + frame[0];
+}
+
+// Trivially copyable type with a formatter: captured by value in async mode
+struct Point {
+    int x;
+    int y;
+};
+
+template <>
+struct std::formatter<Point> : std::formatter<std::string_view> {
+    auto format(const Point& p, std::format_context& ctx) const {
+        return std::format_to(ctx.out(), "({}, {})", p.x, p.y);
+    }
+};
+
+// Non-trivially copyable type with a formatter: formatted on the caller thread in async mode
+struct Tag {
+    std::string name;
+};
+
+template <>
+struct std::formatter<Tag> : std::formatter<std::string_view> {
+    auto format(const Tag& t, std::format_context& ctx) const {
+        return std::format_to(ctx.out(), "<{}>", t.name);
+    }
+};
+
 // ------------------------------------------------------------------------------------------------
 // Tests
 // ------------------------------------------------------------------------------------------------
@@ -217,6 +307,89 @@ TEST_CASE("Logger | Logger creation", "[logger]") {
         log::shutdown();
     }
 
+    SECTION("string_view, std::string and literal names find the same logger") {
+
+        log::init(temp_dir.path());
+
+        const std::string name = "test_name";
+        auto from_string = log::get(name);
+        auto from_view = log::get(std::string_view(name));
+        auto from_literal = log::get("test_name");
+
+        REQUIRE(from_string.get() == from_view.get());
+        REQUIRE(from_string.get() == from_literal.get());
+
+        log::shutdown();
+    }
+
+    SECTION("concurrent first calls for the same name return the same logger") {
+
+        log::init(temp_dir.path());
+
+        constexpr int n_threads = 8;
+        std::vector<std::shared_ptr<log::Logger>> results(n_threads);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < n_threads; t++) {
+            threads.emplace_back([&results, t] {
+                results[t] = log::get("shared");
+                for (int i = 0; i < 100; i++) log::get(std::format("thread_{}_{}", t, i % 4));
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        for (const auto& result : results) {
+            REQUIRE(result.get() == results[0].get());
+        }
+        REQUIRE(log::get("thread_3_2").get() == log::get("thread_3_2").get());
+
+        log::shutdown();
+    }
+
+    SECTION("looking up an existing logger does not allocate") {
+
+        log::init(temp_dir.path());
+
+        auto test_logger = log::get("test");
+        const std::string_view name = "test";
+
+        const test::AllocCounter counter;
+        auto found = log::get(name);
+        const auto allocations = counter.count();
+
+        REQUIRE(found.get() == test_logger.get());
+        REQUIRE(allocations == 0);
+
+        log::shutdown();
+    }
+
+    SECTION("lookups racing with shutdown return a live logger or throw") {
+
+        std::atomic<bool> stop{false};
+        std::atomic<int> found{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&stop, &found] {
+                while (!stop.load()) {
+                    try {
+                        if (log::get("racing")->should_log(log::LogLevel::info)) found++;
+                    } catch (const std::runtime_error&) {
+                        // Not initialized between shutdown() and the next init()
+                    }
+                }
+            });
+        }
+
+        for (int cycle = 0; cycle < 20; cycle++) {
+            log::init(temp_dir.path());
+            log::get("racing");
+            while (found.load() == 0) std::this_thread::yield();
+            log::shutdown();
+            found = 0;
+        }
+        stop = true;
+        for (auto& thread : threads) thread.join();
+    }
+
 }
 
 TEST_CASE("Logger | Log level", "[logger]") {
@@ -738,5 +911,1404 @@ TEST_CASE("Logger | Edge cases ", "[logger]") {
     }
 }
 
+TEST_CASE("Logger | Filtered calls", "[logger]") {
+
+    const TempDir temp_dir;
+
+    SECTION("should_log follows set_level") {
+        log::init(temp_dir.path());
+
+        auto test_logger = log::get("test");
+        CHECK(test_logger->should_log(log::LogLevel::trace));
+
+        test_logger->set_level(log::LogLevel::warn);
+
+        REQUIRE_FALSE(test_logger->should_log(log::LogLevel::info));
+        REQUIRE(test_logger->should_log(log::LogLevel::warn));
+        REQUIRE(test_logger->should_log(log::LogLevel::critical));
+
+        log::shutdown();
+    }
+
+    SECTION("should_log follows set_global_log_level") {
+        log::init(temp_dir.path());
+
+        auto test_logger = log::get("test");
+        log::set_global_log_level(log::LogLevel::error);
+
+        REQUIRE_FALSE(test_logger->should_log(log::LogLevel::warn));
+        REQUIRE(test_logger->should_log(log::LogLevel::error));
+
+        log::set_global_log_level(log::LogLevel::trace);
+
+        REQUIRE(test_logger->should_log(log::LogLevel::trace));
+
+        log::shutdown();
+    }
+
+    SECTION("LogLevel::off filters every level") {
+        log::init(temp_dir.path());
+
+        auto test_logger = log::get("test");
+        test_logger->set_level(log::LogLevel::off);
+
+        REQUIRE_FALSE(test_logger->should_log(log::LogLevel::critical));
+
+        log::shutdown();
+    }
+
+    SECTION("filtered calls do not allocate") {
+        log::init(temp_dir.path());
+
+        auto test_logger = log::get("test");
+        test_logger->set_level(log::LogLevel::warn);
+
+        const std::string long_arg(256, 'x');
+
+        const test::AllocCounter counter;
+        for (int i = 0; i < 1000; i++) {
+            test_logger->trace("value {} and a long string {}", i, long_arg);
+            test_logger->debug("value {}", 3.14);
+            test_logger->info("{} {} {}", long_arg, long_arg, long_arg);
+        }
+        const auto allocations = counter.count();
+
+        REQUIRE(allocations == 0);
+
+        log::shutdown();
+    }
+
+    SECTION("moved-from loggers filter everything") {
+        log::init(temp_dir.path());
+
+        auto test_logger = log::get("test");
+        log::Logger moved_to = std::move(*test_logger);
+
+        REQUIRE(moved_to.should_log(log::LogLevel::trace));
+        REQUIRE_FALSE(test_logger->should_log(log::LogLevel::critical));
+
+        log::shutdown();
+    }
+}
+
+TEST_CASE("Logger | Compile-time level floor", "[logger]") {
+
+    const TempDir temp_dir;
+
+    // Counts how many times an argument expression is evaluated
+    int evaluations = 0;
+    auto expensive = [&evaluations] { return ++evaluations; };
+
+    SECTION("compiled_in compares a level against the floor") {
+        STATIC_REQUIRE(log::compiled_in<log::LogLevel::warn, log::LogLevel::info>);
+        STATIC_REQUIRE(log::compiled_in<log::LogLevel::info, log::LogLevel::info>);
+        STATIC_REQUIRE_FALSE(log::compiled_in<log::LogLevel::debug, log::LogLevel::info>);
+        STATIC_REQUIRE(log::compiled_in<log::min_log_level>);
+    }
+
+    SECTION("calls below the floor are not evaluated and not written") {
+        log::init(temp_dir.path());
+
+        auto test_logger = log::get("test");
+
+        AKNET_LOG_IF(log::LogLevel::warn, log::LogLevel::trace, trace, test_logger, "below floor {}", expensive());
+        AKNET_LOG_IF(log::LogLevel::warn, log::LogLevel::info, info, test_logger, "below floor {}", expensive());
+        test_logger->flush();
+
+        REQUIRE(evaluations == 0);
+        REQUIRE(count_log_lines(temp_dir.path(), "below floor") == 0);
+
+        log::shutdown();
+    }
+
+    SECTION("calls at or above the floor are evaluated and written") {
+        log::init(temp_dir.path());
+
+        auto test_logger = log::get("test");
+
+        AKNET_LOG_IF(log::LogLevel::warn, log::LogLevel::warn, warn, test_logger, "above floor {}", expensive());
+        AKNET_LOG_IF(log::LogLevel::warn, log::LogLevel::error, error, test_logger, "above floor {}", expensive());
+        test_logger->flush();
+
+        REQUIRE(evaluations == 2);
+        REQUIRE(count_log_lines(temp_dir.path(), "above floor") == 2);
+
+        log::shutdown();
+    }
+
+    SECTION("runtime levels still filter above the floor") {
+        log::init(temp_dir.path());
+
+        auto test_logger = log::get("test");
+        test_logger->set_level(log::LogLevel::error);
+
+        AKNET_LOG_IF(log::LogLevel::warn, log::LogLevel::warn, warn, test_logger, "runtime filtered {}", expensive());
+        AKNET_LOG_IF(log::LogLevel::warn, log::LogLevel::error, error, test_logger, "runtime kept {}", expensive());
+
+        log::set_global_log_level(log::LogLevel::critical);
+        AKNET_LOG_IF(log::LogLevel::warn, log::LogLevel::error, error, test_logger, "global filtered {}", expensive());
+        test_logger->flush();
+
+        REQUIRE(evaluations == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "runtime filtered") == 0);
+        REQUIRE(count_log_lines(temp_dir.path(), "runtime kept") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "global filtered") == 0);
+
+        log::shutdown();
+    }
+
+    SECTION("level macros use the build's floor") {
+        log::init(temp_dir.path());
+
+        auto test_logger = log::get("test");
+
+        AKNET_LOG_TRACE(test_logger, "macro trace {}", expensive());
+        AKNET_LOG_CRITICAL(test_logger, "macro critical {}", expensive());
+        test_logger->flush();
+
+        const int expected = log::compiled_in<log::LogLevel::trace> ? 2 : 1;
+        REQUIRE(evaluations == expected);
+        REQUIRE(count_log_lines(temp_dir.path(), "macro trace") == expected - 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "macro critical") == 1);
+
+        log::shutdown();
+    }
+}
+
+TEST_CASE("Logger | Binary log", "[logger]") {
+
+    const TempDir temp_dir;
+
+    SECTION("decoded binary log matches the text log line for line") {
+        log::init(temp_dir.path(), {.binary = {.enabled = true}});
+
+        auto logger_a = log::get("binary_a");
+        auto logger_b = log::get("a_much_longer_logger_name");
+
+        const std::string owned = "owned string";
+        logger_a->trace("plain message");
+        logger_a->debug("ints {} {} {} {}", -42, 42u, std::int64_t{-1} << 40, static_cast<std::uint8_t>(200));
+        logger_a->info("floats {} {} {:.3f} {:e}", 0.1f, 0.1, 3.14159, 12345.678);
+        logger_a->warn("strings {} {} {:>12}|{:<6}|", owned, std::string_view("view"), "right", "left");
+        logger_b->error("misc {} {} {:#x} {:08b} {{escaped}}", true, 'c', 255, 5);
+        logger_b->critical("nested {:>{}}|{:.{}f}|", 7, 5, 2.5, 3);
+        logger_b->info("user types {} {}", Point{3, 4}, Tag{"tag"});
+        logger_a->info("no args, {{braces}}");
+
+        log::shutdown();
+
+        const auto text_files = files_with_extension(temp_dir.path(), ".log");
+        const auto binary_files = files_with_extension(temp_dir.path(), ".aklog");
+        REQUIRE(text_files.size() == 1);
+        REQUIRE(binary_files.size() == 1);
+
+        const auto text_lines = read_lines(text_files[0]);
+        const auto decoded_lines = decode_binary_log(binary_files[0]);
+
+        REQUIRE(text_lines.size() == 8);
+        REQUIRE(decoded_lines == text_lines);
+    }
+
+    SECTION("binary log can replace the text sinks") {
+        log::init(temp_dir.path(), {.binary = {.enabled = true, .text_sinks = false}});
+
+        auto test_logger = log::get("test");
+        test_logger->info("binary only {}", 1);
+        test_logger->flush();
+
+        const auto binary_files = files_with_extension(temp_dir.path(), ".aklog");
+        REQUIRE(binary_files.size() == 1);
+
+        const auto lines = decode_binary_log(binary_files[0]);
+        REQUIRE(lines.size() == 1);
+        REQUIRE(lines[0].ends_with("[      test] [    info] binary only 1"));
+
+        log::shutdown();
+
+        REQUIRE(files_with_extension(temp_dir.path(), ".log").empty());
+    }
+
+    SECTION("rotated binary files decode on their own") {
+        log::init(temp_dir.path(), {.binary = {.enabled = true, .text_sinks = false, .max_file_size = 1024, .max_files = 20},
+                                    .archive = {.enabled = false}});
+
+        auto test_logger = log::get("test");
+        for (int i = 0; i < 200; i++) {
+            test_logger->info("rotation record {}", i);
+        }
+
+        log::shutdown();
+
+        const auto binary_files = files_with_extension(temp_dir.path(), ".aklog");
+        REQUIRE(binary_files.size() > 2);
+
+        std::size_t total = 0;
+        for (const auto& file : binary_files) {
+            const auto lines = decode_binary_log(file);
+            for (const auto& line : lines) {
+                REQUIRE(line.find("[      test] [    info] rotation record ") != std::string::npos);
+            }
+            total += lines.size();
+        }
+        REQUIRE(total == 200);
+    }
+
+    SECTION("reading a file that is not a binary log throws") {
+        log::init(temp_dir.path());
+        log::shutdown();
+
+        const auto text_files = files_with_extension(temp_dir.path(), ".log");
+        REQUIRE(text_files.size() == 1);
+        REQUIRE_THROWS_AS(log::binary::Reader(text_files[0]), std::runtime_error);
+    }
+}
+
+TEST_CASE("Logger | Async mode", "[logger]") {
+
+    const TempDir temp_dir;
+
+    SECTION("records reach the log file after flush") {
+        log::init(temp_dir.path(), {.async = {.enabled = true}});
+
+        auto test_logger = log::get("test");
+        test_logger->info("async hello {}", 42);
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "async hello 42") == 1);
+
+        log::shutdown();
+    }
+
+    SECTION("shutdown drains pending records") {
+        log::init(temp_dir.path(), {.async = {.enabled = true, .poll_interval = std::chrono::hours(1)}});
+
+        auto test_logger = log::get("test");
+        for (int i = 0; i < 10; i++) {
+            test_logger->info("pending {}", i);
+        }
+
+        log::shutdown();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "pending") == 10);
+    }
+
+    SECTION("records from other threads are drained") {
+        log::init(temp_dir.path(), {.async = {.enabled = true}});
+
+        auto test_logger = log::get("test");
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&test_logger, t] {
+                for (int i = 0; i < 100; i++) test_logger->info("thread {} message {}", t, i);
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "message") == 400);
+        REQUIRE(log::dropped_messages() == 0);
+
+        log::shutdown();
+    }
+
+    SECTION("long messages are truncated to the record size") {
+        log::init(temp_dir.path(), {.async = {.enabled = true}});
+
+        auto test_logger = log::get("test");
+        test_logger->info("long {}", std::string(1000, 'y'));
+        test_logger->info("long eager {}", Tag{std::string(1000, 'y')});
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "long yyy") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "long eager <yyy") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), std::string(1000, 'y')) == 0);
+
+        log::shutdown();
+    }
+
+    SECTION("the drop policy discards new records and counts them") {
+        log::init(temp_dir.path(), {.async = {
+            .enabled = true, .ring_capacity = 8, .overflow = log::OverflowPolicy::drop,
+            .poll_interval = std::chrono::hours(1)}});
+
+        auto test_logger = log::get("test");
+        for (int i = 0; i < 20; i++) {
+            test_logger->info("record {:02}", i);
+        }
+        REQUIRE(log::dropped_messages() == 12);
+
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "record 07") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "record 08") == 0);
+
+        log::shutdown();
+    }
+
+    SECTION("the overwrite policy keeps the newest records") {
+        log::init(temp_dir.path(), {.async = {
+            .enabled = true, .ring_capacity = 8, .overflow = log::OverflowPolicy::overwrite_oldest,
+            .poll_interval = std::chrono::hours(1)}});
 
+        auto test_logger = log::get("test");
+        for (int i = 0; i < 20; i++) {
+            test_logger->info("record {:02}", i);
+        }
+        REQUIRE(log::dropped_messages() == 12);
+
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "record 11") == 0);
+        REQUIRE(count_log_lines(temp_dir.path(), "record 12") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "record 19") == 1);
+
+        log::shutdown();
+    }
 
+    SECTION("overwritten records are never read half written, and each loss is counted once") {
+        log::init(temp_dir.path(), {.async = {
+            .enabled = true, .ring_capacity = 8, .overflow = log::OverflowPolicy::overwrite_oldest,
+            .poll_interval = std::chrono::microseconds(50)}});
+
+        // The backend drains while the producer laps it; flush() from another thread consumes as well
+        auto test_logger = log::get("test");
+        std::atomic<bool> done{false};
+        std::thread flusher([&] {
+            while (!done) test_logger->flush();
+        });
+        constexpr int total = 20000;
+        for (int i = 0; i < total; i++) {
+            test_logger->info("race {:05} {}", i, std::string(150, static_cast<char>('0' + i % 10)));
+            if (i % 8 == 0) std::this_thread::yield();
+        }
+        done = true;
+        flusher.join();
+        test_logger->flush();
+
+        int read = 0;
+        for (const auto& line : read_lines(files_with_extension(temp_dir.path(), ".log")[0])) {
+            const auto at = line.find("race ");
+            if (at == std::string::npos) continue;
+            const int i = std::stoi(line.substr(at + 5, 5));
+            REQUIRE(line.substr(at + 11) == std::string(150, static_cast<char>('0' + i % 10)));
+            read++;
+        }
+        REQUIRE(read > 100);
+        REQUIRE(read + static_cast<int>(log::dropped_messages()) == total);
+
+        log::shutdown();
+    }
+
+    SECTION("deferred formatting matches std::format") {
+        log::init(temp_dir.path(), {.async = {.enabled = true, .poll_interval = std::chrono::hours(1)}});
+
+        auto test_logger = log::get("test");
+        {
+            // Temporaries are gone before the backend formats the record
+            std::string text = "owned";
+            const char* c_str = "c string";
+            test_logger->info("strings: {} {} {} {}", text, std::string_view("view"), c_str, std::string("temp"));
+            text = "changed";
+        }
+        test_logger->info("numbers: {:>5}|{:.2f}|{:#x}|{}|{}", 42, 3.14159, 255u, true, 'c');
+        test_logger->info("user types: {} {}", Point{1, 2}, Tag{"tag"});
+        test_logger->info("no arguments");
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "strings: owned view c string temp") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), std::format("numbers: {:>5}|{:.2f}|{:#x}|{}|{}", 42, 3.14159, 255u, true, 'c')) == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "user types: (1, 2) <tag>") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "no arguments") == 1);
+
+        log::shutdown();
+    }
+
+    SECTION("truncated strings leave room for the following arguments") {
+        log::init(temp_dir.path(), {.async = {.enabled = true}});
+
+        auto test_logger = log::get("test");
+        test_logger->info("{} {} end={}", std::string(1000, 'z'), std::string(1000, 'w'), 12345);
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "end=12345") == 1);
+
+        log::shutdown();
+    }
+
+    SECTION("producer calls do not allocate") {
+        log::init(temp_dir.path(), {.async = {.enabled = true, .ring_capacity = 4096}});
+
+        auto test_logger = log::get("test");
+        log::preallocate_thread_buffer();
+
+        const std::string text = "a string that does not fit in the small string buffer";
+
+        const test::AllocCounter counter;
+        for (int i = 0; i < 1000; i++) {
+            test_logger->info("value {} {} {} {}", i, 2.5, "text", text);
+        }
+        const auto allocations = counter.count();
+
+        REQUIRE(allocations == 0);
+
+        log::shutdown();
+    }
+
+    SECTION("set_level still filters in async mode") {
+        log::init(temp_dir.path(), {.async = {.enabled = true}});
+
+        auto test_logger = log::get("test");
+        test_logger->set_level(log::LogLevel::warn);
+        test_logger->info("filtered");
+        test_logger->warn("kept");
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "filtered") == 0);
+        REQUIRE(count_log_lines(temp_dir.path(), "kept") == 1);
+
+        log::shutdown();
+    }
+
+    SECTION("producers racing with shutdown do not use a deleted backend") {
+        std::atomic<bool> stop{false};
+        std::atomic<int> logged{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&stop, &logged] {
+                while (!stop.load()) {
+                    try {
+                        auto test_logger = log::get("racing");
+                        test_logger->info("racing record");
+                        test_logger->flush();
+                        logged++;
+                    } catch (const std::runtime_error&) {
+                        // Not initialized between shutdown() and the next init()
+                    }
+                }
+            });
+        }
+
+        for (int cycle = 0; cycle < 20; cycle++) {
+            log::init(temp_dir.path(), {.async = {.enabled = true}});
+            while (logged.load() == 0) std::this_thread::yield();
+            log::shutdown();
+            logged = 0;
+        }
+        stop = true;
+        for (auto& thread : threads) thread.join();
+    }
+}
+
+TEST_CASE("Logger | Record clock", "[logger]") {
+
+    const TempDir temp_dir;
+
+    const auto system_ns = [] {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    };
+
+    for (const auto source : {log::ClockSource::system, log::ClockSource::monotonic_coarse, log::ClockSource::tsc}) {
+        DYNAMIC_SECTION("binary records are stamped in system time, clock source " << static_cast<int>(source)) {
+            log::init(temp_dir.path(), {.binary = {.enabled = true, .text_sinks = false}, .clock = source});
+
+            auto test_logger = log::get("test");
+            const auto before = system_ns();
+            for (int i = 0; i < 100; i++) test_logger->info("stamped {}", i);
+            const auto after = system_ns();
+            log::shutdown();
+
+            const auto binary_files = files_with_extension(temp_dir.path(), ".aklog");
+            REQUIRE(binary_files.size() == 1);
+
+            // The coarse clock lags by up to a kernel tick; leave room for that and the counter calibration
+            constexpr std::int64_t tolerance_ns = 20'000'000;
+            log::binary::Reader reader(binary_files[0]);
+            log::binary::DecodedRecord record;
+            std::int64_t previous = 0;
+            int count = 0;
+            while (reader.next(record)) {
+                REQUIRE(record.timestamp_ns >= before - tolerance_ns);
+                REQUIRE(record.timestamp_ns <= after + tolerance_ns);
+                REQUIRE(record.timestamp_ns >= previous);
+                previous = record.timestamp_ns;
+                count++;
+            }
+            REQUIRE(count == 100);
+        }
+    }
+}
+
+TEST_CASE("Logger | Flight recorder", "[logger]") {
+
+    const TempDir temp_dir;
+
+    SECTION("levels filtered out of the sinks are recorded and dumped on demand") {
+        log::init(temp_dir.path(), {.flight_recorder = {.enabled = true}});
+
+        auto test_logger = log::get("test");
+        test_logger->set_level(log::LogLevel::warn);
+        REQUIRE(test_logger->should_log(log::LogLevel::trace));
+
+        test_logger->trace("recorded trace {}", 1);
+        test_logger->debug("recorded debug {}", "two");
+        test_logger->warn("recorded warn {}", 3.5);
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "recorded trace") == 0);
+        REQUIRE(count_log_lines(temp_dir.path(), "recorded warn 3.5") == 1);
+
+        const auto dump = log::dump_flight_recorder();
+        REQUIRE(fs::exists(dump));
+        REQUIRE(dump.parent_path() == temp_dir.path());
+
+        const auto lines = decode_binary_log(dump);
+        REQUIRE(lines.size() == 3);
+        REQUIRE(lines[0].ends_with("[   trace] recorded trace 1"));
+        REQUIRE(lines[1].ends_with("[   debug] recorded debug two"));
+        REQUIRE(lines[2].ends_with("[ warning] recorded warn 3.5"));
+
+        log::shutdown();
+    }
+
+    SECTION("the recorder level is independent of the sink levels") {
+        log::init(temp_dir.path(), {.flight_recorder = {.enabled = true, .level = log::LogLevel::info}});
+
+        auto test_logger = log::get("test");
+        test_logger->set_level(log::LogLevel::error);
+        REQUIRE_FALSE(test_logger->should_log(log::LogLevel::debug));
+        REQUIRE(test_logger->should_log(log::LogLevel::info));
+
+        test_logger->debug("not recorded");
+        test_logger->info("recorded info");
+
+        const auto lines = decode_binary_log(log::dump_flight_recorder());
+        REQUIRE(lines.size() == 1);
+        REQUIRE(lines[0].ends_with("recorded info"));
+
+        log::shutdown();
+    }
+
+    SECTION("shutdown writes a dump") {
+        log::init(temp_dir.path(), {.flight_recorder = {.enabled = true}});
+
+        auto test_logger = log::get("test");
+        test_logger->info("before shutdown {}", Tag{"user type"});
+        log::shutdown();
+
+        const auto dumps = files_with_extension(temp_dir.path(), ".aklog");
+        REQUIRE(dumps.size() == 1);
+
+        const auto lines = decode_binary_log(dumps[0]);
+        REQUIRE(lines.size() == 1);
+        REQUIRE(lines[0].ends_with("before shutdown <user type>"));
+    }
+
+    SECTION("each thread keeps its latest records") {
+        log::init(temp_dir.path(), {.flight_recorder = {.enabled = true, .records_per_thread = 16}});
+
+        auto test_logger = log::get("test");
+        for (int i = 0; i < 100; i++) {
+            test_logger->trace("record {}", i);
+        }
+
+        const auto lines = decode_binary_log(log::dump_flight_recorder());
+        REQUIRE(lines.size() == 16);
+        REQUIRE(lines.front().ends_with("record 84"));
+        REQUIRE(lines.back().ends_with("record 99"));
+
+        log::shutdown();
+    }
+
+    SECTION("records of several threads are merged in time order, exited threads included") {
+        log::init(temp_dir.path(), {.flight_recorder = {.enabled = true}});
+
+        auto test_logger = log::get("test");
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&test_logger, t] {
+                for (int i = 0; i < 50; i++) test_logger->trace("thread {} record {}", t, i);
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        log::binary::Reader reader(log::dump_flight_recorder());
+        log::binary::DecodedRecord record;
+        std::int64_t previous = 0;
+        int count = 0;
+        while (reader.next(record)) {
+            REQUIRE(record.timestamp_ns >= previous);
+            previous = record.timestamp_ns;
+            count++;
+        }
+        REQUIRE(count == 200);
+
+        log::shutdown();
+    }
+
+    SECTION("threads beyond max_threads are not recorded") {
+        log::init(temp_dir.path(), {.flight_recorder = {.enabled = true, .max_threads = 1}});
+
+        auto test_logger = log::get("test");
+        test_logger->trace("main thread");
+        std::thread([&test_logger] { test_logger->trace("other thread"); }).join();
+
+        const auto lines = decode_binary_log(log::dump_flight_recorder());
+        REQUIRE(lines.size() == 1);
+        REQUIRE(lines[0].ends_with("main thread"));
+
+        log::shutdown();
+    }
+
+    SECTION("recording does not allocate") {
+        log::init(temp_dir.path(), {.flight_recorder = {.enabled = true}});
+
+        auto test_logger = log::get("test");
+        test_logger->set_level(log::LogLevel::off);
+        test_logger->trace("first call claims the thread's ring");
+
+        const std::string text = "a string that does not fit in the small string buffer";
+
+        const test::AllocCounter counter;
+        for (int i = 0; i < 1000; i++) {
+            test_logger->trace("value {} {} {} {}", i, 2.5, "text", text);
+        }
+        const auto allocations = counter.count();
+
+        REQUIRE(allocations == 0);
+
+        log::shutdown();
+    }
+
+    SECTION("disabled recorder records nothing") {
+        log::init(temp_dir.path());
+
+        auto test_logger = log::get("test");
+        test_logger->set_level(log::LogLevel::warn);
+        REQUIRE_FALSE(test_logger->should_log(log::LogLevel::trace));
+        REQUIRE(log::dump_flight_recorder().empty());
+
+        log::shutdown();
+        REQUIRE(files_with_extension(temp_dir.path(), ".aklog").empty());
+    }
+
+    SECTION("a fatal signal writes a dump") {
+        const pid_t pid = fork();
+        REQUIRE(pid >= 0);
+
+        if (pid == 0) {
+            std::signal(SIGSEGV, SIG_DFL); // chain to the default action rather than to Catch's handler
+            log::init(temp_dir.path(), {.flight_recorder = {.enabled = true}});
+            log::get("test")->trace("last words {}", 42);
+            std::raise(SIGSEGV);
+            _exit(0); // not reached
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        REQUIRE(WIFSIGNALED(status));
+        REQUIRE(WTERMSIG(status) == SIGSEGV);
+
+        const auto dumps = files_with_extension(temp_dir.path(), ".aklog");
+        REQUIRE(dumps.size() == 1);
+
+        const auto lines = decode_binary_log(dumps[0]);
+        REQUIRE(lines.size() == 1);
+        REQUIRE(lines[0].ends_with("last words 42"));
+    }
+
+    SECTION("a stack overflow writes a dump, from the alternate signal stack") {
+        const pid_t pid = fork();
+        REQUIRE(pid >= 0);
+
+        if (pid == 0) {
+            std::signal(SIGSEGV, SIG_DFL);
+            log::init(temp_dir.path(), {.flight_recorder = {.enabled = true}});
+            std::thread([] {
+                log::get("test")->trace("before the overflow");
+                overflow_stack(0);
+            }).join();
+            _exit(0); // not reached
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        REQUIRE(WIFSIGNALED(status));
+        REQUIRE(WTERMSIG(status) == SIGSEGV);
+
+        const auto dumps = files_with_extension(temp_dir.path(), ".aklog");
+        REQUIRE(dumps.size() == 1);
+        REQUIRE(decode_binary_log(dumps[0]).at(0).ends_with("before the overflow"));
+    }
+}
+
+TEST_CASE("Logger | Batched file sink", "[logger]") {
+
+    const TempDir temp_dir;
+
+    SECTION("lines wait in memory until flush") {
+        log::init(temp_dir.path(), {.file = {.max_latency = std::chrono::hours(1)}});
+
+        auto test_logger = log::get("test");
+        test_logger->info("pending line");
+        REQUIRE(count_log_lines(temp_dir.path(), "pending line") == 0);
+
+        test_logger->flush();
+        REQUIRE(count_log_lines(temp_dir.path(), "pending line") == 1);
+
+        log::shutdown();
+    }
+
+    SECTION("pending lines are written after max_latency") {
+        log::init(temp_dir.path(), {.file = {.max_latency = std::chrono::milliseconds(10)}});
+
+        auto test_logger = log::get("test");
+        test_logger->info("late line");
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (count_log_lines(temp_dir.path(), "late line") == 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        REQUIRE(count_log_lines(temp_dir.path(), "late line") == 1);
+
+        log::shutdown();
+    }
+
+    SECTION("a full batch is written without waiting for max_latency") {
+        log::init(temp_dir.path(), {.file = {.batch_size = 1024, .max_latency = std::chrono::hours(1)}});
+
+        auto test_logger = log::get("test");
+        for (int i = 0; i < 100; i++) {
+            test_logger->info("batch line {}", i);
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (count_log_lines(temp_dir.path(), "batch line") == 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        REQUIRE(count_log_lines(temp_dir.path(), "batch line") > 0);
+
+        log::shutdown();
+    }
+
+    SECTION("lines from concurrent threads are written whole") {
+        log::init(temp_dir.path(), {.file = {.batch_size = 4096}, .console = false});
+
+        auto test_logger = log::get("test");
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&test_logger, t] {
+                for (int i = 0; i < 1000; i++) test_logger->info("thread {} line {} end", t, i);
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), " end") == 4000);
+        REQUIRE(count_log_lines(temp_dir.path(), "thread 3 line 999 end") == 1);
+
+        log::shutdown();
+    }
+
+    SECTION("files rotate at max_file_size") {
+        log::init(temp_dir.path(), {.file = {.batch_size = 512, .max_file_size = 4096, .max_files = 2},
+                                    .archive = {.enabled = false}, .console = false});
+
+        auto test_logger = log::get("test");
+        for (int i = 0; i < 500; i++) {
+            test_logger->info("rotation line {}", i);
+            if (i % 10 == 0) test_logger->flush();
+        }
+        test_logger->flush();
+
+        const auto files = files_with_extension(temp_dir.path(), ".log");
+        REQUIRE(files.size() == 3);
+        for (const auto& file : files) {
+            REQUIRE(fs::file_size(file) <= 4096 + 1024);
+        }
+
+        log::shutdown();
+    }
+
+    SECTION("preallocation does not change the visible file size") {
+        log::init(temp_dir.path(), {.console = false});
+
+        auto test_logger = log::get("test");
+        test_logger->info("short line");
+        test_logger->flush();
+
+        const auto files = files_with_extension(temp_dir.path(), ".log");
+        REQUIRE(files.size() == 1);
+        REQUIRE(fs::file_size(files[0]) == read_lines(files[0])[0].size() + 1);
+
+        log::shutdown();
+    }
+
+    SECTION("batches that fail to write are counted and left out of the index") {
+        log::init(temp_dir.path(), {.file = {.index_block_size = 256}, .console = false});
+        auto test_logger = log::get("test");
+        test_logger->info("line before the limit");
+        test_logger->flush();
+        REQUIRE(log::failed_file_writes() == 0);
+
+        // The file cannot grow past 4 KiB: writes beyond fail (EFBIG) as on a full disk
+        const auto previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+        rlimit previous_limit{};
+        ::getrlimit(RLIMIT_FSIZE, &previous_limit);
+        rlimit limit = previous_limit;
+        limit.rlim_cur = 4096;
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+        for (int i = 0; i < 100; i++) {
+            test_logger->info("line {} past the limit", i);
+            if (i % 10 == 0) test_logger->flush();
+        }
+        test_logger->flush();
+        const auto failed = log::failed_file_writes();
+        log::shutdown();
+        test_logger.reset();
+        ::setrlimit(RLIMIT_FSIZE, &previous_limit);
+        std::signal(SIGXFSZ, previous_handler);
+
+        REQUIRE(failed > 0);
+        const auto log_file = files_with_extension(temp_dir.path(), ".log").at(0);
+        REQUIRE(fs::file_size(log_file) <= 4096);
+        const log::index::Index index(log::index::index_path(log_file));
+        REQUIRE_FALSE(index.blocks().empty());
+        for (const auto& block : index.blocks()) REQUIRE(block.offset + block.size <= fs::file_size(log_file));
+    }
+
+    SECTION("the spdlog rotating sink is still available") {
+        log::init(temp_dir.path(), {.file = {.batched = false}});
+
+        auto test_logger = log::get("test");
+        test_logger->info("unbatched line");
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "unbatched line") == 1);
+
+        log::shutdown();
+    }
+}
+
+TEST_CASE("Logger | Log archive", "[logger]") {
+
+    const TempDir temp_dir;
+
+    SECTION("blocks round-trip through the codec") {
+        std::string text;
+        for (int i = 0; i < 2000; i++) text += std::format("2026-10-17 12:00:00.{:03} [      test] [    info] line {}\n", i % 1000, i);
+
+        std::string noise(10000, '\0');
+        std::uint32_t state = 1;
+        for (auto& c : noise) {
+            state = state * 1664525u + 1013904223u;
+            c = static_cast<char>(state >> 24);
+        }
+
+        const std::vector<std::string> blocks = {text, noise, std::string(50000, 'a'), "", "short", "abcdabcdabcdabcd"};
+        for (const auto& block : blocks) {
+            std::vector<char> compressed(block.size() + block.size() / 255 + 16);
+            const auto size = log::archive::compress_block(block.data(), block.size(), compressed.data(), compressed.size());
+            REQUIRE(size > 0);
+
+            std::string decompressed(block.size(), '\0');
+            REQUIRE(log::archive::decompress_block(compressed.data(), size, decompressed.data(), block.size()));
+            REQUIRE(decompressed == block);
+        }
+
+        // Log lines compress well; random bytes do not fit in less than their size
+        std::vector<char> compressed(text.size());
+        REQUIRE(log::archive::compress_block(text.data(), text.size(), compressed.data(), compressed.size()) < text.size() / 4);
+        REQUIRE(log::archive::compress_block(noise.data(), noise.size(), compressed.data(), noise.size() - 1) == 0);
+    }
+
+    SECTION("corrupt blocks are rejected") {
+        const std::string block(1000, 'x');
+        std::vector<char> compressed(100);
+        const auto size = log::archive::compress_block(block.data(), block.size(), compressed.data(), compressed.size());
+        REQUIRE(size > 0);
+
+        std::string out(block.size(), '\0');
+        REQUIRE_FALSE(log::archive::decompress_block(compressed.data(), size - 1, out.data(), out.size()));
+        REQUIRE_FALSE(log::archive::decompress_block(compressed.data(), size, out.data(), out.size() - 1));
+        compressed[2] = static_cast<char>(0xff); // offset past the start of the block
+        REQUIRE_FALSE(log::archive::decompress_block(compressed.data(), size, out.data(), out.size()));
+    }
+
+    SECTION("rotated text segments are compressed and read back") {
+        log::init(temp_dir.path(), {.file = {.batch_size = 512, .max_file_size = 4096}, .console = false});
+
+        auto test_logger = log::get("test");
+        for (int i = 0; i < 500; i++) {
+            test_logger->info("archived line {}", i);
+            if (i % 10 == 0) test_logger->flush();
+        }
+        log::shutdown();
+
+        // Only the current file stays uncompressed; segments are numbered oldest first
+        REQUIRE(files_with_extension(temp_dir.path(), ".log").size() == 1);
+        auto segments = files_with_extension(temp_dir.path(), ".akz");
+        REQUIRE(segments.size() > 2);
+        std::ranges::sort(segments, {}, [](const fs::path& path) {
+            return std::stoi(path.stem().stem().extension().string().substr(1)); // base.<N>.log.akz
+        });
+
+        std::vector<std::string> lines;
+        for (const auto& segment : segments) {
+            REQUIRE(fs::file_size(segment) < 4096);
+            for (auto& line : read_lines(segment)) lines.push_back(std::move(line));
+        }
+        for (auto& line : read_lines(files_with_extension(temp_dir.path(), ".log")[0])) lines.push_back(std::move(line));
+
+        REQUIRE(lines.size() == 500);
+        for (int i = 0; i < 500; i++) REQUIRE(lines[i].ends_with(std::format("archived line {}", i)));
+    }
+
+    SECTION("segments of an earlier session survive the next one") {
+        // Two sessions in turn on the same directory, each with its own archiver
+        const auto session = [&](const std::string& name) {
+            log::init(temp_dir.path(), {.file = {.batch_size = 512, .max_file_size = 4096}, .console = false});
+            auto test_logger = log::get("test");
+            for (int i = 0; i < 300; i++) {
+                test_logger->info("{} line {}", name, i);
+                if (i % 10 == 0) test_logger->flush();
+            }
+            log::shutdown();
+        };
+
+        session("first");
+        std::map<fs::path, std::vector<std::string>> first;
+        for (const auto& segment : files_with_extension(temp_dir.path(), ".akz")) first[segment] = read_lines(segment);
+        REQUIRE(first.size() > 2);
+
+        session("second");
+        const auto segments = files_with_extension(temp_dir.path(), ".akz");
+        REQUIRE(segments.size() > first.size() + 2);
+        for (const auto& [segment, lines] : first) {
+            REQUIRE(fs::exists(segment));
+            REQUIRE(read_lines(segment) == lines);
+        }
+        // Nothing of either session lost
+        std::vector<std::string> lines;
+        for (const auto& segment : segments) {
+            for (auto& line : read_lines(segment)) lines.push_back(std::move(line));
+        }
+        for (const auto& log_file : files_with_extension(temp_dir.path(), ".log")) {
+            for (auto& line : read_lines(log_file)) lines.push_back(std::move(line));
+        }
+        for (const std::string name : {"first", "second"}) {
+            REQUIRE(std::ranges::count_if(lines, [&](const auto& line) {
+                return line.find(name + " line") != std::string::npos;
+            }) == 300);
+        }
+    }
+
+    SECTION("rotated binary segments decode from their compressed form") {
+        log::init(temp_dir.path(), {.binary = {.enabled = true, .text_sinks = false, .max_file_size = 1024}});
+
+        auto test_logger = log::get("test");
+        for (int i = 0; i < 200; i++) {
+            test_logger->info("rotation record {}", i);
+        }
+        log::shutdown();
+
+        std::size_t total = 0;
+        for (const auto& file : files_with_extension(temp_dir.path(), ".akz")) {
+            REQUIRE(file.stem().extension() == log::binary::file_extension);
+            total += decode_binary_log(file).size();
+        }
+        REQUIRE(total > 0);
+        total += decode_binary_log(files_with_extension(temp_dir.path(), ".aklog").at(0)).size();
+        REQUIRE(total == 200);
+    }
+
+    SECTION("the oldest segments are deleted beyond the retention budget") {
+        constexpr std::size_t max_bytes = 2000;
+        log::init(temp_dir.path(), {.file = {.batch_size = 512, .max_file_size = 4096},
+                                    .archive = {.max_bytes = max_bytes}, .console = false});
+
+        auto test_logger = log::get("test");
+        for (int i = 0; i < 2000; i++) {
+            test_logger->info("retained line {}", i);
+            if (i % 10 == 0) test_logger->flush();
+        }
+        log::shutdown();
+
+        std::uintmax_t total = 0;
+        for (const auto& segment : files_with_extension(temp_dir.path(), ".akz")) total += fs::file_size(segment);
+        REQUIRE(total <= max_bytes);
+        REQUIRE(count_log_lines(temp_dir.path(), "retained line 1999") == 1);
+    }
+
+    SECTION("reading a file that is not a compressed segment throws") {
+        log::init(temp_dir.path());
+        log::shutdown();
+
+        const auto text_files = files_with_extension(temp_dir.path(), ".log");
+        REQUIRE(text_files.size() == 1);
+        REQUIRE_THROWS_AS(log::archive::Reader(text_files[0]), std::runtime_error);
+    }
+}
+
+TEST_CASE("Logger | Time index", "[logger]") {
+
+    const TempDir temp_dir;
+
+    const auto system_ns = [] {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    };
+
+    SECTION("blocks cover the file and select by time, logger and level") {
+        std::int64_t middle_ns = 0;
+        {
+            log::init(temp_dir.path(), {.file = {.index_block_size = 1024}, .console = false});
+
+            auto net = log::get("net");
+            auto audio = log::get("audio");
+            for (int i = 0; i < 200; i++) {
+                net->info("net line {}", i);
+                if (i % 20 == 0) net->flush();
+            }
+            net->flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            middle_ns = system_ns();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            for (int i = 0; i < 200; i++) {
+                audio->error("audio line {}", i);
+                if (i % 20 == 0) audio->flush();
+            }
+
+            log::shutdown();
+        } // the sinks close with the last logger handles
+
+        const auto log_file = files_with_extension(temp_dir.path(), ".log").at(0);
+        const log::index::Index index(log::index::index_path(log_file));
+        const auto& blocks = index.blocks();
+        REQUIRE(blocks.size() > 4);
+
+        std::uint64_t offset = 0;
+        for (const auto& block : blocks) {
+            REQUIRE(block.offset == offset);
+            REQUIRE(block.first_ns <= block.last_ns);
+            offset += block.size;
+        }
+        REQUIRE(index.indexed_size() == fs::file_size(log_file));
+
+        // Selected blocks hold every matching line, and nothing but them is needed
+        const auto content = read_lines(log_file);
+        const auto lines_of = [&](const std::vector<log::index::Block>& selected) {
+            std::string text;
+            std::ifstream file(log_file, std::ios::binary);
+            for (const auto& block : selected) {
+                std::string bytes(block.size, '\0');
+                file.seekg(static_cast<std::streamoff>(block.offset));
+                file.read(bytes.data(), block.size);
+                text += bytes;
+            }
+            return text;
+        };
+
+        const auto audio_blocks = index.select(std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max(),
+                                               index.logger_mask("audio"));
+        REQUIRE(audio_blocks.size() < blocks.size());
+        const auto audio_text = lines_of(audio_blocks);
+        for (int i = 0; i < 200; i++) REQUIRE(audio_text.find(std::format("audio line {}\n", i)) != std::string::npos);
+
+        const auto error_blocks = index.select(std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max(),
+                                               log::index::all_loggers, 1u << static_cast<unsigned>(log::LogLevel::error));
+        REQUIRE(error_blocks.size() == audio_blocks.size());
+
+        const auto late_blocks = index.select(middle_ns, std::numeric_limits<std::int64_t>::max());
+        REQUIRE(late_blocks.size() == audio_blocks.size());
+        REQUIRE(lines_of(late_blocks).find("net line") == std::string::npos);
+
+        REQUIRE(index.logger_mask("video") == 0);
+    }
+
+    SECTION("indexes follow their files through rotation and archiving") {
+        for (const bool archived : {false, true}) {
+            {
+                log::init(temp_dir.path(), {.file = {.batch_size = 512, .max_file_size = 4096, .max_files = 20, .index_block_size = 1024},
+                                            .archive = {.enabled = archived}, .console = false});
+                auto test_logger = log::get("test");
+                for (int i = 0; i < 500; i++) {
+                    test_logger->info("rotated line {}", i);
+                    if (i % 10 == 0) test_logger->flush();
+                }
+                log::shutdown();
+            }
+
+            const auto segments = files_with_extension(temp_dir.path(), archived ? ".akz" : ".log");
+            REQUIRE(segments.size() > 2);
+            for (const auto& segment : segments) {
+                const log::index::Index index(log::index::index_path(segment));
+                std::uint64_t size = 0;
+                for (const auto& line : read_lines(segment)) size += line.size() + 1;
+                REQUIRE(index.indexed_size() == size);
+            }
+
+            for (const auto& entry : fs::directory_iterator(temp_dir.path())) fs::remove(entry.path());
+        }
+    }
+}
+
+TEST_CASE("Logger | Rate limiting", "[logger]") {
+
+    const TempDir temp_dir;
+
+    SECTION("sampling keeps one call in N and reports the others") {
+        log::init(temp_dir.path(), {.console = false});
+
+        auto test_logger = log::get("test");
+        test_logger->set_rate_limit({.sample_every = 10});
+        for (int i = 0; i < 100; i++) {
+            test_logger->warn("sampled {}", i);
+        }
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "] sampled") == 10);
+        REQUIRE(count_log_lines(temp_dir.path(), "] sampled 90") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "] 9 similar messages suppressed: sampled {}") == 10);
+
+        log::shutdown();
+    }
+
+    SECTION("the token bucket admits a burst then suppresses") {
+        log::init(temp_dir.path(), {.console = false});
+
+        auto test_logger = log::get("test");
+        test_logger->set_rate_limit({.messages_per_second = 0.001, .burst = 5});
+        for (int i = 0; i < 100; i++) {
+            test_logger->warn("flood {}", i);
+        }
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "] flood") == 5);
+        REQUIRE(count_log_lines(temp_dir.path(), "] flood 4") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "] 95 similar messages suppressed: flood {}") == 1);
+
+        log::shutdown();
+    }
+
+    SECTION("the bucket refills over time") {
+        log::init(temp_dir.path(), {.console = false});
+
+        auto test_logger = log::get("test");
+        test_logger->set_rate_limit({.messages_per_second = 50, .burst = 1});
+        test_logger->warn("refill");
+        test_logger->warn("refill");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        test_logger->warn("refill");
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "] refill") == 2);
+        REQUIRE(count_log_lines(temp_dir.path(), "] 1 similar messages suppressed: refill") == 1);
+
+        log::shutdown();
+    }
+
+    SECTION("call sites and loggers are limited independently") {
+        log::init(temp_dir.path(), {.console = false});
+
+        auto limited = log::get("limited");
+        auto other = log::get("other");
+        limited->set_rate_limit({.messages_per_second = 0.001, .burst = 1});
+        for (int i = 0; i < 10; i++) {
+            limited->warn("site a {}", i);
+            limited->warn("site b {}", i);
+            other->warn("site a {}", i);
+        }
+        limited->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "[   limited] [ warning] site a") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "[   limited] [ warning] site b") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "[     other] [ warning] site a") == 10);
+
+        log::shutdown();
+    }
+
+    SECTION("one format string at two levels is two call sites") {
+        log::init(temp_dir.path(), {.console = false});
+
+        auto test_logger = log::get("test");
+        test_logger->set_rate_limit({.messages_per_second = 0.001, .burst = 1});
+        static constexpr char format[] = "either level {}";
+        for (int i = 0; i < 10; i++) {
+            test_logger->warn(format, i);
+            test_logger->error(format, i);
+        }
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "[ warning] either level 0") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "[   error] either level 0") == 1);
+        REQUIRE(count_log_lines(temp_dir.path(), "] either level") == 2);
+
+        log::shutdown();
+    }
+
+    SECTION("filtered calls are not counted") {
+        log::init(temp_dir.path(), {.console = false});
+
+        auto test_logger = log::get("test");
+        test_logger->set_rate_limit({.sample_every = 2});
+        test_logger->set_level(log::LogLevel::warn);
+        for (int i = 0; i < 10; i++) {
+            test_logger->info("filtered {}", i);
+        }
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "suppressed") == 0);
+
+        log::shutdown();
+    }
+
+    SECTION("an empty config removes the limit") {
+        log::init(temp_dir.path(), {.console = false});
+
+        auto test_logger = log::get("test");
+        test_logger->set_rate_limit({.messages_per_second = 0.001, .burst = 1});
+        test_logger->warn("limited {}", 0);
+        test_logger->warn("limited {}", 1);
+        test_logger->set_rate_limit({});
+        test_logger->warn("limited {}", 2);
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "] limited") == 2);
+        REQUIRE(count_log_lines(temp_dir.path(), "] 1 similar messages suppressed: limited {}") == 1);
+
+        log::shutdown();
+    }
+
+    SECTION("concurrent calls are sampled exactly") {
+        log::init(temp_dir.path(), {.console = false});
+
+        auto test_logger = log::get("test");
+        test_logger->set_rate_limit({.sample_every = 4});
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&test_logger] {
+                for (int i = 0; i < 1000; i++) test_logger->warn("concurrent line {}", i);
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "] concurrent line") == 1000);
+
+        log::shutdown();
+    }
+
+    SECTION("limited calls do not allocate in async mode") {
+        log::init(temp_dir.path(), {.async = {.enabled = true, .ring_capacity = 4096}, .console = false});
+
+        auto test_logger = log::get("test");
+        test_logger->set_rate_limit({.messages_per_second = 1000, .burst = 10, .sample_every = 3});
+        log::preallocate_thread_buffer();
+        test_logger->warn("first call claims the site {}", 0);
+
+        const test::AllocCounter counter;
+        for (int i = 0; i < 1000; i++) {
+            test_logger->warn("first call claims the site {}", i);
+        }
+        const auto allocations = counter.count();
+
+        REQUIRE(allocations == 0);
+
+        log::shutdown();
+    }
+}
+
+TEST_CASE("Logger | Structured fields", "[logger]") {
+
+    const TempDir temp_dir;
+
+    SECTION("fields are rendered as key=value in the text log") {
+        log::init(temp_dir.path(), {.console = false});
+
+        auto test_logger = log::get("test");
+        const std::string label = "main out";
+        test_logger->warn("underrun", log::kv("stream", 3), log::kv("depth", 12u), log::kv("ratio", 0.5),
+                          log::kv("label", label), log::kv("quote", std::string_view("say \"hi\"")),
+                          log::kv("ok", true), log::kv("empty", ""));
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(),
+                                "[ warning] underrun stream=3 depth=12 ratio=0.5 label=\"main out\" "
+                                "quote=\"say \\\"hi\\\"\" ok=true empty=\"\"") == 1);
+
+        log::shutdown();
+    }
+
+    SECTION("fields are kept typed in the binary log") {
+        log::init(temp_dir.path(), {.binary = {.enabled = true}, .console = false});
+
+        auto test_logger = log::get("stream");
+        test_logger->info("underrun", log::kv("stream", std::int64_t{-7}), log::kv("depth", std::uint16_t{64}),
+                          log::kv("latency_ms", 2.25f), log::kv("device", "USB Audio"));
+        test_logger->info("not a field {}", 1);
+        test_logger->info("user type", log::kv("at", Point{1, 2}));
+
+        log::shutdown();
+
+        const auto binary_files = files_with_extension(temp_dir.path(), ".aklog");
+        REQUIRE(binary_files.size() == 1);
+        REQUIRE(decode_binary_log(binary_files[0]) == read_lines(files_with_extension(temp_dir.path(), ".log")[0]));
+
+        log::binary::Reader reader(binary_files[0]);
+        log::binary::DecodedRecord record;
+        REQUIRE(reader.next(record));
+        REQUIRE(record.event == "underrun");
+        REQUIRE(record.message == "underrun stream=-7 depth=64 latency_ms=2.25 device=\"USB Audio\"");
+        REQUIRE(record.fields.size() == 4);
+        REQUIRE(record.fields[0].key == "stream");
+        REQUIRE(record.fields[0].type == log::detail::ArgType::i64);
+        REQUIRE(record.fields[0].value == "-7");
+        REQUIRE(record.fields[3].value == "USB Audio");
+
+        const auto json = log::binary::format_json_line(record);
+        REQUIRE(json.find(R"("logger":"stream","level":"info","msg":"underrun","stream":-7,"depth":64,)"
+                          R"("latency_ms":2.25,"device":"USB Audio"})") != std::string::npos);
+
+        REQUIRE(reader.next(record));
+        REQUIRE(record.fields.empty());
+        REQUIRE(log::binary::format_json_line(record).ends_with(R"("msg":"not a field 1"})"));
+
+        // Custom types cannot be decoded offline: the record keeps its text
+        REQUIRE(reader.next(record));
+        REQUIRE(record.message == "user type at=(1, 2)");
+        REQUIRE(record.fields.empty());
+        REQUIRE_FALSE(reader.next(record));
+    }
+
+    SECTION("long keys and values are truncated to the record") {
+        log::init(temp_dir.path(), {.async = {.enabled = true}, .console = false});
+
+        auto test_logger = log::get("test");
+        const std::string long_value(400, 'v');
+        test_logger->info("long", log::kv(std::string(300, 'k'), long_value), log::kv("last", 42));
+        test_logger->flush();
+
+        REQUIRE(count_log_lines(temp_dir.path(), "vv last=42") == 1);
+
+        log::shutdown();
+    }
+
+    SECTION("numeric fields do not allocate in async mode") {
+        log::init(temp_dir.path(), {.async = {.enabled = true, .ring_capacity = 4096}, .console = false});
+
+        auto test_logger = log::get("test");
+        log::preallocate_thread_buffer();
+
+        const test::AllocCounter counter;
+        for (int i = 0; i < 1000; i++) {
+            test_logger->info("tick", log::kv("i", i), log::kv("depth", 0.25 * i), log::kv("device", "hw:0"));
+        }
+        const auto allocations = counter.count();
+
+        REQUIRE(allocations == 0);
+
+        log::shutdown();
+        REQUIRE(count_log_lines(temp_dir.path(), "] tick i=") == 1000);
+    }
+}
@@ -0,0 +1,59 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+// aknet_logdump: decode binary .aklog files back to the text log format.
+//
+//   aknet_logdump [--json] <file.aklog | file.aklog.akz | file.log.akz>...
+//
+// Files are decoded in the order given, one line per record on stdout. Compressed segments are
+// decompressed on the fly; compressed text segments are printed as they were written.
+// With --json, binary records are printed as JSON lines, structured fields as typed members.
+
+#include <binary_log.h>
+#include <log_archive.h>
+
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace archive = aknet::log::archive;
+namespace binary = aknet::log::binary;
+
+int main(int argc, char** argv) {
+    const bool json = argc > 1 && std::strcmp(argv[1], "--json") == 0;
+    const int first = json ? 2 : 1;
+    if (argc <= first || std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0) {
+        std::cerr << "Usage: " << argv[0] << " [--json] <file" << binary::file_extension << " | file"
+                  << binary::file_extension << archive::file_extension << " | file.log" << archive::file_extension << ">..." << std::endl;
+        return argc <= first ? 1 : 0;
+    }
+
+    int status = 0;
+    for (int i = first; i < argc; i++) {
+        const std::filesystem::path path = argv[i];
+        try {
+            // Compressed text segment: its lines are already in the text format
+            if (path.extension() == archive::file_extension && path.stem().extension() != binary::file_extension) {
+                archive::Reader in(path);
+                std::string line;
+                while (std::getline(in, line)) std::cout << line << '\n';
+                if (in.bad()) throw std::runtime_error("Corrupt compressed log segment");
+                continue;
+            }
+
+            binary::Reader reader(path);
+            binary::DecodedRecord record;
+            while (reader.next(record)) {
+                std::cout << (json ? binary::format_json_line(record) : binary::format_text_line(record)) << '\n';
+            }
+        } catch (const std::exception& ex) {
+            std::cerr << argv[i] << ": " << ex.what() << std::endl;
+            status = 1;
+        }
+    }
+    return status;
+}
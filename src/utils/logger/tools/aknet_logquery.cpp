@@ -0,0 +1,283 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+// aknet_logquery: print the lines of text log files in a time range, of some loggers or levels.
+//
+//   aknet_logquery [--from <time>] [--to <time>] [--logger <name>]... [--level <min level>] <file.log | file.log.akz>...
+//
+// Times are local, "YYYY-MM-DD HH:MM:SS[.mmm]" (or with a 'T' between date and time).
+// Files with a time index (.akidx, see log_index.h) are memory-mapped and only the indexed blocks that may
+// match are scanned; the rest of a file (not indexed yet, or no index) is scanned line by line.
+// Compressed segments are skipped as a whole when their index rules them out, and streamed otherwise.
+
+#include <log_archive.h>
+#include <log_index.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+namespace archive = aknet::log::archive;
+namespace log_index = aknet::log::index;
+using aknet::log::LogLevel;
+
+namespace {
+
+    constexpr std::array<std::string_view, 7> level_names = {"trace", "debug", "info", "warning", "error", "critical", "off"};
+
+    struct Query {
+        std::int64_t from_ns = std::numeric_limits<std::int64_t>::min();
+        std::int64_t to_ns = std::numeric_limits<std::int64_t>::max();
+        std::vector<std::string> loggers; // empty: all
+        LogLevel min_level = LogLevel::trace;
+        std::vector<fs::path> files;
+
+        std::uint8_t level_mask() const {
+            return static_cast<std::uint8_t>(log_index::all_levels << static_cast<unsigned>(min_level));
+        }
+    };
+
+    // "YYYY-MM-DD HH:MM:SS[.mmm]" local time -> ns since the epoch
+    std::optional<std::int64_t> parse_time(std::string_view text) {
+        if (text.size() < 19 || text[4] != '-' || text[7] != '-' || (text[10] != ' ' && text[10] != 'T') ||
+            text[13] != ':' || text[16] != ':') {
+            return {};
+        }
+        const auto field = [&](std::size_t pos, std::size_t length, int& value) {
+            return std::from_chars(text.data() + pos, text.data() + pos + length, value).ec == std::errc{};
+        };
+
+        std::tm tm{};
+        int year, month;
+        if (!field(0, 4, year) || !field(5, 2, month) || !field(8, 2, tm.tm_mday) || !field(11, 2, tm.tm_hour) ||
+            !field(14, 2, tm.tm_min) || !field(17, 2, tm.tm_sec)) {
+            return {};
+        }
+        tm.tm_year = year - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_isdst = -1;
+        const auto seconds = std::mktime(&tm);
+        if (seconds == -1) return {};
+
+        int ms = 0;
+        if (text.size() >= 23 && text[19] == '.' && !field(20, 3, ms)) return {};
+        return static_cast<std::int64_t>(seconds) * 1'000'000'000 + static_cast<std::int64_t>(ms) * 1'000'000;
+    }
+
+    // -------------------------------------------------------------------------
+    // Line filter for the text sink layout: "%Y-%m-%d %H:%M:%S.%e [%10!n] [%8l] %v"
+    // -------------------------------------------------------------------------
+    class LineFilter {
+    public:
+        explicit LineFilter(const Query& query) : query_(query) {}
+
+        // Continuation lines (multi-line messages) follow the verdict of the line they continue
+        bool matches(std::string_view line) {
+            constexpr std::size_t prefix = 23 + 2 + 10 + 3 + 8 + 2; // up to the message
+            if (line.size() < prefix - 1 || line[23] != ' ' || line[24] != '[') return last_;
+
+            // mktime is slow: lines within the same second share it
+            if (line.compare(0, 19, second_) != 0) {
+                const auto seconds = parse_time(line.substr(0, 19));
+                if (!seconds) return last_;
+                second_.assign(line.substr(0, 19));
+                second_ns_ = *seconds;
+            }
+            int ms = 0;
+            std::from_chars(line.data() + 20, line.data() + 23, ms);
+            const auto time_ns = second_ns_ + static_cast<std::int64_t>(ms) * 1'000'000;
+
+            last_ = time_ns >= query_.from_ns && time_ns <= query_.to_ns && logger_matches(line.substr(25, 10)) &&
+                    level_matches(line.substr(38, 8));
+            return last_;
+        }
+
+        void reset() { last_ = false; }
+
+    private:
+        bool logger_matches(std::string_view field) const {
+            if (query_.loggers.empty()) return true;
+            const auto name = field.substr(std::min(field.find_first_not_of(' '), field.size()));
+            return std::ranges::any_of(query_.loggers, [&](const std::string& logger) {
+                return std::string_view(logger).substr(0, 10) == name;
+            });
+        }
+
+        bool level_matches(std::string_view field) const {
+            const auto name = field.substr(std::min(field.find_first_not_of(' '), field.size()));
+            const auto it = std::ranges::find(level_names, name);
+            return it == level_names.end() || static_cast<int>(it - level_names.begin()) >= static_cast<int>(query_.min_level);
+        }
+
+        const Query& query_;
+        std::string second_;
+        std::int64_t second_ns_ = 0;
+        bool last_ = false;
+    };
+
+    void print_matching_lines(std::string_view text, LineFilter& filter) {
+        filter.reset();
+        while (!text.empty()) {
+            const auto end = text.find('\n');
+            const auto line = text.substr(0, end);
+            if (filter.matches(line)) std::cout << line << '\n';
+            text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Files
+    // -------------------------------------------------------------------------
+    std::optional<log_index::Index> load_index(const fs::path& file) {
+        std::error_code ec;
+        const auto path = log_index::index_path(file);
+        if (!fs::exists(path, ec)) return {};
+        return log_index::Index(path);
+    }
+
+    std::uint64_t logger_mask(const Query& query, const log_index::Index& idx) {
+        if (query.loggers.empty()) return log_index::all_loggers;
+        std::uint64_t mask = 0;
+        for (const auto& logger : query.loggers) mask |= idx.logger_mask(logger);
+        return mask;
+    }
+
+    class MappedFile {
+    public:
+        explicit MappedFile(const fs::path& path) {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) throw std::runtime_error("Cannot open log file: " + path.string());
+
+            struct stat st{};
+            if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+                size_ = static_cast<std::size_t>(st.st_size);
+                data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            }
+            ::close(fd);
+            if (data_ == MAP_FAILED) throw std::runtime_error("Cannot map log file: " + path.string());
+        }
+        ~MappedFile() {
+            if (data_ && data_ != MAP_FAILED) ::munmap(data_, size_);
+        }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        std::string_view text() const { return data_ ? std::string_view(static_cast<const char*>(data_), size_) : std::string_view{}; }
+
+    private:
+        void* data_ = nullptr;
+        std::size_t size_ = 0;
+    };
+
+    void query_mapped(const fs::path& path, const Query& query, LineFilter& filter) {
+        const MappedFile file(path);
+        const auto text = file.text();
+        const auto idx = load_index(path);
+        if (!idx) return print_matching_lines(text, filter);
+
+        // Selected blocks, plus whatever the index does not cover
+        const auto mask = logger_mask(query, *idx);
+        std::uint64_t covered = 0;
+        for (const auto& block : idx->blocks()) {
+            if (block.offset < covered || block.offset + block.size > text.size()) break; // stale index
+            if (block.offset > covered) print_matching_lines(text.substr(covered, block.offset - covered), filter);
+            if (block.matches(query.from_ns, query.to_ns, mask, query.level_mask())) {
+                print_matching_lines(text.substr(block.offset, block.size), filter);
+            }
+            covered = block.offset + block.size;
+        }
+        if (covered < text.size()) print_matching_lines(text.substr(covered), filter);
+    }
+
+    void query_compressed(const fs::path& path, const Query& query, LineFilter& filter) {
+        // Archived segments are fully indexed: no matching block, nothing to decompress
+        if (const auto idx = load_index(path)) {
+            if (idx->select(query.from_ns, query.to_ns, logger_mask(query, *idx), query.level_mask()).empty()) return;
+        }
+
+        archive::Reader in(path);
+        filter.reset();
+        std::string line;
+        while (std::getline(in, line)) {
+            if (filter.matches(line)) std::cout << line << '\n';
+        }
+        if (in.bad()) throw std::runtime_error("Corrupt compressed log segment");
+    }
+
+    std::optional<Query> parse_query(int argc, char** argv) {
+        Query query;
+        for (int i = 1; i < argc; i++) {
+            const std::string_view arg = argv[i];
+            const bool has_value = i + 1 < argc;
+            if ((arg == "--from" || arg == "--to") && has_value) {
+                const auto time = parse_time(argv[++i]);
+                if (!time) return {};
+                (arg == "--from" ? query.from_ns : query.to_ns) = *time;
+            } else if (arg == "--logger" && has_value) {
+                query.loggers.emplace_back(argv[++i]);
+            } else if (arg == "--level" && has_value) {
+                std::string_view name = argv[++i];
+                if (name == "warn") name = "warning";
+                const auto it = std::ranges::find(level_names, name);
+                if (it == level_names.end()) return {};
+                query.min_level = static_cast<LogLevel>(it - level_names.begin());
+            } else if (arg.starts_with("--")) {
+                return {};
+            } else {
+                query.files.emplace_back(arg);
+            }
+        }
+        if (query.files.empty()) return {};
+        return query;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto query = parse_query(argc, argv);
+    if (!query) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--from <time>] [--to <time>] [--logger <name>]... [--level <min level>] <file.log>...\n"
+                     "  time: local \"YYYY-MM-DD HH:MM:SS[.mmm]\", level: trace debug info warning error critical"
+                  << std::endl;
+        return 1;
+    }
+
+    // A millisecond range: the text lines have millisecond timestamps
+    Query rounded = *query;
+    if (rounded.to_ns != std::numeric_limits<std::int64_t>::max()) rounded.to_ns += 999'999;
+
+    int status = 0;
+    LineFilter filter(rounded);
+    for (const auto& file : rounded.files) {
+        try {
+            if (file.extension() == archive::file_extension) {
+                query_compressed(file, rounded, filter);
+            } else {
+                query_mapped(file, rounded, filter);
+            }
+        } catch (const std::exception& ex) {
+            std::cerr << file.string() << ": " << ex.what() << std::endl;
+            status = 1;
+        }
+    }
+    return status;
+}
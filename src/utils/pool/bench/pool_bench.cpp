@@ -0,0 +1,219 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+// aknet_pool_bench: allocation and release of 2 KiB buffers under contention, BufferPool against
+// std::allocator (malloc).
+//
+//   aknet_pool_bench [--format text|csv|json] [--operations <n>] [--threads <n>]
+//
+// Two patterns, each with 1, 2, 4... up to `threads` threads:
+//   - local: every thread allocates 8 buffers, writes to them and releases them, over and over
+//   - handoff: threads in pairs, one allocating and writing buffers, the other releasing them, through a
+//     single-producer single-consumer ring: a packet going from the network thread to the audio thread
+// Each allocating thread does `operations` allocations. Time is per allocation and release, from the wall time of the
+// whole run; speedup is against std::allocator with the same pattern and threads.
+
+#include <buffer_pool.h>
+#include <bench_support.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace aknet;
+
+namespace {
+
+    constexpr std::size_t buffer_bytes = 2048;
+
+    struct Result {
+        std::string pattern;
+        std::string allocator;
+        std::uint32_t threads = 0;
+        double ns_per_operation = 0;
+        double million_per_second = 0;
+        double speedup = 1;
+    };
+
+    struct Options {
+        bench::Format format = bench::Format::text;
+        std::uint32_t operations = 1'000'000;
+        std::uint32_t threads = std::max(2u, std::thread::hardware_concurrency());
+    };
+
+    // ---------------------------------------------------------------------------------------------
+    // Allocators
+    // ---------------------------------------------------------------------------------------------
+
+    struct PoolAllocator {
+        static constexpr std::string_view name = "BufferPool";
+        using Handle = pool::Buffer;
+        pool::BufferPool& pool;
+
+        Handle get() { return pool.allocate(); }
+        void put(Handle& handle) { handle.reset(); }
+        static std::byte* data(const Handle& handle) { return handle.bytes().data(); }
+        void done() { pool.release_thread_cache(); }
+    };
+
+    struct StdAllocator {
+        static constexpr std::string_view name = "std::allocator";
+        using Handle = std::byte*;
+
+        Handle get() { return std::allocator<std::byte>().allocate(buffer_bytes); }
+        void put(Handle& handle) { std::allocator<std::byte>().deallocate(std::exchange(handle, nullptr), buffer_bytes); }
+        static std::byte* data(Handle handle) { return handle; }
+        void done() {}
+    };
+
+    // ---------------------------------------------------------------------------------------------
+    // Patterns
+    // ---------------------------------------------------------------------------------------------
+
+    // Runs `work(thread index)` on `threads` threads, returns the wall time
+    template <typename Work>
+    double run_threads(std::uint32_t threads, Work work) {
+        std::atomic<bool> go{false};
+        std::vector<std::thread> workers;
+        for (std::uint32_t t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                work(t);
+            });
+        }
+        const auto t0 = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& worker : workers) worker.join();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    template <typename Allocator>
+    double local(Allocator allocator, const Options& options, std::uint32_t threads) {
+        return run_threads(threads, [&](std::uint32_t) {
+            Allocator a = allocator;
+            std::array<typename Allocator::Handle, 8> held{};
+            for (std::uint32_t i = 0; i < options.operations; i += held.size()) {
+                for (auto& handle : held) {
+                    handle = a.get();
+                    Allocator::data(handle)[0] = std::byte{1};
+                }
+                for (auto& handle : held) a.put(handle);
+            }
+            a.done();
+        });
+    }
+
+    template <typename Allocator>
+    double handoff(Allocator allocator, const Options& options, std::uint32_t threads) {
+        struct alignas(64) Ring {
+            std::array<typename Allocator::Handle, 256> slots{};
+            alignas(64) std::atomic<std::uint32_t> head{0};
+            alignas(64) std::atomic<std::uint32_t> tail{0};
+        };
+        const auto rings = std::make_unique<Ring[]>(threads / 2);
+
+        return run_threads(threads / 2 * 2, [&](std::uint32_t t) {
+            Allocator a = allocator;
+            Ring& ring = rings[t / 2];
+            for (std::uint32_t i = 0; i < options.operations; i++) {
+                if (t % 2 == 0) {
+                    auto handle = a.get();
+                    while (!Allocator::data(handle)) {
+                        std::this_thread::yield(); // pool exhausted: the consumer is behind
+                        handle = a.get();
+                    }
+                    Allocator::data(handle)[0] = std::byte{1};
+                    const auto tail = ring.tail.load(std::memory_order_relaxed);
+                    while (tail - ring.head.load(std::memory_order_acquire) == ring.slots.size()) std::this_thread::yield();
+                    ring.slots[tail % ring.slots.size()] = std::move(handle);
+                    ring.tail.store(tail + 1, std::memory_order_release);
+                } else {
+                    const auto head = ring.head.load(std::memory_order_relaxed);
+                    while (head == ring.tail.load(std::memory_order_acquire)) std::this_thread::yield();
+                    auto handle = std::move(ring.slots[head % ring.slots.size()]);
+                    ring.head.store(head + 1, std::memory_order_release);
+                    a.put(handle);
+                }
+            }
+            a.done();
+        });
+    }
+
+    // ---------------------------------------------------------------------------------------------
+    // Output
+    // ---------------------------------------------------------------------------------------------
+
+    void print(const Options& options, const std::vector<Result>& results) {
+        bench::Table table{"results", {
+            {.key = "pattern", .header = "pattern", .width = 10, .left = true},
+            {.key = "allocator", .header = "allocator", .width = 16, .left = true},
+            {.key = "threads", .header = "threads", .width = 8},
+            {.key = "ns_per_operation", .header = "ns/op", .width = 10, .precision = 1},
+            {.key = "million_per_second", .header = "Mops/s", .width = 10, .precision = 2},
+            {.key = "speedup", .header = "speedup", .width = 8, .precision = 2, .unit = "x"},
+        }};
+        for (const auto& r : results) {
+            table.add({r.pattern, r.allocator, r.threads, r.ns_per_operation, r.million_per_second, r.speedup});
+        }
+        bench::print(options.format, {table});
+    }
+
+    std::optional<Options> parse_options(int argc, char** argv) {
+        return bench::parse_options<Options>(argc, argv, [](Options& options, std::string_view name, std::string_view value) {
+            if (name == "--operations") return bench::parse_count(value, options.operations);
+            if (name == "--threads") return bench::parse_count(value, options.threads);
+            return false;
+        });
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_options(argc, argv);
+    if (!options) {
+        std::cerr << "Usage: " << argv[0] << " [--format text|csv|json] [--operations <n>] [--threads <n>]"
+                  << std::endl;
+        return 1;
+    }
+
+    pool::BufferPool pool({.buffer_bytes = buffer_bytes, .buffers = 4096, .thread_caches = 64, .checks = false});
+    std::vector<Result> results;
+    // `allocating` threads do `operations` allocations each
+    const auto add = [&](std::string_view pattern, std::uint32_t threads, std::uint32_t allocating, auto measure) {
+        const double std_ns = measure(StdAllocator{});
+        const double pool_ns = measure(PoolAllocator{pool});
+        const double operations = static_cast<double>(options->operations) * allocating;
+        for (const auto& [name, ns] : {std::pair{StdAllocator::name, std_ns}, std::pair{PoolAllocator::name, pool_ns}}) {
+            results.push_back({
+                .pattern = std::string(pattern),
+                .allocator = std::string(name),
+                .threads = threads,
+                .ns_per_operation = ns / operations,
+                .million_per_second = operations / ns * 1e3,
+                .speedup = std_ns / ns,
+            });
+        }
+    };
+
+    for (std::uint32_t threads = 1; threads <= options->threads; threads *= 2) {
+        add("local", threads, threads, [&](auto allocator) { return local(allocator, *options, threads); });
+    }
+    for (std::uint32_t threads = 2; threads <= options->threads; threads *= 2) {
+        add("handoff", threads, threads / 2, [&](auto allocator) { return handoff(allocator, *options, threads); });
+    }
+
+    print(*options, results);
+    return 0;
+}
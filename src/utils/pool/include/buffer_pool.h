@@ -0,0 +1,207 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#ifndef AKNET_BUFFER_POOL_H
+#define AKNET_BUFFER_POOL_H
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace aknet::pool {
+
+    class BufferPool;
+
+    // -------------------------------------------------------------------------
+    // Buffer: a counted reference to one buffer of a pool. Copies share the buffer (no copy of the data, an
+    // atomic increment), so one buffer can go to many consumers; the last reference to go returns it to the
+    // pool from whichever thread drops it. An empty Buffer refers to nothing.
+    // -------------------------------------------------------------------------
+    class Buffer {
+    public:
+        Buffer() noexcept = default;
+        Buffer(const Buffer& other) noexcept;
+        Buffer(Buffer&& other) noexcept : pool_(std::exchange(other.pool_, nullptr)), index_(other.index_) {}
+        Buffer& operator=(Buffer other) noexcept {
+            std::swap(pool_, other.pool_);
+            std::swap(index_, other.index_);
+            return *this;
+        }
+        ~Buffer() { reset(); }
+
+        explicit operator bool() const noexcept { return pool_ != nullptr; }
+
+        // The whole buffer: buffer_bytes rounded up to 64, 64-byte aligned. Empty span on an empty Buffer.
+        std::span<std::byte> bytes() const noexcept;
+
+        // The buffer as an array of T (e.g. float samples)
+        template <typename T>
+        std::span<T> as() const noexcept {
+            const auto b = bytes();
+            return {reinterpret_cast<T*>(b.data()), b.size() / sizeof(T)};
+        }
+
+        // References to this buffer, this one included (0 for an empty Buffer)
+        std::uint32_t use_count() const noexcept;
+
+        // Drop this reference
+        void reset() noexcept;
+
+    private:
+        friend class BufferPool;
+        Buffer(BufferPool* pool, std::uint32_t index) noexcept : pool_(pool), index_(index) {}
+
+        BufferPool* pool_ = nullptr;
+        std::uint32_t index_ = 0;
+    };
+
+    // Called on a failed debug check, with what went wrong. It may return (tests), or not.
+    using ErrorHandler = void (*)(std::string_view message);
+
+    struct BufferPoolConfig {
+        std::size_t buffer_bytes = 2048;       // rounded up to a multiple of 64
+        std::uint32_t buffers = 4096;
+        std::uint32_t thread_caches = 16;      // threads that get a cache; others use the depot directly
+        std::uint32_t cache_buffers = 32;      // buffers a thread keeps at most, moved half at a time
+#ifdef NDEBUG
+        bool checks = false;
+#else
+        bool checks = true;                    // detect leaks and writes to released buffers
+#endif
+        ErrorHandler on_error = nullptr;       // nullptr: print to stderr and abort
+    };
+
+    struct BufferPoolStats {
+        std::size_t buffers = 0;
+        std::size_t buffer_bytes = 0;
+        std::uint64_t allocations = 0;
+        std::uint64_t in_use = 0;
+        std::uint64_t exhausted = 0;           // allocations that found no buffer left
+        std::uint64_t refills = 0;             // batches a thread cache took from the depot
+        std::uint64_t spills = 0;              // batches a thread cache gave back to the depot
+    };
+
+    // -------------------------------------------------------------------------
+    // BufferPool: fixed-size, cache-line-aligned buffers, allocated once, for packets and audio blocks that
+    // move between threads (network, jitter buffer, engine) without touching malloc on the way.
+    //
+    // allocate() and the release of the last reference are lock-free and real-time safe. Each thread using
+    // the pool gets a cache of up to cache_buffers buffers, so most operations touch no shared state;
+    // caches exchange half of their capacity at a time with a global depot, a lock-free stack of batches.
+    // Buffers freed on another thread than the one that allocated them simply land in that thread's cache.
+    //
+    // With checks on, released buffers are filled with a pattern verified at their next allocation (a write
+    // after release is reported), and the destructor reports buffers still referenced (leaks).
+    //
+    // The pool must outlive its Buffers and the threads using it must not be using it while it is
+    // destroyed. A thread's cached buffers go back to the depot when it exits; a thread that stops using
+    // the pool but keeps running should call release_thread_cache() so that they go back for other threads.
+    //
+    // A thread holds caches of up to 8 pools at once, and up to 256 pools with thread caches may be alive
+    // in the process; past either limit, the depot is used directly. The caches of a destroyed pool stop
+    // counting against the first limit on their own, without release_thread_cache().
+    // -------------------------------------------------------------------------
+    class BufferPool {
+    public:
+        // Throws std::invalid_argument on zero buffers or bytes, or buffers that do not fit in 32-bit indices
+        explicit BufferPool(const BufferPoolConfig& config = {});
+        ~BufferPool();
+
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        const BufferPoolConfig& config() const noexcept { return config_; }
+
+        // A buffer with one reference, or an empty Buffer if the pool is exhausted. Its content is whatever the
+        // previous user left.
+        Buffer allocate() noexcept;
+
+        // Give this thread's cached buffers back to the depot
+        void release_thread_cache() noexcept;
+
+        BufferPoolStats stats() const noexcept;
+
+    private:
+        friend class Buffer;
+
+        static constexpr std::uint32_t none = 0xFFFF'FFFF;
+
+        // Per buffer, on its own cache line: references move between threads
+        struct alignas(64) Slot {
+            std::atomic<std::uint32_t> refs{0};
+            std::atomic<std::uint32_t> next_batch{none}; // depot: next batch, on the first buffer of a batch
+            std::uint32_t next = none;                   // depot: next buffer of the same batch
+        };
+
+        struct alignas(64) Cache {
+            std::atomic<bool> claimed{false};
+            std::vector<std::uint32_t> indices;          // owner thread only
+            std::uint32_t count = 0;
+            std::atomic<std::uint64_t> allocations{0}, releases{0}, refills{0}, spills{0};
+        };
+
+        std::byte* data(std::uint32_t index) const noexcept { return memory_.get() + index * stride_; }
+        void release(std::uint32_t index) noexcept;
+        Cache* thread_cache() noexcept;
+        std::uint32_t pop_batch() noexcept;
+        void push_batch(std::uint32_t first) noexcept;
+        void push_cached(Cache& cache, std::uint32_t count) noexcept;
+        void poison(std::uint32_t index) noexcept;
+        void check_poison(std::uint32_t index) noexcept;
+        void fail(std::string_view message) const noexcept;
+
+        struct AlignedDelete {
+            void operator()(std::byte* p) const noexcept;
+        };
+
+        const BufferPoolConfig config_;
+        const std::size_t stride_;
+        const std::uint64_t id_;                         // tells this pool apart in thread-local cache lookups
+        std::uint32_t live_slot_ = none;                 // in the registry of pools with thread caches, if any
+        std::unique_ptr<std::byte[], AlignedDelete> memory_;
+        std::unique_ptr<Slot[]> slots_;
+        std::unique_ptr<Cache[]> caches_;
+
+        // Depot: a lock-free stack of batches. Top batch index in the low half, a tag bumped on every change
+        // in the high half, so that a pop racing with a pop and a push of the same batch fails its CAS (ABA).
+        alignas(64) std::atomic<std::uint64_t> depot_{none};
+
+        // Threads without a cache
+        alignas(64) std::atomic<std::uint64_t> direct_allocations_{0}, direct_releases_{0};
+        std::atomic<std::uint64_t> exhausted_{0};
+    };
+
+    // -------------------------------------------------------------------------
+    // Buffer, inline
+    // -------------------------------------------------------------------------
+
+    inline Buffer::Buffer(const Buffer& other) noexcept : pool_(other.pool_), index_(other.index_) {
+        if (pool_) pool_->slots_[index_].refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline std::span<std::byte> Buffer::bytes() const noexcept {
+        return pool_ ? std::span(pool_->data(index_), pool_->stride_) : std::span<std::byte>();
+    }
+
+    inline std::uint32_t Buffer::use_count() const noexcept {
+        return pool_ ? pool_->slots_[index_].refs.load(std::memory_order_relaxed) : 0;
+    }
+
+    inline void Buffer::reset() noexcept {
+        if (!pool_) return;
+        // The last reference releases: acquire every other holder's writes before the buffer is reused
+        if (pool_->slots_[index_].refs.fetch_sub(1, std::memory_order_acq_rel) == 1) pool_->release(index_);
+        pool_ = nullptr;
+    }
+
+} // namespace aknet::pool
+
+#endif // AKNET_BUFFER_POOL_H
@@ -0,0 +1,302 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include "buffer_pool.h"
+
+#include <counters.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+namespace aknet::pool {
+
+    namespace {
+        // Released buffers are filled with this when checks are on
+        constexpr std::byte poison_byte{0xDB};
+
+        std::atomic<std::uint64_t> next_pool_id{1};
+
+        // Ids of the pools with thread caches alive, 0 for a free slot. Pool ids are never reused, so a
+        // slot holding another id than a thread cache entry's tells that entry's pool is gone. An exiting
+        // thread sets returning_cache on its pools' ids while it gives their caches back, and the pools'
+        // destructors wait for it to clear.
+        constexpr std::size_t max_cached_pools = 256;
+        constexpr std::uint64_t returning_cache = std::uint64_t{1} << 63;
+        std::array<std::atomic<std::uint64_t>, max_cached_pools> live_pools{};
+
+        // Caches this thread claimed, by pool id (0: free entry). Entries of destroyed pools are reused.
+        struct ThreadCacheEntry {
+            std::uint64_t pool = 0;
+            std::uint32_t live_slot = 0;   // the pool's slot in live_pools
+            BufferPool* owner = nullptr;   // only dereferenced while live_pools tells the pool is alive
+            void* cache = nullptr;
+        };
+
+        // At thread exit, the caches of the pools still alive go back to their depots, so that buffers do
+        // not stay out of circulation with the threads that last released them
+        struct ThreadCacheEntries {
+            std::array<ThreadCacheEntry, 8> entries{};
+
+            ~ThreadCacheEntries() {
+                for (const auto entry : entries) {
+                    if (entry.pool == 0 || !entry.cache) continue;
+                    auto& live = live_pools[entry.live_slot];
+                    std::uint64_t expected = entry.pool;
+                    if (live.compare_exchange_strong(expected, entry.pool | returning_cache, std::memory_order_acquire)) {
+                        entry.owner->release_thread_cache();
+                        live.store(entry.pool, std::memory_order_release);
+                    }
+                }
+            }
+        };
+        thread_local ThreadCacheEntries thread_cache_entries;
+
+        bool reusable(const ThreadCacheEntry& entry) noexcept {
+            const auto live = live_pools[entry.live_slot].load(std::memory_order_acquire);
+            return entry.pool == 0 || (live & ~returning_cache) != entry.pool;
+        }
+
+        BufferPoolConfig validated(const BufferPoolConfig& config) {
+            if (config.buffers == 0 || config.buffer_bytes == 0) {
+                throw std::invalid_argument("Buffer pool buffers and buffer bytes must not be zero");
+            }
+            const std::size_t stride = (config.buffer_bytes + 63) / 64 * 64;
+            if (config.buffers >= 0xFFFF'FFFFu || stride < config.buffer_bytes ||
+                config.buffers > std::numeric_limits<std::size_t>::max() / stride) {
+                throw std::invalid_argument("Buffer pool is too large");
+            }
+            return config;
+        }
+    }
+
+    void BufferPool::AlignedDelete::operator()(std::byte* p) const noexcept {
+        ::operator delete[](p, std::align_val_t{64});
+    }
+
+    BufferPool::BufferPool(const BufferPoolConfig& config)
+        : config_(validated(config)),
+          stride_((config.buffer_bytes + 63) / 64 * 64),
+          id_(next_pool_id.fetch_add(1, std::memory_order_relaxed)),
+          memory_(static_cast<std::byte*>(::operator new[](stride_ * config.buffers, std::align_val_t{64}))),
+          slots_(std::make_unique<Slot[]>(config.buffers)) {
+        // Thread caches need a slot in live_pools: with max_cached_pools alive, new pools use the depot only
+        for (std::uint32_t i = 0; i < max_cached_pools && config_.cache_buffers > 0 && config_.thread_caches > 0; i++) {
+            std::uint64_t expected = 0;
+            if (live_pools[i].compare_exchange_strong(expected, id_, std::memory_order_acq_rel)) {
+                live_slot_ = i;
+                break;
+            }
+        }
+        if (live_slot_ != none) {
+            caches_ = std::make_unique<Cache[]>(config_.thread_caches);
+            for (std::uint32_t i = 0; i < config_.thread_caches; i++) caches_[i].indices.resize(config_.cache_buffers);
+        }
+
+        // Everything starts in the depot, in batches of a cache refill
+        const std::uint32_t batch = std::max<std::uint32_t>(1, config_.cache_buffers / 2);
+        for (std::uint32_t first = config_.buffers; first > 0;) {
+            const std::uint32_t begin = first > batch ? first - batch : 0;
+            for (std::uint32_t i = begin; i < first; i++) {
+                slots_[i].next = i + 1 < first ? i + 1 : none;
+                if (config_.checks) poison(i);
+            }
+            push_batch(begin);
+            first = begin;
+        }
+    }
+
+    BufferPool::~BufferPool() {
+        release_thread_cache();
+        if (live_slot_ != none) {
+            // Wait for exiting threads still giving their caches back
+            auto& live = live_pools[live_slot_];
+            for (std::uint64_t expected = id_; !live.compare_exchange_weak(expected, 0, std::memory_order_acq_rel);) {
+                expected = id_;
+                std::this_thread::yield();
+            }
+        }
+
+        if (config_.checks) {
+            std::uint32_t leaked = 0;
+            for (std::uint32_t i = 0; i < config_.buffers; i++) {
+                leaked += slots_[i].refs.load(std::memory_order_acquire) != 0;
+            }
+            if (leaked > 0) fail(std::format("{} buffers still referenced when the pool was destroyed (leak)", leaked));
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Allocation
+    // -------------------------------------------------------------------------
+
+    Buffer BufferPool::allocate() noexcept {
+        Cache* cache = thread_cache();
+        std::uint32_t index = none;
+        if (cache) {
+            if (cache->count == 0) {
+                if (const std::uint32_t first = pop_batch(); first != none) {
+                    for (std::uint32_t i = first; i != none; i = slots_[i].next) cache->indices[cache->count++] = i;
+                    bump(cache->refills);
+                }
+            }
+            if (cache->count > 0) index = cache->indices[--cache->count];
+        } else if (index = pop_batch(); index != none && slots_[index].next != none) {
+            // Take one, put the rest of the batch back
+            push_batch(slots_[index].next);
+        }
+
+        if (index == none) {
+            exhausted_.fetch_add(1, std::memory_order_relaxed);
+            return {};
+        }
+        if (config_.checks) check_poison(index);
+        slots_[index].refs.store(1, std::memory_order_relaxed);
+        if (cache) {
+            bump(cache->allocations);
+        } else {
+            direct_allocations_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return {this, index};
+    }
+
+    void BufferPool::release(std::uint32_t index) noexcept {
+        if (config_.checks) poison(index);
+
+        Cache* cache = thread_cache();
+        if (!cache) {
+            slots_[index].next = none;
+            push_batch(index);
+            direct_releases_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (cache->count == cache->indices.size()) {
+            push_cached(*cache, std::max<std::uint32_t>(1, cache->count / 2));
+            bump(cache->spills);
+        }
+        cache->indices[cache->count++] = index;
+        bump(cache->releases);
+    }
+
+    void BufferPool::release_thread_cache() noexcept {
+        for (auto& entry : thread_cache_entries.entries) {
+            if (entry.pool != id_) continue;
+            if (auto* cache = static_cast<Cache*>(entry.cache)) {
+                push_cached(*cache, cache->count);
+                cache->claimed.store(false, std::memory_order_release);
+            }
+            entry = {};
+        }
+    }
+
+    BufferPool::Cache* BufferPool::thread_cache() noexcept {
+        if (!caches_) return nullptr;
+        auto& entries = thread_cache_entries.entries;
+        for (auto& entry : entries) {
+            if (entry.pool == id_) return static_cast<Cache*>(entry.cache);
+        }
+
+        // First use on this thread: claim a cache, and remember it (or that there was none left)
+        const auto free_entry = std::ranges::find_if(entries, reusable);
+        if (free_entry == entries.end()) return nullptr;
+        *free_entry = {.pool = id_, .live_slot = live_slot_, .owner = this};
+        for (std::uint32_t i = 0; i < config_.thread_caches; i++) {
+            bool expected = false;
+            if (caches_[i].claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                free_entry->cache = &caches_[i];
+                break;
+            }
+        }
+        return static_cast<Cache*>(free_entry->cache);
+    }
+
+    // -------------------------------------------------------------------------
+    // Depot
+    // -------------------------------------------------------------------------
+
+    std::uint32_t BufferPool::pop_batch() noexcept {
+        auto top = depot_.load(std::memory_order_acquire);
+        while (true) {
+            const auto first = static_cast<std::uint32_t>(top);
+            if (first == none) return none;
+            const std::uint64_t next = slots_[first].next_batch.load(std::memory_order_relaxed);
+            if (depot_.compare_exchange_weak(top, ((top >> 32) + 1) << 32 | next, std::memory_order_acquire,
+                                             std::memory_order_acquire)) {
+                return first;
+            }
+        }
+    }
+
+    // `first` starts a batch already linked through Slot::next
+    void BufferPool::push_batch(std::uint32_t first) noexcept {
+        auto top = depot_.load(std::memory_order_relaxed);
+        do {
+            slots_[first].next_batch.store(static_cast<std::uint32_t>(top), std::memory_order_relaxed);
+        } while (!depot_.compare_exchange_weak(top, ((top >> 32) + 1) << 32 | first, std::memory_order_release,
+                                               std::memory_order_relaxed));
+    }
+
+    // The last `count` buffers of a cache go back to the depot as one batch
+    void BufferPool::push_cached(Cache& cache, std::uint32_t count) noexcept {
+        if (count == 0) return;
+        const std::uint32_t begin = cache.count - count;
+        for (std::uint32_t i = begin; i < cache.count; i++) {
+            slots_[cache.indices[i]].next = i + 1 < cache.count ? cache.indices[i + 1] : none;
+        }
+        push_batch(cache.indices[begin]);
+        cache.count = begin;
+    }
+
+    // -------------------------------------------------------------------------
+    // Checks
+    // -------------------------------------------------------------------------
+
+    void BufferPool::poison(std::uint32_t index) noexcept {
+        std::memset(data(index), std::to_integer<int>(poison_byte), stride_);
+    }
+
+    void BufferPool::check_poison(std::uint32_t index) noexcept {
+        const std::byte* begin = data(index);
+        const std::byte* end = begin + stride_;
+        if (const auto* written = std::find_if(begin, end, [](std::byte b) { return b != poison_byte; }); written != end) {
+            fail(std::format("Buffer {} was written at byte {} after its release (use after free)", index,
+                             written - begin));
+        }
+    }
+
+    void BufferPool::fail(std::string_view message) const noexcept {
+        if (config_.on_error) {
+            config_.on_error(message);
+            return;
+        }
+        std::fprintf(stderr, "aknet buffer pool: %.*s\n", static_cast<int>(message.size()), message.data());
+        std::abort();
+    }
+
+    BufferPoolStats BufferPool::stats() const noexcept {
+        BufferPoolStats stats{
+            .buffers = config_.buffers,
+            .buffer_bytes = stride_,
+            .allocations = direct_allocations_.load(std::memory_order_relaxed),
+            .exhausted = exhausted_.load(std::memory_order_relaxed),
+        };
+        std::uint64_t releases = direct_releases_.load(std::memory_order_relaxed);
+        for (std::uint32_t i = 0; caches_ && i < config_.thread_caches; i++) {
+            stats.allocations += caches_[i].allocations.load(std::memory_order_relaxed);
+            releases += caches_[i].releases.load(std::memory_order_relaxed);
+            stats.refills += caches_[i].refills.load(std::memory_order_relaxed);
+            stats.spills += caches_[i].spills.load(std::memory_order_relaxed);
+        }
+        stats.in_use = stats.allocations - std::min(releases, stats.allocations);
+        return stats;
+    }
+
+} // namespace aknet::pool
@@ -0,0 +1,247 @@
+//
+// Created by Nicolas Désilles on 17/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <buffer_pool.h>
+
+using namespace aknet;
+
+// ------------------------------------------------------------------------------------------------
+// Helpers
+// ------------------------------------------------------------------------------------------------
+
+// Failed checks, recorded instead of aborting
+std::vector<std::string> g_errors;
+
+void record_error(std::string_view message) {
+    g_errors.emplace_back(message);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Tests
+// ------------------------------------------------------------------------------------------------
+
+TEST_CASE("Pool | Buffer pool", "[pool]") {
+
+    SECTION("buffers are aligned, rounded up to cache lines and distinct") {
+        pool::BufferPool pool({.buffer_bytes = 1000, .buffers = 64});
+        REQUIRE(pool.stats().buffer_bytes == 1024);
+
+        std::vector<pool::Buffer> buffers;
+        for (int i = 0; i < 64; i++) buffers.push_back(pool.allocate());
+        for (const auto& buffer : buffers) {
+            REQUIRE(buffer);
+            REQUIRE(buffer.bytes().size() == 1024);
+            REQUIRE(reinterpret_cast<std::uintptr_t>(buffer.bytes().data()) % 64 == 0);
+            REQUIRE(buffer.as<float>().size() == 256);
+        }
+        std::vector<const std::byte*> addresses;
+        for (const auto& buffer : buffers) addresses.push_back(buffer.bytes().data());
+        std::ranges::sort(addresses);
+        REQUIRE(std::ranges::adjacent_find(addresses) == addresses.end());
+    }
+
+    SECTION("an exhausted pool returns empty buffers until one comes back") {
+        pool::BufferPool pool({.buffer_bytes = 64, .buffers = 10, .cache_buffers = 4});
+        std::vector<pool::Buffer> buffers;
+        for (int i = 0; i < 10; i++) buffers.push_back(pool.allocate());
+        REQUIRE(pool.stats().in_use == 10);
+
+        const auto none = pool.allocate();
+        REQUIRE_FALSE(none);
+        REQUIRE(none.bytes().empty());
+        REQUIRE(pool.stats().exhausted == 1);
+
+        buffers.pop_back();
+        REQUIRE(pool.allocate());
+        REQUIRE(pool.stats().in_use == 9);
+    }
+
+    SECTION("copies share the buffer, and the last one releases it") {
+        pool::BufferPool pool({.buffer_bytes = 64, .buffers = 4});
+        auto buffer = pool.allocate();
+        buffer.as<float>()[0] = 0.5f;
+
+        std::vector<pool::Buffer> consumers(3, buffer);
+        REQUIRE(buffer.use_count() == 4);
+        REQUIRE(consumers[2].as<float>()[0] == 0.5f);
+        REQUIRE(consumers[2].bytes().data() == buffer.bytes().data());
+
+        auto moved = std::move(buffer);
+        REQUIRE_FALSE(buffer);
+        REQUIRE(moved.use_count() == 4);
+
+        consumers.clear();
+        REQUIRE(moved.use_count() == 1);
+        REQUIRE(pool.stats().in_use == 1);
+        moved.reset();
+        REQUIRE(pool.stats().in_use == 0);
+    }
+
+    SECTION("thread caches exchange batches with the depot") {
+        pool::BufferPool pool({.buffer_bytes = 64, .buffers = 256, .cache_buffers = 16});
+        std::vector<pool::Buffer> buffers;
+        for (int i = 0; i < 100; i++) buffers.push_back(pool.allocate());
+        buffers.clear();
+
+        const auto stats = pool.stats();
+        REQUIRE(stats.refills == 100 / 8 + 1);
+        REQUIRE(stats.spills >= (100 - 16) / 8);
+        REQUIRE(stats.in_use == 0);
+
+        // Another thread gets them all, the cached ones once this thread lets go of its cache
+        pool.release_thread_cache();
+        std::thread([&] {
+            std::vector<pool::Buffer> all;
+            for (int i = 0; i < 256; i++) all.push_back(pool.allocate());
+            REQUIRE(std::ranges::all_of(all, [](const auto& b) { return static_cast<bool>(b); }));
+            pool.release_thread_cache();
+        }).join();
+    }
+
+    SECTION("threads without a cache use the depot directly") {
+        pool::BufferPool pool({.buffer_bytes = 64, .buffers = 8, .thread_caches = 0});
+        std::vector<pool::Buffer> buffers;
+        for (int i = 0; i < 8; i++) buffers.push_back(pool.allocate());
+        REQUIRE_FALSE(pool.allocate());
+        buffers.clear();
+        for (int i = 0; i < 8; i++) buffers.push_back(pool.allocate());
+        REQUIRE(pool.stats().in_use == 8);
+    }
+
+    SECTION("exiting threads give their caches back") {
+        // Every thread drops the last reference to one buffer and exits, without release_thread_cache()
+        pool::BufferPool pool({.buffer_bytes = 64, .buffers = 32, .cache_buffers = 4});
+        std::vector<pool::Buffer> buffers;
+        for (int i = 0; i < 32; i++) buffers.push_back(pool.allocate());
+        std::vector<std::thread> threads;
+        for (auto& buffer : buffers) threads.emplace_back([b = std::move(buffer)]() mutable { b.reset(); });
+        for (auto& thread : threads) thread.join();
+        REQUIRE(pool.stats().in_use == 0);
+
+        buffers.clear();
+        for (int i = 0; i < 32; i++) buffers.push_back(pool.allocate());
+        REQUIRE(std::ranges::all_of(buffers, [](const auto& b) { return static_cast<bool>(b); }));
+
+        // And the caches are free for the next threads
+        buffers.clear();
+        pool.release_thread_cache();
+        const auto refills = pool.stats().refills;
+        std::thread([&] { REQUIRE(pool.allocate()); }).join();
+        REQUIRE(pool.stats().refills == refills + 1);
+    }
+
+    SECTION("pools destroyed on another thread do not use up this thread's caches") {
+        // More pools than a thread has cache entries, each destroyed elsewhere without releasing its cache
+        for (int i = 0; i < 20; i++) {
+            auto used = std::make_unique<pool::BufferPool>(pool::BufferPoolConfig{.buffer_bytes = 64, .buffers = 64});
+            REQUIRE(used->allocate());
+            std::thread([&] { used.reset(); }).join();
+        }
+
+        pool::BufferPool pool({.buffer_bytes = 64, .buffers = 64});
+        REQUIRE(pool.allocate());
+        REQUIRE(pool.stats().refills == 1);
+    }
+
+    SECTION("buffers cross threads without being handed out twice") {
+        // Producers allocate and stamp buffers, consumers check the stamp and release them
+        pool::BufferPool pool({.buffer_bytes = 64, .buffers = 512, .cache_buffers = 16, .checks = false});
+        constexpr int threads = 4;
+        constexpr int rounds = 20000;
+        std::atomic<int> failures{0};
+
+        struct Ring {
+            std::array<pool::Buffer, 64> slots;
+            std::atomic<std::uint32_t> head{0}, tail{0};
+        };
+        std::vector<Ring> rings(threads);
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                Ring& ring = rings[t];
+                for (int i = 0; i < rounds; i++) {
+                    auto buffer = pool.allocate();
+                    if (!buffer) {
+                        i--;
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    auto words = buffer.as<std::uint32_t>();
+                    std::ranges::fill(words, static_cast<std::uint32_t>(t << 24 | i));
+                    while (ring.tail.load(std::memory_order_relaxed) - ring.head.load(std::memory_order_acquire) == 64) {
+                        std::this_thread::yield();
+                    }
+                    const auto tail = ring.tail.load(std::memory_order_relaxed);
+                    ring.slots[tail % 64] = std::move(buffer);
+                    ring.tail.store(tail + 1, std::memory_order_release);
+                }
+                pool.release_thread_cache();
+            });
+            workers.emplace_back([&, t] {
+                Ring& ring = rings[t];
+                for (int i = 0; i < rounds; i++) {
+                    while (ring.head.load(std::memory_order_relaxed) == ring.tail.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+                    const auto head = ring.head.load(std::memory_order_relaxed);
+                    pool::Buffer buffer = std::move(ring.slots[head % 64]);
+                    ring.head.store(head + 1, std::memory_order_release);
+
+                    const auto words = buffer.as<std::uint32_t>();
+                    const auto stamp = static_cast<std::uint32_t>(t << 24 | i);
+                    if (!std::ranges::all_of(words, [&](std::uint32_t w) { return w == stamp; })) failures++;
+                }
+                pool.release_thread_cache();
+            });
+        }
+        for (auto& worker : workers) worker.join();
+
+        REQUIRE(failures == 0);
+        REQUIRE(pool.stats().allocations == threads * rounds);
+        REQUIRE(pool.stats().in_use == 0);
+    }
+
+    SECTION("checks report writes after release and leaks") {
+        g_errors.clear();
+        {
+            pool::BufferPool pool({.buffer_bytes = 64, .buffers = 2, .thread_caches = 0, .checks = true,
+                                   .on_error = record_error});
+            auto buffer = pool.allocate();
+            std::byte* dangling = buffer.bytes().data();
+            buffer.reset();
+            dangling[10] = std::byte{1};
+
+            // The depot is a stack: the buffer just released comes out first
+            auto reused = pool.allocate();
+            REQUIRE(reused.bytes().data() == dangling);
+            REQUIRE(g_errors.size() == 1);
+            REQUIRE(g_errors[0].find("after its release") != std::string::npos);
+
+            // A reference that is never dropped, on purpose: the pool reports it
+            alignas(pool::Buffer) std::byte leaked[sizeof(pool::Buffer)];
+            new (leaked) pool::Buffer(pool.allocate());
+            reused.reset();
+        }
+        REQUIRE(g_errors.size() == 2);
+        REQUIRE(g_errors[1].find("1 buffers still referenced") != std::string::npos);
+    }
+
+    SECTION("invalid configurations are rejected") {
+        REQUIRE_THROWS_AS(pool::BufferPool({.buffer_bytes = 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(pool::BufferPool({.buffers = 0}), std::invalid_argument);
+        REQUIRE_THROWS_AS(pool::BufferPool({.buffers = 0xFFFF'FFFFu}), std::invalid_argument);
+    }
+}